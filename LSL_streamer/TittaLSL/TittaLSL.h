@@ -31,6 +31,9 @@ namespace TittaLSL
     //// global SDK functions
     TobiiResearchSDKVersion getTobiiSDKVersion();
     int32_t getLSLVersion();
+    // scheduling of TittaLSL's and the SDK's threads, same as Titta::setThreadSettings()/getThreadSettings()
+    void setThreadSettings(std::optional<std::string> policy_ = std::nullopt, std::optional<int> priority_ = std::nullopt, std::optional<int> nice_ = std::nullopt, std::optional<std::vector<int>> cpus_ = std::nullopt);
+    std::vector<TittaThreads::info> getThreadSettings();
 
     class Sender
     {
@@ -77,6 +77,21 @@ classdef (Abstract) Base < handle
             LSLVersion = fnc('GetLSLVersion');
         end
 
+        % thread scheduling
+        function SetThreadSettings(policy,priority,nice,cpus)
+            % all inputs optional, pass empty to leave a setting unchanged
+            if nargin<1, policy = []; end
+            if nargin<2, priority = []; end
+            if nargin<3, nice = []; end
+            if nargin<4, cpus = []; end
+            fnc = TittaLSL.detail.Base.getMexFnc();
+            fnc('SetThreadSettings',char(policy),double(priority),double(nice),double(cpus));
+        end
+        function threads = GetThreadSettings()
+            fnc = TittaLSL.detail.Base.getMexFnc();
+            threads = fnc('GetThreadSettings');
+        end
+
         % stream info
         function streams = GetAllStreamsString(quoteChar,snakeCase)
             fnc = TittaLSL.detail.Base.getMexFnc();
@@ -85,6 +85,10 @@ namespace mxTypes
     struct typeNeedsMxCellStorage<TobiiTypes::eyeTracker> { static constexpr bool value = false; };
     template <>
     struct typeNeedsMxCellStorage<lsl::stream_info> { static constexpr bool value = false; };
+    template <>
+    struct typeToMxClass<TittaThreads::info> { static constexpr mxClassID value = mxSTRUCT_CLASS; };
+    template <>
+    struct typeNeedsMxCellStorage<TittaThreads::info> { static constexpr bool value = false; };
 
     // forward declarations
     template<typename Cont, typename... Fs>
@@ -96,6 +100,7 @@ namespace mxTypes
     mxArray* ToMatlab(TobiiResearchCapabilities                                 data_);
     mxArray* ToMatlab(lsl::channel_format_t                                     data_);
     mxArray* ToMatlab(Titta::Stream                                             data_);
+    mxArray* ToMatlab(TittaThreads::info     data_, mwIndex idx_ = 0, mwSize size_ = 1, mxArray* storage_ = nullptr);
 
     mxArray* ToMatlab(std::vector<TittaLSL::Receiver::gaze           >          data_);
     mxArray* FieldToMatlab(const std::vector<TittaLSL::Receiver::gaze>&         data_, bool rowVector_, TobiiTypes::eyeData Titta::gaze::* field_);
@@ -161,6 +166,8 @@ namespace {
         //// static functions
         GetTobiiSDKVersion,
         GetLSLVersion,
+        SetThreadSettings,
+        GetThreadSettings,
 
 
         //// convenience wrappers for Titta functions
@@ -203,6 +210,8 @@ namespace {
         //// static functions
         { "GetTobiiSDKVersion",             Action::GetTobiiSDKVersion },
         { "GetLSLVersion",                  Action::GetLSLVersion },
+        { "SetThreadSettings",              Action::SetThreadSettings },
+        { "GetThreadSettings",              Action::GetThreadSettings },
 
         //// convenience wrappers for Titta functions
         { "GetAllStreamsString",            Action::GetAllStreamsString },
@@ -309,7 +318,7 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
         // for static class members, set the type only
         instanceMap_type::const_iterator instIt;
         auto type = ExportedType::Unknown;
-        if (action == Action::Touch || action == Action::New || action == Action::GetTobiiSDKVersion || action == Action::GetLSLVersion || action == Action::GetAllStreamsString)
+        if (action == Action::Touch || action == Action::New || action == Action::GetTobiiSDKVersion || action == Action::GetLSLVersion || action == Action::SetThreadSettings || action == Action::GetThreadSettings || action == Action::GetAllStreamsString)
         {
             // no handle needed
         }
@@ -445,6 +454,49 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
                 plhs_[0] = mxTypes::ToMatlab(TittaLSL::getLSLVersion());
                 break;
             }
+        case Action::SetThreadSettings:
+            {
+                // all inputs optional, empty means leave unchanged
+                std::optional<std::string> policy;
+                if (nrhs_ > 1 && !mxIsEmpty(prhs_[1]))
+                {
+                    if (!mxIsChar(prhs_[1]))
+                        throw "setThreadSettings: Expected first argument to be a string.";
+                    char* cPolicy = mxArrayToString(prhs_[1]);
+                    policy = cPolicy;
+                    mxFree(cPolicy);
+                }
+                std::optional<int> priority;
+                if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+                {
+                    if (!mxIsNumeric(prhs_[2]) || mxIsComplex(prhs_[2]) || !mxIsScalar(prhs_[2]))
+                        throw "setThreadSettings: Expected second argument to be a numeric scalar.";
+                    priority = static_cast<int>(mxGetScalar(prhs_[2]));
+                }
+                std::optional<int> nice;
+                if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+                {
+                    if (!mxIsNumeric(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                        throw "setThreadSettings: Expected third argument to be a numeric scalar.";
+                    nice = static_cast<int>(mxGetScalar(prhs_[3]));
+                }
+                std::optional<std::vector<int>> cpus;
+                if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+                {
+                    if (!mxIsDouble(prhs_[4]) || mxIsComplex(prhs_[4]))
+                        throw "setThreadSettings: Expected fourth argument to be a double array.";
+                    const auto in = static_cast<double*>(mxGetData(prhs_[4]));
+                    cpus.emplace(in, in + mxGetNumberOfElements(prhs_[4]));
+                }
+
+                TittaLSL::setThreadSettings(policy, priority, nice, cpus);
+                break;
+            }
+        case Action::GetThreadSettings:
+            {
+                plhs_[0] = mxTypes::ToMatlab(TittaLSL::getThreadSettings());
+                break;
+            }
 
         case Action::GetAllStreamsString:
             {
@@ -980,6 +1032,28 @@ namespace mxTypes
 
         return storage_;
     }
+    mxArray* ToMatlab(TittaThreads::info data_, mwIndex idx_/*=0*/, mwSize size_/*=1*/, mxArray* storage_/*=nullptr*/)
+    {
+        if (idx_ == 0)
+        {
+            const char* fieldNames[] = { "name","id","isSDKThread","policy","priority","nice","cpus","error" };
+            storage_ = mxCreateStructMatrix(size_, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+            if (size_ == 0)
+                return storage_;
+        }
+
+        mxSetFieldByNumber(storage_, idx_, 0, ToMatlab(data_.name));
+        mxSetFieldByNumber(storage_, idx_, 1, ToMatlab(data_.id));
+        mxSetFieldByNumber(storage_, idx_, 2, mxCreateLogicalScalar(data_.isSDKThread));
+        mxSetFieldByNumber(storage_, idx_, 3, ToMatlab(data_.policy));
+        // as doubles for ease of use
+        mxSetFieldByNumber(storage_, idx_, 4, ToMatlab(static_cast<double>(data_.priority)));
+        mxSetFieldByNumber(storage_, idx_, 5, ToMatlab(static_cast<double>(data_.nice)));
+        mxSetFieldByNumber(storage_, idx_, 6, ToMatlab(std::vector<double>(data_.cpus.begin(), data_.cpus.end())));
+        mxSetFieldByNumber(storage_, idx_, 7, ToMatlab(data_.error));
+
+        return storage_;
+    }
     mxArray* ToMatlab(lsl::channel_format_t data_)
     {
         switch (data_)
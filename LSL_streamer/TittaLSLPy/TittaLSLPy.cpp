@@ -220,6 +220,29 @@ py::dict StructToDict(const lsl::stream_info& data_)
     return d;
 }
 
+py::dict StructToDict(const TittaThreads::info& data_)
+{
+    py::dict d;
+    d["name"] = data_.name;
+    d["id"] = data_.id;
+    d["is_SDK_thread"] = data_.isSDKThread;
+    d["policy"] = data_.policy;
+    d["priority"] = data_.priority;
+    d["nice"] = data_.nice;
+    d["cpus"] = data_.cpus;
+    d["error"] = data_.error;
+    return d;
+}
+py::list StructVectorToList(const std::vector<TittaThreads::info>& data_)
+{
+    py::list out;
+
+    for (auto&& i : data_)
+        out.append(StructToDict(i));
+
+    return out;
+}
+
 py::list StructVectorToList(std::vector<lsl::stream_info>&& data_)
 {
     py::list out;
@@ -302,6 +325,9 @@ PYBIND11_MODULE(MODULE_NAME, m)
     //// global SDK functions
     m.def("get_Tobii_SDK_version", []() { const auto v = TittaLSL::getTobiiSDKVersion(); return string_format("%d.%d.%d.%d", v.major, v.minor, v.revision, v.build); });
     m.def("get_LSL_version", &TittaLSL::getLSLVersion);
+    m.def("set_thread_settings", &TittaLSL::setThreadSettings,
+        py::arg_v("policy", std::nullopt, "None"), py::arg_v("priority", std::nullopt, "None"), py::arg_v("nice", std::nullopt, "None"), py::arg_v("cpus", std::nullopt, "None"));
+    m.def("get_thread_settings", []() { return StructVectorToList(TittaLSL::getThreadSettings()); });
 
     // outlets
     auto cStreamer = py::class_<TittaLSL::Sender>(m, "Sender", py::module_local())
@@ -59,6 +59,22 @@ for SDK_version=1:2
             fullfile(myDir,'..','SDK_wrapper','src','Titta.cpp')
             fullfile(myDir,'..','SDK_wrapper','src','types.cpp')
             fullfile(myDir,'..','SDK_wrapper','src','utils.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','eyeImageCodec.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','eyeImageReducer.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','gifDecoder.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','workerPool.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','discovery.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','pinnedAllocator.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','threading.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','shmRing.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','pipeline.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','resample.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','logSink.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','calibrationCache.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','compactGaze.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','trace.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','latency.cpp')
+            fullfile(myDir,'..','SDK_wrapper','src','replay.cpp')
             linkTobiiResearchLib
             '-llsl'}.';
 
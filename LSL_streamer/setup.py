@@ -35,7 +35,7 @@ class get_pybind_include(object):
 def get_extension_def(sdk_version):
     return Extension(
         'TittaLSLPy_v%d' % sdk_version,
-        ['../SDK_wrapper/src/Titta.cpp','../SDK_wrapper/src/types.cpp','../SDK_wrapper/src/utils.cpp','src/TittaLSL.cpp','TittaLSLPy/TittaLSLPy.cpp'],
+        ['../SDK_wrapper/src/Titta.cpp','../SDK_wrapper/src/types.cpp','../SDK_wrapper/src/utils.cpp','../SDK_wrapper/src/eyeImageCodec.cpp','../SDK_wrapper/src/eyeImageReducer.cpp','../SDK_wrapper/src/gifDecoder.cpp','../SDK_wrapper/src/workerPool.cpp','../SDK_wrapper/src/discovery.cpp','../SDK_wrapper/src/pinnedAllocator.cpp','../SDK_wrapper/src/threading.cpp','../SDK_wrapper/src/shmRing.cpp','../SDK_wrapper/src/pipeline.cpp','../SDK_wrapper/src/resample.cpp','../SDK_wrapper/src/logSink.cpp','../SDK_wrapper/src/calibrationCache.cpp','../SDK_wrapper/src/compactGaze.cpp','../SDK_wrapper/src/trace.cpp','../SDK_wrapper/src/latency.cpp','../SDK_wrapper/src/replay.cpp','src/TittaLSL.cpp','TittaLSLPy/TittaLSLPy.cpp'],
         include_dirs=[
             # Path to pybind11 headers
             get_pybind_include(),
@@ -78,7 +78,7 @@ class BuildExt(build_ext):
         # set rpath so that delocate can find .dylib
         l_opts['unix'].extend(['-L./TittaLSLMex/+TittaLSL/+detail/', '-Wl,-rpath,''./LSL_streamer/TittaLSLMex/+TittaLSL/+detail/''','-dead_strip'])
     else:
-        l_opts['unix'].extend(['-L./TittaLSLMex/+TittaLSL/+detail/', '-Wl,--gc-sections'])
+        l_opts['unix'].extend(['-L./TittaLSLMex/+TittaLSL/+detail/', '-Wl,--gc-sections', '-lrt'])
 
     def build_extensions(self):
         ct = self.compiler.compiler_type
@@ -97,6 +97,14 @@ int32_t getLSLVersion()
 {
     return lsl::library_version();
 }
+void setThreadSettings(std::optional<std::string> policy_, std::optional<int> priority_, std::optional<int> nice_, std::optional<std::vector<int>> cpus_)
+{
+    Titta::setThreadSettings(std::move(policy_), priority_, nice_, std::move(cpus_));
+}
+std::vector<TittaThreads::info> getThreadSettings()
+{
+    return Titta::getThreadSettings();
+}
 
 
 // callbacks
@@ -104,6 +112,7 @@ void GazeCallback(TobiiResearchGazeData* gaze_data_, void* user_data)
 {
     if (user_data)
     {
+        TittaThreads::onCallback("TittaLSL gaze callback");
         const auto instance = static_cast<TittaLSL::Sender*>(user_data);
         instance->receiveSample(gaze_data_, nullptr);
     }
@@ -112,6 +121,7 @@ void EyeOpennessCallback(TobiiResearchEyeOpennessData* openness_data_, void* use
 {
     if (user_data)
     {
+        TittaThreads::onCallback("TittaLSL eye openness callback");
         const auto instance = static_cast<TittaLSL::Sender*>(user_data);
         instance->receiveSample(nullptr, openness_data_);
     }
@@ -120,6 +130,7 @@ void ExtSignalCallback(TobiiResearchExternalSignalData* ext_signal_, void* user_
 {
     if (user_data)
     {
+        TittaThreads::onCallback("TittaLSL external signal callback");
         const auto instance = static_cast<TittaLSL::Sender*>(user_data);
         if (instance->isStreaming(Titta::Stream::ExtSignal))
             instance->pushSample(*ext_signal_);
@@ -129,6 +140,7 @@ void TimeSyncCallback(TobiiResearchTimeSynchronizationData* time_sync_data_, voi
 {
     if (user_data)
     {
+        TittaThreads::onCallback("TittaLSL time sync callback");
         const auto instance = static_cast<TittaLSL::Sender*>(user_data);
         if (instance->isStreaming(Titta::Stream::TimeSync))
             instance->pushSample(*time_sync_data_);
@@ -138,6 +150,7 @@ void PositioningCallback(TobiiResearchUserPositionGuide* position_data_, void* u
 {
     if (user_data)
     {
+        TittaThreads::onCallback("TittaLSL positioning callback");
         const auto instance = static_cast<TittaLSL::Sender*>(user_data);
         if (instance->isStreaming(Titta::Stream::Positioning))
             instance->pushSample(*position_data_);
@@ -1442,6 +1455,7 @@ void Receiver::recorderThreadFunc()
     constexpr size_t numElem = LSLInletTypeNumSamples_v<DataType>;
     using array_t = data_t[numElem];
     auto& inlet = getInlet<DataType>();
+    TittaThreads::scope threadRegistration("TittaLSL receiver " + Titta::streamToString(LSLInletTypeToTittaStream_v<DataType>));
     double lastTCorr = -1.;
     while (!inlet._recorder_should_stop)
     {
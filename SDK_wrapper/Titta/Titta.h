@@ -8,6 +8,11 @@
 #include <thread>
 #include <atomic>
 #include <variant>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <map>
 #include <tobii_research.h>
 #include <tobii_research_eyetracker.h>
 #include <tobii_research_streams.h>
@@ -26,6 +31,24 @@
 #include <readerwriterqueue/readerwriterqueue.h>
 
 #include "types.h"
+#include "latency.h"
+#include "memory.h"
+#include "compactGaze.h"
+#include "calibrationCache.h"
+#include "discovery.h"
+#include "logRing.h"
+#include "logSink.h"
+#include "resample.h"
+#include "latestSlot.h"
+#include "pipeline.h"
+#include "shmRing.h"
+#include "trace.h"
+#include "threading.h"
+#include "pinnedAllocator.h"
+#include "workerPool.h"
+#include "eyeImageReducer.h"
+
+class TittaReplay;
 
 
 class Titta
@@ -40,6 +63,14 @@ public:
     using streamError   = TobiiTypes::streamErrorMessage;
     using notification  = TobiiTypes::notification;
     using allLogTypes   = std::variant<logMessage, streamError>;
+    using latencyStats  = TobiiTypes::latencyStats;
+    using memoryUsage   = TobiiTypes::memoryUsage;
+    using bufferAllocation = TobiiTypes::bufferAllocation;
+    using eyeImageReduction = TobiiTypes::eyeImageReduction;
+    using eyeImageCompressionStats = TobiiTypes::eyeImageCompressionStats;
+    using allStreamsData= TobiiTypes::allStreamsData;
+    using gazeExtSignalJoin = TobiiTypes::gazeExtSignalJoin;
+    using derivedSample = TobiiTypes::derivedSample;
 
     // data stream type (NB: not log, as that isn't a class member)
     enum class Stream
@@ -75,7 +106,7 @@ public:
     static std::string getAllBufferSidesString(const char* quoteChar_ = "\"");
 
 public:
-    Titta(std::string address_);
+    Titta(std::string address_);    // NB: an address of the form "replay://<path to _gaze.tsv file>" replays a recorded session instead of connecting to an eye tracker
     Titta(TobiiResearchEyeTracker* et_);
     ~Titta();
 
@@ -84,15 +115,39 @@ public:
     static int64_t getSystemTimestamp();
     static std::vector<TobiiTypes::eyeTracker> findAllEyeTrackers();
     static TobiiTypes::eyeTracker getEyeTrackerFromAddress(std::string address_);
+    // background eye tracker discovery. While running, findAllEyeTrackers() and getEyeTrackerFromAddress()
+    // return instantly from the list it keeps, and connecting to an address in the list needs no lookup
+    static void startEyeTrackerDiscovery(std::optional<double> intervalMs_ = std::nullopt);
+    static void stopEyeTrackerDiscovery();
+    static bool isEyeTrackerDiscoveryRunning();
+    static void refreshEyeTrackers(std::optional<bool> wait_ = std::nullopt);    // scan now instead of waiting for the interval to pass
+    static std::vector<EyeTrackerDiscovery::entry> getDiscoveredEyeTrackers();
+    static std::vector<EyeTrackerDiscovery::event> getEyeTrackerDiscoveryEvents(std::optional<bool> clear_ = std::nullopt);
+    static void setEyeTrackerDiscoveryCallback(std::function<void(EyeTrackerDiscovery::event)> callback_);    // invoked on the discovery thread
     // logging
-    static bool startLogging(std::optional<size_t> initialBufferSize_ = std::nullopt);
+    static bool startLogging(std::optional<size_t> initialBufferSize_ = std::nullopt);   // buffer size: number of messages kept, oldest are dropped
     static std::vector<Titta::allLogTypes> getLog(std::optional<bool> clearLog_ = std::nullopt);
     static bool stopLogging();	// always clears buffer
+    // messages less severe than this level are discarded before they are stored
+    static void setLogLevel(TobiiResearchLogLevel level_);
+    static TobiiResearchLogLevel getLogLevel();
+    static uint64_t getNumDroppedLogMessages();
+    // stream log to a rotating file in the background
+    static void startLogFile(std::string fileName_, std::optional<uint64_t> maxBytes_ = std::nullopt, std::optional<size_t> maxFiles_ = std::nullopt);
+    static void stopLogFile();
+    // tracing (only available if built with TITTA_ENABLE_TRACING defined)
+    static bool isTracingEnabled();
+    static std::string getTrace(std::optional<bool> clear_ = std::nullopt);    // Chrome trace-event JSON
+    // scheduling and CPU affinity of the threads Titta owns and of the SDK's callback threads, see threading.h
+    static void setThreadSettings(std::optional<std::string> policy_ = std::nullopt, std::optional<int> priority_ = std::nullopt, std::optional<int> nice_ = std::nullopt, std::optional<std::vector<int>> cpus_ = std::nullopt);
+    static std::vector<TittaThreads::info> getThreadSettings();
 
     //// eye-tracker specific getters and setters
-    // getters
+    // getters. NB: these are served from a cache that is kept current by the notification stream,
+    // pass paramToRefresh_ to force fetching that property from the eye tracker
     TobiiTypes::eyeTracker getEyeTrackerInfo(std::optional<std::string> paramToRefresh_ = std::nullopt);
     TobiiResearchDisplayArea getDisplayArea() const;
+    TobiiTypes::deviceState getDeviceState() const;
     // setters. NB: these trigger a refresh of eye tracker info
     void setDeviceName(std::string deviceName_);
     void setFrequency(float frequency_);
@@ -105,13 +160,30 @@ public:
     bool enterCalibrationMode(bool doMonocular_);
     bool isInCalibrationMode(std::optional<bool> issueErrorIfNot_) const;
     bool leaveCalibrationMode(std::optional<bool> force_);
-    void calibrationCollectData(std::array<float, 2> coordinates_, std::optional<std::string> eye_);
-    void calibrationDiscardData(std::array<float, 2> coordinates_, std::optional<std::string> eye_);
-    void calibrationComputeAndApply();
-    void calibrationGetData();
-    void calibrationApplyData(std::vector<uint8_t> calibrationData_);
+    // the below calibration actions return a request ID that identifies their result
+    uint64_t calibrationCollectData(std::array<float, 2> coordinates_, std::optional<std::string> eye_);
+    uint64_t calibrationDiscardData(std::array<float, 2> coordinates_, std::optional<std::string> eye_);
+    uint64_t calibrationComputeAndApply();
+    uint64_t calibrationGetData();
+    uint64_t calibrationApplyData(std::vector<uint8_t> calibrationData_);
     TobiiTypes::CalibrationState calibrationGetStatus();
     std::optional<TobiiTypes::CalibrationWorkResult> calibrationRetrieveResult(bool makeStatusString_ = false);
+    // blocks until the result for the given request (or any result if no request ID is given) is available,
+    // the timeout expires, or calibration mode is left without that result having been produced
+    std::optional<TobiiTypes::CalibrationWorkResult> calibrationWaitForResult(std::optional<uint64_t> requestId_, std::optional<double> timeOutMs_, bool makeStatusString_ = false);
+    // if set, results are also delivered to the callback (on the calibration thread). They remain queued for
+    // calibrationRetrieveResult() and calibrationWaitForResult(). Pass an empty function to unset
+    void setCalibrationResultCallback(std::function<void(TobiiTypes::CalibrationWorkResult)> callback_);
+    // calibration cache, keyed by eye tracker serial number, tracking mode and participant label.
+    // Shared between all instances, optionally also stored on disk
+    uint64_t calibrationStoreInCache(std::string participant_);     // caches the current calibration, on the calibration thread
+    uint64_t calibrationApplyCached(std::string participant_);
+    void addToCalibrationCache(std::string participant_, std::vector<uint8_t> calibrationData_);
+    bool hasCachedCalibration(std::string participant_);
+    std::vector<std::string> getCachedCalibrations() const;
+    void clearCalibrationCache(std::optional<std::string> participant_);    // in memory only, leaves files on disk alone
+    void setCalibrationCacheDirectory(std::optional<std::string> directory_);
+    std::optional<std::string> getCalibrationCacheDirectory() const;
 
     //// data streams
     // query if stream is supported
@@ -120,10 +192,45 @@ public:
 
     // deal with eyeOpenness stream
     bool setIncludeEyeOpennessInGaze(bool include_);    // returns previous state
+    // store gaze samples in compact form (see compactGaze.h) to reduce memory use during long recordings,
+    // optionally with quantized gaze point on display area, and optionally with older samples further
+    // compressed in the background. Samples are decoded when consumed or peeked.
+    // Can only be changed when not recording gaze and the gaze buffer is empty. Returns previous state
+    bool setCompactGazeStorage(bool compact_, std::optional<bool> quantize_ = std::nullopt, std::optional<bool> compressOld_ = std::nullopt);
+    bool isCompactGazeStorage() const;
 
     // start stream
     bool start(std::string stream_, std::optional<size_t> initialBufferSize_ = std::nullopt, std::optional<bool> asGif_ = std::nullopt, bool snake_case_on_stream_not_found = false);
     bool start(Stream      stream_, std::optional<size_t> initialBufferSize_ = std::nullopt, std::optional<bool> asGif_ = std::nullopt);
+    // decoding of GIF eye images to raw 8-bit frames, on a pool of worker threads. "ingest": frames are
+    // decoded in the background as they arrive, "peek": frames are decoded when they are first read. Either
+    // way, eye images returned by consumeN, consumeTimeRange, peekN, peekTimeRange and getLatest are decoded
+    // (any frame not yet decoded is decoded then), and decoded frames replace the GIFs in the buffer so that
+    // each is decoded only once. "none" (default): GIFs are returned as received
+    enum class EyeImageDecoding
+    {
+        None,
+        Ingest,
+        Peek
+    };
+    void setEyeImageDecoding(std::string mode_, std::optional<size_t> numThreads_ = std::nullopt);
+    std::string getEyeImageDecoding() const;
+    // reduction of eye images at ingest, so that longer histories fit in the same memory. Of each camera only
+    // every keepEveryN_-th frame is kept. Kept frames are cropped, crop_: "none" (default), "fixed": to
+    // cropRect_ ([left, top, width, height] in pixels of the image as received), or "pupil": to a window of
+    // cropRect_'s width and height centred on the pupil (the darkest region of the image), and then downscaled
+    // by averaging blocks of downscale_ x downscale_ pixels. The eye image's crop_left, crop_top and downscale
+    // fields record what was done. GIF frames are cropped and downscaled when they are decoded (see
+    // setEyeImageDecoding()). Applies to frames arriving from now on
+    void setEyeImageReduction(std::optional<std::string> crop_ = std::nullopt, std::optional<std::array<int, 4>> cropRect_ = std::nullopt, std::optional<int> downscale_ = std::nullopt, std::optional<size_t> keepEveryN_ = std::nullopt);
+    eyeImageReduction getEyeImageReduction() const;
+    // lossless compression of stored eye images, so that more of them fit in memory. Frames are compressed on a
+    // pool of worker threads shortly after they arrive (GIF frames once decoded, see setEyeImageDecoding()), and
+    // decompressed when they are read by consumeN, consumeTimeRange, peekN or peekTimeRange. The cacheSize_ most
+    // recently peeked frames are kept decompressed, so that reading them again is cheap. Frames that were already
+    // compressed stay so when compression is switched off. The stats show the compression ratio and timings
+    void setEyeImageCompression(bool compress_, std::optional<size_t> numThreads_ = std::nullopt, std::optional<size_t> cacheSize_ = std::nullopt);
+    eyeImageCompressionStats getEyeImageCompressionStats(std::optional<bool> reset_ = std::nullopt);
 
     // request stream state
     bool isRecording(std::string stream_, bool snake_case_on_stream_not_found = false) const;
@@ -143,6 +250,76 @@ public:
     template <typename T>
     std::vector<T> peekTimeRange(std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt);
 
+    // consume or peek several streams in one go. A single cut-off (by default now) is taken first, and each
+    // stream then returns its samples in [timeStart_, cutOff_], so that the streams' data boundaries line up.
+    // Samples arriving after the cut-off stay in the buffer for the next call. Each buffer is locked only
+    // while its own samples are copied out. Positioning has no timestamps, all its samples are returned.
+    // By default gaze, eyeImage, externalSignal, timeSync and notification streams are returned
+    allStreamsData drainAll   (std::vector<std::string>                streams_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> cutOff_ = std::nullopt, bool snake_case_on_stream_not_found = false);
+    allStreamsData drainAll   (std::optional<std::vector<Stream>>      streams_ = std::nullopt, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> cutOff_ = std::nullopt);
+    allStreamsData snapshotAll(std::vector<std::string>                streams_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> cutOff_ = std::nullopt, bool snake_case_on_stream_not_found = false);
+    allStreamsData snapshotAll(std::optional<std::vector<Stream>>      streams_ = std::nullopt, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> cutOff_ = std::nullopt);
+
+    // annotate gaze samples within given timestamps (inclusive, by default whole buffer) with the most recent
+    // external signal, and find for each external signal event the nearest gaze sample. Buffers are not consumed.
+    // The last external signal event before timeStart_ (if any) is included so that the first samples can be annotated
+    gazeExtSignalJoin joinGazeExtSignal(std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt);
+    // same on data you already have, both inputs must be sorted by system_time_stamp
+    static gazeExtSignalJoin joinGazeExtSignal(std::vector<gaze> gaze_, std::vector<extSignal> extSignal_);
+
+    //// resampling of gaze data to a uniform grid on system_time_stamp, see GazeResampler. maxGap_ in us
+    // batch: resample gaze within given timestamps (inclusive, by default whole buffer), buffer is not consumed
+    std::vector<gaze> resampleGaze(double frequency_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt, std::optional<int64_t> maxGap_ = std::nullopt, std::optional<GazeResampler::Method> method_ = std::nullopt);
+    // incremental: resample gaze as it comes in. By default starts with the next sample that arrives,
+    // if gridStart_ is provided, buffered samples from that time on are included
+    void startGazeResampler(double frequency_, std::optional<int64_t> maxGap_ = std::nullopt, std::optional<GazeResampler::Method> method_ = std::nullopt, std::optional<int64_t> gridStart_ = std::nullopt);
+    // grid samples that became available since the previous call. The resampler is fed as gaze arrives, so
+    // consuming gaze does not affect it
+    std::vector<gaze> getResampledGaze();
+    bool isGazeResamplerRunning() const;
+    // returns the remaining grid samples
+    std::vector<gaze> stopGazeResampler();
+
+    //// processing pipeline, see GazePipeline. While running, stages are run on a worker thread as gaze comes in, in
+    // the order in which they were added. Each stage gets the gaze as output by the previous stage, and stores its
+    // output in a derived stream named after the stage. The pipeline is fed as gaze arrives, so consuming gaze does
+    // not affect it
+    static std::vector<std::string> getPipelineStageTypes();
+    void addPipelineStage(std::string name_, std::string type_, std::optional<std::map<std::string, double>> params_ = std::nullopt);
+    void clearPipeline();
+    std::vector<std::tuple<std::string, std::string>> getPipelineStages() const;   // name and type
+    std::vector<std::string> getDerivedStreamChannels(const std::string& name_) const;
+    // processes gaze that arrives from now on
+    void startPipeline();
+    void stopPipeline();
+    bool isPipelineRunning() const;
+    // derived streams, same semantics as consumeN, consumeTimeRange, peekN, peekTimeRange and clear
+    std::vector<derivedSample> consumeDerivedN(const std::string& name_, std::optional<size_t> NSamp_ = std::nullopt, std::optional<BufferSide> side_ = std::nullopt);
+    std::vector<derivedSample> consumeDerivedTimeRange(const std::string& name_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt);
+    std::vector<derivedSample> peekDerivedN(const std::string& name_, std::optional<size_t> NSamp_ = std::nullopt, std::optional<BufferSide> side_ = std::nullopt);
+    std::vector<derivedSample> peekDerivedTimeRange(const std::string& name_, std::optional<int64_t> timeStart_ = std::nullopt, std::optional<int64_t> timeEnd_ = std::nullopt);
+    void clearDerived(const std::string& name_);
+
+    // most recent sample received on a stream, regardless of whether it has since been consumed or
+    // cleared from the buffer. Does not take the buffer lock, so it never contends with incoming data.
+    // Empty if no sample was received yet. getLatestCount() is the number of samples received, which
+    // can be used to check whether there is a new sample
+    template <typename T>
+    std::optional<T> getLatest();
+    template <typename T>
+    uint64_t getLatestCount();
+
+    //// shared memory: samples of a stream are additionally written to a ring in shared memory with the given name,
+    // so that other processes on this machine can read them, see ShmRingReader. Supported for the gaze,
+    // externalSignal, timeSync and positioning streams. The ring holds the last capacity_ samples
+    void startSharedMemory(std::string stream_, std::string name_, std::optional<size_t> capacity_ = std::nullopt, bool snake_case_on_stream_not_found = false);
+    void startSharedMemory(Stream      stream_, std::string name_, std::optional<size_t> capacity_ = std::nullopt);
+    // empty if not writing to shared memory
+    std::optional<std::string> getSharedMemoryName(std::string stream_, bool snake_case_on_stream_not_found = false);
+    std::optional<std::string> getSharedMemoryName(Stream      stream_);
+    void stopSharedMemory(std::string stream_, bool snake_case_on_stream_not_found = false);
+    void stopSharedMemory(Stream      stream_);
+
     // clear all buffer contents
     void clear(std::string stream_, bool snake_case_on_stream_not_found = false);
     void clear(Stream      stream_);
@@ -154,6 +331,41 @@ public:
     bool stop(std::string stream_, std::optional<bool> clearBuffer_ = std::nullopt, bool snake_case_on_stream_not_found = false);
     bool stop(Stream      stream_, std::optional<bool> clearBuffer_ = std::nullopt);
 
+    //// latency instrumentation
+    // histograms (us) of how long samples took from their system_time_stamp until available in the buffer,
+    // and from then until they were consumed. Not available for the positioning stream, it has no timestamps
+    latencyStats getLatencyStats(std::string stream_, std::optional<bool> reset_ = std::nullopt, bool snake_case_on_stream_not_found = false);
+    latencyStats getLatencyStats(Stream      stream_, std::optional<bool> reset_ = std::nullopt);
+
+    //// memory governor
+    // bytes used per stream and for all streams together, and their high-water marks
+    memoryUsage getMemoryUsage(std::string stream_, bool snake_case_on_stream_not_found = false);
+    memoryUsage getMemoryUsage(Stream      stream_);
+    memoryUsage getTotalMemoryUsage();
+    // budgets in bytes, 0 means unlimited. When a stream exceeds its own budget, its oldest samples are
+    // evicted. When all streams together exceed the global budget, oldest samples are evicted from the
+    // streams in eviction order, moving on to the next stream only once the previous one is empty.
+    // Starting a stream with an initialBufferSize that does not fit in the budget is an error
+    void setMemoryBudget(size_t bytes_);
+    void setStreamMemoryBudget(std::string stream_, size_t bytes_, bool snake_case_on_stream_not_found = false);
+    void setStreamMemoryBudget(Stream      stream_, size_t bytes_);
+    // streams not listed are never evicted to satisfy the global budget
+    void setEvictionOrder(const std::vector<std::string>& streams_, bool snake_case_on_stream_not_found = false);
+    std::vector<std::string> getEvictionOrder(bool snakeCase_ = false) const;
+    // memory of the sample buffers can be pre-faulted, locked in RAM and backed by huge pages ("none",
+    // "transparent" or "explicit"), so that storing samples incurs no page faults and fewer TLB misses.
+    // Takes effect for a stream the next time it is started while its buffer is empty
+    void setBufferAllocation(std::optional<bool> prefault_ = std::nullopt, std::optional<bool> lock_ = std::nullopt, std::optional<std::string> hugePages_ = std::nullopt);
+    bufferAllocation getBufferAllocation(std::string stream_, bool snake_case_on_stream_not_found = false);
+    bufferAllocation getBufferAllocation(Stream      stream_);
+
+    //// replay of recorded session (only for instances created with a "replay://" address)
+    bool isReplay() const;
+    // 1: real-time, >1: accelerated, 0: as fast as possible. Original inter-sample timing is kept
+    void setReplaySpeed(double speed_);
+    double getReplaySpeed() const;
+    bool isReplayFinished() const;
+
 private:
     void Init();
     // Tobii callbacks need to be friends
@@ -169,30 +381,92 @@ private:
     friend void TittaNotificationCallback(TobiiResearchNotification*             notification_, void* user_data_);
     // calibration
     void calibrationThread();
+    uint64_t enqueueCalibrationWork(TobiiTypes::CalibrationWorkItem workItem_);
+    void deliverCalibrationResult(TobiiTypes::CalibrationWorkResult result_);
     // gaze + eye openness receiver
     void receiveSample(const TobiiResearchGazeData* gaze_data_, const TobiiResearchEyeOpennessData* openness_data_);
+    void storeGaze(std::deque<gaze>& samples_, int64_t now_);   // caller must hold write lock of gaze buffer
     //// generic functions for internal use
     // helpers
+    template <typename T>  using buffer = std::vector<T, PinnedAllocator<T>>;
     template <typename T>  mutex_type&      getMutex();
-    template <typename T>  read_lock        lockForReading();
-    template <typename T>  write_lock       lockForWriting();
-    template <typename T>  std::vector<T>&  getBuffer();
+    template <typename T>  traced_read_lock lockForReading();
+    template <typename T>  traced_write_lock lockForWriting();
+    template <typename T>  buffer<T>&       getBuffer();
+    template <typename T>  LatencyTracker&  getLatencyTracker();
+    template <typename T>  MemoryAccount&   getMemoryAccount();
+    template <typename T>  LatestSlot<T>&   getLatestSlot();
+    template <typename T>  std::unique_ptr<ShmRingWriter<T>>& getShmWriter();
+    template <typename T>  void             startSharedMemoryImpl(std::string name_, size_t capacity_);
+    // latency and memory bookkeeping, caller must hold write lock of buffer
+    // registerArrival: for last NSamp_ samples of buffer, evicts if stream over budget. now_ is their arrival time,
+    // taken once per callback before locking (not used for positioning data)
+    template <typename T>  void             registerArrival(size_t NSamp_, int64_t now_ = 0);
+    template <typename T>  void             registerRemoval(typename buffer<T>::iterator startIt_, typename buffer<T>::iterator endIt_, bool isConsumed_);
+    template <typename T>  void             registerRemoval(size_t iStart_, size_t iEnd_, bool isConsumed_);
+    template <typename T>  void             addToMemoryAccount(size_t bytes_);
+    template <typename T>  void             removeFromMemoryAccount(size_t bytes_);
+    // the storage of compact gaze samples shrinks when their block moves to the cold tier, so instead of per
+    // sample, its account is set from what the buffer holds. Call after each change to the buffer
+    void                                    syncCompactGazeAccount();
+    // storage-agnostic access to buffer contents (gaze may be stored compactly)
+    template <typename T>  size_t           getNumSamples();
+    template <typename T>  int64_t          getSampleTimeStamp(size_t i_);
+    template <typename T>  size_t           getBytesPerSample();                // excluding heap data owned by sample
+    template <typename T>  size_t           getSampleBytes(size_t iStart_, size_t iEnd_);
     template <typename T>
-                           std::tuple<typename std::vector<T>::iterator, typename std::vector<T>::iterator>
+                           std::tuple<typename buffer<T>::iterator, typename buffer<T>::iterator>
                                             getIteratorsFromSampleAndSide(size_t NSamp_, BufferSide side_);
     template <typename T>
-                           std::tuple<typename std::vector<T>::iterator, typename std::vector<T>::iterator, bool>
+                           std::tuple<typename buffer<T>::iterator, typename buffer<T>::iterator, bool>
                                             getIteratorsFromTimeRange(int64_t timeStart_, int64_t timeEnd_);
+    // memory governor, evictImpl: caller must hold write lock of buffer
+    template <typename T>  size_t           evictImpl(size_t bytesToFree_);     // returns number of bytes freed
+    size_t                                  evictCompactGaze(size_t bytesToFree_);
+    template <typename T>  void             prepareBuffer(Stream stream_, std::optional<size_t> initialBufferSize_, size_t defaultBufferSize_);
+    template <typename T>  memoryUsage      getMemoryUsageImpl();
+    template <typename T>  bufferAllocation getBufferAllocationImpl();
+    template <typename T>  void             setStreamMemoryBudgetImpl(size_t bytes_);
+    void                                    enforceMemoryBudget();      // global budget, caller must not hold any buffer lock
+    // decodes the GIF frames among images_ on the decoding pool, and if cache_, also replaces them in the buffer
+    void                                    decodeEyeImages(std::vector<eyeImage>& images_, bool cache_);
+    // replaces frames in the buffer by the given decoded (if fromGif_) or compressed versions
+    void                                    replaceEyeImages(const std::vector<const eyeImage*>& images_, bool fromGif_);
+    bool                                    compressEyeImage(eyeImage& image_);     // false if left as is
+    // identifies a frame in the eye image buffer
+    struct eyeImageId { int64_t system_time_stamp; int camera_id; int region_id; };
+    // compresses the identified frames of the buffer on the compression pool
+    void                                    compressEyeImagesInBackground(std::vector<eyeImageId> images_);
+    // decompresses the compressed frames among images_, using and if cache_ filling the cache of decompressed frames
+    void                                    decompressEyeImages(std::vector<eyeImage>& images_, bool cache_);
+    void                                    onDeviceNotification(const TobiiResearchNotification& notification_);
+    // fetch (part of) the device state from the eye tracker, paramToRefresh_ as for eyeTracker::refreshInfo() or "displayArea"
+    void                                    refreshDeviceState(std::optional<std::string> paramToRefresh_) const;
+    void                                    pipelineThread();
+    void                                    gazeCompressThread();
+    void                                    stopGazeCompressThread();
     // generic implementations
     template <typename T>  void             clearImpl(int64_t timeStart_, int64_t timeEnd_);
+    allStreamsData                          drainOrSnapshotAll(bool consume_, std::optional<std::vector<Stream>> streams_, std::optional<int64_t> timeStart_, std::optional<int64_t> cutOff_);
 
 private:
-    TobiiTypes::eyeTracker      _eyeTracker;
+    TobiiTypes::eyeTracker      _eyeTracker;                    // properties that may change are read from _deviceState instead
+    // cached device state, readers don't lock or call into the SDK. Writers (refreshes and notifications) are serialized
+    mutable LatestSlot<TobiiTypes::deviceState> _deviceState;
+    mutable std::mutex          _deviceStateMutex;
+    WorkerPool                  _deviceStateRefresher   {"Titta device state refresher"};   // refetches state after notifications that do not carry the new value
 
     bool                        _recordingGaze          = false;
     bool                        _recordingEyeOpenness   = false;
     bool                        _includeEyeOpennessInGaze = false;
-    std::vector<gaze>           _gaze;
+    buffer<gaze>                _gaze;
+    bool                        _gazeIsCompact          = false;
+    CompactGazeBuffer           _gazeCompact;           // used instead of _gaze if _gazeIsCompact
+    std::thread                 _gazeCompressThread;    // moves old blocks of _gazeCompact to its cold tier
+    std::mutex                  _gazeCompressMutex;
+    std::condition_variable     _gazeCompressCV;
+    bool                        _gazeCompressPending    = false;    // guarded by _gazeCompressMutex
+    std::atomic<bool>           _gazeCompressStop       = false;    // set under _gazeCompressMutex
     mutex_type                  _gazeMutex;
     // staging area to merge gaze and eye openness
     std::deque<gaze>            _gazeStaging;
@@ -200,35 +474,134 @@ private:
     mutex_type                  _gazeStageMutex;
 
     bool                        _recordingEyeImages     = false;
-    std::vector<eyeImage>       _eyeImages;
+    buffer<eyeImage>            _eyeImages;
     bool                        _eyeImIsGif             = false;
     mutex_type                  _eyeImagesMutex;
+    std::atomic<EyeImageDecoding> _eyeImageDecoding     = EyeImageDecoding::None;
+    WorkerPool                  _eyeImageDecoder        {"Titta eye image decoder"};
+    EyeImageReducer             _eyeImageReducer;
+    std::atomic<bool>           _eyeImageCompression    = false;
+    WorkerPool                  _eyeImageCompressor     {"Titta eye image compressor"};
+    struct EyeImageCompressionCounters
+    {
+        uint64_t    nCompressed     = 0;
+        uint64_t    nIncompressible = 0;
+        size_t      rawBytes        = 0;
+        size_t      compressedBytes = 0;
+        int64_t     compressNs      = 0;
+        uint64_t    nDecompressed   = 0;
+        int64_t     decompressNs    = 0;
+        uint64_t    nCacheHits      = 0;
+    };
+    EyeImageCompressionCounters _eyeImageCompressionCounters;       // guarded by _eyeImageCompressionMutex
+    std::deque<eyeImage>        _eyeImageDecompressed;              // cache, most recent last. Guarded by _eyeImageCompressionMutex
+    size_t                      _eyeImageDecompressedMax = 0;       // guarded by _eyeImageCompressionMutex
+    std::mutex                  _eyeImageCompressionMutex;
 
     bool                        _recordingExtSignal     = false;
-    std::vector<extSignal>      _extSignal;
+    buffer<extSignal>           _extSignal;
     mutex_type                  _extSignalMutex;
 
     bool                        _recordingTimeSync      = false;
-    std::vector<timeSync>       _timeSync;
+    buffer<timeSync>            _timeSync;
     mutex_type                  _timeSyncMutex;
 
     bool                        _recordingPositioning   = false;
-    std::vector<positioning>    _positioning;
+    buffer<positioning>         _positioning;
     mutex_type                  _positioningMutex;
 
     bool                        _recordingNotification  = false;
-    std::vector<notification>   _notification;
+    buffer<notification>        _notification;
     mutex_type                  _notificationMutex;
 
+    // latency instrumentation (not for positioning, which has no timestamps)
+    LatencyTracker              _gazeLatency;
+    LatencyTracker              _eyeImagesLatency;
+    LatencyTracker              _extSignalLatency;
+    LatencyTracker              _timeSyncLatency;
+    LatencyTracker              _notificationLatency;
+
+    // most recent sample of each stream
+    LatestSlot<gaze>            _gazeLatest;
+    LatestSlot<eyeImage>        _eyeImagesLatest;
+    LatestSlot<extSignal>       _extSignalLatest;
+    LatestSlot<timeSync>        _timeSyncLatest;
+    LatestSlot<positioning>     _positioningLatest;
+    LatestSlot<notification>    _notificationLatest;
+
+    // samples mirrored to shared memory, guarded by the stream's buffer mutex
+    std::unique_ptr<ShmRingWriter<gaze>>        _gazeShm;
+    std::unique_ptr<ShmRingWriter<extSignal>>   _extSignalShm;
+    std::unique_ptr<ShmRingWriter<timeSync>>    _timeSyncShm;
+    std::unique_ptr<ShmRingWriter<positioning>> _positioningShm;
+
+    // memory governor
+    MemoryAccount               _gazeMemory;
+    MemoryAccount               _eyeImagesMemory;
+    MemoryAccount               _extSignalMemory;
+    MemoryAccount               _timeSyncMemory;
+    MemoryAccount               _positioningMemory;
+    MemoryAccount               _notificationMemory;
+    std::atomic<size_t>         _memoryTotal            = 0;
+    std::atomic<size_t>         _memoryHighWaterMark    = 0;
+    std::atomic<size_t>         _memoryBudget           = 0;
+    std::vector<Stream>         _evictionOrder;
+    mutable mutex_type          _evictionOrderMutex;
+    std::mutex                  _memoryEnforceMutex;
+    std::atomic<PinnedMemory::options> _bufferAllocation;           // applied to buffers when their stream is started
+
+    static void logSinkThread();
+    static void drainLogRing();                                     // caller must hold write lock on _logsMutex
+
     static inline bool          _isLogging              = false;
+    // log callbacks push into the lock-free ring, consumers move messages from there into
+    // _logMessages (guarded by _logsMutex) and, if active, the file sink
     static inline std::unique_ptr<
-        std::vector<allLogTypes>> _logMessages          = nullptr;
+        LogRing<allLogTypes>>   _logRing                = nullptr;
+    static inline std::deque<allLogTypes> _logMessages;
     static inline mutex_type    _logsMutex;
+    static inline std::atomic<TobiiResearchLogLevel> _logLevel = TOBII_RESEARCH_LOG_LEVEL_TRACE;
+    static inline std::unique_ptr<LogFileSink> _logSink = nullptr; // guarded by _logsMutex
+    static inline std::mutex    _logSinkMutex;
+    static inline std::condition_variable _logSinkCV;
+    static inline bool          _logSinkStop            = false;    // guarded by _logSinkMutex
+    static inline std::thread   _logSinkThread;
+    // a joinable std::thread must not be destroyed, stop the sink at exit if the user didn't
+    static inline struct LogSinkStopper { ~LogSinkStopper() { Titta::stopLogFile(); } } _logSinkStopper;
 
     // calibration
     bool                                        _calibrationIsMonocular = false;
     std::thread                                 _calibrationThread;
     moodycamel::BlockingReaderWriterQueue<TobiiTypes::CalibrationWorkItem>   _calibrationWorkQueue;
-    moodycamel::BlockingReaderWriterQueue<TobiiTypes::CalibrationWorkResult> _calibrationWorkResultQueue;
     std::atomic<TobiiTypes::CalibrationState>   _calibrationState;
+    std::atomic<uint64_t>                       _calibrationNextRequestId = 1;
+    // completed work, guarded by _calibrationResultMutex
+    std::mutex                                  _calibrationResultMutex;
+    std::condition_variable                     _calibrationResultCV;
+    std::deque<TobiiTypes::CalibrationWorkResult> _calibrationWorkResults;
+    bool                                        _calibrationThreadRunning = false;
+    std::function<void(TobiiTypes::CalibrationWorkResult)> _calibrationResultCallback;
+    static inline CalibrationCache              _calibrationCache;
+
+    // eye tracker discovery
+    static inline EyeTrackerDiscovery           _eyeTrackerDiscovery;
+
+    // replay of recorded session, stands in for eye tracker
+    std::unique_ptr<TittaReplay>                _replay;
+
+    // incremental resampling of gaze
+    mutable std::mutex                          _gazeResamplerMutex;
+    std::unique_ptr<GazeResampler>              _gazeResampler;
+    std::atomic<bool>                           _gazeResamplerRunning   = false;
+    std::vector<gaze>                           _gazeResampled;                 // fed by storeGaze, guarded by _gazeResamplerMutex
+
+    // processing pipeline
+    GazePipeline                                _pipeline;
+    std::thread                                 _pipelineThread;
+    std::atomic<bool>                           _pipelineRunning        = false;
+    std::mutex                                  _pipelineMutex;
+    std::condition_variable                     _pipelineCV;
+    bool                                        _pipelineNewData        = false;    // guarded by _pipelineMutex
+    bool                                        _pipelineStop           = false;    // guarded by _pipelineMutex
+    moodycamel::ReaderWriterQueue<gaze>         _pipelineQueue;                     // filled by storeGaze (under gaze write lock), drained by the pipeline thread
 };
@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <map>
+#include <tuple>
+#include <optional>
+#include <mutex>
+#include <cstdint>
+
+
+// Cache of calibration data blobs (as retrieved with calibrationGetData()), keyed by
+// tracker serial number, tracking mode and participant label. Calibrations are kept in
+// memory and, if a directory is set, also written to disk. Each entry carries a checksum
+// that is verified when it is read back from disk. All member functions are thread-safe.
+class CalibrationCache
+{
+public:
+    struct key
+    {
+        std::string serialNumber;
+        std::string trackingMode;
+        std::string participant;
+
+        auto operator<=>(const key&) const = default;
+    };
+
+    void    setDirectory(std::optional<std::string> directory_);
+    std::optional<std::string> getDirectory() const;
+
+    void    store(const key& key_, std::vector<uint8_t> calibrationData_);
+    bool    contains(const key& key_);                  // also looks on disk
+    // returns nullopt if not found. Errors if the entry on disk is corrupt
+    std::optional<std::vector<uint8_t>> get(const key& key_);
+    void    clear(std::optional<std::string> participant_);     // memory only, files on disk are left alone
+    std::vector<std::string> getParticipants(const std::string& serialNumber_, const std::string& trackingMode_) const;   // in memory
+
+    static uint64_t checksum(const std::vector<uint8_t>& data_);
+
+private:
+    struct entry
+    {
+        std::vector<uint8_t>    data;
+        uint64_t                checksum = 0;
+    };
+
+    std::string getFileName(const key& key_) const;     // caller must hold _mutex, _directory must be set
+    void    writeToDisk(const key& key_, const entry& entry_) const;
+    std::optional<entry> readFromDisk(const key& key_) const;
+
+private:
+    mutable std::mutex          _mutex;
+    std::map<key, entry>        _entries;
+    std::optional<std::string>  _directory;
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <vector>
+#include <tuple>
+#include <optional>
+#include <cstdint>
+
+#include "types.h"
+
+
+// Compact in-memory storage of gaze samples for long recordings. Samples are
+// stored in blocks of fixed-size records: timestamps as 32-bit deltas against
+// the block's base, validity and availability of all fields packed in a 16-bit
+// bitfield, and all values as floats (lossless). Optionally, the gaze point on
+// the display area is stored as 16-bit fixed point with a resolution of
+// 1/8192 (maximum error 6.1e-5 of the display's width/height, values beyond
+// +-4 are clamped). Samples must be added in order of system_time_stamp.
+// Record size is 92 bytes (84 bytes when quantized) vs 160 bytes for a
+// TobiiTypes::gazeData.
+//
+// Optionally, blocks older than the most recent hotBlocks are further
+// compressed (the cold tier): timestamps as delta-of-delta, and all other
+// record words as the XOR with the same word of the previous sample, both with
+// variable-length bit codes. As the validity flags are part of the record
+// words, unchanged validity costs a single bit. Cold blocks are decoded
+// transparently when accessed, timestamps can be accessed without decoding the
+// whole block. Compression is lossless, and happens outside the buffer: the
+// owner gets a job with getCompressionJob(), runs compress() on it without
+// holding its lock and then hands the result to commitCompression().
+class CompactGazeBuffer
+{
+public:
+    static constexpr size_t hotBlocks = 2;      // most recent blocks that are never compressed
+
+    // a copy of a block to compress, and the compressed result
+    struct compressionJob
+    {
+        uint64_t                id          = 0;
+        size_t                  recordSize  = 0;
+        size_t                  n           = 0;
+        std::vector<uint8_t>    data;
+    };
+    struct checkpoint       // decoder state before every checkpointInterval-th timestamp
+    {
+        uint64_t                bitPos      = 0;
+        int32_t                 device      = 0;
+        int32_t                 system      = 0;
+        int64_t                 deviceDelta = 0;
+        int64_t                 systemDelta = 0;
+    };
+    struct compressedBlock
+    {
+        uint64_t                id          = 0;
+        size_t                  n           = 0;
+        std::vector<uint64_t>   times;
+        std::vector<uint64_t>   values;
+        std::vector<checkpoint> checkpoints;
+    };
+
+public:
+    CompactGazeBuffer() = default;
+    explicit CompactGazeBuffer(bool quantize_, bool compressOld_ = false) : _quantize(quantize_), _compressOld(compressOld_) {}
+
+    bool    isQuantized() const { return _quantize; }
+    bool    isCompressingOld() const { return _compressOld; }
+    size_t  getSampleBytes() const;        // size of one record
+    size_t  getStoredBytes() const { return _storedBytes; }    // records of hot blocks and compressed data of cold blocks
+    size_t  getReservedBytes() const;
+    size_t  getNumBlocks() const { return _blocks.size(); }
+
+    // cold tier, see above. getCompressionJob needs read access to the buffer, commitCompression write access
+    std::optional<compressionJob> getCompressionJob() const;
+    static compressedBlock compress(const compressionJob& job_);
+    bool    commitCompression(compressedBlock&& block_);   // false if block was changed or removed since the job was made
+
+    size_t  size() const { return _size; }
+    bool    empty() const { return !_size; }
+    void    reserve(size_t nSamp_);
+    void    clear();
+
+    void    push_back(const TobiiTypes::gazeData& sample_);
+    int64_t getSystemTimeStamp(size_t i_) const;
+    // decode samples [iStart_, iEnd_)
+    std::vector<TobiiTypes::gazeData> get(size_t iStart_, size_t iEnd_) const;
+    void    erase(size_t iStart_, size_t iEnd_);
+    // same semantics as Titta::getIteratorsFromTimeRange(), but returns indices
+    std::tuple<size_t, size_t, bool> findTimeRange(int64_t timeStart_, int64_t timeEnd_) const;
+
+private:
+    struct block
+    {
+        uint64_t                id          = 0;
+        int64_t                 deviceBase  = 0;
+        int64_t                 systemBase  = 0;
+        size_t                  n           = 0;
+        std::vector<uint8_t>    data;       // records, empty if block is compressed
+        std::optional<compressedBlock> cold;
+    };
+
+    static constexpr size_t _blockSize = 4096;     // samples
+
+    std::tuple<size_t, size_t> locate(size_t i_) const;     // block and index within block
+    void    updateBlockStarts();
+    void    encode(uint8_t* out_, const TobiiTypes::gazeData& sample_, const block& block_) const;
+    void    decode(TobiiTypes::gazeData& out_, const uint8_t* in_, const block& block_) const;
+    int64_t getSystemTimeStamp(const block& block_, size_t i_) const;
+    size_t  findFirst(int64_t time_, bool after_) const;  // first sample with timestamp >= time_, or > time_ if after_
+    static size_t getColdBytes(const compressedBlock& block_);
+    std::vector<uint8_t> decompress(const block& block_, size_t nSamp_) const;     // records of first nSamp_ samples
+
+private:
+    bool                _quantize   = false;
+    bool                _compressOld= false;
+    std::vector<block>  _blocks;
+    std::vector<size_t> _blockStart;    // index of first sample of each block
+    size_t              _size       = 0;
+    size_t              _storedBytes= 0;
+    uint64_t            _nextBlockId= 0;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <string>
+#include <optional>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <tobii_research.h>
+
+#include "types.h"
+
+
+// Background discovery of eye trackers. Keeps a list of the eye trackers found by
+// tobii_research_find_all_eyetrackers(), along with when each was first and last seen.
+// While running, the list is refreshed periodically (and on request) on a background
+// thread, so that it can be read without blocking. Eye trackers that are already in
+// the list are not queried again when they are seen in a later scan, eye trackers no
+// longer found are dropped. Changes are recorded as events and can be delivered to a
+// callback (invoked on the discovery thread). All member functions are thread-safe.
+class EyeTrackerDiscovery
+{
+public:
+    struct entry
+    {
+        TobiiTypes::eyeTracker  info;
+        int64_t                 firstSeen   = 0;    // system time stamp (us)
+        int64_t                 lastSeen    = 0;    // system time stamp (us) of the last scan that found the eye tracker
+    };
+    enum class EventType
+    {
+        Found,
+        Lost
+    };
+    struct event
+    {
+        EventType               type        = EventType::Found;
+        int64_t                 system_time_stamp = 0;
+        TobiiTypes::eyeTracker  info;
+    };
+    static std::string eventTypeToString(EventType type_);
+
+    ~EyeTrackerDiscovery();
+
+    void    start(std::chrono::milliseconds interval_);     // restarts with the new interval if already running
+    void    stop();
+    bool    isRunning() const;
+    // scans now. If running, asks the discovery thread to scan and, if wait_, blocks until
+    // that scan has completed. If not running, scans on the calling thread, errors if the scan failed
+    void    refresh(bool wait_);
+
+    // if running and a scan has completed, returns the cached list. Otherwise scans on the
+    // calling thread, creating new eye tracker objects, like tobii_research_find_all_eyetrackers()
+    std::vector<TobiiTypes::eyeTracker> getEyeTrackers();
+    std::vector<entry>  getEntries() const;
+    // only looks in the list, does not scan
+    std::optional<TobiiTypes::eyeTracker> find(const std::string& address_) const;
+    std::string getLastError() const;       // error of the last scan, empty if it succeeded
+
+    std::vector<event>  getEvents(bool clear_);
+    void    setCallback(std::function<void(event)> callback_);
+
+private:
+    void    thread(std::chrono::milliseconds interval_);
+    // returns false and sets _lastError if the scan failed. Otherwise updates the list,
+    // fresh_ determines whether eye trackers already in the list are queried again
+    bool    scan(bool fresh_);
+    void    addEvent(event event_);         // caller must hold _mutex
+
+private:
+    static constexpr size_t             _maxEvents = 256;  // oldest are dropped
+
+    mutable std::mutex                  _mutex;
+    std::vector<entry>                  _entries;
+    std::deque<event>                   _events;
+    std::function<void(event)>          _callback;
+    std::string                         _lastError;
+    bool                                _running        = false;
+    bool                                _refreshPending = false;
+    bool                                _stopRequested  = false;
+    uint64_t                            _scansStarted   = 0;
+    uint64_t                            _scansCompleted = 0;
+    std::condition_variable             _cv;
+    std::mutex                          _scanMutex;             // one scan at a time, _entries is only modified by scans
+    std::thread                         _thread;
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <array>
+#include <map>
+#include <mutex>
+#include <cstddef>
+
+#include "types.h"
+
+
+// Reduction of eye images as they arrive, so that longer histories fit in the
+// same memory. Only every keepEveryN-th frame of each camera is kept. Kept
+// frames are cropped, either to a fixed rectangle or to a window around the
+// pupil (the darkest region of the image, as the trackers record dark-pupil
+// images), and then downscaled by an integer factor by averaging blocks of
+// pixels. Only 8-bit raw images can be cropped and downscaled, others (GIFs)
+// are left alone.
+class EyeImageReducer
+{
+public:
+    enum class Crop
+    {
+        None,
+        Fixed,
+        Pupil
+    };
+    static Crop         stringToCrop(const std::string& crop_);
+    static std::string  cropToString(Crop crop_);
+
+    struct options
+    {
+        Crop                crop        = Crop::None;
+        std::array<int, 4>  cropRect    = {};       // left, top, width, height. Crop::Pupil only uses width and height
+        int                 downscale   = 1;
+        size_t              keepEveryN  = 1;
+
+        bool isPlain() const { return crop == Crop::None && downscale == 1 && keepEveryN == 1; }
+    };
+
+    // thread-safe. Setting options restarts the frame count
+    void    setOptions(const options& options_);
+    options getOptions() const;
+
+    // returns false if the frame is to be dropped, else reduces it in place
+    bool    process(TobiiTypes::eyeImage& image_);
+    // crop and downscale only
+    static void reduce(TobiiTypes::eyeImage& image_, const options& options_);
+
+private:
+    mutable std::mutex      _mutex;
+    options                 _options;
+    std::map<int, size_t>   _frameCounts;   // per camera_id
+};
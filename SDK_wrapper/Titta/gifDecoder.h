@@ -0,0 +1,17 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+
+// Decoder for the GIF eye images delivered by the Tobii SDK (see
+// tobii_research_subscribe_to_eye_image_as_gif()). The first image in the file is
+// decoded onto a canvas of the file's logical screen size, and each pixel is output
+// as the 8-bit luminance of its palette entry, so that the result has the same layout
+// as a raw eye image (row-major, 8 bits per pixel, no padding).
+namespace GifDecoder
+{
+    // returns false and sets error_ if data_ is not a GIF that can be decoded
+    bool decode(const uint8_t* data_, size_t size_, std::vector<uint8_t>& pixels_, int& width_, int& height_, std::string& error_);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <array>
+#include <deque>
+#include <atomic>
+#include <cstdint>
+
+#include "types.h"
+
+
+// HDR-style histogram of latencies in microseconds. Values are resolved to within 1%
+// up to 2^32 us (~71 minutes), larger values are clamped. Recording is lock-free
+// and constant time, so it can be done from the SDK's callback threads.
+class LatencyHistogram
+{
+public:
+    void record(int64_t value_);
+    void reset();
+    TobiiTypes::latencySummary getSummary() const;
+
+private:
+    static constexpr int    _subBucketBits  = 7;                            // 128 sub-buckets per power of two
+    static constexpr int    _subBucketHalf  = 1 << (_subBucketBits - 1);
+    static constexpr int    _maxValueBits   = 32;
+    static constexpr size_t _nBuckets       = (1 << _subBucketBits) + (_maxValueBits - _subBucketBits) * _subBucketHalf;
+
+    static size_t  valueToIndex(uint64_t value_);
+    static int64_t indexToValue(size_t index_);   // representative (middle) value of bucket
+
+private:
+    std::array<std::atomic<uint64_t>, _nBuckets>    _counts{};
+    std::atomic<uint64_t>                           _total  = 0;
+    std::atomic<uint64_t>                           _sum    = 0;
+    std::atomic<int64_t>                            _min    = INT64_MAX;
+    std::atomic<int64_t>                            _max    = 0;
+};
+
+// latency bookkeeping of a single data stream
+struct LatencyTracker
+{
+    // per sample in the buffer, time (us) between its system_time_stamp and its arrival
+    // in the buffer. Index-aligned with the stream's buffer, and guarded by its mutex.
+    // Stored relative to the sample's timestamp so it fits in 32 bits. A deque, as
+    // samples are mostly removed from the front
+    std::deque<int32_t>     arrival;
+    LatencyHistogram        ingest;
+    LatencyHistogram        consume;
+};
@@ -0,0 +1,165 @@
+#pragma once
+#include <atomic>
+#include <array>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+
+
+// Holds the most recent value of a stream. Storing never takes a lock and
+// loading never blocks a writer. For trivially copyable types this is a
+// seqlock: the value is stored in atomic words guarded by a sequence counter,
+// and a reader retries in the rare case that its copy overlapped a store.
+// Other types (which own heap memory, so a copy must not overlap a store) are
+// written into one of a few preallocated snapshots, and the index of the
+// latest is published. A reader pins that snapshot while copying it, the
+// writer picks a snapshot that is neither published nor pinned (it only has
+// to wait in the unlikely case that readers pin all of them).
+// Only needs lock-free 32- and 64-bit atomics (checked below), so it also builds
+// with standard libraries that lack std::atomic<std::shared_ptr> (libc++).
+template <typename T>
+class LatestSlot
+{
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free, "LatestSlot requires lock-free 32- and 64-bit atomics");
+public:
+    template <typename... Args>
+    void emplace(Args&&... args_)
+    {
+        if constexpr (isSeqlock)
+            store(T(std::forward<Args>(args_)...));
+        else
+        {
+            const auto seq = beginWrite();
+            publish(T(std::forward<Args>(args_)...));
+            _seq.store(seq + 2, std::memory_order_release);
+        }
+    }
+    void store(const T& val_)
+    {
+        const auto seq = beginWrite();
+        if constexpr (isSeqlock)
+        {
+            std::atomic_thread_fence(std::memory_order_release);
+
+            std::array<uint64_t, nWords> words{};
+            std::memcpy(words.data(), &val_, sizeof(T));
+            for (size_t i = 0; i < nWords; i++)
+                _words[i].store(words[i], std::memory_order_relaxed);
+        }
+        else
+            publish(val_);
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+    // for types that are expensive to copy: only keeps a copy of val_ once the slot has
+    // been read, until then only counts it
+    void storeIfRead(const T& val_) requires (!std::is_trivially_copyable_v<T>)
+    {
+        if (_wasRead.load(std::memory_order_relaxed))
+            store(val_);
+        else
+            _seq.store(beginWrite() + 2, std::memory_order_release);
+    }
+
+    // empty if nothing was stored yet
+    std::optional<T> load() const
+    {
+        if constexpr (isSeqlock)
+        {
+            std::array<uint64_t, nWords> words;
+            uint64_t seq0, seq1;
+            do
+            {
+                seq0 = _seq.load(std::memory_order_acquire);
+                for (size_t i = 0; i < nWords; i++)
+                    words[i] = _words[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                seq1 = _seq.load(std::memory_order_relaxed);
+            } while ((seq0 & 1) || seq0 != seq1);
+            if (!seq0)
+                return std::nullopt;
+
+            T out;
+            std::memcpy(static_cast<void*>(&out), words.data(), sizeof(T));
+            return out;
+        }
+        else
+        {
+            if (!_wasRead.load(std::memory_order_relaxed))
+                _wasRead.store(true, std::memory_order_relaxed);
+            while (true)
+            {
+                const auto i = _current.load();
+                if (i == noSnapshot)
+                    return std::nullopt;
+                // pin, then check it is still the published snapshot. If so, the
+                // writer will not pick it until we unpin
+                auto& snap = _snapshots[i];
+                snap.readers.fetch_add(1);
+                if (_current.load() == i)
+                {
+                    struct Unpin { std::atomic<uint32_t>& r; ~Unpin() { r.fetch_sub(1, std::memory_order_release); } } unpin{ snap.readers };
+                    return snap.value;
+                }
+                snap.readers.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // number of values stored so far, can be used to cheaply check whether there is a new value
+    uint64_t getCount() const
+    {
+        return _seq.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    // makes _seq odd, also keeps concurrent writers (normally there are none) from interleaving
+    uint64_t beginWrite()
+    {
+        uint64_t seq = _seq.load(std::memory_order_relaxed);
+        do
+        {
+            while (seq & 1)
+                seq = _seq.load(std::memory_order_relaxed);
+        } while (!_seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed));
+        return seq;
+    }
+    template <typename U>
+    void publish(U&& val_)
+    {
+        const auto cur = _current.load(std::memory_order_relaxed);
+        while (true)
+        {
+            for (uint32_t i = 0; i < nSnapshots; i++)
+            {
+                if (i == cur || _snapshots[i].readers.load())
+                    continue;
+                _snapshots[i].value = std::forward<U>(val_);
+                _current.store(i);
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    static constexpr bool       isSeqlock   = std::is_trivially_copyable_v<T>;
+    static constexpr size_t     nWords      = isSeqlock ? (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t) : 0;
+    static constexpr uint32_t   nSnapshots  = isSeqlock ? 0 : 4;
+    static constexpr uint32_t   noSnapshot  = UINT32_MAX;
+
+    struct Snapshot
+    {
+        alignas(64) std::atomic<uint32_t>   readers = 0;
+        T                                   value   = {};
+    };
+
+    // sequence counter, also counts the values stored
+    alignas(64) std::atomic<uint64_t>               _seq        = 0;
+    // seqlock storage
+    std::array<std::atomic<uint64_t>, nWords>       _words      = {};
+    // storage for other types
+    std::atomic<uint32_t>                           _current    = noSnapshot;
+    mutable std::array<Snapshot, nSnapshots>        _snapshots  = {};
+    mutable std::atomic<bool>                       _wasRead    = false;
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <bit>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+
+// Bounded multi-producer multi-consumer lock-free ring (after D. Vyukov's bounded MPMC
+// queue). Producers never block or take a lock: when the ring is full, the oldest entry
+// is dropped to make room, so log callbacks never contend with anything else.
+template <typename T>
+class LogRing
+{
+public:
+    explicit LogRing(size_t capacity_) :
+        _capacity(std::bit_ceil(std::max<size_t>(capacity_, 2))),
+        _mask(_capacity - 1),
+        _buffer(std::make_unique<cell[]>(_capacity))
+    {
+        for (size_t i = 0; i < _capacity; i++)
+            _buffer[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // never blocks, if the ring is full the oldest entry is dropped
+    void push(T item_)
+    {
+        while (!tryPush(item_))
+        {
+            T discard;
+            if (tryPop(discard))
+                _nDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPop(T& out_)
+    {
+        cell* c;
+        size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            c = &_buffer[pos & _mask];
+            const size_t seq = c->sequence.load(std::memory_order_acquire);
+            const auto diff  = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;   // empty
+            else
+                pos = _dequeuePos.load(std::memory_order_relaxed);
+        }
+        out_ = std::move(c->data);
+        c->sequence.store(pos + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t   capacity() const { return _capacity; }
+    uint64_t getNumDropped() const { return _nDropped.load(std::memory_order_relaxed); }
+    void     addDropped(uint64_t n_) { _nDropped.fetch_add(n_, std::memory_order_relaxed); }
+
+private:
+    bool tryPush(T& item_)
+    {
+        cell* c;
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            c = &_buffer[pos & _mask];
+            const size_t seq = c->sequence.load(std::memory_order_acquire);
+            const auto diff  = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;   // full
+            else
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+        c->data = std::move(item_);
+        c->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        T                   data;
+    };
+
+    const size_t                        _capacity;
+    const size_t                        _mask;
+    std::unique_ptr<cell[]>             _buffer;
+    alignas(64) std::atomic<size_t>     _enqueuePos = 0;
+    alignas(64) std::atomic<size_t>     _dequeuePos = 0;
+    alignas(64) std::atomic<uint64_t>   _nDropped   = 0;
+};
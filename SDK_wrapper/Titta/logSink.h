@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <variant>
+#include <cstdint>
+
+#include "types.h"
+
+
+// Writes log messages and stream errors to a tab-separated text file. When the file
+// exceeds maxBytes, it is rotated: <file> becomes <file>.1, <file>.1 becomes <file>.2,
+// and so on, keeping at most maxFiles files in total.
+class LogFileSink
+{
+public:
+    LogFileSink(std::string fileName_, uint64_t maxBytes_, size_t maxFiles_);
+
+    void write(const std::variant<TobiiTypes::logMessage, TobiiTypes::streamErrorMessage>& entry_);
+    void flush();
+
+    const std::string& getFileName() const { return _fileName; }
+
+private:
+    bool open();
+    void rotate();
+
+private:
+    std::string     _fileName;
+    uint64_t        _maxBytes;
+    size_t          _maxFiles;
+    std::ofstream   _file;
+    uint64_t        _bytesWritten   = 0;
+};
@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+
+// memory bookkeeping of a single data stream, guarded by the stream's mutex
+struct MemoryAccount
+{
+    size_t      bytes           = 0;    // held by samples in the buffer, including heap data they own
+    size_t      highWaterMark   = 0;
+    size_t      budget          = 0;    // 0: unlimited
+    uint64_t    nEvicted        = 0;
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <type_traits>
+
+
+// Allocator for the sample buffers. By default it allocates like std::allocator.
+// Optionally, memory is pre-faulted (all pages touched at allocation, so that
+// writing samples into the reserved capacity of a buffer does not page fault),
+// locked into RAM (mlock/VirtualLock) and/or backed by huge pages (transparent:
+// madvise(MADV_HUGEPAGE) on a huge-page aligned mapping, explicit: MAP_HUGETLB
+// or MEM_LARGE_PAGES, falling back to transparent if unavailable), reducing TLB
+// misses. Failures do not fail the allocation, they are recorded in the status.
+namespace PinnedMemory
+{
+    enum class HugePages
+    {
+        None,
+        Transparent,
+        Explicit
+    };
+    HugePages   stringToHugePages(const std::string& hugePages_);
+    std::string hugePagesToString(HugePages hugePages_);
+
+    struct options
+    {
+        bool        prefault    = false;
+        bool        lock        = false;
+        HugePages   hugePages   = HugePages::None;
+
+        bool isPlain() const { return !prefault && !lock && hugePages == HugePages::None; }
+        bool operator==(const options&) const = default;
+    };
+    // outcome of the most recent allocation
+    struct status
+    {
+        const void* ptr         = nullptr;
+        size_t      bytes       = 0;
+        bool        prefaulted  = false;
+        bool        locked      = false;
+        bool        hugePages   = false;
+        std::string error;                  // what could not be done, empty if all succeeded
+    };
+    struct state
+    {
+        const options   opts;
+        status          stat;               // guarded by the lock of the buffer using the allocator
+    };
+
+    // throw std::bad_alloc if no memory could be allocated at all
+    void* allocate(size_t bytes_, const options& options_, status& status_);
+    void  deallocate(void* ptr_, size_t bytes_, const options& options_, status& status_) noexcept;
+}
+
+template <typename T>
+class PinnedAllocator
+{
+public:
+    using value_type                                = T;
+    using propagate_on_container_copy_assignment    = std::true_type;
+    using propagate_on_container_move_assignment    = std::true_type;
+    using propagate_on_container_swap               = std::true_type;
+
+    PinnedAllocator() noexcept = default;
+    explicit PinnedAllocator(const PinnedMemory::options& options_) :
+        _state(options_.isPlain() ? nullptr : std::make_shared<PinnedMemory::state>(options_))
+    {}
+    // NB: copy only, a moved-from allocator must remain usable by the container it was moved from
+    PinnedAllocator(const PinnedAllocator&) noexcept = default;
+    PinnedAllocator& operator=(const PinnedAllocator&) noexcept = default;
+    template <typename U>
+    PinnedAllocator(const PinnedAllocator<U>& other_) noexcept : _state(other_._state) {}
+
+    T* allocate(const size_t n_)
+    {
+        if (!_state)
+            return std::allocator<T>{}.allocate(n_);
+        static_assert(alignof(T) <= alignof(std::max_align_t));    // memory is page-aligned, but be explicit about what we rely on
+        return static_cast<T*>(PinnedMemory::allocate(n_ * sizeof(T), _state->opts, _state->stat));
+    }
+    void deallocate(T* p_, const size_t n_) noexcept
+    {
+        if (!_state)
+            std::allocator<T>{}.deallocate(p_, n_);
+        else
+            PinnedMemory::deallocate(p_, n_ * sizeof(T), _state->opts, _state->stat);
+    }
+
+    PinnedMemory::options getOptions() const
+    {
+        return _state ? _state->opts : PinnedMemory::options{};
+    }
+    PinnedMemory::status getStatus() const
+    {
+        return _state ? _state->stat : PinnedMemory::status{};
+    }
+
+    template <typename U>
+    bool operator==(const PinnedAllocator<U>& other_) const noexcept { return _state == other_._state; }
+
+private:
+    template <typename U> friend class PinnedAllocator;
+    std::shared_ptr<PinnedMemory::state> _state;    // nullptr: plain allocation
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <tuple>
+#include <cstdint>
+
+#include "types.h"
+
+
+// A processing stage of a GazePipeline. Stages are run in order on each batch
+// of incoming gaze samples. A stage gets the samples as output by the previous
+// stage and can modify them in place (filters), and can emit samples to its
+// own derived stream (transforms, detectors). Stages keep whatever state they
+// need across batches.
+class PipelineStage
+{
+public:
+    virtual ~PipelineStage() = default;
+
+    virtual void process(std::vector<TobiiTypes::gazeData>& samples_, std::vector<TobiiTypes::derivedSample>& output_) = 0;
+    // names of the values of each derived sample
+    virtual std::vector<std::string> getChannels() const = 0;
+};
+
+// Chain of processing stages. Stage types are looked up in a registry that
+// holds the built-in stages and to which C++ users can add their own. Derived
+// streams are buffered per stage until consumed, up to maxBufferedSamples.
+class GazePipeline
+{
+public:
+    using params  = std::map<std::string, double>;
+    using factory = std::function<std::unique_ptr<PipelineStage>(const params&)>;
+
+    // each derived stream holds at most this many samples, the oldest are dropped
+    static constexpr size_t maxBufferedSamples = 2<<19;
+
+    // registry of stage types
+    static void registerStageType(std::string type_, factory factory_);
+    static std::vector<std::string> getStageTypes();
+
+    // configuration
+    void addStage(std::string name_, std::string type_, const params& params_);
+    void clear();
+    std::vector<std::tuple<std::string, std::string>> getStages() const;    // name and type, in processing order
+    std::vector<std::string> getChannels(const std::string& name_) const;
+
+    // run all stages on new samples (in order of system_time_stamp)
+    void process(std::vector<TobiiTypes::gazeData> samples_);
+
+    // derived stream access, same semantics as the corresponding Titta functions
+    std::vector<TobiiTypes::derivedSample> consumeN(const std::string& name_, size_t NSamp_, bool fromStart_);
+    std::vector<TobiiTypes::derivedSample> consumeTimeRange(const std::string& name_, int64_t timeStart_, int64_t timeEnd_);
+    std::vector<TobiiTypes::derivedSample> peekN(const std::string& name_, size_t NSamp_, bool fromStart_);
+    std::vector<TobiiTypes::derivedSample> peekTimeRange(const std::string& name_, int64_t timeStart_, int64_t timeEnd_);
+    void clearDerived(const std::string& name_);
+
+private:
+    struct stage
+    {
+        std::string                             name;
+        std::string                             type;
+        std::unique_ptr<PipelineStage>          impl;
+        std::vector<TobiiTypes::derivedSample>  buffer;     // guarded by _bufferMutex
+    };
+    stage& getStage(const std::string& name_, const char* func_);
+    const stage& getStage(const std::string& name_, const char* func_) const;
+    std::tuple<size_t, size_t> getRange(const stage& stage_, size_t NSamp_, bool fromStart_) const;
+    std::tuple<size_t, size_t> getRange(const stage& stage_, int64_t timeStart_, int64_t timeEnd_) const;
+
+private:
+    // _stageMutex is held while processing, so stages are not added or removed mid-batch. _bufferMutex guards the
+    // derived streams, so that these can be read while a batch is processed
+    std::vector<std::unique_ptr<stage>> _stages;
+    mutable std::mutex                  _stageMutex;
+    mutable std::mutex                  _bufferMutex;
+};
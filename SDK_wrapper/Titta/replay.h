@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <tobii_research.h>
+#include <tobii_research_streams.h>
+
+#include "Titta.h"
+
+
+// Stands in for an eye tracker: reads a recorded session and feeds it through the
+// normal ingest callbacks of a Titta instance, as if it came from an eye tracker.
+// Supported input is the gaze tsv file written by Titta.saveGazeDataToTSV()
+class TittaReplay
+{
+public:
+    // addresses of the form "replay://<path to _gaze.tsv file>" create a replay instance
+    static constexpr std::string_view addressPrefix = "replay://";
+    static bool isReplayAddress(std::string_view address_);
+
+    TittaReplay(std::string address_);
+    ~TittaReplay();
+
+    // info about the recorded session, in the form of a (fake) eye tracker
+    TobiiTypes::eyeTracker getEyeTrackerInfo() const;
+
+    // playback speed: 1 is real-time, larger is faster (e.g. 100x),
+    // 0 (or inf) is as fast as possible. Can be changed during playback.
+    // Only the pacing changes, timestamps keep their recorded intervals
+    void   setSpeed(double speed_);
+    double getSpeed() const;
+    // true once all samples have been played back
+    bool   isFinished() const;
+
+    // mimics the SDK's (un)subscribe functions. Playback starts upon the
+    // first subscription to a stream that is in the file, and pauses while
+    // no such stream is subscribed. Subscribing once playback has finished
+    // plays the recording again from the start
+    TobiiResearchStatus subscribe(Titta::Stream stream_, void* user_data_);
+    TobiiResearchStatus unsubscribe(Titta::Stream stream_);
+
+private:
+    void readFile(const std::string& fileName_);
+    void playbackThread();
+    bool hasSubscriber();       // to a stream with data
+
+private:
+    struct sample
+    {
+        TobiiResearchGazeData           gaze;
+        TobiiResearchEyeOpennessData    eyeOpenness;
+        bool                            hasEyeOpenness;
+    };
+
+    std::string                                 _address;
+    std::vector<sample>                         _samples;
+    bool                                        _hasEyeOpenness = false;
+    float                                       _frequency      = 0.f;
+
+    std::atomic<double>                         _speed      = 1.;
+    std::atomic<bool>                           _isFinished = false;
+
+    // subscription state, guarded by _callbackMutex so no callback is delivered after unsubscribe returns
+    std::mutex                                  _callbackMutex;
+    void*                                       _userData               = nullptr;
+    bool                                        _gazeSubscribed         = false;
+    bool                                        _eyeOpennessSubscribed  = false;
+
+    std::thread                                 _thread;
+    std::mutex                                  _stopMutex;
+    std::condition_variable                     _stopCondition;
+    std::atomic<bool>                           _shouldStop = false;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <string>
+#include <optional>
+#include <cstdint>
+
+#include "types.h"
+
+
+// Resamples gaze data to a uniform grid on system_time_stamp. Grid points are
+// at gridStart + k/frequency. For each eye, the gaze point, pupil, gaze origin
+// and eye openness are interpolated independently between the nearest valid
+// samples on either side of a grid point, as long as these are at most maxGap
+// (us) apart. Otherwise the field is marked invalid for that grid point.
+// Samples can be added incrementally, a grid point is output once enough data
+// has arrived to compute it (for gaps, this may take up to maxGap). Batch
+// resampling gives the same result as adding all data at once and flushing.
+class GazeResampler
+{
+public:
+    enum class Method
+    {
+        Linear,
+        Cubic       // cubic Hermite, falls back to linear where there are no valid neighbors within maxGap
+    };
+    static Method      stringToMethod(std::string method_);
+    static std::string methodToString(Method method_);
+
+    GazeResampler(double frequency_, int64_t maxGap_, Method method_, std::optional<int64_t> gridStart_ = std::nullopt);
+
+    // samples must be in order of system_time_stamp, samples older than the newest already added are ignored.
+    // Returns the grid samples that can be computed now
+    std::vector<TobiiTypes::gazeData> push(const std::vector<TobiiTypes::gazeData>& samples_);
+    // no more samples will be added, returns all remaining grid samples up to the last added sample
+    std::vector<TobiiTypes::gazeData> flush();
+
+    static std::vector<TobiiTypes::gazeData> resample(const std::vector<TobiiTypes::gazeData>& samples_, double frequency_, int64_t maxGap_, Method method_, std::optional<int64_t> gridStart_ = std::nullopt);
+
+    double  getFrequency() const { return _frequency; }
+    int64_t getMaxGap() const { return _maxGap; }
+    Method  getMethod() const { return _method; }
+
+private:
+    int64_t gridTime(uint64_t k_) const;
+    std::vector<TobiiTypes::gazeData> emit(bool final_);
+    bool    computeSample(int64_t t_, bool final_, TobiiTypes::gazeData& out_) const;  // false if more data is needed
+    template <typename G>
+    bool    interpolate(int64_t t_, size_t p_, bool final_, TobiiTypes::eyeData TobiiTypes::gazeData::* eye_, G TobiiTypes::eyeData::* field_, G& out_) const;
+
+private:
+    double                              _frequency;
+    int64_t                             _maxGap;
+    Method                              _method;
+    std::optional<int64_t>              _gridStart;
+    uint64_t                            _nextGridIdx    = 0;
+    std::deque<TobiiTypes::gazeData>    _window;        // input samples still needed for upcoming grid points
+};
@@ -0,0 +1,237 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <variant>
+#include <algorithm>
+#include <new>
+#include <atomic>
+#include <limits>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+
+#include "types.h"
+#include "utils.h"
+
+
+// Named shared memory region. The creator maps it read-write, others attach
+// read-only. Uses shm_open and mmap on POSIX systems and a named file mapping
+// on Windows.
+class SharedMemory
+{
+public:
+    // create (replacing any existing region with the same name)
+    SharedMemory(std::string name_, size_t size_);
+    // attach read-only to existing region
+    explicit SharedMemory(std::string name_);
+    ~SharedMemory();
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    void*       data() const { return _data; }
+    size_t      size() const { return _size; }
+    const std::string& getName() const { return _name; }
+
+private:
+    std::string _name;
+    void*       _data    = nullptr;
+    size_t      _size    = 0;
+    bool        _isOwner = false;
+#ifdef _WIN32
+    void*       _handle  = nullptr;
+#endif
+};
+
+
+// Layout of a shared-memory sample ring. A header is followed by capacity
+// slots. Each slot holds a sequence word and the sample, stored as 64-bit
+// words so that all accesses to shared memory are atomic. The single writer
+// marks a slot odd while writing sample i to it and sets it to 2*(i+1) when
+// done, and then increments writeSeq. Readers follow writeSeq and use the
+// slot sequence word to detect that a sample was overwritten while copying.
+namespace ShmRing
+{
+    constexpr uint32_t magic   = 0x52535454;    // "TTSR"
+    constexpr uint32_t version = 1;
+
+    enum class StreamType : uint32_t
+    {
+        Gaze        = 1,
+        ExtSignal,
+        TimeSync,
+        Positioning
+    };
+
+    template <typename T>
+    constexpr StreamType streamTypeOf()
+    {
+        if constexpr (std::is_same_v<T, TobiiTypes::gazeData>)
+            return StreamType::Gaze;
+        else if constexpr (std::is_same_v<T, TobiiResearchExternalSignalData>)
+            return StreamType::ExtSignal;
+        else if constexpr (std::is_same_v<T, TobiiResearchTimeSynchronizationData>)
+            return StreamType::TimeSync;
+        else if constexpr (std::is_same_v<T, TobiiResearchUserPositionGuide>)
+            return StreamType::Positioning;
+        else
+            static_assert(!sizeof(T), "ShmRing: unsupported sample type");
+    }
+    template <typename T>
+    constexpr size_t nWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct header
+    {
+        uint32_t                magic;
+        uint32_t                version;
+        uint32_t                streamType;     // StreamType
+        uint32_t                sampleSize;     // sizeof sample, in bytes
+        uint64_t                capacity;       // number of slots
+        uint64_t                slotSize;       // in bytes
+        alignas(64) std::atomic<uint64_t> writeSeq;     // number of samples published
+        std::atomic<uint32_t>   writerClosed;
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free, "ShmRing: lock-free atomics are needed for use across processes");
+
+    constexpr size_t headerSize = (sizeof(header) + 63) / 64 * 64;
+
+    // attaches to the region and checks that it has a compatible layout, returns the stream type
+    StreamType checkLayout(const SharedMemory& shm_);
+}
+
+template <typename T>
+class ShmRingWriter
+{
+public:
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    ShmRingWriter(std::string name_, size_t capacity_) :
+        _shm(std::move(name_), ShmRing::headerSize + capacity_ * slotSize),
+        _capacity(capacity_)
+    {
+        if (!_capacity)
+            DoExitWithMsg("Titta::cpp::ShmRingWriter: capacity must be at least 1");
+        auto h = new (_shm.data()) ShmRing::header{ ShmRing::magic, ShmRing::version, static_cast<uint32_t>(ShmRing::streamTypeOf<T>()), sizeof(T), _capacity, slotSize, {0}, {0} };
+        _header = h;
+        for (size_t i = 0; i < _capacity * (1 + ShmRing::nWords<T>); i++)
+            new (getWords() + i) std::atomic<uint64_t>(0);
+    }
+    ~ShmRingWriter()
+    {
+        _header->writerClosed.store(1, std::memory_order_release);
+    }
+
+    void push(const T& sample_)
+    {
+        const auto i    = _header->writeSeq.load(std::memory_order_relaxed);
+        auto       slot = getWords() + (i % _capacity) * (1 + ShmRing::nWords<T>);
+        slot[0].store(2 * i + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        uint64_t words[ShmRing::nWords<T>]{};
+        std::memcpy(words, &sample_, sizeof(T));
+        for (size_t w = 0; w < ShmRing::nWords<T>; w++)
+            slot[1 + w].store(words[w], std::memory_order_relaxed);
+
+        slot[0].store(2 * (i + 1), std::memory_order_release);
+        _header->writeSeq.store(i + 1, std::memory_order_release);
+    }
+
+    const std::string& getName() const { return _shm.getName(); }
+    size_t getCapacity() const { return _capacity; }
+
+private:
+    static constexpr size_t slotSize = (1 + ShmRing::nWords<T>) * sizeof(uint64_t);
+    std::atomic<uint64_t>* getWords() const { return reinterpret_cast<std::atomic<uint64_t>*>(static_cast<char*>(_shm.data()) + ShmRing::headerSize); }
+
+    SharedMemory            _shm;
+    size_t                  _capacity;
+    ShmRing::header*        _header = nullptr;
+};
+
+template <typename T>
+class ShmRingReader
+{
+public:
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    // by default, starts with the next sample that is written. If fromOldest_, starts with the oldest sample still in the ring
+    ShmRingReader(std::unique_ptr<SharedMemory> shm_, const bool fromOldest_ = false) :
+        _shm(std::move(shm_))
+    {
+        if (ShmRing::checkLayout(*_shm) != ShmRing::streamTypeOf<T>())
+            DoExitWithMsg("Titta::cpp::ShmRingReader: shared memory \"" + _shm->getName() + "\" holds a different stream");
+        _header   = static_cast<const ShmRing::header*>(_shm->data());
+        _capacity = _header->capacity;
+        _next     = _header->writeSeq.load(std::memory_order_acquire);
+        if (fromOldest_)
+            _next = _next > _capacity ? _next - _capacity : 0;
+    }
+    explicit ShmRingReader(std::string name_, const bool fromOldest_ = false) :
+        ShmRingReader(std::make_unique<SharedMemory>(std::move(name_)), fromOldest_)
+    {}
+
+    // samples written since the previous call, oldest first, at most NSamp_
+    std::vector<T> read(const size_t NSamp_ = std::numeric_limits<size_t>::max())
+    {
+        std::vector<T> out;
+        auto w = _header->writeSeq.load(std::memory_order_acquire);
+        out.reserve(std::min(static_cast<uint64_t>(NSamp_), std::min(w - _next, _capacity)));
+        while (_next < w && out.size() < NSamp_)
+        {
+            // skip samples the writer already overwrote
+            if (w - _next > _capacity)
+            {
+                _nDropped += w - _capacity - _next;
+                _next      = w - _capacity;
+            }
+
+            const auto slot = getWords() + (_next % _capacity) * (1 + ShmRing::nWords<T>);
+            const auto seq0 = slot[0].load(std::memory_order_acquire);
+            uint64_t words[ShmRing::nWords<T>];
+            for (size_t i = 0; i < ShmRing::nWords<T>; i++)
+                words[i] = slot[1 + i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const auto seq1 = slot[0].load(std::memory_order_relaxed);
+            if (seq0 != 2 * (_next + 1) || seq1 != seq0)
+            {
+                // overwritten while copying, resync with writer
+                w = _header->writeSeq.load(std::memory_order_acquire);
+                if (w - _next <= _capacity)
+                    _nDropped++, _next++;
+                continue;
+            }
+
+            T sample;
+            std::memcpy(static_cast<void*>(&sample), words, sizeof(T));
+            out.push_back(sample);
+            _next++;
+        }
+        return out;
+    }
+
+    static constexpr ShmRing::StreamType getStreamType() { return ShmRing::streamTypeOf<T>(); }
+    // number of samples that were overwritten before they could be read
+    uint64_t getNumDropped() const { return _nDropped; }
+    // whether the writing Titta instance has stopped writing to this ring
+    bool isWriterClosed() const { return _header->writerClosed.load(std::memory_order_acquire) != 0; }
+    const std::string& getName() const { return _shm->getName(); }
+
+private:
+    const std::atomic<uint64_t>* getWords() const { return reinterpret_cast<const std::atomic<uint64_t>*>(static_cast<const char*>(_shm->data()) + ShmRing::headerSize); }
+
+    std::unique_ptr<SharedMemory>   _shm;
+    const ShmRing::header*          _header   = nullptr;
+    uint64_t                        _capacity = 0;
+    uint64_t                        _next     = 0;      // sequence number of next sample to read
+    uint64_t                        _nDropped = 0;
+};
+
+// reader for whatever stream the shared memory region holds
+using AnyShmRingReader = std::variant<
+    ShmRingReader<TobiiTypes::gazeData>,
+    ShmRingReader<TobiiResearchExternalSignalData>,
+    ShmRingReader<TobiiResearchTimeSynchronizationData>,
+    ShmRingReader<TobiiResearchUserPositionGuide>
+>;
+AnyShmRingReader openShmRingReader(std::string name_, bool fromOldest_ = false);
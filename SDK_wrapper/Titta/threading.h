@@ -0,0 +1,64 @@
+#pragma once
+// Scheduling policy, priority, nice value and CPU affinity of the threads
+// Titta owns (calibration, processing pipeline, gaze compression, log sink,
+// replay, eye tracker discovery, eye image decoding and compression, LSL
+// receivers) and of the Tobii SDK threads that call into Titta.
+// Owned threads register themselves for their lifetime (see scope) and
+// settings are applied to them immediately. SDK threads are not under our
+// control, settings are applied to them from within the first callback they
+// make after the settings were changed (see onCallback).
+// On Linux everything is supported (realtime policies need CAP_SYS_NICE or an
+// rtprio limit). On Windows, the policy/priority and nice value are mapped to
+// thread priority levels. On macOS, CPU affinity and nice values are not
+// available per thread.
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstdint>
+
+namespace TittaThreads
+{
+    // unset fields are left unchanged
+    struct settings
+    {
+        std::optional<std::string>      policy;     // "other", "fifo" or "rr"
+        std::optional<int>              priority;   // for "fifo" and "rr", 1-99 on Linux
+        std::optional<int>              nice;       // -20-19
+        std::optional<std::vector<int>> cpus;       // CPUs the thread may run on
+    };
+    // settings of a thread as read back from the operating system
+    struct info
+    {
+        std::string         name;
+        int64_t             id          = 0;        // operating system thread id
+        bool                isSDKThread = false;    // if true, info is as read back when settings were last applied, not current
+        std::string         policy;                 // "other", "fifo", "rr", "batch", "idle", or on Windows "priority"
+        int                 priority    = 0;        // on Windows: thread priority level
+        int                 nice        = 0;
+        std::vector<int>    cpus;
+        std::string         error;                  // why settings could not (all) be applied, empty if successful
+    };
+
+    // validates and stores settings, and applies them to all threads
+    void                    set(settings settings_);
+    std::optional<settings> get();
+    std::vector<info>       getInfo();
+
+    // registers the calling thread under name_ for the lifetime of the object
+    class scope
+    {
+    public:
+        explicit scope(std::string name_);
+        ~scope();
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+    };
+
+    // to be called at the start of each SDK callback, cheap if there is nothing to do.
+    // NB: name_ must be a string literal
+    void onCallback(const char* name_);
+    // to be called when a stream is stopped: forgets the registered SDK threads, as it is
+    // unknown which of them stopped calling in. Those still delivering data register again
+    // on their next callback
+    void onUnsubscribe();
+}
@@ -0,0 +1,90 @@
+#pragma once
+// Low-overhead tracing of where time is spent: callbacks, lock waits and holds
+// per stream, copying of data out of buffers, conversion to MATLAB/Python types
+// and calibration work items. Spans are recorded into a ring buffer per thread
+// and can be retrieved as Chrome trace-event JSON (open in chrome://tracing or
+// https://ui.perfetto.dev).
+// Tracing is compiled in only when TITTA_ENABLE_TRACING is defined, otherwise
+// all of the below compiles away to nothing.
+#include "types.h"
+
+#ifdef TITTA_ENABLE_TRACING
+#include <string>
+#include <cstdint>
+
+#ifndef TITTA_TRACE_RING_SIZE
+#   define TITTA_TRACE_RING_SIZE (1 << 16)     // events per thread, older events are overwritten
+#endif
+
+namespace TittaTrace
+{
+    // ns since tracing epoch
+    int64_t now();
+    // NB: name_ and category_ are stored as pointers, so must be string literals or otherwise outlive the trace
+    void record(const char* name_, const char* category_, int64_t start_, int64_t end_);
+    void setThreadName(const char* name_);
+    // all events recorded since the last clear, as Chrome trace-event JSON
+    std::string getChromeJSON(bool clear_);
+
+    // RAII span
+    class scope
+    {
+    public:
+        scope(const char* name_, const char* category_) : _name(name_), _category(category_), _start(now()) {}
+        ~scope() { record(_name, _category, _start, now()); }
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+    private:
+        const char* _name;
+        const char* _category;
+        int64_t     _start;
+    };
+
+    // lock that records how long it took to acquire, and how long it was held
+    template <typename Lock>
+    class lock : public Lock
+    {
+    public:
+        lock(typename Lock::mutex_type& mutex_, const char* waitName_, const char* holdName_) :
+            Lock(mutex_, std::defer_lock),
+            _holdName(holdName_)
+        {
+            const auto t0 = now();
+            Lock::lock();
+            _acquired = now();
+            record(waitName_, "lock", t0, _acquired);
+        }
+        lock(lock&&) noexcept = default;
+        ~lock()
+        {
+            if (this->owns_lock())
+                record(_holdName, "lock", _acquired, now());
+        }
+        void unlock()
+        {
+            record(_holdName, "lock", _acquired, now());
+            Lock::unlock();
+        }
+    private:
+        const char* _holdName;
+        int64_t     _acquired = 0;
+    };
+}
+
+using traced_read_lock  = TittaTrace::lock<read_lock>;
+using traced_write_lock = TittaTrace::lock<write_lock>;
+
+#define TITTA_TRACE_CONCAT_IMPL(a_, b_) a_##b_
+#define TITTA_TRACE_CONCAT(a_, b_) TITTA_TRACE_CONCAT_IMPL(a_, b_)
+#define TITTA_TRACE_SCOPE(name_, category_) TittaTrace::scope TITTA_TRACE_CONCAT(tittaTraceScope_, __LINE__)(name_, category_)
+#define TITTA_TRACE_THREAD_NAME(name_) TittaTrace::setThreadName(name_)
+
+#else
+
+using traced_read_lock  = read_lock;
+using traced_write_lock = write_lock;
+
+#define TITTA_TRACE_SCOPE(name_, category_)
+#define TITTA_TRACE_THREAD_NAME(name_)
+
+#endif
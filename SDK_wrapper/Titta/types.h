@@ -38,6 +38,15 @@ namespace TobiiTypes
         std::vector<std::string>    supportedModes;
     };
 
+    // eye tracker properties as cached by Titta: fetched from the eye tracker once, then
+    // kept current by the notification stream
+    struct deviceState
+    {
+        eyeTracker                              info;
+        std::optional<TobiiResearchDisplayArea> displayArea;                    // fetched on first use
+        int64_t                                 calibrationChanged  = 0;        // system time stamp of the last calibration changed notification, 0 if none
+    };
+
     // extended gaze data (for merging gaze and eye openness)
     struct gazeOrigin
     {
@@ -132,9 +141,13 @@ namespace TobiiTypes
             region_id(0),
             region_top(0),
             region_left(0),
+            crop_left(0),
+            crop_top(0),
+            downscale(1),
             type(TOBII_RESEARCH_EYE_IMAGE_TYPE_UNKNOWN),
             camera_id(0),
             data_size(0),
+            is_compressed(false),
             _eyeIm({nullptr,std::free})
         {}
         eyeImage(const TobiiResearchEyeImage* e_) :
@@ -148,9 +161,13 @@ namespace TobiiTypes
             region_id(e_->region_id),
             region_top(e_->top),
             region_left(e_->left),
+            crop_left(0),
+            crop_top(0),
+            downscale(1),
             type(e_->type),
             camera_id(e_->camera_id),
             data_size(e_->data_size),
+            is_compressed(false),
             _eyeIm({malloc(e_->data_size),std::free})
         {
             std::memcpy(_eyeIm.get(), e_->data, e_->data_size);
@@ -166,9 +183,13 @@ namespace TobiiTypes
             region_id(e_->region_id),
             region_top(e_->top),
             region_left(e_->left),
+            crop_left(0),
+            crop_top(0),
+            downscale(1),
             type(e_->type),
             camera_id(e_->camera_id),
             data_size(e_->image_size),
+            is_compressed(false),
             _eyeIm({malloc(e_->image_size),std::free})
         {
             std::memcpy(_eyeIm.get(), e_->image_data, e_->image_size);
@@ -185,9 +206,13 @@ namespace TobiiTypes
             region_id(other_.region_id),
             region_top(other_.region_top),
             region_left(other_.region_left),
+            crop_left(other_.crop_left),
+            crop_top(other_.crop_top),
+            downscale(other_.downscale),
             type(other_.type),
             camera_id(other_.camera_id),
             data_size(other_.data_size),
+            is_compressed(other_.is_compressed),
             _eyeIm({malloc(other_.data_size),std::free})
         {
             std::memcpy(_eyeIm.get(), other_.data(), other_.data_size);
@@ -226,9 +251,13 @@ namespace TobiiTypes
             swap(first_.region_id, second_.region_id);
             swap(first_.region_top, second_.region_top);
             swap(first_.region_left, second_.region_left);
+            swap(first_.crop_left, second_.crop_left);
+            swap(first_.crop_top, second_.crop_top);
+            swap(first_.downscale, second_.downscale);
             swap(first_.type, second_.type);
             swap(first_.camera_id, second_.camera_id);
             swap(first_.data_size, second_.data_size);
+            swap(first_.is_compressed, second_.is_compressed);
             swap(first_._eyeIm, second_._eyeIm);
         }
 
@@ -243,9 +272,17 @@ namespace TobiiTypes
         int                         region_id;
         int                         region_top;
         int                         region_left;
+        // if reduced at ingest (see Titta::setEyeImageReduction()): position of the stored image in the image
+        // as received, and the factor by which it was downscaled. The region, type and camera fields are
+        // kept as received, width, height and data_size describe the stored image
+        int                         crop_left;
+        int                         crop_top;
+        int                         downscale;
         TobiiResearchEyeImageType   type;
         int                         camera_id;
         size_t                      data_size;
+        // data is held compressed, see Titta::setEyeImageCompression(). Never the case for images handed out by Titta
+        bool                        is_compressed;
     private:
         std::unique_ptr<void, decltype(std::free)*> _eyeIm;
     };
@@ -389,16 +426,20 @@ namespace TobiiTypes
         Compute,
         GetCalibrationData,
         ApplyCalibrationData,
+        CacheCalibrationData,
+        ApplyCachedCalibrationData,
         Exit
     };
 
     struct CalibrationWorkItem
     {
         CalibrationAction	                action = CalibrationAction::Nothing;
+        uint64_t                            requestId = 0;
         // some actions need one or multiple of the below
         std::optional<std::array<float,2>>  coordinates;
         std::optional<std::string>          eye;
         std::optional<std::vector<uint8_t>> calibrationData;
+        std::optional<std::string>          participant = std::nullopt;  // calibration cache key
     };
 
     struct CalibrationWorkResult
@@ -410,4 +451,110 @@ namespace TobiiTypes
         std::optional<CalibrationResult>    calibrationResult;
         std::optional<std::vector<uint8_t>> calibrationData;
     };
+
+
+    //// latency instrumentation
+    // summary of a latency histogram, all values in microseconds
+    struct latencySummary
+    {
+        uint64_t    count   = 0;
+        int64_t     min     = 0;
+        int64_t     max     = 0;
+        double      mean    = 0.;
+        int64_t     p50     = 0;
+        int64_t     p90     = 0;
+        int64_t     p99     = 0;
+        int64_t     p99_9   = 0;
+    };
+
+    struct latencyStats
+    {
+        latencySummary  ingest;     // from system_time_stamp of sample until it is available in the buffer
+        latencySummary  consume;    // from when sample became available in the buffer until it was consumed
+    };
+
+
+    //// memory governor
+    // memory accounting of a stream, or of all streams together. All sizes in bytes
+    struct memoryUsage
+    {
+        size_t      bytes           = 0;    // held by samples currently in the buffer (including eye image data)
+        size_t      highWaterMark   = 0;    // maximum of bytes since the instance was created
+        size_t      reserved        = 0;    // allocated capacity of the buffer
+        size_t      budget          = 0;    // 0 means unlimited
+        uint64_t    nEvicted        = 0;    // samples dropped to stay within budget
+    };
+    // how the memory of a stream's buffer was allocated
+    struct bufferAllocation
+    {
+        // requested
+        bool        prefault        = false;
+        bool        lock            = false;
+        std::string hugePages       = "none";   // "none", "transparent" or "explicit"
+        // outcome for the buffer's current storage
+        size_t      bytes           = 0;
+        bool        isPrefaulted    = false;
+        bool        isLocked        = false;
+        bool        hasHugePages    = false;
+        std::string error;                      // what could not be done, empty if all succeeded
+    };
+    // reduction applied to eye images at ingest, see Titta::setEyeImageReduction()
+    struct eyeImageReduction
+    {
+        std::string         crop            = "none";   // "none", "fixed" or "pupil"
+        std::array<int, 4>  cropRect        = {};       // left, top, width, height. "pupil" only uses width and height
+        int                 downscale       = 1;
+        size_t              keepEveryN      = 1;
+    };
+    // in-memory compression of eye images, see Titta::setEyeImageCompression(). Counts and times since the last reset
+    struct eyeImageCompressionStats
+    {
+        bool        enabled             = false;
+        size_t      numThreads          = 0;
+        size_t      cacheSize           = 0;    // maximum number of decompressed frames kept
+        uint64_t    nCompressed         = 0;    // frames stored compressed
+        uint64_t    nIncompressible     = 0;    // frames kept as is because compressing them would not save memory
+        size_t      rawBytes            = 0;    // size of the compressed frames before compression
+        size_t      compressedBytes     = 0;    // and after
+        double      ratio               = 0.;   // rawBytes / compressedBytes
+        double      compressTime        = 0.;   // mean time per frame (us), including incompressible frames
+        uint64_t    nDecompressed       = 0;
+        double      decompressTime      = 0.;   // mean time per frame (us)
+        uint64_t    nCacheHits          = 0;    // frames served from the cache of decompressed frames instead
+        size_t      cacheBytes          = 0;    // currently held by the cache
+    };
+
+    //// alignment of external signals to gaze
+    // as-of join of gaze samples with external signal events on system_time_stamp
+    struct gazeExtSignalJoin
+    {
+        std::vector<TobiiTypes::gazeData>               gaze;
+        std::vector<TobiiResearchExternalSignalData>    extSignal;
+        // per gaze sample: index into extSignal of the most recent event at or before the sample, -1 if none
+        std::vector<int64_t>                            extSignalIndex;
+        std::vector<uint32_t>                           extSignalValue;     // value of that event, 0 if none
+        // per external signal event: index into gaze of the sample nearest in time (earliest on ties), -1 if no gaze
+        std::vector<int64_t>                            nearestGazeIndex;
+    };
+
+    //// processing pipeline
+    // sample of a derived stream, values are in the order of the producing stage's channels
+    struct derivedSample
+    {
+        int64_t                 system_time_stamp = 0;
+        std::vector<double>     values;
+    };
+
+    //// multi-stream drain/snapshot
+    // contents of all requested streams up to a common cut-off. Streams that were not requested are left empty
+    struct allStreamsData
+    {
+        int64_t                                                             cutOff = 0; // system_time_stamp, all returned samples are at or before it
+        std::optional<std::vector<TobiiTypes::gazeData>>                    gaze;
+        std::optional<std::vector<TobiiTypes::eyeImage>>                    eyeImage;
+        std::optional<std::vector<TobiiResearchExternalSignalData>>         extSignal;
+        std::optional<std::vector<TobiiResearchTimeSynchronizationData>>    timeSync;
+        std::optional<std::vector<TobiiResearchUserPositionGuide>>          positioning;
+        std::optional<std::vector<TobiiTypes::notification>>                notification;
+    };
 }
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <string>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+
+
+// Small pool of worker threads. Jobs queued with submit() are run in order of
+// submission by whichever worker is free. run() spreads a batch of jobs over the
+// workers and the calling thread, and returns once all of them have completed.
+// Workers register with TittaThreads under the pool's name. All member functions
+// are thread-safe.
+class WorkerPool
+{
+public:
+    explicit WorkerPool(std::string name_);
+    ~WorkerPool();
+
+    void    start(size_t nThreads_);    // restarts with the new number of threads if already running, queued jobs are kept
+    void    stop();                     // waits for running jobs to finish, queued jobs are dropped
+    size_t  getNumThreads() const;
+    size_t  getNumQueued() const;
+
+    // returns false, without running the job, if the pool is not running. job_ is
+    // only moved from if accepted, so that the caller can then run it itself
+    bool    submit(std::function<void()>&& job_);
+    // if the pool is not running, all jobs are run on the calling thread
+    void    run(std::vector<std::function<void()>> jobs_);
+
+private:
+    void    thread(uint64_t generation_);
+
+private:
+    const std::string                   _name;
+    mutable std::mutex                  _mutex;
+    std::deque<std::function<void()>>   _queue;
+    std::condition_variable             _cv;
+    std::vector<std::thread>            _threads;
+    bool                                _running    = false;    // guarded by _mutex
+    uint64_t                            _generation = 0;        // guarded by _mutex, workers of other generations stop
+};
@@ -55,6 +55,8 @@
 #include <atomic>
 #include <cstring>
 #include <cinttypes>
+#include <algorithm>
+#include <cctype>
 
 #include "cpp_mex_helpers/include_matlab.h"
 
@@ -88,6 +90,18 @@ namespace mxTypes
     struct typeNeedsMxCellStorage<TobiiTypes::CalibrationPoint> { static constexpr bool value = false; };
     template <>
     struct typeNeedsMxCellStorage<Titta::notification> { static constexpr bool value = false; };
+    template <>
+    struct typeToMxClass<TittaThreads::info> { static constexpr mxClassID value = mxSTRUCT_CLASS; };
+    template <>
+    struct typeNeedsMxCellStorage<TittaThreads::info> { static constexpr bool value = false; };
+    template <>
+    struct typeToMxClass<EyeTrackerDiscovery::entry> { static constexpr mxClassID value = mxSTRUCT_CLASS; };
+    template <>
+    struct typeNeedsMxCellStorage<EyeTrackerDiscovery::entry> { static constexpr bool value = false; };
+    template <>
+    struct typeToMxClass<EyeTrackerDiscovery::event> { static constexpr mxClassID value = mxSTRUCT_CLASS; };
+    template <>
+    struct typeNeedsMxCellStorage<EyeTrackerDiscovery::event> { static constexpr bool value = false; };
 
     // forward declarations
     template<typename Cont, typename... Fs>
@@ -121,6 +135,19 @@ namespace mxTypes
     mxArray* ToMatlab(TobiiResearchNormalizedPoint2D                    data_);
     mxArray* ToMatlab(std::vector<TobiiResearchCalibrationSample>       data_);
     mxArray* FieldToMatlab(std::vector<TobiiResearchCalibrationSample>  data_, bool rowVector_, TobiiResearchCalibrationEyeData TobiiResearchCalibrationSample::* field_);
+    mxArray* ToMatlab(TobiiTypes::latencyStats                          data_);
+    mxArray* ToMatlab(TobiiTypes::latencySummary                        data_);
+    mxArray* ToMatlab(TobiiTypes::memoryUsage                           data_);
+    mxArray* ToMatlab(TobiiTypes::bufferAllocation                      data_);
+    mxArray* ToMatlab(TobiiTypes::eyeImageReduction                     data_);
+    mxArray* ToMatlab(TobiiTypes::eyeImageCompressionStats              data_);
+    mxArray* ToMatlab(TobiiTypes::allStreamsData                        data_);
+    mxArray* ToMatlab(TobiiTypes::gazeExtSignalJoin                     data_);
+    mxArray* ToMatlab(std::vector<TobiiTypes::derivedSample> data_, const std::vector<std::string>& channels_);
+    mxArray* ToMatlab(std::vector<std::tuple<std::string, std::string>> data_);
+    mxArray* ToMatlab(TittaThreads::info data_, mwIndex idx_ = 0, mwSize size_ = 1, mxArray* storage_ = nullptr);
+    mxArray* ToMatlab(EyeTrackerDiscovery::entry data_, mwIndex idx_ = 0, mwSize size_ = 1, mxArray* storage_ = nullptr);
+    mxArray* ToMatlab(EyeTrackerDiscovery::event data_, mwIndex idx_ = 0, mwSize size_ = 1, mxArray* storage_ = nullptr);
 }
 #include "cpp_mex_helpers/mex_type_utils.h"
 
@@ -143,10 +170,27 @@ namespace {
         GetSystemTimestamp,
         FindAllEyeTrackers,
         GetEyeTrackerFromAddress,
+        // eye tracker discovery
+        StartEyeTrackerDiscovery,
+        StopEyeTrackerDiscovery,
+        IsEyeTrackerDiscoveryRunning,
+        RefreshEyeTrackers,
+        GetDiscoveredEyeTrackers,
+        GetEyeTrackerDiscoveryEvents,
         // logging
         StartLogging,
         GetLog,
         StopLogging,
+        SetLogLevel,
+        GetLogLevel,
+        GetNumDroppedLogMessages,
+        StartLogFile,
+        StopLogFile,
+        // tracing
+        IsTracingEnabled,
+        GetTrace,
+        SetThreadSettings,
+        GetThreadSettings,
         // check functions for dummy mode
         CheckStream,
         CheckBufferSide,
@@ -188,19 +232,86 @@ namespace {
         CalibrationApplyData,
         CalibrationGetStatus,
         CalibrationRetrieveResult,
+        CalibrationWaitForResult,
+        CalibrationStoreInCache,
+        CalibrationApplyCached,
+        AddToCalibrationCache,
+        HasCachedCalibration,
+        GetCachedCalibrations,
+        ClearCalibrationCache,
+        SetCalibrationCacheDirectory,
+        GetCalibrationCacheDirectory,
 
         //// data streams
         HasStream,
         SetIncludeEyeOpennessInGaze,
+        SetCompactGazeStorage,
+        IsCompactGazeStorage,
         Start,
+        SetEyeImageDecoding,
+        GetEyeImageDecoding,
+        SetEyeImageReduction,
+        GetEyeImageReduction,
+        SetEyeImageCompression,
+        GetEyeImageCompressionStats,
         IsRecording,
         ConsumeN,
         ConsumeTimeRange,
         PeekN,
         PeekTimeRange,
+        GetLatest,
+        DrainAll,
+        SnapshotAll,
+        JoinGazeExtSignal,
+        ResampleGaze,
+        StartGazeResampler,
+        GetResampledGaze,
+        IsGazeResamplerRunning,
+        StopGazeResampler,
+        GetPipelineStageTypes,
+        AddPipelineStage,
+        ClearPipeline,
+        GetPipelineStages,
+        GetDerivedStreamChannels,
+        StartPipeline,
+        StopPipeline,
+        IsPipelineRunning,
+        ConsumeDerivedN,
+        ConsumeDerivedTimeRange,
+        PeekDerivedN,
+        PeekDerivedTimeRange,
+        ClearDerived,
         Clear,
         ClearTimeRange,
-        Stop
+        Stop,
+
+        //// latency instrumentation
+        GetLatencyStats,
+
+        //// memory governor
+        GetMemoryUsage,
+        GetTotalMemoryUsage,
+        SetMemoryBudget,
+        SetStreamMemoryBudget,
+        SetEvictionOrder,
+        GetEvictionOrder,
+        SetBufferAllocation,
+        GetBufferAllocation,
+
+        //// shared memory
+        StartSharedMemory,
+        GetSharedMemoryName,
+        StopSharedMemory,
+        OpenSharedMemoryReader,
+        ReadSharedMemory,
+        GetSharedMemoryReaderInfo,
+        CloseSharedMemoryReader,
+
+        //// replay of recorded session
+        IsReplay,
+        SetReplaySpeed,
+        GetReplaySpeed,
+        IsReplayFinished
     };
 
     // Map string (first input argument to mexFunction) to an Action
@@ -216,10 +327,27 @@ namespace {
         { "getSystemTimestamp",             Action::GetSystemTimestamp },
         { "findAllEyeTrackers",             Action::FindAllEyeTrackers },
         { "getEyeTrackerFromAddress",       Action::GetEyeTrackerFromAddress },
+        // eye tracker discovery
+        { "startEyeTrackerDiscovery",       Action::StartEyeTrackerDiscovery },
+        { "stopEyeTrackerDiscovery",        Action::StopEyeTrackerDiscovery },
+        { "isEyeTrackerDiscoveryRunning",   Action::IsEyeTrackerDiscoveryRunning },
+        { "refreshEyeTrackers",             Action::RefreshEyeTrackers },
+        { "getDiscoveredEyeTrackers",       Action::GetDiscoveredEyeTrackers },
+        { "getEyeTrackerDiscoveryEvents",   Action::GetEyeTrackerDiscoveryEvents },
         // logging
         { "startLogging",                   Action::StartLogging },
         { "getLog",                         Action::GetLog },
         { "stopLogging",                    Action::StopLogging },
+        { "setLogLevel",                    Action::SetLogLevel },
+        { "getLogLevel",                    Action::GetLogLevel },
+        { "getNumDroppedLogMessages",       Action::GetNumDroppedLogMessages },
+        { "startLogFile",                   Action::StartLogFile },
+        { "stopLogFile",                    Action::StopLogFile },
+        // tracing
+        { "isTracingEnabled",               Action::IsTracingEnabled },
+        { "getTrace",                       Action::GetTrace },
+        { "setThreadSettings",              Action::SetThreadSettings },
+        { "getThreadSettings",              Action::GetThreadSettings },
         // check functions for dummy mode
         { "checkStream",                    Action::CheckStream },
         { "checkBufferSide",                Action::CheckBufferSide },
@@ -261,19 +389,86 @@ namespace {
         { "calibrationApplyData",           Action::CalibrationApplyData },
         { "calibrationGetStatus",           Action::CalibrationGetStatus },
         { "calibrationRetrieveResult",      Action::CalibrationRetrieveResult },
+        { "calibrationWaitForResult",       Action::CalibrationWaitForResult },
+        { "calibrationStoreInCache",        Action::CalibrationStoreInCache },
+        { "calibrationApplyCached",         Action::CalibrationApplyCached },
+        { "addToCalibrationCache",          Action::AddToCalibrationCache },
+        { "hasCachedCalibration",           Action::HasCachedCalibration },
+        { "getCachedCalibrations",          Action::GetCachedCalibrations },
+        { "clearCalibrationCache",          Action::ClearCalibrationCache },
+        { "setCalibrationCacheDirectory",   Action::SetCalibrationCacheDirectory },
+        { "getCalibrationCacheDirectory",   Action::GetCalibrationCacheDirectory },
 
         //// data streams
         { "hasStream",                      Action::HasStream },
         { "setIncludeEyeOpennessInGaze",    Action::SetIncludeEyeOpennessInGaze },
+        { "setCompactGazeStorage",          Action::SetCompactGazeStorage },
+        { "isCompactGazeStorage",           Action::IsCompactGazeStorage },
         { "start",                          Action::Start },
+        { "setEyeImageDecoding",            Action::SetEyeImageDecoding },
+        { "getEyeImageDecoding",            Action::GetEyeImageDecoding },
+        { "setEyeImageReduction",           Action::SetEyeImageReduction },
+        { "getEyeImageReduction",           Action::GetEyeImageReduction },
+        { "setEyeImageCompression",         Action::SetEyeImageCompression },
+        { "getEyeImageCompressionStats",    Action::GetEyeImageCompressionStats },
         { "isRecording",                    Action::IsRecording },
         { "consumeN",                       Action::ConsumeN },
         { "consumeTimeRange",               Action::ConsumeTimeRange },
         { "peekN",                          Action::PeekN },
         { "peekTimeRange",                  Action::PeekTimeRange },
+        { "getLatest",                      Action::GetLatest },
+        { "drainAll",                       Action::DrainAll },
+        { "snapshotAll",                    Action::SnapshotAll },
+        { "joinGazeExtSignal",              Action::JoinGazeExtSignal },
+        { "resampleGaze",                   Action::ResampleGaze },
+        { "startGazeResampler",             Action::StartGazeResampler },
+        { "getResampledGaze",               Action::GetResampledGaze },
+        { "isGazeResamplerRunning",         Action::IsGazeResamplerRunning },
+        { "stopGazeResampler",              Action::StopGazeResampler },
+        { "getPipelineStageTypes",          Action::GetPipelineStageTypes },
+        { "addPipelineStage",               Action::AddPipelineStage },
+        { "clearPipeline",                  Action::ClearPipeline },
+        { "getPipelineStages",              Action::GetPipelineStages },
+        { "getDerivedStreamChannels",       Action::GetDerivedStreamChannels },
+        { "startPipeline",                  Action::StartPipeline },
+        { "stopPipeline",                   Action::StopPipeline },
+        { "isPipelineRunning",              Action::IsPipelineRunning },
+        { "consumeDerivedN",                Action::ConsumeDerivedN },
+        { "consumeDerivedTimeRange",        Action::ConsumeDerivedTimeRange },
+        { "peekDerivedN",                   Action::PeekDerivedN },
+        { "peekDerivedTimeRange",           Action::PeekDerivedTimeRange },
+        { "clearDerived",                   Action::ClearDerived },
         { "clear",                          Action::Clear },
         { "clearTimeRange",                 Action::ClearTimeRange },
         { "stop",                           Action::Stop },
+
+        //// latency instrumentation
+        { "getLatencyStats",                Action::GetLatencyStats },
+
+        //// memory governor
+        { "getMemoryUsage",                 Action::GetMemoryUsage },
+        { "getTotalMemoryUsage",            Action::GetTotalMemoryUsage },
+        { "setMemoryBudget",                Action::SetMemoryBudget },
+        { "setStreamMemoryBudget",          Action::SetStreamMemoryBudget },
+        { "setEvictionOrder",               Action::SetEvictionOrder },
+        { "getEvictionOrder",               Action::GetEvictionOrder },
+        { "setBufferAllocation",            Action::SetBufferAllocation },
+        { "getBufferAllocation",            Action::GetBufferAllocation },
+
+        //// shared memory
+        { "startSharedMemory",              Action::StartSharedMemory },
+        { "getSharedMemoryName",            Action::GetSharedMemoryName },
+        { "stopSharedMemory",               Action::StopSharedMemory },
+        { "openSharedMemoryReader",         Action::OpenSharedMemoryReader },
+        { "readSharedMemory",               Action::ReadSharedMemory },
+        { "getSharedMemoryReaderInfo",      Action::GetSharedMemoryReaderInfo },
+        { "closeSharedMemoryReader",        Action::CloseSharedMemoryReader },
+
+        //// replay of recorded session
+        { "isReplay",                       Action::IsReplay },
+        { "setReplaySpeed",                 Action::SetReplaySpeed },
+        { "getReplaySpeed",                 Action::GetReplaySpeed },
+        { "isReplayFinished",               Action::IsReplayFinished },
     };
 
 
@@ -300,10 +495,39 @@ namespace {
         return it;
     }
 
+    // table mapping handles to shared memory readers, these do not need a Titta instance
+    std::map<HandleType, AnyShmRingReader> shmReaderTab;
+    std::atomic<HandleType> shmReaderHandleVal = {0};
+    AnyShmRingReader& getShmReader(int nrhs, const mxArray* prhs[])
+    {
+        const auto h = getHandle(nrhs, prhs);
+        auto it = shmReaderTab.find(h);
+        if (it == shmReaderTab.end())
+            throw string_format("No shared memory reader corresponding to handle %u found.", h);
+        return it->second;
+    }
+    Titta::Stream shmStreamTypeToStream(ShmRing::StreamType type_)
+    {
+        switch (type_)
+        {
+        case ShmRing::StreamType::Gaze:
+            return Titta::Stream::Gaze;
+        case ShmRing::StreamType::ExtSignal:
+            return Titta::Stream::ExtSignal;
+        case ShmRing::StreamType::TimeSync:
+            return Titta::Stream::TimeSync;
+        case ShmRing::StreamType::Positioning:
+            break;
+        }
+        return Titta::Stream::Positioning;
+    }
+
     bool registeredAtExit = false;
     void atExitCleanUp()
     {
         instanceTab.clear();
+        shmReaderTab.clear();
+        Titta::stopEyeTrackerDiscovery();
     }
 }
 
@@ -330,6 +554,7 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
         if (it == actionTypeMap.end())
             throw "Unrecognized action (not in actionTypeMap): " + actionStr;
         Action action = it->second;
+        TITTA_TRACE_SCOPE(it->first.c_str(), "mex");
 
         // If action is not "new" or others that don't require a handle, try to locate an existing instance based on input handle
         InstanceMapType::const_iterator instIt;
@@ -337,7 +562,17 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
         if (action != Action::Touch && action != Action::New &&
             action != Action::GetSDKVersion && action != Action::GetSystemTimestamp &&
             action != Action::FindAllEyeTrackers && action != Action::GetEyeTrackerFromAddress &&
+            action != Action::StartEyeTrackerDiscovery && action != Action::StopEyeTrackerDiscovery &&
+            action != Action::IsEyeTrackerDiscoveryRunning && action != Action::RefreshEyeTrackers &&
+            action != Action::GetDiscoveredEyeTrackers && action != Action::GetEyeTrackerDiscoveryEvents &&
             action != Action::StartLogging && action != Action::GetLog && action != Action::StopLogging &&
+            action != Action::SetLogLevel && action != Action::GetLogLevel && action != Action::GetNumDroppedLogMessages &&
+            action != Action::StartLogFile && action != Action::StopLogFile &&
+            action != Action::GetPipelineStageTypes &&
+            action != Action::OpenSharedMemoryReader && action != Action::ReadSharedMemory &&
+            action != Action::GetSharedMemoryReaderInfo && action != Action::CloseSharedMemoryReader &&
+            action != Action::IsTracingEnabled && action != Action::GetTrace &&
+            action != Action::SetThreadSettings && action != Action::GetThreadSettings &&
             action != Action::CheckStream && action != Action::CheckBufferSide &&
             action != Action::GetAllStreamsString && action != Action::GetAllBufferSidesString)
         {
@@ -399,13 +634,70 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
             if (nrhs_ < 2 || !mxIsChar(prhs_[1]))
                 throw "TittaMex: Second argument must be a string.";
 
-            char* address = mxArrayToString(prhs_[1]);
-            auto insResult = instanceTab.insert({ ++handleVal, std::make_shared<ClassType>(address) });
-            mxFree(address);
+            char* cAddress = mxArrayToString(prhs_[1]);
+            std::string address(cAddress);
+            mxFree(cAddress);
 
             plhs_[0] = mxTypes::ToMatlab(Titta::getEyeTrackerFromAddress(address));
             break;
         }
+        case Action::StartEyeTrackerDiscovery:
+        {
+            // get optional input argument
+            std::optional<double> intervalMs;
+            if (nrhs_ > 1 && !mxIsEmpty(prhs_[1]))
+            {
+                if (!mxIsDouble(prhs_[1]) || mxIsComplex(prhs_[1]) || !mxIsScalar(prhs_[1]))
+                    throw "startEyeTrackerDiscovery: Expected first argument to be a double scalar.";
+                intervalMs = *static_cast<double*>(mxGetData(prhs_[1]));
+            }
+
+            Titta::startEyeTrackerDiscovery(intervalMs);
+            break;
+        }
+        case Action::StopEyeTrackerDiscovery:
+        {
+            Titta::stopEyeTrackerDiscovery();
+            break;
+        }
+        case Action::IsEyeTrackerDiscoveryRunning:
+        {
+            plhs_[0] = mxCreateLogicalScalar(Titta::isEyeTrackerDiscoveryRunning());
+            break;
+        }
+        case Action::RefreshEyeTrackers:
+        {
+            // get optional input argument
+            std::optional<bool> wait;
+            if (nrhs_ > 1 && !mxIsEmpty(prhs_[1]))
+            {
+                if (!(mxIsDouble(prhs_[1]) && !mxIsComplex(prhs_[1]) && mxIsScalar(prhs_[1])) && !mxIsLogicalScalar(prhs_[1]))
+                    throw "refreshEyeTrackers: Expected first argument to be a logical scalar.";
+                wait = mxIsLogicalScalarTrue(prhs_[1]);
+            }
+
+            Titta::refreshEyeTrackers(wait);
+            break;
+        }
+        case Action::GetDiscoveredEyeTrackers:
+        {
+            plhs_[0] = mxTypes::ToMatlab(Titta::getDiscoveredEyeTrackers());
+            break;
+        }
+        case Action::GetEyeTrackerDiscoveryEvents:
+        {
+            // get optional input argument
+            std::optional<bool> clearEvents;
+            if (nrhs_ > 1 && !mxIsEmpty(prhs_[1]))
+            {
+                if (!(mxIsDouble(prhs_[1]) && !mxIsComplex(prhs_[1]) && mxIsScalar(prhs_[1])) && !mxIsLogicalScalar(prhs_[1]))
+                    throw "getEyeTrackerDiscoveryEvents: Expected first argument to be a logical scalar.";
+                clearEvents = mxIsLogicalScalarTrue(prhs_[1]);
+            }
+
+            plhs_[0] = mxTypes::ToMatlab(Titta::getEyeTrackerDiscoveryEvents(clearEvents));
+            break;
+        }
         case Action::StartLogging:
         {
             // get optional input argument
@@ -440,6 +732,121 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
         case Action::StopLogging:
             plhs_[0] = mxCreateLogicalScalar(Titta::stopLogging());
             return;
+        case Action::SetLogLevel:
+        {
+            if (nrhs_ < 2 || !mxIsChar(prhs_[1]))
+                throw "setLogLevel: First input must be a log level string (error, warning, information, debug or trace).";
+            char* clevel = mxArrayToString(prhs_[1]);
+            std::string level(clevel);
+            mxFree(clevel);
+
+            // accept both short names (e.g. debug) and the full names used in the log (e.g. TOBII_RESEARCH_LOG_LEVEL_DEBUG)
+            std::string upper = level;
+            std::ranges::transform(upper, upper.begin(), [](const unsigned char c_) { return static_cast<char>(std::toupper(c_)); });
+            std::optional<TobiiResearchLogLevel> logLevel;
+            for (const auto l : { TOBII_RESEARCH_LOG_LEVEL_ERROR, TOBII_RESEARCH_LOG_LEVEL_WARNING, TOBII_RESEARCH_LOG_LEVEL_INFORMATION, TOBII_RESEARCH_LOG_LEVEL_DEBUG, TOBII_RESEARCH_LOG_LEVEL_TRACE })
+                if (const auto name = TobiiResearchLogLevelToString(l); upper == name || "TOBII_RESEARCH_LOG_LEVEL_" + upper == name)
+                    logLevel = l;
+            if (!logLevel)
+                throw "setLogLevel: Log level \"" + level + "\" not understood, expected error, warning, information, debug or trace.";
+
+            Titta::setLogLevel(*logLevel);
+            return;
+        }
+        case Action::GetLogLevel:
+            plhs_[0] = mxTypes::ToMatlab(TobiiResearchLogLevelToString(Titta::getLogLevel()));
+            return;
+        case Action::GetNumDroppedLogMessages:
+            plhs_[0] = mxTypes::ToMatlab(static_cast<double>(Titta::getNumDroppedLogMessages()));
+            return;
+        case Action::StartLogFile:
+        {
+            if (nrhs_ < 2 || !mxIsChar(prhs_[1]))
+                throw "startLogFile: First input must be a file name.";
+            char* cfile = mxArrayToString(prhs_[1]);
+            std::string file(cfile);
+            mxFree(cfile);
+
+            // get optional input arguments
+            std::optional<uint64_t> maxBytes;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!mxIsUint64(prhs_[2]) || mxIsComplex(prhs_[2]) || !mxIsScalar(prhs_[2]))
+                    throw "startLogFile: Expected second argument to be a uint64 scalar.";
+                maxBytes = *static_cast<uint64_t*>(mxGetData(prhs_[2]));
+            }
+            std::optional<size_t> maxFiles;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsUint64(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                    throw "startLogFile: Expected third argument to be a uint64 scalar.";
+                maxFiles = static_cast<size_t>(*static_cast<uint64_t*>(mxGetData(prhs_[3])));
+            }
+
+            Titta::startLogFile(file, maxBytes, maxFiles);
+            return;
+        }
+        case Action::StopLogFile:
+            Titta::stopLogFile();
+            return;
+        case Action::IsTracingEnabled:
+            plhs_[0] = mxCreateLogicalScalar(Titta::isTracingEnabled());
+            return;
+        case Action::GetTrace:
+        {
+            // get optional input argument
+            std::optional<bool> clearTrace;
+            if (nrhs_ > 1 && !mxIsEmpty(prhs_[1]))
+            {
+                if (!(mxIsDouble(prhs_[1]) && !mxIsComplex(prhs_[1]) && mxIsScalar(prhs_[1])) && !mxIsLogicalScalar(prhs_[1]))
+                    throw "getTrace: Expected first argument to be a logical scalar.";
+                clearTrace = mxIsLogicalScalarTrue(prhs_[1]);
+            }
+
+            plhs_[0] = mxTypes::ToMatlab(Titta::getTrace(clearTrace));
+            return;
+        }
+        case Action::SetThreadSettings:
+        {
+            // all inputs optional, empty means leave unchanged
+            std::optional<std::string> policy;
+            if (nrhs_ > 1 && !mxIsEmpty(prhs_[1]))
+            {
+                if (!mxIsChar(prhs_[1]))
+                    throw "setThreadSettings: Expected first argument to be a string.";
+                char* cPolicy = mxArrayToString(prhs_[1]);
+                policy = cPolicy;
+                mxFree(cPolicy);
+            }
+            std::optional<int> priority;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!mxIsNumeric(prhs_[2]) || mxIsComplex(prhs_[2]) || !mxIsScalar(prhs_[2]))
+                    throw "setThreadSettings: Expected second argument to be a numeric scalar.";
+                priority = static_cast<int>(mxGetScalar(prhs_[2]));
+            }
+            std::optional<int> nice;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsNumeric(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                    throw "setThreadSettings: Expected third argument to be a numeric scalar.";
+                nice = static_cast<int>(mxGetScalar(prhs_[3]));
+            }
+            std::optional<std::vector<int>> cpus;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!mxIsDouble(prhs_[4]) || mxIsComplex(prhs_[4]))
+                    throw "setThreadSettings: Expected fourth argument to be a double array.";
+                const auto in = static_cast<double*>(mxGetData(prhs_[4]));
+                cpus.emplace(in, in + mxGetNumberOfElements(prhs_[4]));
+            }
+
+            Titta::setThreadSettings(policy, priority, nice, cpus);
+            return;
+        }
+        case Action::GetThreadSettings:
+            plhs_[0] = mxTypes::ToMatlab(Titta::getThreadSettings());
+            return;
         case Action::CheckStream:
         {
             if (nrhs_ < 2 || !mxIsChar(prhs_[1]))
@@ -522,61 +929,61 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
         }
         case Action::GetDeviceName:
         {
-            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo("deviceName").deviceName);
+            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo().deviceName);
             break;
         }
         case Action::GetSerialNumber:
         {
-            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo("serialNumber").serialNumber);
+            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo().serialNumber);
             break;
         }
         case Action::GetModel:
         {
-            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo("model").model);
+            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo().model);
             break;
         }
         case Action::GetFirmwareVersion:
         {
-            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo("firmwareVersion").firmwareVersion);
+            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo().firmwareVersion);
             break;
         }
         case Action::GetRuntimeVersion:
         {
-            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo("runtimeVersion").runtimeVersion);
+            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo().runtimeVersion);
             break;
         }
         case Action::GetAddress:
         {
-            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo("address").address);
+            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo().address);
             break;
         }
         case Action::GetCapabilities:
         {
-            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo("capabilities").capabilities);
+            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo().capabilities);
             break;
         }
         case Action::GetSupportedFrequencies:
         {
             // return as doubles
             std::vector<double> freqs;
-            for (float f : instance->getEyeTrackerInfo("supportedFrequencies").supportedFrequencies)
+            for (float f : instance->getEyeTrackerInfo().supportedFrequencies)
                 freqs.push_back(static_cast<double>(f));
             plhs_[0] = mxTypes::ToMatlab(freqs);
             break;
         }
         case Action::GetSupportedModes:
         {
-            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo("supportedModes").supportedModes);
+            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo().supportedModes);
             break;
         }
         case Action::GetFrequency:
         {
-            plhs_[0] = mxTypes::ToMatlab(static_cast<double>(instance->getEyeTrackerInfo("frequency").frequency));
+            plhs_[0] = mxTypes::ToMatlab(static_cast<double>(instance->getEyeTrackerInfo().frequency));
             break;
         }
         case Action::GetTrackingMode:
         {
-            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo("trackingMode").trackingMode);
+            plhs_[0] = mxTypes::ToMatlab(instance->getEyeTrackerInfo().trackingMode);
             break;
         }
         case Action::GetDisplayArea:
@@ -698,7 +1105,7 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
                 mxFree(ceye);
             }
 
-            instance->calibrationCollectData(point, eye);
+            plhs_[0] = mxTypes::ToMatlab(static_cast<double>(instance->calibrationCollectData(point, eye)));
             break;
         }
         case Action::CalibrationDiscardData:
@@ -719,17 +1126,17 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
                 mxFree(ceye);
             }
 
-            instance->calibrationDiscardData(point, eye);
+            plhs_[0] = mxTypes::ToMatlab(static_cast<double>(instance->calibrationDiscardData(point, eye)));
             break;
         }
         case Action::CalibrationComputeAndApply:
         {
-            instance->calibrationComputeAndApply();
+            plhs_[0] = mxTypes::ToMatlab(static_cast<double>(instance->calibrationComputeAndApply()));
             break;
         }
         case Action::CalibrationGetData:
         {
-            instance->calibrationGetData();
+            plhs_[0] = mxTypes::ToMatlab(static_cast<double>(instance->calibrationGetData()));
             break;
         }
         case Action::CalibrationApplyData:
@@ -739,7 +1146,7 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
             uint8_t* in = static_cast<uint8_t*>(mxGetData(prhs_[2]));
             std::vector<uint8_t> calData{ in, in + mxGetNumberOfElements(prhs_[2]) };
 
-            instance->calibrationApplyData(calData);
+            plhs_[0] = mxTypes::ToMatlab(static_cast<double>(instance->calibrationApplyData(calData)));
             break;
         }
         case Action::CalibrationGetStatus:
@@ -752,6 +1159,118 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
             plhs_[0] = mxTypes::ToMatlab(instance->calibrationRetrieveResult(true));
             break;
         }
+        case Action::CalibrationWaitForResult:
+        {
+            // get optional input arguments
+            std::optional<uint64_t> requestId;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!mxIsNumeric(prhs_[2]) || mxIsComplex(prhs_[2]) || !mxIsScalar(prhs_[2]) || mxGetScalar(prhs_[2]) < 0)
+                    throw "calibrationWaitForResult: Expected first argument to be a request ID, as returned by the calibration functions.";
+                requestId = static_cast<uint64_t>(mxGetScalar(prhs_[2]));
+            }
+            std::optional<double> timeOut;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsDouble(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                    throw "calibrationWaitForResult: Expected second argument to be a double scalar.";
+                timeOut = *static_cast<double*>(mxGetData(prhs_[3]));
+            }
+
+            // blocks MATLAB until the result is available or the timeout expires, no need to poll
+            plhs_[0] = mxTypes::ToMatlab(instance->calibrationWaitForResult(requestId, timeOut, true));
+            break;
+        }
+        case Action::CalibrationStoreInCache:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+                throw "calibrationStoreInCache: First argument must be a participant label string.";
+            char* cparticipant = mxArrayToString(prhs_[2]);
+            std::string participant(cparticipant);
+            mxFree(cparticipant);
+
+            plhs_[0] = mxTypes::ToMatlab(static_cast<double>(instance->calibrationStoreInCache(participant)));
+            break;
+        }
+        case Action::CalibrationApplyCached:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+                throw "calibrationApplyCached: First argument must be a participant label string.";
+            char* cparticipant = mxArrayToString(prhs_[2]);
+            std::string participant(cparticipant);
+            mxFree(cparticipant);
+
+            plhs_[0] = mxTypes::ToMatlab(static_cast<double>(instance->calibrationApplyCached(participant)));
+            break;
+        }
+        case Action::AddToCalibrationCache:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+                throw "addToCalibrationCache: First argument must be a participant label string.";
+            char* cparticipant = mxArrayToString(prhs_[2]);
+            std::string participant(cparticipant);
+            mxFree(cparticipant);
+            if (nrhs_ < 4 || !mxIsUint8(prhs_[3]) || mxIsComplex(prhs_[3]) || mxIsEmpty(prhs_[3]))
+                throw "addToCalibrationCache: Second argument must be a n-element uint8 array, as returned from calibrationGetData.";
+            uint8_t* in = static_cast<uint8_t*>(mxGetData(prhs_[3]));
+            std::vector<uint8_t> calData{ in, in + mxGetNumberOfElements(prhs_[3]) };
+
+            instance->addToCalibrationCache(participant, calData);
+            break;
+        }
+        case Action::HasCachedCalibration:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+                throw "hasCachedCalibration: First argument must be a participant label string.";
+            char* cparticipant = mxArrayToString(prhs_[2]);
+            std::string participant(cparticipant);
+            mxFree(cparticipant);
+
+            plhs_[0] = mxCreateLogicalScalar(instance->hasCachedCalibration(participant));
+            break;
+        }
+        case Action::GetCachedCalibrations:
+        {
+            plhs_[0] = mxTypes::ToMatlab(instance->getCachedCalibrations());
+            break;
+        }
+        case Action::ClearCalibrationCache:
+        {
+            // get optional input argument
+            std::optional<std::string> participant;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!mxIsChar(prhs_[2]))
+                    throw "clearCalibrationCache: Expected first argument to be a participant label string.";
+                char* cparticipant = mxArrayToString(prhs_[2]);
+                participant = cparticipant;
+                mxFree(cparticipant);
+            }
+
+            instance->clearCalibrationCache(participant);
+            break;
+        }
+        case Action::SetCalibrationCacheDirectory:
+        {
+            // empty input: don't store calibrations on disk
+            std::optional<std::string> directory;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!mxIsChar(prhs_[2]))
+                    throw "setCalibrationCacheDirectory: Expected first argument to be a char array.";
+                char* cdirectory = mxArrayToString(prhs_[2]);
+                directory = cdirectory;
+                mxFree(cdirectory);
+            }
+
+            instance->setCalibrationCacheDirectory(directory);
+            break;
+        }
+        case Action::GetCalibrationCacheDirectory:
+        {
+            plhs_[0] = mxTypes::ToMatlab(instance->getCalibrationCacheDirectory());
+            break;
+        }
 
         case Action::HasStream:
         {
@@ -776,6 +1295,36 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
             plhs_[0] = mxCreateLogicalScalar(instance->setIncludeEyeOpennessInGaze(include));
             break;
         }
+        case Action::SetCompactGazeStorage:
+        {
+            if (nrhs_ < 3 || mxIsEmpty(prhs_[2]) || !mxIsScalar(prhs_[2]) || !mxIsLogicalScalar(prhs_[2]))
+                throw "setCompactGazeStorage: First argument must be a logical scalar.";
+            bool compact = mxIsLogicalScalarTrue(prhs_[2]);
+
+            // get optional input argument
+            std::optional<bool> quantize;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!(mxIsDouble(prhs_[3]) && !mxIsComplex(prhs_[3]) && mxIsScalar(prhs_[3])) && !mxIsLogicalScalar(prhs_[3]))
+                    throw "setCompactGazeStorage: Expected second argument to be a logical scalar.";
+                quantize = mxIsLogicalScalarTrue(prhs_[3]);
+            }
+            std::optional<bool> compressOld;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!(mxIsDouble(prhs_[4]) && !mxIsComplex(prhs_[4]) && mxIsScalar(prhs_[4])) && !mxIsLogicalScalar(prhs_[4]))
+                    throw "setCompactGazeStorage: Expected third argument to be a logical scalar.";
+                compressOld = mxIsLogicalScalarTrue(prhs_[4]);
+            }
+
+            plhs_[0] = mxCreateLogicalScalar(instance->setCompactGazeStorage(compact, quantize, compressOld));
+            break;
+        }
+        case Action::IsCompactGazeStorage:
+        {
+            plhs_[0] = mxCreateLogicalScalar(instance->isCompactGazeStorage());
+            break;
+        }
         case Action::Start:
         {
             if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
@@ -807,6 +1356,113 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
             mxFree(bufferCstr);
             return;
         }
+        case Action::SetEyeImageDecoding:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+                throw "setEyeImageDecoding: First input must be a string ('none', 'ingest' or 'peek').";
+
+            // get optional input argument
+            std::optional<size_t> numThreads;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsUint64(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                    throw "setEyeImageDecoding: Expected second argument to be a uint64 scalar.";
+                numThreads = static_cast<size_t>(*static_cast<uint64_t*>(mxGetData(prhs_[3])));
+            }
+
+            char* cMode = mxArrayToString(prhs_[2]);
+            std::string mode = cMode;
+            mxFree(cMode);
+            instance->setEyeImageDecoding(std::move(mode), numThreads);
+            break;
+        }
+        case Action::GetEyeImageDecoding:
+        {
+            plhs_[0] = ToMatlab(instance->getEyeImageDecoding());
+            break;
+        }
+        case Action::SetEyeImageReduction:
+        {
+            // all inputs optional
+            std::optional<std::string> crop;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!mxIsChar(prhs_[2]))
+                    throw "setEyeImageReduction: Expected first argument to be a string ('none', 'fixed' or 'pupil').";
+                char* cCrop = mxArrayToString(prhs_[2]);
+                crop = cCrop;
+                mxFree(cCrop);
+            }
+            std::optional<std::array<int, 4>> cropRect;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsDouble(prhs_[3]) || mxIsComplex(prhs_[3]) || mxGetNumberOfElements(prhs_[3]) != 4)
+                    throw "setEyeImageReduction: Expected second argument to be a 4-element double array.";
+                const auto in = static_cast<double*>(mxGetData(prhs_[3]));
+                cropRect = { static_cast<int>(in[0]), static_cast<int>(in[1]), static_cast<int>(in[2]), static_cast<int>(in[3]) };
+            }
+            std::optional<int> downscale;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!mxIsNumeric(prhs_[4]) || mxIsComplex(prhs_[4]) || !mxIsScalar(prhs_[4]))
+                    throw "setEyeImageReduction: Expected third argument to be a numeric scalar.";
+                downscale = static_cast<int>(mxGetScalar(prhs_[4]));
+            }
+            std::optional<size_t> keepEveryN;
+            if (nrhs_ > 5 && !mxIsEmpty(prhs_[5]))
+            {
+                if (!mxIsUint64(prhs_[5]) || mxIsComplex(prhs_[5]) || !mxIsScalar(prhs_[5]))
+                    throw "setEyeImageReduction: Expected fourth argument to be a uint64 scalar.";
+                keepEveryN = static_cast<size_t>(*static_cast<uint64_t*>(mxGetData(prhs_[5])));
+            }
+
+            instance->setEyeImageReduction(crop, cropRect, downscale, keepEveryN);
+            break;
+        }
+        case Action::GetEyeImageReduction:
+        {
+            plhs_[0] = ToMatlab(instance->getEyeImageReduction());
+            break;
+        }
+        case Action::SetEyeImageCompression:
+        {
+            if (nrhs_ < 3 || mxIsEmpty(prhs_[2]) || !mxIsScalar(prhs_[2]) || !mxIsLogicalScalar(prhs_[2]))
+                throw "setEyeImageCompression: First argument must be a logical scalar.";
+            const bool compress = mxIsLogicalScalarTrue(prhs_[2]);
+
+            // get optional input arguments
+            std::optional<size_t> numThreads;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsUint64(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                    throw "setEyeImageCompression: Expected second argument to be a uint64 scalar.";
+                numThreads = static_cast<size_t>(*static_cast<uint64_t*>(mxGetData(prhs_[3])));
+            }
+            std::optional<size_t> cacheSize;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!mxIsUint64(prhs_[4]) || mxIsComplex(prhs_[4]) || !mxIsScalar(prhs_[4]))
+                    throw "setEyeImageCompression: Expected third argument to be a uint64 scalar.";
+                cacheSize = static_cast<size_t>(*static_cast<uint64_t*>(mxGetData(prhs_[4])));
+            }
+
+            instance->setEyeImageCompression(compress, numThreads, cacheSize);
+            break;
+        }
+        case Action::GetEyeImageCompressionStats:
+        {
+            // get optional input argument
+            std::optional<bool> reset;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!(mxIsDouble(prhs_[2]) && !mxIsComplex(prhs_[2]) && mxIsScalar(prhs_[2])) && !mxIsLogicalScalar(prhs_[2]))
+                    throw "getEyeImageCompressionStats: Expected first argument to be a logical scalar.";
+                reset = mxIsLogicalScalarTrue(prhs_[2]);
+            }
+
+            plhs_[0] = ToMatlab(instance->getEyeImageCompressionStats(reset));
+            break;
+        }
         case Action::IsRecording:
         {
             if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
@@ -1045,31 +1701,380 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
                 return;
             }
         }
-        case Action::Clear:
+        case Action::GetLatest:
         {
             if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
             {
-                std::string err = "clear: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
+                std::string err = "getLatest: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
                 throw err;
             }
 
-            // get data stream identifier string, clear buffer
+            // get data stream identifier string
             char* bufferCstr = mxArrayToString(prhs_[2]);
-            instance->clear(bufferCstr);
+            Titta::Stream stream = instance->stringToStream(bufferCstr);
             mxFree(bufferCstr);
-            break;
-        }
-        case Action::ClearTimeRange:
-        {
-            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+
+            // output in same format as peekN, empty if nothing received yet
+            auto toVec = []<typename T>(std::optional<T> sample_) { return sample_ ? std::vector<T>{std::move(*sample_)} : std::vector<T>{}; };
+            switch (stream)
             {
-                std::string err = "clearTimeRange: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
-                throw err;
+            case Titta::Stream::Gaze:
+            case Titta::Stream::EyeOpenness:
+                plhs_[0] = mxTypes::ToMatlab(toVec(instance->getLatest<Titta::gaze>()));
+                return;
+            case Titta::Stream::EyeImage:
+                plhs_[0] = mxTypes::ToMatlab(toVec(instance->getLatest<Titta::eyeImage>()));
+                return;
+            case Titta::Stream::ExtSignal:
+                plhs_[0] = mxTypes::ToMatlab(toVec(instance->getLatest<Titta::extSignal>()));
+                return;
+            case Titta::Stream::TimeSync:
+                plhs_[0] = mxTypes::ToMatlab(toVec(instance->getLatest<Titta::timeSync>()));
+                return;
+            case Titta::Stream::Positioning:
+                plhs_[0] = mxTypes::ToMatlab(toVec(instance->getLatest<Titta::positioning>()));
+                return;
+            case Titta::Stream::Notification:
+                plhs_[0] = mxTypes::ToMatlab(toVec(instance->getLatest<Titta::notification>()));
+                return;
             }
+        }
+        case Action::DrainAll:
+        case Action::SnapshotAll:
+        {
+            const std::string func = action == Action::DrainAll ? "drainAll" : "snapshotAll";
 
             // get optional input arguments
-            std::optional<int64_t> timeStart;
-            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            std::optional<std::vector<std::string>> streams;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!mxIsCell(prhs_[2]))
+                    throw func + ": Expected first argument to be a cell array of data stream identifier strings.";
+                streams.emplace();
+                const auto nElem = static_cast<mwIndex>(mxGetNumberOfElements(prhs_[2]));
+                for (mwIndex i = 0; i < nElem; i++)
+                {
+                    mxArray* cellElement = mxGetCell(prhs_[2], i);
+                    if (!cellElement || !mxIsChar(cellElement))
+                        throw func + ": All cells should contain a data stream identifier string.";
+                    char* bufferCstr = mxArrayToString(cellElement);
+                    streams->emplace_back(bufferCstr);
+                    mxFree(bufferCstr);
+                }
+            }
+            std::optional<int64_t> timeStart;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsInt64(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                    throw func + ": Expected second argument to be a int64 scalar.";
+                timeStart = *static_cast<int64_t*>(mxGetData(prhs_[3]));
+            }
+            std::optional<int64_t> cutOff;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!mxIsInt64(prhs_[4]) || mxIsComplex(prhs_[4]) || !mxIsScalar(prhs_[4]))
+                    throw func + ": Expected third argument to be a int64 scalar.";
+                cutOff = *static_cast<int64_t*>(mxGetData(prhs_[4]));
+            }
+
+            TobiiTypes::allStreamsData data;
+            if (streams)
+                data = action == Action::DrainAll ? instance->drainAll(std::move(*streams), timeStart, cutOff) : instance->snapshotAll(std::move(*streams), timeStart, cutOff);
+            else
+                data = action == Action::DrainAll ? instance->drainAll(std::nullopt, timeStart, cutOff) : instance->snapshotAll(std::nullopt, timeStart, cutOff);
+            plhs_[0] = mxTypes::ToMatlab(std::move(data));
+            return;
+        }
+        case Action::JoinGazeExtSignal:
+        {
+            // get optional input arguments
+            std::optional<int64_t> timeStart;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!mxIsInt64(prhs_[2]) || mxIsComplex(prhs_[2]) || !mxIsScalar(prhs_[2]))
+                    throw "joinGazeExtSignal: Expected first argument to be a int64 scalar.";
+                timeStart = *static_cast<int64_t*>(mxGetData(prhs_[2]));
+            }
+            std::optional<int64_t> timeEnd;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsInt64(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                    throw "joinGazeExtSignal: Expected second argument to be a int64 scalar.";
+                timeEnd = *static_cast<int64_t*>(mxGetData(prhs_[3]));
+            }
+
+            plhs_[0] = mxTypes::ToMatlab(instance->joinGazeExtSignal(timeStart, timeEnd));
+            return;
+        }
+        case Action::ResampleGaze:
+        {
+            if (nrhs_ < 3 || mxIsEmpty(prhs_[2]) || !mxIsDouble(prhs_[2]) || mxIsComplex(prhs_[2]) || !mxIsScalar(prhs_[2]))
+                throw "resampleGaze: Expected first argument to be a double scalar.";
+            const auto frequency = *static_cast<double*>(mxGetData(prhs_[2]));
+
+            // get optional input arguments
+            std::optional<int64_t> timeStart;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsInt64(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                    throw "resampleGaze: Expected second argument to be a int64 scalar.";
+                timeStart = *static_cast<int64_t*>(mxGetData(prhs_[3]));
+            }
+            std::optional<int64_t> timeEnd;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!mxIsInt64(prhs_[4]) || mxIsComplex(prhs_[4]) || !mxIsScalar(prhs_[4]))
+                    throw "resampleGaze: Expected third argument to be a int64 scalar.";
+                timeEnd = *static_cast<int64_t*>(mxGetData(prhs_[4]));
+            }
+            std::optional<int64_t> maxGap;
+            if (nrhs_ > 5 && !mxIsEmpty(prhs_[5]))
+            {
+                if (!mxIsInt64(prhs_[5]) || mxIsComplex(prhs_[5]) || !mxIsScalar(prhs_[5]))
+                    throw "resampleGaze: Expected fourth argument to be a int64 scalar.";
+                maxGap = *static_cast<int64_t*>(mxGetData(prhs_[5]));
+            }
+            std::optional<GazeResampler::Method> method;
+            if (nrhs_ > 6 && !mxIsEmpty(prhs_[6]))
+            {
+                if (!mxIsChar(prhs_[6]))
+                    throw "resampleGaze: Expected fifth argument to be a string (\"linear\" or \"cubic\").";
+                char* bufferCstr = mxArrayToString(prhs_[6]);
+                method = GazeResampler::stringToMethod(bufferCstr);
+                mxFree(bufferCstr);
+            }
+
+            plhs_[0] = mxTypes::ToMatlab(instance->resampleGaze(frequency, timeStart, timeEnd, maxGap, method));
+            return;
+        }
+        case Action::StartGazeResampler:
+        {
+            if (nrhs_ < 3 || mxIsEmpty(prhs_[2]) || !mxIsDouble(prhs_[2]) || mxIsComplex(prhs_[2]) || !mxIsScalar(prhs_[2]))
+                throw "startGazeResampler: Expected first argument to be a double scalar.";
+            const auto frequency = *static_cast<double*>(mxGetData(prhs_[2]));
+
+            // get optional input arguments
+            std::optional<int64_t> maxGap;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsInt64(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                    throw "startGazeResampler: Expected second argument to be a int64 scalar.";
+                maxGap = *static_cast<int64_t*>(mxGetData(prhs_[3]));
+            }
+            std::optional<GazeResampler::Method> method;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!mxIsChar(prhs_[4]))
+                    throw "startGazeResampler: Expected third argument to be a string (\"linear\" or \"cubic\").";
+                char* bufferCstr = mxArrayToString(prhs_[4]);
+                method = GazeResampler::stringToMethod(bufferCstr);
+                mxFree(bufferCstr);
+            }
+            std::optional<int64_t> gridStart;
+            if (nrhs_ > 5 && !mxIsEmpty(prhs_[5]))
+            {
+                if (!mxIsInt64(prhs_[5]) || mxIsComplex(prhs_[5]) || !mxIsScalar(prhs_[5]))
+                    throw "startGazeResampler: Expected fourth argument to be a int64 scalar.";
+                gridStart = *static_cast<int64_t*>(mxGetData(prhs_[5]));
+            }
+
+            instance->startGazeResampler(frequency, maxGap, method, gridStart);
+            break;
+        }
+        case Action::GetResampledGaze:
+        {
+            plhs_[0] = mxTypes::ToMatlab(instance->getResampledGaze());
+            break;
+        }
+        case Action::IsGazeResamplerRunning:
+        {
+            plhs_[0] = mxCreateLogicalScalar(instance->isGazeResamplerRunning());
+            break;
+        }
+        case Action::StopGazeResampler:
+        {
+            plhs_[0] = mxTypes::ToMatlab(instance->stopGazeResampler());
+            break;
+        }
+        case Action::GetPipelineStageTypes:
+        {
+            plhs_[0] = mxTypes::ToMatlab(Titta::getPipelineStageTypes());
+            return;
+        }
+        case Action::AddPipelineStage:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+                throw "addPipelineStage: First input must be a stage name string.";
+            if (nrhs_ < 4 || !mxIsChar(prhs_[3]))
+                throw "addPipelineStage: Second input must be a stage type string.";
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            std::string name(bufferCstr);
+            mxFree(bufferCstr);
+            bufferCstr = mxArrayToString(prhs_[3]);
+            std::string type(bufferCstr);
+            mxFree(bufferCstr);
+
+            // get optional input arguments
+            std::optional<GazePipeline::params> params;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!mxIsStruct(prhs_[4]) || !mxIsScalar(prhs_[4]))
+                    throw "addPipelineStage: Expected third argument to be a scalar struct with a double scalar for each stage parameter.";
+                params.emplace();
+                const auto nFields = mxGetNumberOfFields(prhs_[4]);
+                for (int i = 0; i < nFields; i++)
+                {
+                    const mxArray* field = mxGetFieldByNumber(prhs_[4], 0, i);
+                    if (!field || !mxIsDouble(field) || mxIsComplex(field) || !mxIsScalar(field))
+                        throw "addPipelineStage: Expected third argument to be a scalar struct with a double scalar for each stage parameter.";
+                    params->emplace(mxGetFieldNameByNumber(prhs_[4], i), *static_cast<double*>(mxGetData(field)));
+                }
+            }
+
+            instance->addPipelineStage(std::move(name), std::move(type), params);
+            break;
+        }
+        case Action::ClearPipeline:
+        {
+            instance->clearPipeline();
+            break;
+        }
+        case Action::GetPipelineStages:
+        {
+            plhs_[0] = mxTypes::ToMatlab(instance->getPipelineStages());
+            break;
+        }
+        case Action::GetDerivedStreamChannels:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+                throw "getDerivedStreamChannels: First input must be a stage name string.";
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            std::string name(bufferCstr);
+            mxFree(bufferCstr);
+            plhs_[0] = mxTypes::ToMatlab(instance->getDerivedStreamChannels(name));
+            break;
+        }
+        case Action::StartPipeline:
+        {
+            instance->startPipeline();
+            break;
+        }
+        case Action::StopPipeline:
+        {
+            instance->stopPipeline();
+            break;
+        }
+        case Action::IsPipelineRunning:
+        {
+            plhs_[0] = mxCreateLogicalScalar(instance->isPipelineRunning());
+            break;
+        }
+        case Action::ConsumeDerivedN:
+        case Action::PeekDerivedN:
+        {
+            const auto funcName = action == Action::ConsumeDerivedN ? std::string("consumeDerivedN") : std::string("peekDerivedN");
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+                throw funcName + ": First input must be a stage name string.";
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            std::string name(bufferCstr);
+            mxFree(bufferCstr);
+
+            // get optional input arguments
+            std::optional<size_t> nSamp;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsUint64(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                    throw funcName + ": Expected second argument to be a uint64 scalar.";
+                auto temp = *static_cast<uint64_t*>(mxGetData(prhs_[3]));
+                if (temp > SIZE_MAX)
+                    throw funcName + ": Requesting preallocated buffer of a larger size than is possible on a 32bit platform.";
+                nSamp = static_cast<size_t>(temp);
+            }
+            std::optional<Titta::BufferSide> side;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!mxIsChar(prhs_[4]))
+                    throw funcName + ": Third input must be a buffer side identifier string (" + Titta::getAllBufferSidesString("'") + ").";
+                bufferCstr = mxArrayToString(prhs_[4]);
+                side = instance->stringToBufferSide(bufferCstr);
+                mxFree(bufferCstr);
+            }
+
+            auto channels = instance->getDerivedStreamChannels(name);
+            if (action == Action::ConsumeDerivedN)
+                plhs_[0] = mxTypes::ToMatlab(instance->consumeDerivedN(name, nSamp, side), channels);
+            else
+                plhs_[0] = mxTypes::ToMatlab(instance->peekDerivedN(name, nSamp, side), channels);
+            break;
+        }
+        case Action::ConsumeDerivedTimeRange:
+        case Action::PeekDerivedTimeRange:
+        {
+            const auto funcName = action == Action::ConsumeDerivedTimeRange ? std::string("consumeDerivedTimeRange") : std::string("peekDerivedTimeRange");
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+                throw funcName + ": First input must be a stage name string.";
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            std::string name(bufferCstr);
+            mxFree(bufferCstr);
+
+            // get optional input arguments
+            std::optional<int64_t> timeStart;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!mxIsInt64(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                    throw funcName + ": Expected second argument to be a int64 scalar.";
+                timeStart = *static_cast<int64_t*>(mxGetData(prhs_[3]));
+            }
+            std::optional<int64_t> timeEnd;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!mxIsInt64(prhs_[4]) || mxIsComplex(prhs_[4]) || !mxIsScalar(prhs_[4]))
+                    throw funcName + ": Expected third argument to be a int64 scalar.";
+                timeEnd = *static_cast<int64_t*>(mxGetData(prhs_[4]));
+            }
+
+            auto channels = instance->getDerivedStreamChannels(name);
+            if (action == Action::ConsumeDerivedTimeRange)
+                plhs_[0] = mxTypes::ToMatlab(instance->consumeDerivedTimeRange(name, timeStart, timeEnd), channels);
+            else
+                plhs_[0] = mxTypes::ToMatlab(instance->peekDerivedTimeRange(name, timeStart, timeEnd), channels);
+            break;
+        }
+        case Action::ClearDerived:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+                throw "clearDerived: First input must be a stage name string.";
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            std::string name(bufferCstr);
+            mxFree(bufferCstr);
+            instance->clearDerived(name);
+            break;
+        }
+        case Action::Clear:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+            {
+                std::string err = "clear: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
+                throw err;
+            }
+
+            // get data stream identifier string, clear buffer
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            instance->clear(bufferCstr);
+            mxFree(bufferCstr);
+            break;
+        }
+        case Action::ClearTimeRange:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+            {
+                std::string err = "clearTimeRange: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
+                throw err;
+            }
+
+            // get optional input arguments
+            std::optional<int64_t> timeStart;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
             {
                 if (!mxIsInt64(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
                     throw "clearTimeRange: Expected second argument to be a int64 scalar.";
@@ -1113,6 +2118,287 @@ void mexFunction(int nlhs_, mxArray *plhs_[], int nrhs_, const mxArray *prhs_[])
             break;
         }
 
+        case Action::GetLatencyStats:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+            {
+                std::string err = "getLatencyStats: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
+                throw err;
+            }
+
+            // get optional input argument
+            std::optional<bool> reset;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!(mxIsDouble(prhs_[3]) && !mxIsComplex(prhs_[3]) && mxIsScalar(prhs_[3])) && !mxIsLogicalScalar(prhs_[3]))
+                    throw "getLatencyStats: Expected second argument to be a logical scalar.";
+                reset = mxIsLogicalScalarTrue(prhs_[3]);
+            }
+
+            // get data stream identifier string, get stats
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            plhs_[0] = mxTypes::ToMatlab(instance->getLatencyStats(bufferCstr, reset));
+            mxFree(bufferCstr);
+            break;
+        }
+
+        case Action::GetMemoryUsage:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+            {
+                std::string err = "getMemoryUsage: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
+                throw err;
+            }
+
+            // get data stream identifier string, get memory usage
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            plhs_[0] = mxTypes::ToMatlab(instance->getMemoryUsage(bufferCstr));
+            mxFree(bufferCstr);
+            break;
+        }
+        case Action::GetTotalMemoryUsage:
+        {
+            plhs_[0] = mxTypes::ToMatlab(instance->getTotalMemoryUsage());
+            break;
+        }
+        case Action::SetMemoryBudget:
+        {
+            if (nrhs_ < 3 || mxIsEmpty(prhs_[2]) || !mxIsUint64(prhs_[2]) || mxIsComplex(prhs_[2]) || !mxIsScalar(prhs_[2]))
+                throw "setMemoryBudget: Expected first argument to be a uint64 scalar.";
+            instance->setMemoryBudget(static_cast<size_t>(*static_cast<uint64_t*>(mxGetData(prhs_[2]))));
+            break;
+        }
+        case Action::SetStreamMemoryBudget:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+            {
+                std::string err = "setStreamMemoryBudget: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
+                throw err;
+            }
+            if (nrhs_ < 4 || mxIsEmpty(prhs_[3]) || !mxIsUint64(prhs_[3]) || mxIsComplex(prhs_[3]) || !mxIsScalar(prhs_[3]))
+                throw "setStreamMemoryBudget: Expected second argument to be a uint64 scalar.";
+            const auto bytes = static_cast<size_t>(*static_cast<uint64_t*>(mxGetData(prhs_[3])));
+
+            // get data stream identifier string, set budget
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            instance->setStreamMemoryBudget(bufferCstr, bytes);
+            mxFree(bufferCstr);
+            break;
+        }
+        case Action::SetEvictionOrder:
+        {
+            if (nrhs_ < 3 || !mxIsCell(prhs_[2]))
+                throw "setEvictionOrder: Expected first argument to be a cell array of data stream identifier strings.";
+
+            std::vector<std::string> streams;
+            const auto nElem = static_cast<mwIndex>(mxGetNumberOfElements(prhs_[2]));
+            for (mwIndex i = 0; i < nElem; i++)
+            {
+                mxArray* cellElement = mxGetCell(prhs_[2], i);
+                if (!cellElement || !mxIsChar(cellElement))
+                    throw "setEvictionOrder: All cells should contain a data stream identifier string.";
+                char* bufferCstr = mxArrayToString(cellElement);
+                streams.emplace_back(bufferCstr);
+                mxFree(bufferCstr);
+            }
+
+            instance->setEvictionOrder(streams);
+            break;
+        }
+        case Action::GetEvictionOrder:
+        {
+            plhs_[0] = mxTypes::ToMatlab(instance->getEvictionOrder());
+            break;
+        }
+        case Action::SetBufferAllocation:
+        {
+            // get optional input arguments
+            std::optional<bool> prefault;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!(mxIsDouble(prhs_[2]) && !mxIsComplex(prhs_[2]) && mxIsScalar(prhs_[2])) && !mxIsLogicalScalar(prhs_[2]))
+                    throw "setBufferAllocation: Expected first argument to be a logical scalar.";
+                prefault = mxIsLogicalScalarTrue(prhs_[2]);
+            }
+            std::optional<bool> lock;
+            if (nrhs_ > 3 && !mxIsEmpty(prhs_[3]))
+            {
+                if (!(mxIsDouble(prhs_[3]) && !mxIsComplex(prhs_[3]) && mxIsScalar(prhs_[3])) && !mxIsLogicalScalar(prhs_[3]))
+                    throw "setBufferAllocation: Expected second argument to be a logical scalar.";
+                lock = mxIsLogicalScalarTrue(prhs_[3]);
+            }
+            std::optional<std::string> hugePages;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!mxIsChar(prhs_[4]))
+                    throw "setBufferAllocation: Expected third argument to be a string.";
+                char* cHugePages = mxArrayToString(prhs_[4]);
+                hugePages = cHugePages;
+                mxFree(cHugePages);
+            }
+
+            instance->setBufferAllocation(prefault, lock, hugePages);
+            break;
+        }
+        case Action::GetBufferAllocation:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+            {
+                std::string err = "getBufferAllocation: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
+                throw err;
+            }
+
+            // get data stream identifier string, get allocation info
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            plhs_[0] = mxTypes::ToMatlab(instance->getBufferAllocation(bufferCstr));
+            mxFree(bufferCstr);
+            break;
+        }
+
+        case Action::StartSharedMemory:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+            {
+                std::string err = "startSharedMemory: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
+                throw err;
+            }
+            if (nrhs_ < 4 || !mxIsChar(prhs_[3]))
+                throw "startSharedMemory: Second input must be a shared memory name string.";
+
+            // get optional input argument
+            std::optional<size_t> capacity;
+            if (nrhs_ > 4 && !mxIsEmpty(prhs_[4]))
+            {
+                if (!mxIsUint64(prhs_[4]) || mxIsComplex(prhs_[4]) || !mxIsScalar(prhs_[4]))
+                    throw "startSharedMemory: Expected third argument to be a uint64 scalar.";
+                capacity = static_cast<size_t>(*static_cast<uint64_t*>(mxGetData(prhs_[4])));
+            }
+
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            char* nameCstr   = mxArrayToString(prhs_[3]);
+            std::string stream(bufferCstr), name(nameCstr);
+            mxFree(bufferCstr);
+            mxFree(nameCstr);
+            instance->startSharedMemory(std::move(stream), std::move(name), capacity);
+            break;
+        }
+        case Action::GetSharedMemoryName:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+            {
+                std::string err = "getSharedMemoryName: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
+                throw err;
+            }
+
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            std::string stream(bufferCstr);
+            mxFree(bufferCstr);
+            if (const auto name = instance->getSharedMemoryName(std::move(stream)))
+                plhs_[0] = mxTypes::ToMatlab(*name);
+            else
+                plhs_[0] = mxCreateDoubleMatrix(0, 0, mxREAL);
+            break;
+        }
+        case Action::StopSharedMemory:
+        {
+            if (nrhs_ < 3 || !mxIsChar(prhs_[2]))
+            {
+                std::string err = "stopSharedMemory: First input must be a data stream identifier string (" + Titta::getAllStreamsString("'") + ").";
+                throw err;
+            }
+
+            char* bufferCstr = mxArrayToString(prhs_[2]);
+            std::string stream(bufferCstr);
+            mxFree(bufferCstr);
+            instance->stopSharedMemory(std::move(stream));
+            break;
+        }
+        case Action::OpenSharedMemoryReader:
+        {
+            if (nrhs_ < 2 || !mxIsChar(prhs_[1]))
+                throw "openSharedMemoryReader: First input must be a shared memory name string.";
+
+            // get optional input argument
+            bool fromOldest = false;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!(mxIsDouble(prhs_[2]) && !mxIsComplex(prhs_[2]) && mxIsScalar(prhs_[2])) && !mxIsLogicalScalar(prhs_[2]))
+                    throw "openSharedMemoryReader: Expected second argument to be a logical scalar.";
+                fromOldest = mxIsLogicalScalarTrue(prhs_[2]) || (mxIsDouble(prhs_[2]) && *static_cast<double*>(mxGetData(prhs_[2])) != 0.);
+            }
+
+            char* nameCstr = mxArrayToString(prhs_[1]);
+            std::string name(nameCstr);
+            mxFree(nameCstr);
+            auto insResult = shmReaderTab.emplace(++shmReaderHandleVal, openShmRingReader(std::move(name), fromOldest));
+            mexLock(); // add to the lock count
+
+            // return the handle
+            plhs_[0] = mxTypes::ToMatlab(insResult.first->first);
+            break;
+        }
+        case Action::ReadSharedMemory:
+        {
+            auto& reader = getShmReader(nrhs_, prhs_);
+
+            // get optional input argument
+            std::optional<size_t> nSamp;
+            if (nrhs_ > 2 && !mxIsEmpty(prhs_[2]))
+            {
+                if (!mxIsUint64(prhs_[2]) || mxIsComplex(prhs_[2]) || !mxIsScalar(prhs_[2]))
+                    throw "readSharedMemory: Expected second argument to be a uint64 scalar.";
+                nSamp = static_cast<size_t>(*static_cast<uint64_t*>(mxGetData(prhs_[2])));
+            }
+
+            plhs_[0] = std::visit([&](auto& r_) { return nSamp ? mxTypes::ToMatlab(r_.read(*nSamp)) : mxTypes::ToMatlab(r_.read()); }, reader);
+            break;
+        }
+        case Action::GetSharedMemoryReaderInfo:
+        {
+            auto& reader = getShmReader(nrhs_, prhs_);
+
+            const char* fieldNames[] = {"name","stream","numDropped","isWriterClosed"};
+            plhs_[0] = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+            std::visit([&](const auto& r_)
+            {
+                mxSetFieldByNumber(plhs_[0], 0, 0, mxTypes::ToMatlab(r_.getName()));
+                mxSetFieldByNumber(plhs_[0], 0, 1, mxTypes::ToMatlab(Titta::streamToString(shmStreamTypeToStream(r_.getStreamType()))));
+                mxSetFieldByNumber(plhs_[0], 0, 2, mxTypes::ToMatlab(r_.getNumDropped()));
+                mxSetFieldByNumber(plhs_[0], 0, 3, mxCreateLogicalScalar(r_.isWriterClosed()));
+            }, reader);
+            break;
+        }
+        case Action::CloseSharedMemoryReader:
+        {
+            const auto h = getHandle(nrhs_, prhs_);
+            if (shmReaderTab.erase(h))
+                mexUnlock();
+            break;
+        }
+
+        case Action::IsReplay:
+        {
+            plhs_[0] = mxCreateLogicalScalar(instance->isReplay());
+            break;
+        }
+        case Action::SetReplaySpeed:
+        {
+            if (nrhs_ < 3 || mxIsEmpty(prhs_[2]) || !mxIsDouble(prhs_[2]) || mxIsComplex(prhs_[2]) || !mxIsScalar(prhs_[2]))
+                throw "setReplaySpeed: Expected first argument to be a double scalar.";
+            instance->setReplaySpeed(*static_cast<double*>(mxGetData(prhs_[2])));
+            break;
+        }
+        case Action::GetReplaySpeed:
+        {
+            plhs_[0] = mxTypes::ToMatlab(instance->getReplaySpeed());
+            break;
+        }
+        case Action::IsReplayFinished:
+        {
+            plhs_[0] = mxCreateLogicalScalar(instance->isReplayFinished());
+            break;
+        }
+
         default:
             throw "Unhandled action: " + actionStr;
             break;
@@ -1318,6 +2604,7 @@ namespace mxTypes
 
     mxArray* ToMatlab(std::vector<Titta::gaze> data_)
     {
+        TITTA_TRACE_SCOPE("ToMatlab gaze", "conversion");
         const char* fieldNames[] = {"deviceTimeStamp","systemTimeStamp","left","right"};
         mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
 
@@ -1385,6 +2672,7 @@ namespace mxTypes
 
     mxArray* ToMatlab(std::vector<Titta::eyeImage> data_)
     {
+        TITTA_TRACE_SCOPE("ToMatlab eyeImage", "conversion");
         // check if all gif, then don't output unneeded fields
         bool allGif = allEquals(data_, &Titta::eyeImage::is_gif, true);
 
@@ -1397,7 +2685,7 @@ namespace mxTypes
         }
         else
         {
-            const char* fieldNames[] = {"deviceTimeStamp","systemTimeStamp","regionID","regionTop","regionLeft","bitsPerPixel","paddingPerPixel","width","height","type","cameraID","isGif","image"};
+            const char* fieldNames[] = {"deviceTimeStamp","systemTimeStamp","regionID","regionTop","regionLeft","bitsPerPixel","paddingPerPixel","width","height","cropLeft","cropTop","downscale","type","cameraID","isGif","image"};
             out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
         }
 
@@ -1413,8 +2701,11 @@ namespace mxTypes
             mxSetFieldByNumber(out, 0, 6, FieldToMatlab(data_, true, &Titta::eyeImage::padding_per_pixel, 0.)); // 0. causes values to be stored as double
             mxSetFieldByNumber(out, 0, 7, FieldToMatlab(data_, true, &Titta::eyeImage::width, 0.));             // 0. causes values to be stored as double
             mxSetFieldByNumber(out, 0, 8, FieldToMatlab(data_, true, &Titta::eyeImage::height, 0.));            // 0. causes values to be stored as double
+            mxSetFieldByNumber(out, 0, 9, FieldToMatlab(data_, true, &Titta::eyeImage::crop_left, 0.));         // 0. causes values to be stored as double
+            mxSetFieldByNumber(out, 0,10, FieldToMatlab(data_, true, &Titta::eyeImage::crop_top, 0.));          // 0. causes values to be stored as double
+            mxSetFieldByNumber(out, 0,11, FieldToMatlab(data_, true, &Titta::eyeImage::downscale, 0.));         // 0. causes values to be stored as double
         }
-        int off = 4 * (!allGif);
+        int off = 7 * (!allGif);
         mxSetFieldByNumber(out, 0, 5 + off, FieldToMatlab(data_, true, &Titta::eyeImage::type, [](auto in_) {return TobiiResearchEyeImageToString(in_);}));
         mxSetFieldByNumber(out, 0, 6 + off, FieldToMatlab(data_, true, &Titta::eyeImage::camera_id, 0.));       // 0. causes values to be stored as double
         mxSetFieldByNumber(out, 0, 7 + off, FieldToMatlab(data_, true, &Titta::eyeImage::is_gif));
@@ -1425,6 +2716,7 @@ namespace mxTypes
 
     mxArray* ToMatlab(std::vector<Titta::extSignal> data_)
     {
+        TITTA_TRACE_SCOPE("ToMatlab externalSignal", "conversion");
         const char* fieldNames[] = {"deviceTimeStamp","systemTimeStamp","value","changeType"};
         mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
 
@@ -1442,6 +2734,7 @@ namespace mxTypes
 
     mxArray* ToMatlab(std::vector<Titta::timeSync> data_)
     {
+        TITTA_TRACE_SCOPE("ToMatlab timeSync", "conversion");
         const char* fieldNames[] = {"systemRequestTimeStamp","deviceTimeStamp","systemResponseTimeStamp"};
         mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
 
@@ -1470,6 +2763,7 @@ namespace mxTypes
 
     mxArray* ToMatlab(std::vector<Titta::positioning> data_)
     {
+        TITTA_TRACE_SCOPE("ToMatlab positioning", "conversion");
         const char* fieldNames[] = {"left","right"};
         mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
 
@@ -1600,27 +2894,28 @@ namespace mxTypes
         // results are used in the code, these result from separate thread actions.
         if (hasCalResult)
         {
-            const char* fieldNames[] = { "workItem","status","statusString","calibrationResult" };
+            const char* fieldNames[] = { "workItem","requestId","status","statusString","calibrationResult" };
             out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
         }
         else if (hasCalData)
         {
-            const char* fieldNames[] = { "workItem","status","statusString","calibrationData" };
+            const char* fieldNames[] = { "workItem","requestId","status","statusString","calibrationData" };
             out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
         }
         else
         {
-            const char* fieldNames[] = { "workItem","status","statusString" };
+            const char* fieldNames[] = { "workItem","requestId","status","statusString" };
             out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
         }
 
         mxSetFieldByNumber(out, 0, 0, ToMatlab(data_.workItem));
-        mxSetFieldByNumber(out, 0, 1, ToMatlab(data_.status));
-        mxSetFieldByNumber(out, 0, 2, ToMatlab(data_.statusString));
+        mxSetFieldByNumber(out, 0, 1, ToMatlab(static_cast<double>(data_.workItem.requestId)));
+        mxSetFieldByNumber(out, 0, 2, ToMatlab(data_.status));
+        mxSetFieldByNumber(out, 0, 3, ToMatlab(data_.statusString));
         if (hasCalResult)
-            mxSetFieldByNumber(out, 0, 3, ToMatlab(data_.calibrationResult));
+            mxSetFieldByNumber(out, 0, 4, ToMatlab(data_.calibrationResult));
         if (hasCalData)
-            mxSetFieldByNumber(out, 0, 3, ToMatlab(data_.calibrationData));
+            mxSetFieldByNumber(out, 0, 4, ToMatlab(data_.calibrationData));
 
         return out;
     }
@@ -1629,12 +2924,13 @@ namespace mxTypes
         auto hasCoords  = data_.coordinates    .has_value();
         auto hasEye     = data_.eye            .has_value();
         auto hasCalData = data_.calibrationData.has_value();
+        auto hasPartic  = data_.participant    .has_value();
         mxArray* out;
 
-        // there are four options: (1) none of the three above variables are set; (2) calData is set
-        // (3) coordinates is set without eye; (4) coordinates is set with eye. Other combinations
-        // are not possible because of how work items are used in the code, these are separate thread
-        // actions.
+        // there are five options: (1) none of the four above variables are set; (2) calData is set
+        // (3) coordinates is set without eye; (4) coordinates is set with eye; (5) participant is set.
+        // Other combinations are not possible because of how work items are used in the code, these
+        // are separate thread actions.
         if (hasCoords)
         {
             if (hasEye)
@@ -1653,6 +2949,11 @@ namespace mxTypes
             const char* fieldNames[] = { "action","calibrationData" };
             out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
         }
+        else if (hasPartic)
+        {
+            const char* fieldNames[] = { "action","participant" };
+            out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+        }
         else
         {
             const char* fieldNames[] = { "action" };
@@ -1666,6 +2967,8 @@ namespace mxTypes
             mxSetFieldByNumber(out, 0, 2, ToMatlab(data_.eye));
         if (hasCalData)
             mxSetFieldByNumber(out, 0, 1, ToMatlab(data_.calibrationData));
+        if (hasPartic)
+            mxSetFieldByNumber(out, 0, 1, ToMatlab(data_.participant));
 
         return out;
     }
@@ -1699,6 +3002,12 @@ namespace mxTypes
         case TobiiTypes::CalibrationAction::ApplyCalibrationData:
             str = "ApplyCalibrationData";
             break;
+        case TobiiTypes::CalibrationAction::CacheCalibrationData:
+            str = "CacheCalibrationData";
+            break;
+        case TobiiTypes::CalibrationAction::ApplyCachedCalibrationData:
+            str = "ApplyCachedCalibrationData";
+            break;
         case TobiiTypes::CalibrationAction::Exit:
             str = "Exit";
             break;
@@ -1783,6 +3092,248 @@ namespace mxTypes
 
         return out;
     }
+
+    mxArray* ToMatlab(TobiiTypes::latencyStats data_)
+    {
+        const char* fieldNames[] = {"ingest","consume"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        mxSetFieldByNumber(out, 0, 0, ToMatlab(data_.ingest));
+        mxSetFieldByNumber(out, 0, 1, ToMatlab(data_.consume));
+
+        return out;
+    }
+    mxArray* ToMatlab(TobiiTypes::latencySummary data_)
+    {
+        const char* fieldNames[] = {"count","min","max","mean","p50","p90","p99","p99_9"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        // all in microseconds, as doubles for ease of use
+        mxSetFieldByNumber(out, 0, 0, ToMatlab(static_cast<double>(data_.count)));
+        mxSetFieldByNumber(out, 0, 1, ToMatlab(static_cast<double>(data_.min)));
+        mxSetFieldByNumber(out, 0, 2, ToMatlab(static_cast<double>(data_.max)));
+        mxSetFieldByNumber(out, 0, 3, ToMatlab(data_.mean));
+        mxSetFieldByNumber(out, 0, 4, ToMatlab(static_cast<double>(data_.p50)));
+        mxSetFieldByNumber(out, 0, 5, ToMatlab(static_cast<double>(data_.p90)));
+        mxSetFieldByNumber(out, 0, 6, ToMatlab(static_cast<double>(data_.p99)));
+        mxSetFieldByNumber(out, 0, 7, ToMatlab(static_cast<double>(data_.p99_9)));
+
+        return out;
+    }
+
+    mxArray* ToMatlab(TobiiTypes::memoryUsage data_)
+    {
+        const char* fieldNames[] = {"bytes","highWaterMark","reserved","budget","nEvicted"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        // as doubles for ease of use
+        mxSetFieldByNumber(out, 0, 0, ToMatlab(static_cast<double>(data_.bytes)));
+        mxSetFieldByNumber(out, 0, 1, ToMatlab(static_cast<double>(data_.highWaterMark)));
+        mxSetFieldByNumber(out, 0, 2, ToMatlab(static_cast<double>(data_.reserved)));
+        mxSetFieldByNumber(out, 0, 3, ToMatlab(static_cast<double>(data_.budget)));
+        mxSetFieldByNumber(out, 0, 4, ToMatlab(static_cast<double>(data_.nEvicted)));
+
+        return out;
+    }
+
+    mxArray* ToMatlab(TittaThreads::info data_, mwIndex idx_/*=0*/, mwSize size_/*=1*/, mxArray* storage_/*=nullptr*/)
+    {
+        if (idx_ == 0)
+        {
+            const char* fieldNames[] = { "name","id","isSDKThread","policy","priority","nice","cpus","error" };
+            storage_ = mxCreateStructMatrix(size_, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+            if (size_ == 0)
+                return storage_;
+        }
+
+        mxSetFieldByNumber(storage_, idx_, 0, ToMatlab(data_.name));
+        mxSetFieldByNumber(storage_, idx_, 1, ToMatlab(data_.id));
+        mxSetFieldByNumber(storage_, idx_, 2, mxCreateLogicalScalar(data_.isSDKThread));
+        mxSetFieldByNumber(storage_, idx_, 3, ToMatlab(data_.policy));
+        // as doubles for ease of use
+        mxSetFieldByNumber(storage_, idx_, 4, ToMatlab(static_cast<double>(data_.priority)));
+        mxSetFieldByNumber(storage_, idx_, 5, ToMatlab(static_cast<double>(data_.nice)));
+        mxSetFieldByNumber(storage_, idx_, 6, ToMatlab(std::vector<double>(data_.cpus.begin(), data_.cpus.end())));
+        mxSetFieldByNumber(storage_, idx_, 7, ToMatlab(data_.error));
+
+        return storage_;
+    }
+
+    mxArray* ToMatlab(EyeTrackerDiscovery::entry data_, mwIndex idx_/*=0*/, mwSize size_/*=1*/, mxArray* storage_/*=nullptr*/)
+    {
+        if (idx_ == 0)
+        {
+            const char* fieldNames[] = { "eyeTracker","firstSeen","lastSeen" };
+            storage_ = mxCreateStructMatrix(size_, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+            if (size_ == 0)
+                return storage_;
+        }
+
+        mxSetFieldByNumber(storage_, idx_, 0, ToMatlab(std::move(data_.info)));
+        mxSetFieldByNumber(storage_, idx_, 1, ToMatlab(data_.firstSeen));
+        mxSetFieldByNumber(storage_, idx_, 2, ToMatlab(data_.lastSeen));
+
+        return storage_;
+    }
+
+    mxArray* ToMatlab(EyeTrackerDiscovery::event data_, mwIndex idx_/*=0*/, mwSize size_/*=1*/, mxArray* storage_/*=nullptr*/)
+    {
+        if (idx_ == 0)
+        {
+            const char* fieldNames[] = { "type","systemTimeStamp","eyeTracker" };
+            storage_ = mxCreateStructMatrix(size_, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+            if (size_ == 0)
+                return storage_;
+        }
+
+        mxSetFieldByNumber(storage_, idx_, 0, ToMatlab(EyeTrackerDiscovery::eventTypeToString(data_.type)));
+        mxSetFieldByNumber(storage_, idx_, 1, ToMatlab(data_.system_time_stamp));
+        mxSetFieldByNumber(storage_, idx_, 2, ToMatlab(std::move(data_.info)));
+
+        return storage_;
+    }
+
+    mxArray* ToMatlab(TobiiTypes::bufferAllocation data_)
+    {
+        const char* fieldNames[] = {"prefault","lock","hugePages","bytes","isPrefaulted","isLocked","hasHugePages","error"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        mxSetFieldByNumber(out, 0, 0, mxCreateLogicalScalar(data_.prefault));
+        mxSetFieldByNumber(out, 0, 1, mxCreateLogicalScalar(data_.lock));
+        mxSetFieldByNumber(out, 0, 2, ToMatlab(data_.hugePages));
+        mxSetFieldByNumber(out, 0, 3, ToMatlab(static_cast<double>(data_.bytes)));
+        mxSetFieldByNumber(out, 0, 4, mxCreateLogicalScalar(data_.isPrefaulted));
+        mxSetFieldByNumber(out, 0, 5, mxCreateLogicalScalar(data_.isLocked));
+        mxSetFieldByNumber(out, 0, 6, mxCreateLogicalScalar(data_.hasHugePages));
+        mxSetFieldByNumber(out, 0, 7, ToMatlab(data_.error));
+
+        return out;
+    }
+
+    mxArray* ToMatlab(TobiiTypes::eyeImageReduction data_)
+    {
+        const char* fieldNames[] = {"crop","cropRect","downscale","keepEveryN"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        mxSetFieldByNumber(out, 0, 0, ToMatlab(data_.crop));
+        mxSetFieldByNumber(out, 0, 1, ToMatlab(std::array<double, 4>{static_cast<double>(data_.cropRect[0]), static_cast<double>(data_.cropRect[1]), static_cast<double>(data_.cropRect[2]), static_cast<double>(data_.cropRect[3])}));
+        mxSetFieldByNumber(out, 0, 2, ToMatlab(static_cast<double>(data_.downscale)));
+        mxSetFieldByNumber(out, 0, 3, ToMatlab(static_cast<double>(data_.keepEveryN)));
+
+        return out;
+    }
+
+    mxArray* ToMatlab(TobiiTypes::eyeImageCompressionStats data_)
+    {
+        const char* fieldNames[] = {"enabled","numThreads","cacheSize","nCompressed","nIncompressible","rawBytes","compressedBytes","ratio","compressTime","nDecompressed","decompressTime","nCacheHits","cacheBytes"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        mxSetFieldByNumber(out, 0, 0, mxCreateLogicalScalar(data_.enabled));
+        mxSetFieldByNumber(out, 0, 1, ToMatlab(static_cast<double>(data_.numThreads)));
+        mxSetFieldByNumber(out, 0, 2, ToMatlab(static_cast<double>(data_.cacheSize)));
+        mxSetFieldByNumber(out, 0, 3, ToMatlab(static_cast<double>(data_.nCompressed)));
+        mxSetFieldByNumber(out, 0, 4, ToMatlab(static_cast<double>(data_.nIncompressible)));
+        mxSetFieldByNumber(out, 0, 5, ToMatlab(static_cast<double>(data_.rawBytes)));
+        mxSetFieldByNumber(out, 0, 6, ToMatlab(static_cast<double>(data_.compressedBytes)));
+        mxSetFieldByNumber(out, 0, 7, ToMatlab(data_.ratio));
+        mxSetFieldByNumber(out, 0, 8, ToMatlab(data_.compressTime));
+        mxSetFieldByNumber(out, 0, 9, ToMatlab(static_cast<double>(data_.nDecompressed)));
+        mxSetFieldByNumber(out, 0,10, ToMatlab(data_.decompressTime));
+        mxSetFieldByNumber(out, 0,11, ToMatlab(static_cast<double>(data_.nCacheHits)));
+        mxSetFieldByNumber(out, 0,12, ToMatlab(static_cast<double>(data_.cacheBytes)));
+
+        return out;
+    }
+
+    mxArray* ToMatlab(TobiiTypes::allStreamsData data_)
+    {
+        // same field names as Titta.m's ConsumeAllData. Streams that were not requested are left empty
+        const char* fieldNames[] = {"gaze","eyeImages","externalSignals","timeSync","notifications","positioning","cutOff"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        if (data_.gaze)
+            mxSetFieldByNumber(out, 0, 0, ToMatlab(std::move(*data_.gaze)));
+        if (data_.eyeImage)
+            mxSetFieldByNumber(out, 0, 1, ToMatlab(std::move(*data_.eyeImage)));
+        if (data_.extSignal)
+            mxSetFieldByNumber(out, 0, 2, ToMatlab(std::move(*data_.extSignal)));
+        if (data_.timeSync)
+            mxSetFieldByNumber(out, 0, 3, ToMatlab(std::move(*data_.timeSync)));
+        if (data_.notification)
+            mxSetFieldByNumber(out, 0, 4, ToMatlab(std::move(*data_.notification)));
+        if (data_.positioning)
+            mxSetFieldByNumber(out, 0, 5, ToMatlab(std::move(*data_.positioning)));
+        mxSetFieldByNumber(out, 0, 6, ToMatlab(data_.cutOff));
+
+        return out;
+    }
+
+    mxArray* ToMatlab(TobiiTypes::gazeExtSignalJoin data_)
+    {
+        const char* fieldNames[] = {"gaze","externalSignals","extSignalIndex","extSignalValue","nearestGazeIndex"};
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+
+        // indices as 1-based doubles, NaN where there is no match
+        auto toIndex = [](const std::vector<int64_t>& idx_)
+        {
+            std::vector<double> o;
+            o.reserve(idx_.size());
+            for (const auto i : idx_)
+                o.push_back(i < 0 ? std::numeric_limits<double>::quiet_NaN() : static_cast<double>(i + 1));
+            return o;
+        };
+        std::vector<double> values;
+        values.reserve(data_.extSignalValue.size());
+        for (size_t i = 0; i < data_.extSignalValue.size(); i++)
+            values.push_back(data_.extSignalIndex[i] < 0 ? std::numeric_limits<double>::quiet_NaN() : static_cast<double>(data_.extSignalValue[i]));
+
+        mxSetFieldByNumber(out, 0, 2, ToMatlab(toIndex(data_.extSignalIndex)));
+        mxSetFieldByNumber(out, 0, 3, ToMatlab(values));
+        mxSetFieldByNumber(out, 0, 4, ToMatlab(toIndex(data_.nearestGazeIndex)));
+        mxSetFieldByNumber(out, 0, 0, ToMatlab(std::move(data_.gaze)));
+        mxSetFieldByNumber(out, 0, 1, ToMatlab(std::move(data_.extSignal)));
+
+        return out;
+    }
+
+    mxArray* ToMatlab(std::vector<TobiiTypes::derivedSample> data_, const std::vector<std::string>& channels_)
+    {
+        std::vector<const char*> fieldNames{ "systemTimeStamp" };
+        for (const auto& c : channels_)
+            fieldNames.push_back(c.c_str());
+        mxArray* out = mxCreateStructMatrix(1, 1, static_cast<int>(fieldNames.size()), fieldNames.data());
+
+        // each channel as a row vector
+        const auto nSamp = data_.size();
+        mxArray* temp = mxCreateUninitNumericMatrix(1, nSamp, mxINT64_CLASS, mxREAL);
+        auto ts = static_cast<int64_t*>(mxGetData(temp));
+        for (size_t i = 0; i < nSamp; i++)
+            ts[i] = data_[i].system_time_stamp;
+        mxSetFieldByNumber(out, 0, 0, temp);
+        for (size_t c = 0; c < channels_.size(); c++)
+        {
+            temp = mxCreateUninitNumericMatrix(1, nSamp, mxDOUBLE_CLASS, mxREAL);
+            auto vals = static_cast<double*>(mxGetData(temp));
+            for (size_t i = 0; i < nSamp; i++)
+                vals[i] = c < data_[i].values.size() ? data_[i].values[c] : std::numeric_limits<double>::quiet_NaN();
+            mxSetFieldByNumber(out, 0, static_cast<int>(c + 1), temp);
+        }
+
+        return out;
+    }
+
+    mxArray* ToMatlab(std::vector<std::tuple<std::string, std::string>> data_)
+    {
+        const char* fieldNames[] = {"name","type"};
+        mxArray* out = mxCreateStructMatrix(data_.size(), 1, static_cast<int>(std::size(fieldNames)), fieldNames);
+        for (size_t i = 0; i < data_.size(); i++)
+        {
+            mxSetFieldByNumber(out, i, 0, ToMatlab(std::get<0>(data_[i])));
+            mxSetFieldByNumber(out, i, 1, ToMatlab(std::get<1>(data_[i])));
+        }
+
+        return out;
+    }
 }
 
 
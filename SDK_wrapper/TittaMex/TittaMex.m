@@ -142,6 +142,28 @@ classdef TittaMex < handle
         function eyeTracker = getEyeTrackerFromAddress(this,address)
             eyeTracker = this.cppmethodGlobal('getEyeTrackerFromAddress',ensureStringIsChar(address));
         end
+        % eye tracker discovery
+        function startEyeTrackerDiscovery(this,intervalMs)
+            if nargin<2, intervalMs = []; end
+            this.cppmethodGlobal('startEyeTrackerDiscovery',double(intervalMs));
+        end
+        function stopEyeTrackerDiscovery(this)
+            this.cppmethodGlobal('stopEyeTrackerDiscovery');
+        end
+        function running = isEyeTrackerDiscoveryRunning(this)
+            running = this.cppmethodGlobal('isEyeTrackerDiscoveryRunning');
+        end
+        function refreshEyeTrackers(this,wait)
+            if nargin<2, wait = []; end
+            this.cppmethodGlobal('refreshEyeTrackers',logical(wait));
+        end
+        function eyeTrackers = getDiscoveredEyeTrackers(this)
+            eyeTrackers = this.cppmethodGlobal('getDiscoveredEyeTrackers');
+        end
+        function events = getEyeTrackerDiscoveryEvents(this,clearEvents)
+            if nargin<2, clearEvents = []; end
+            events = this.cppmethodGlobal('getEyeTrackerDiscoveryEvents',logical(clearEvents));
+        end
         % logging
         function success = startLogging(this,initialBufferSize)
             % optional buffer size input
@@ -163,6 +185,53 @@ classdef TittaMex < handle
         function stopLogging(this)
             this.cppmethodGlobal('stopLogging');
         end
+        function setLogLevel(this,level)
+            this.cppmethodGlobal('setLogLevel',ensureStringIsChar(level));
+        end
+        function level = getLogLevel(this)
+            level = this.cppmethodGlobal('getLogLevel');
+        end
+        function nDropped = getNumDroppedLogMessages(this)
+            nDropped = this.cppmethodGlobal('getNumDroppedLogMessages');
+        end
+        function startLogFile(this,fileName,maxBytes,maxFiles)
+            % optional maximum file size and number of files inputs
+            if nargin<3
+                maxBytes = [];
+            end
+            if nargin>3 && ~isempty(maxFiles)
+                this.cppmethodGlobal('startLogFile',ensureStringIsChar(fileName),uint64(maxBytes),uint64(maxFiles));
+            else
+                this.cppmethodGlobal('startLogFile',ensureStringIsChar(fileName),uint64(maxBytes));
+            end
+        end
+        function stopLogFile(this)
+            this.cppmethodGlobal('stopLogFile');
+        end
+        % tracing
+        function enabled = isTracingEnabled(this)
+            enabled = this.cppmethodGlobal('isTracingEnabled');
+        end
+        function trace = getTrace(this,clearTrace)
+            % optional clear trace input
+            if nargin>1 && ~isempty(clearTrace)
+                trace = this.cppmethodGlobal('getTrace',logical(clearTrace));
+            else
+                trace = this.cppmethodGlobal('getTrace');
+            end
+        end
+        % thread scheduling
+        function setThreadSettings(this,policy,priority,nice,cpus)
+            % all inputs optional, pass empty to leave a setting unchanged
+            if nargin<2, policy = []; end
+            if nargin<3, priority = []; end
+            if nargin<4, nice = []; end
+            if nargin<5, cpus = []; end
+            this.cppmethodGlobal('setThreadSettings',char(policy),double(priority),double(nice),double(cpus));
+        end
+        function threads = getThreadSettings(this)
+            threads = this.cppmethodGlobal('getThreadSettings');
+        end
         % stream info
         function streams = getAllStreamsString(this,quoteChar,snakeCase)
             if nargin>2
@@ -314,28 +383,28 @@ classdef TittaMex < handle
                 hasEnqueuedLeave = this.cppmethod('leaveCalibrationMode');
             end
         end
-        function calibrationCollectData(this,coordinates,eye)
+        function requestId = calibrationCollectData(this,coordinates,eye)
             if nargin>2 && ~isempty(eye)
-                this.cppmethod('calibrationCollectData',coordinates,ensureStringIsChar(eye));
+                requestId = this.cppmethod('calibrationCollectData',coordinates,ensureStringIsChar(eye));
             else
-                this.cppmethod('calibrationCollectData',coordinates);
+                requestId = this.cppmethod('calibrationCollectData',coordinates);
             end
         end
-        function calibrationDiscardData(this,coordinates,eye)
+        function requestId = calibrationDiscardData(this,coordinates,eye)
             if nargin>2 && ~isempty(eye)
-                this.cppmethod('calibrationDiscardData',coordinates,ensureStringIsChar(eye));
+                requestId = this.cppmethod('calibrationDiscardData',coordinates,ensureStringIsChar(eye));
             else
-                this.cppmethod('calibrationDiscardData',coordinates);
+                requestId = this.cppmethod('calibrationDiscardData',coordinates);
             end
         end
-        function calibrationComputeAndApply(this)
-            this.cppmethod('calibrationComputeAndApply');
+        function requestId = calibrationComputeAndApply(this)
+            requestId = this.cppmethod('calibrationComputeAndApply');
         end
-        function calibrationGetData(this)
-            this.cppmethod('calibrationGetData');
+        function requestId = calibrationGetData(this)
+            requestId = this.cppmethod('calibrationGetData');
         end
-        function calibrationApplyData(this,calibrationData)
-            this.cppmethod('calibrationApplyData',calibrationData);
+        function requestId = calibrationApplyData(this,calibrationData)
+            requestId = this.cppmethod('calibrationApplyData',calibrationData);
         end
         function status = calibrationGetStatus(this)
             status = this.cppmethod('calibrationGetStatus');
@@ -343,6 +412,53 @@ classdef TittaMex < handle
         function result = calibrationRetrieveResult(this)
             result = this.cppmethod('calibrationRetrieveResult');
         end
+        function result = calibrationWaitForResult(this,requestId,timeOutMs)
+            % both inputs optional. If requestId is empty, wait for any
+            % result. If timeOutMs is empty, wait until result is available
+            % or calibration mode is left
+            if nargin<2
+                requestId = [];
+            end
+            if nargin>2 && ~isempty(timeOutMs)
+                result = this.cppmethod('calibrationWaitForResult',requestId,double(timeOutMs));
+            else
+                result = this.cppmethod('calibrationWaitForResult',requestId);
+            end
+        end
+        % calibration cache, keyed by eye tracker serial number, tracking
+        % mode and participant label
+        function requestId = calibrationStoreInCache(this,participant)
+            requestId = this.cppmethod('calibrationStoreInCache',ensureStringIsChar(participant));
+        end
+        function requestId = calibrationApplyCached(this,participant)
+            requestId = this.cppmethod('calibrationApplyCached',ensureStringIsChar(participant));
+        end
+        function addToCalibrationCache(this,participant,calibrationData)
+            this.cppmethod('addToCalibrationCache',ensureStringIsChar(participant),calibrationData);
+        end
+        function hasCal = hasCachedCalibration(this,participant)
+            hasCal = this.cppmethod('hasCachedCalibration',ensureStringIsChar(participant));
+        end
+        function participants = getCachedCalibrations(this)
+            participants = this.cppmethod('getCachedCalibrations');
+        end
+        function clearCalibrationCache(this,participant)
+            if nargin>1 && ~isempty(participant)
+                this.cppmethod('clearCalibrationCache',ensureStringIsChar(participant));
+            else
+                this.cppmethod('clearCalibrationCache');
+            end
+        end
+        function setCalibrationCacheDirectory(this,directory)
+            if nargin>1 && ~isempty(directory)
+                this.cppmethod('setCalibrationCacheDirectory',ensureStringIsChar(directory));
+            else
+                this.cppmethod('setCalibrationCacheDirectory');
+            end
+        end
+        function directory = getCalibrationCacheDirectory(this)
+            directory = this.cppmethod('getCalibrationCacheDirectory');
+        end
         
         %% data streams
         function supported = hasStream(this,stream)
@@ -354,6 +470,65 @@ classdef TittaMex < handle
         function prevEyeOpennessState = setIncludeEyeOpennessInGaze(this,include)
             prevEyeOpennessState = this.cppmethod('setIncludeEyeOpennessInGaze',include);
         end
+        function prevCompactState = setCompactGazeStorage(this,compact,quantize,compressOld)
+            % optional boolean input indicating whether the gaze point
+            % on the display area should be stored as fixed point
+            % optional boolean input indicating whether older samples
+            % should be further compressed in the background
+            if nargin<3
+                quantize = [];
+            end
+            if nargin>3 && ~isempty(compressOld)
+                prevCompactState = this.cppmethod('setCompactGazeStorage',logical(compact),logical(quantize),logical(compressOld));
+            else
+                prevCompactState = this.cppmethod('setCompactGazeStorage',logical(compact),logical(quantize));
+            end
+        end
+        function isCompact = isCompactGazeStorage(this)
+            isCompact = this.cppmethod('isCompactGazeStorage');
+        end
+        function setEyeImageDecoding(this,mode,numThreads)
+            % mode: 'none', 'ingest' or 'peek'. Optional numThreads input
+            % indicating the number of decoding threads
+            if nargin>2 && ~isempty(numThreads)
+                this.cppmethod('setEyeImageDecoding',ensureStringIsChar(mode),uint64(numThreads));
+            else
+                this.cppmethod('setEyeImageDecoding',ensureStringIsChar(mode));
+            end
+        end
+        function mode = getEyeImageDecoding(this)
+            mode = this.cppmethod('getEyeImageDecoding');
+        end
+        function setEyeImageReduction(this,crop,cropRect,downscale,keepEveryN)
+            % crop: 'none', 'fixed' or 'pupil'. cropRect: [left top width
+            % height] of the fixed crop, for 'pupil' only width and height
+            % are used. downscale: integer factor. keepEveryN: keep only
+            % every Nth frame of each camera. All inputs are optional
+            if nargin<2, crop = []; end
+            if nargin<3, cropRect = []; end
+            if nargin<4, downscale = []; end
+            if nargin<5, keepEveryN = []; end
+            this.cppmethod('setEyeImageReduction',char(crop),double(cropRect),double(downscale),uint64(keepEveryN));
+        end
+        function reduction = getEyeImageReduction(this)
+            reduction = this.cppmethod('getEyeImageReduction');
+        end
+        function setEyeImageCompression(this,compress,numThreads,cacheSize)
+            % compress: whether to losslessly compress stored eye images.
+            % Optional numThreads input indicating the number of
+            % compression threads, and optional cacheSize input indicating
+            % how many decompressed frames to keep for repeated peeks
+            if nargin<3, numThreads = []; end
+            if nargin<4, cacheSize = []; end
+            this.cppmethod('setEyeImageCompression',logical(compress),uint64(numThreads),uint64(cacheSize));
+        end
+        function stats = getEyeImageCompressionStats(this,doReset)
+            if nargin>1 && ~isempty(doReset)
+                stats = this.cppmethod('getEyeImageCompressionStats',logical(doReset));
+            else
+                stats = this.cppmethod('getEyeImageCompressionStats');
+            end
+        end
         function success = start(this,stream,initialBufferSize,asGif,blockUntilStarted)
             % optional buffer size input, and optional input to request
             % gif-encoded instead of raw images
@@ -452,6 +627,167 @@ classdef TittaMex < handle
                 data = this.cppmethod('peekTimeRange',stream);
             end
         end
+        function data = getLatest(this,stream)
+            % most recent sample of the stream, in same format as peekN.
+            % Does not contend with incoming data, cheap to call every
+            % frame
+            if nargin<2
+                error('TittaMex::getLatest: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            data = this.cppmethod('getLatest',ensureStringIsChar(stream));
+        end
+        function data = drainAll(this,streams,startT,cutOff)
+            % consume multiple streams in one call, all up to the same
+            % cut-off time. optional inputs:
+            % - streams: cell array of stream names. Default: gaze,
+            %            eyeImage, externalSignal, timeSync and
+            %            notification
+            % -  startT: Default: start of buffer
+            % -  cutOff: Default: now. Returned in output struct
+            % positioning has no timestamps, if requested all its samples
+            % are returned
+            if nargin<2, streams = []; end
+            if nargin<3, startT  = []; end
+            if nargin<4, cutOff  = []; end
+            if ~isempty(streams)
+                if ~iscell(streams)
+                    streams = {streams};
+                end
+                streams = cellfun(@ensureStringIsChar,streams,'uni',false);
+            end
+            data = this.cppmethod('drainAll',streams,int64(startT),int64(cutOff));
+        end
+        function data = joinGazeExtSignal(this,startT,endT)
+            % annotate gaze samples in the time range with the most recent
+            % external signal (extSignalIndex, extSignalValue), and get
+            % the nearest gaze sample for each external signal event
+            % (nearestGazeIndex). Indices are 1-based, NaN if none.
+            % optional inputs startT and endT. Default: whole buffer.
+            % Buffers are not consumed
+            if nargin>2 && ~isempty(endT)
+                data = this.cppmethod('joinGazeExtSignal',int64(startT),int64(endT));
+            elseif nargin>1 && ~isempty(startT)
+                data = this.cppmethod('joinGazeExtSignal',int64(startT));
+            else
+                data = this.cppmethod('joinGazeExtSignal');
+            end
+        end
+        function data = resampleGaze(this,frequency,startT,endT,maxGap,method)
+            % resample gaze data to a uniform grid at the given frequency
+            % (Hz). Optional inputs:
+            % - startT, endT: Default: whole buffer
+            % -       maxGap: longest gap (us) to interpolate across.
+            %                 Default: 75000
+            % -       method: 'linear' or 'cubic'. Default: 'linear'
+            % Buffer is not consumed
+            assert(nargin>1,'TittaMex::resampleGaze: provide frequency argument.');
+            if nargin<3, startT = []; end
+            if nargin<4, endT   = []; end
+            if nargin<5, maxGap = []; end
+            if nargin<6, method = []; else, method = ensureStringIsChar(method); end
+            data = this.cppmethod('resampleGaze',double(frequency),int64(startT),int64(endT),int64(maxGap),method);
+        end
+        function startGazeResampler(this,frequency,maxGap,method,gridStart)
+            % resample gaze data as it comes in, get output with
+            % getResampledGaze(). maxGap and method as for resampleGaze().
+            % By default starts with the next sample that arrives, if
+            % gridStart is provided, buffered samples from that time on
+            % are included
+            assert(nargin>1,'TittaMex::startGazeResampler: provide frequency argument.');
+            if nargin<3, maxGap    = []; end
+            if nargin<4, method    = []; else, method = ensureStringIsChar(method); end
+            if nargin<5, gridStart = []; end
+            this.cppmethod('startGazeResampler',double(frequency),int64(maxGap),method,int64(gridStart));
+        end
+        function data = getResampledGaze(this)
+            data = this.cppmethod('getResampledGaze');
+        end
+        function running = isGazeResamplerRunning(this)
+            running = this.cppmethod('isGazeResamplerRunning');
+        end
+        function data = stopGazeResampler(this)
+            % returns remaining resampled data
+            data = this.cppmethod('stopGazeResampler');
+        end
+        function types = getPipelineStageTypes(this)
+            types = this.cppmethodGlobal('getPipelineStageTypes');
+        end
+        function addPipelineStage(this,name,type,params)
+            % add a stage to the end of the gaze processing pipeline. The
+            % stage's output is available as the derived stream 'name'.
+            % Optional params is a struct with a scalar for each stage
+            % parameter, e.g. struct('window',5) for a movingAverage stage
+            % or struct('threshold',30) for an ivt stage
+            assert(nargin>2,'TittaMex::addPipelineStage: provide name and type arguments.');
+            if nargin<4, params = []; end
+            this.cppmethod('addPipelineStage',ensureStringIsChar(name),ensureStringIsChar(type),params);
+        end
+        function clearPipeline(this)
+            this.cppmethod('clearPipeline');
+        end
+        function stages = getPipelineStages(this)
+            % struct array with name and type of each stage, in
+            % processing order
+            stages = this.cppmethod('getPipelineStages');
+        end
+        function channels = getDerivedStreamChannels(this,name)
+            channels = this.cppmethod('getDerivedStreamChannels',ensureStringIsChar(name));
+        end
+        function startPipeline(this)
+            % process gaze data that arrives from now on
+            this.cppmethod('startPipeline');
+        end
+        function stopPipeline(this)
+            this.cppmethod('stopPipeline');
+        end
+        function running = isPipelineRunning(this)
+            running = this.cppmethod('isPipelineRunning');
+        end
+        function data = consumeDerivedN(this,name,NSamp,side)
+            % derived stream of pipeline stage 'name', struct with
+            % systemTimeStamp and a field per channel. Optional inputs as
+            % for consumeN
+            assert(nargin>1,'TittaMex::consumeDerivedN: provide name argument.');
+            if nargin<3, NSamp = []; end
+            if nargin<4, side  = []; else, side = ensureStringIsChar(side); end
+            data = this.cppmethod('consumeDerivedN',ensureStringIsChar(name),uint64(NSamp),side);
+        end
+        function data = consumeDerivedTimeRange(this,name,startT,endT)
+            assert(nargin>1,'TittaMex::consumeDerivedTimeRange: provide name argument.');
+            if nargin<3, startT = []; end
+            if nargin<4, endT   = []; end
+            data = this.cppmethod('consumeDerivedTimeRange',ensureStringIsChar(name),int64(startT),int64(endT));
+        end
+        function data = peekDerivedN(this,name,NSamp,side)
+            % optional inputs as for peekN
+            assert(nargin>1,'TittaMex::peekDerivedN: provide name argument.');
+            if nargin<3, NSamp = []; end
+            if nargin<4, side  = []; else, side = ensureStringIsChar(side); end
+            data = this.cppmethod('peekDerivedN',ensureStringIsChar(name),uint64(NSamp),side);
+        end
+        function data = peekDerivedTimeRange(this,name,startT,endT)
+            assert(nargin>1,'TittaMex::peekDerivedTimeRange: provide name argument.');
+            if nargin<3, startT = []; end
+            if nargin<4, endT   = []; end
+            data = this.cppmethod('peekDerivedTimeRange',ensureStringIsChar(name),int64(startT),int64(endT));
+        end
+        function clearDerived(this,name)
+            assert(nargin>1,'TittaMex::clearDerived: provide name argument.');
+            this.cppmethod('clearDerived',ensureStringIsChar(name));
+        end
+        function data = snapshotAll(this,streams,startT,cutOff)
+            % as drainAll, but samples are left in the buffers
+            if nargin<2, streams = []; end
+            if nargin<3, startT  = []; end
+            if nargin<4, cutOff  = []; end
+            if ~isempty(streams)
+                if ~iscell(streams)
+                    streams = {streams};
+                end
+                streams = cellfun(@ensureStringIsChar,streams,'uni',false);
+            end
+            data = this.cppmethod('snapshotAll',streams,int64(startT),int64(cutOff));
+        end
         function clear(this,stream)
             if nargin<2
                 error('TittaMex::clear: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
@@ -485,6 +821,145 @@ classdef TittaMex < handle
                 success = this.cppmethod('stop',stream);
             end
         end
+
+        %% latency instrumentation
+        function stats = getLatencyStats(this,stream,doReset)
+            % optional boolean input indicating whether the latency
+            % histograms should be reset after they are read out
+            if nargin<2
+                error('TittaMex::getLatencyStats: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            stream = ensureStringIsChar(stream);
+            if nargin>2 && ~isempty(doReset)
+                stats = this.cppmethod('getLatencyStats',stream,logical(doReset));
+            else
+                stats = this.cppmethod('getLatencyStats',stream);
+            end
+        end
+
+        %% memory governor
+        function usage = getMemoryUsage(this,stream)
+            if nargin<2
+                error('TittaMex::getMemoryUsage: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            stream = ensureStringIsChar(stream);
+            usage = this.cppmethod('getMemoryUsage',stream);
+        end
+        function usage = getTotalMemoryUsage(this)
+            usage = this.cppmethod('getTotalMemoryUsage');
+        end
+        function setMemoryBudget(this,bytes)
+            % budget in bytes for all streams together, 0 for unlimited
+            assert(nargin>1,'TittaMex::setMemoryBudget: provide bytes argument.');
+            this.cppmethod('setMemoryBudget',uint64(bytes));
+        end
+        function setStreamMemoryBudget(this,stream,bytes)
+            % budget in bytes for the indicated stream, 0 for unlimited
+            if nargin<3
+                error('TittaMex::setStreamMemoryBudget: provide stream and bytes arguments. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            stream = ensureStringIsChar(stream);
+            this.cppmethod('setStreamMemoryBudget',stream,uint64(bytes));
+        end
+        function setEvictionOrder(this,streams)
+            % cell array of stream names, oldest samples of the first
+            % stream are evicted first when over the global budget
+            assert(nargin>1,'TittaMex::setEvictionOrder: provide streams argument.');
+            if ~iscell(streams)
+                streams = {streams};
+            end
+            streams = cellfun(@ensureStringIsChar,streams,'uni',false);
+            this.cppmethod('setEvictionOrder',streams);
+        end
+        function streams = getEvictionOrder(this)
+            streams = this.cppmethod('getEvictionOrder');
+        end
+        function setBufferAllocation(this,prefault,lock,hugePages)
+            % pre-fault and/or lock the memory of the sample buffers and
+            % back it with huge pages ('none', 'transparent' or
+            % 'explicit'). Takes effect for a stream the next time it is
+            % started while its buffer is empty
+            if nargin<2, prefault = []; end
+            if nargin<3, lock = []; end
+            if nargin<4, hugePages = []; end
+            this.cppmethod('setBufferAllocation',logical(prefault),logical(lock),char(hugePages));
+        end
+        function info = getBufferAllocation(this,stream)
+            if nargin<2
+                error('TittaMex::getBufferAllocation: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            stream = ensureStringIsChar(stream);
+            info = this.cppmethod('getBufferAllocation',stream);
+        end
+
+        %% shared memory
+        function startSharedMemory(this,stream,name,capacity)
+            % also write samples of the stream (gaze, externalSignal,
+            % timeSync or positioning) to a ring in shared memory that
+            % other processes on this machine can read with
+            % openSharedMemoryReader(). Optional capacity: number of
+            % samples the ring holds. Default: 8192
+            if nargin<3
+                error('TittaMex::startSharedMemory: provide stream and name arguments. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            if nargin<4, capacity = []; end
+            this.cppmethod('startSharedMemory',ensureStringIsChar(stream),ensureStringIsChar(name),uint64(capacity));
+        end
+        function name = getSharedMemoryName(this,stream)
+            % empty if the stream is not written to shared memory
+            if nargin<2
+                error('TittaMex::getSharedMemoryName: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            name = this.cppmethod('getSharedMemoryName',ensureStringIsChar(stream));
+        end
+        function stopSharedMemory(this,stream)
+            if nargin<2
+                error('TittaMex::stopSharedMemory: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            this.cppmethod('stopSharedMemory',ensureStringIsChar(stream));
+        end
+        % shared memory readers do not need a connection to an eye
+        % tracker, i.e., init() does not have to be called
+        function handle = openSharedMemoryReader(this,name,fromOldest)
+            % attach to shared memory written by another Titta instance.
+            % By default reads samples written from now on, if fromOldest
+            % is true, starts with the oldest sample still in the ring
+            assert(nargin>1,'TittaMex::openSharedMemoryReader: provide name argument.');
+            if nargin<3, fromOldest = []; else, fromOldest = logical(fromOldest); end
+            handle = this.cppmethodGlobal('openSharedMemoryReader',ensureStringIsChar(name),fromOldest);
+        end
+        function data = readSharedMemory(this,handle,NSamp)
+            % samples written since the previous call, in the same format
+            % as consumeN. Optional NSamp: maximum number of samples
+            assert(nargin>1,'TittaMex::readSharedMemory: provide handle argument.');
+            if nargin<3, NSamp = []; end
+            data = this.cppmethodGlobal('readSharedMemory',handle,uint64(NSamp));
+        end
+        function info = getSharedMemoryReaderInfo(this,handle)
+            % name, stream, number of samples overwritten before they
+            % could be read, and whether the writer has stopped
+            assert(nargin>1,'TittaMex::getSharedMemoryReaderInfo: provide handle argument.');
+            info = this.cppmethodGlobal('getSharedMemoryReaderInfo',handle);
+        end
+        function closeSharedMemoryReader(this,handle)
+            assert(nargin>1,'TittaMex::closeSharedMemoryReader: provide handle argument.');
+            this.cppmethodGlobal('closeSharedMemoryReader',handle);
+        end
+
+        %% replay of recorded session
+        function isReplay = isReplay(this)
+            isReplay = this.cppmethod('isReplay');
+        end
+        function setReplaySpeed(this,speed)
+            assert(nargin>1,'TittaMex::setReplaySpeed: provide speed argument.');
+            this.cppmethod('setReplaySpeed',double(speed));
+        end
+        function speed = getReplaySpeed(this)
+            speed = this.cppmethod('getReplaySpeed');
+        end
+        function isFinished = isReplayFinished(this)
+            isFinished = this.cppmethod('isReplayFinished');
+        end
     end
 end
 
@@ -54,7 +54,7 @@ classdef TittaMexDummyMode < TittaMex
                 % filter out those methods that we on purpose do not define
                 % in this subclass, as the superclass methods work fine
                 % (call static functions in the mex)
-                qNotOverridden = ~ismember({superMethods.Name},{thisMethods.Name}) & ~ismember({superMethods.Name},{'findAllEyeTrackers','getEyeTrackerFromAddress','startLogging','getLog','stopLogging','getAllBufferSidesString','getAllStreamsString'});
+                qNotOverridden = ~ismember({superMethods.Name},{thisMethods.Name}) & ~ismember({superMethods.Name},{'findAllEyeTrackers','getEyeTrackerFromAddress','startEyeTrackerDiscovery','stopEyeTrackerDiscovery','isEyeTrackerDiscoveryRunning','refreshEyeTrackers','getDiscoveredEyeTrackers','getEyeTrackerDiscoveryEvents','startLogging','getLog','stopLogging','setLogLevel','getLogLevel','getNumDroppedLogMessages','startLogFile','stopLogFile','isTracingEnabled','getTrace','setThreadSettings','getThreadSettings','getPipelineStageTypes','openSharedMemoryReader','readSharedMemory','getSharedMemoryReaderInfo','closeSharedMemoryReader','getAllBufferSidesString','getAllStreamsString'});
                 if any(qNotOverridden)
                     fprintf('methods from %s not overridden in %s:\n',superInfo.Name,thisInfo.Name);
                     fprintf('  %s\n',superMethods(qNotOverridden).Name);
@@ -130,15 +130,20 @@ classdef TittaMexDummyMode < TittaMex
             this.isInCalMode    = false;
             hasEnqueuedLeave    = true;
         end
-        function calibrationCollectData(~,~,~)
+        function requestId = calibrationCollectData(~,~,~)
+            requestId = 0;
         end
-        function calibrationDiscardData(~,~,~)
+        function requestId = calibrationDiscardData(~,~,~)
+            requestId = 0;
         end
-        function calibrationComputeAndApply(~)
+        function requestId = calibrationComputeAndApply(~)
+            requestId = 0;
         end
-        function calibrationGetData(~)
+        function requestId = calibrationGetData(~)
+            requestId = 0;
         end
-        function calibrationApplyData(~,~)
+        function requestId = calibrationApplyData(~,~)
+            requestId = 0;
         end
         function status = calibrationGetStatus(~)
             status = '';
@@ -146,6 +151,30 @@ classdef TittaMexDummyMode < TittaMex
         function result = calibrationRetrieveResult(~)
             result = struct();
         end
+        function result = calibrationWaitForResult(~,~,~)
+            result = struct();
+        end
+        function requestId = calibrationStoreInCache(~,~)
+            requestId = 0;
+        end
+        function requestId = calibrationApplyCached(~,~)
+            requestId = 0;
+        end
+        function addToCalibrationCache(~,~,~)
+        end
+        function hasCal = hasCachedCalibration(~,~)
+            hasCal = false;
+        end
+        function participants = getCachedCalibrations(~)
+            participants = {};
+        end
+        function clearCalibrationCache(~,~)
+        end
+        function setCalibrationCacheDirectory(~,~)
+        end
+        function directory = getCalibrationCacheDirectory(~)
+            directory = [];
+        end
 
         %% data streams
         function supported = hasStream(this,stream)
@@ -157,6 +186,27 @@ classdef TittaMexDummyMode < TittaMex
         function prevEyeOpennessState = setIncludeEyeOpennessInGaze(~,~)
             prevEyeOpennessState = false;
         end
+        function prevCompactState = setCompactGazeStorage(~,~,~,~)
+            prevCompactState = false;
+        end
+        function isCompact = isCompactGazeStorage(~)
+            isCompact = false;
+        end
+        function setEyeImageDecoding(~,~,~)
+        end
+        function mode = getEyeImageDecoding(~)
+            mode = 'none';
+        end
+        function setEyeImageReduction(~,~,~,~,~)
+        end
+        function reduction = getEyeImageReduction(~)
+            reduction = struct('crop','none','cropRect',[0 0 0 0],'downscale',1,'keepEveryN',1);
+        end
+        function setEyeImageCompression(~,~,~,~)
+        end
+        function stats = getEyeImageCompressionStats(~,~)
+            stats = struct('enabled',false,'numThreads',0,'cacheSize',0,'nCompressed',0,'nIncompressible',0,'rawBytes',0,'compressedBytes',0,'ratio',0,'compressTime',0,'nDecompressed',0,'decompressTime',0,'nCacheHits',0,'cacheBytes',0);
+        end
         function success = start(this,stream,~,~,~)
             if nargin<2
                 error('TittaMex::start: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
@@ -222,6 +272,74 @@ classdef TittaMexDummyMode < TittaMex
                 data = getMouseSample(this.isRecordingGaze);
             end
         end
+        function data = getLatest(this,stream)
+            if nargin<2
+                error('TittaMex::getLatest: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            checkValidStream(this,stream);
+            data = [];
+            if strcmpi(stream,'gaze')
+                data = getMouseSample(this.isRecordingGaze);
+            end
+        end
+        function data = drainAll(this,~,~,~)
+            data = struct('gaze',getMouseSample(this.isRecordingGaze),'eyeImages',[],'externalSignals',[],'timeSync',[],'notifications',[],'positioning',[],'cutOff',this.getSystemTimestamp());
+        end
+        function data = snapshotAll(this,~,~,~)
+            data = struct('gaze',getMouseSample(this.isRecordingGaze),'eyeImages',[],'externalSignals',[],'timeSync',[],'notifications',[],'positioning',[],'cutOff',this.getSystemTimestamp());
+        end
+        function data = joinGazeExtSignal(this,~,~)
+            data = struct('gaze',getMouseSample(this.isRecordingGaze),'externalSignals',[],'extSignalIndex',[],'extSignalValue',[],'nearestGazeIndex',[]);
+            if ~isempty(data.gaze)
+                data.extSignalIndex = nan;
+                data.extSignalValue = nan;
+            end
+        end
+        function data = resampleGaze(this,~,~,~,~,~)
+            data = getMouseSample(this.isRecordingGaze);
+        end
+        function startGazeResampler(~,~,~,~,~)
+        end
+        function data = getResampledGaze(this)
+            data = getMouseSample(this.isRecordingGaze);
+        end
+        function running = isGazeResamplerRunning(~)
+            running = false;
+        end
+        function data = stopGazeResampler(~)
+            data = [];
+        end
+        function addPipelineStage(~,~,~,~)
+        end
+        function clearPipeline(~)
+        end
+        function stages = getPipelineStages(~)
+            stages = struct('name',{},'type',{});
+        end
+        function channels = getDerivedStreamChannels(~,~)
+            channels = {};
+        end
+        function startPipeline(~)
+        end
+        function stopPipeline(~)
+        end
+        function running = isPipelineRunning(~)
+            running = false;
+        end
+        function data = consumeDerivedN(~,~,~,~)
+            data = struct('systemTimeStamp',zeros(1,0,'int64'));
+        end
+        function data = consumeDerivedTimeRange(~,~,~,~)
+            data = struct('systemTimeStamp',zeros(1,0,'int64'));
+        end
+        function data = peekDerivedN(~,~,~,~)
+            data = struct('systemTimeStamp',zeros(1,0,'int64'));
+        end
+        function data = peekDerivedTimeRange(~,~,~,~)
+            data = struct('systemTimeStamp',zeros(1,0,'int64'));
+        end
+        function clearDerived(~,~)
+        end
         function clear(this,stream)
             if nargin<2
                 error('TittaMex::clear: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
@@ -243,6 +361,66 @@ classdef TittaMexDummyMode < TittaMex
                 this.isRecordingGaze = false;
             end
         end
+
+        %% latency instrumentation
+        function stats = getLatencyStats(this,stream,~)
+            if nargin<2
+                error('TittaMex::getLatencyStats: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            checkValidStream(this,stream);
+            stats = [];
+        end
+
+        %% memory governor
+        function usage = getMemoryUsage(this,stream)
+            if nargin<2
+                error('TittaMex::getMemoryUsage: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            checkValidStream(this,stream);
+            usage = [];
+        end
+        function usage = getTotalMemoryUsage(~)
+            usage = [];
+        end
+        function setMemoryBudget(~,~)
+        end
+        function setStreamMemoryBudget(this,stream,~)
+            checkValidStream(this,stream);
+        end
+        function setEvictionOrder(~,~)
+        end
+        function streams = getEvictionOrder(~)
+            streams = {};
+        end
+        function setBufferAllocation(~,~,~,~)
+        end
+        function info = getBufferAllocation(this,stream)
+            if nargin<2
+                error('TittaMex::getBufferAllocation: provide stream argument. \nSupported streams are: %s.',this.getAllStreamsString());
+            end
+            checkValidStream(this,stream);
+            info = [];
+        end
+        function startSharedMemory(~,~,~,~)
+        end
+        function name = getSharedMemoryName(~,~)
+            name = [];
+        end
+        function stopSharedMemory(~,~)
+        end
+
+        %% replay of recorded session
+        function isReplay = isReplay(~)
+            isReplay = false;
+        end
+        function setReplaySpeed(~,~)
+        end
+        function speed = getReplaySpeed(~)
+            speed = [];
+        end
+        function isFinished = isReplayFinished(~)
+            isFinished = false;
+        end
     end
 end
 
@@ -158,6 +158,7 @@ void outputEyeImages(py::dict& out_, const std::vector<Titta::eyeImage>& data_,
 
 py::dict StructVectorToDict(std::vector<Titta::gaze>&& data_)
 {
+    TITTA_TRACE_SCOPE("StructVectorToDict gaze", "conversion");
     py::dict out;
 
     // 1. device timestamps
@@ -174,6 +175,7 @@ py::dict StructVectorToDict(std::vector<Titta::gaze>&& data_)
 
 py::dict StructVectorToDict(std::vector<Titta::eyeImage>&& data_)
 {
+    TITTA_TRACE_SCOPE("StructVectorToDict eyeImage", "conversion");
     py::dict out;
 
     // check if all gif, then don't output unneeded fields
@@ -188,6 +190,9 @@ py::dict StructVectorToDict(std::vector<Titta::eyeImage>&& data_)
     {
         FieldToNpArray<true>(out, data_, "bits_per_pixel"   , &Titta::eyeImage::bits_per_pixel);
         FieldToNpArray<true>(out, data_, "padding_per_pixel", &Titta::eyeImage::padding_per_pixel);
+        FieldToNpArray<true>(out, data_, "crop_left"        , &Titta::eyeImage::crop_left);
+        FieldToNpArray<true>(out, data_, "crop_top"         , &Titta::eyeImage::crop_top);
+        FieldToNpArray<true>(out, data_, "downscale"        , &Titta::eyeImage::downscale);
     }
     FieldToNpArray<false>(out, data_, "type"     , &Titta::eyeImage::type);
     FieldToNpArray<true> (out, data_, "camera_id", &Titta::eyeImage::camera_id);
@@ -199,6 +204,7 @@ py::dict StructVectorToDict(std::vector<Titta::eyeImage>&& data_)
 
 py::dict StructVectorToDict(std::vector<Titta::extSignal>&& data_)
 {
+    TITTA_TRACE_SCOPE("StructVectorToDict externalSignal", "conversion");
     py::dict out;
 
     FieldToNpArray<true>(out, data_, "device_time_stamp", &Titta::extSignal::device_time_stamp);
@@ -211,6 +217,7 @@ py::dict StructVectorToDict(std::vector<Titta::extSignal>&& data_)
 
 py::dict StructVectorToDict(std::vector<Titta::timeSync>&& data_)
 {
+    TITTA_TRACE_SCOPE("StructVectorToDict timeSync", "conversion");
     py::dict out;
 
     FieldToNpArray<true>(out, data_, "system_request_time_stamp" , &Titta::timeSync::system_request_time_stamp);
@@ -222,6 +229,7 @@ py::dict StructVectorToDict(std::vector<Titta::timeSync>&& data_)
 
 py::dict StructVectorToDict(std::vector<Titta::positioning>&& data_)
 {
+    TITTA_TRACE_SCOPE("StructVectorToDict positioning", "conversion");
     py::dict out;
 
     TobiiFieldToNpArray(out, data_, "left_user_position"        , &Titta::positioning::left_eye , &TobiiResearchEyeUserPositionGuide::user_position);
@@ -234,6 +242,7 @@ py::dict StructVectorToDict(std::vector<Titta::positioning>&& data_)
 
 py::dict StructVectorToDict(std::vector<Titta::notification>&& data_)
 {
+    TITTA_TRACE_SCOPE("StructVectorToDict notification", "conversion");
     py::dict out;
 
     FieldToNpArray<true> (out, data_, "system_time_stamp" , &Titta::notification::system_time_stamp);
@@ -332,6 +341,8 @@ py::dict StructToDict(const TobiiTypes::CalibrationWorkItem& data_)
         d["eye"] = *data_.eye;
     if (data_.calibrationData.has_value())
         d["calibration_data"] = *data_.calibrationData;
+    if (data_.participant.has_value())
+        d["participant"] = *data_.participant;
 
     return d;
 }
@@ -341,6 +352,7 @@ py::dict StructToDict(const TobiiTypes::CalibrationWorkResult& data_)
     py::dict d;
 
     d["work_item"] = StructToDict(data_.workItem);
+    d["request_id"] = data_.workItem.requestId;
     d["status"] = static_cast<int>(data_.status);
     d["status_string"] = data_.statusString;
     if (data_.calibrationResult.has_value())
@@ -397,6 +409,64 @@ py::list StructVectorToList(const std::vector<TobiiTypes::eyeTracker>& data_)
     return out;
 }
 
+py::dict StructToDict(const TittaThreads::info& data_)
+{
+    py::dict d;
+    d["name"] = data_.name;
+    d["id"] = data_.id;
+    d["is_SDK_thread"] = data_.isSDKThread;
+    d["policy"] = data_.policy;
+    d["priority"] = data_.priority;
+    d["nice"] = data_.nice;
+    d["cpus"] = data_.cpus;
+    d["error"] = data_.error;
+    return d;
+}
+py::list StructVectorToList(const std::vector<TittaThreads::info>& data_)
+{
+    py::list out;
+
+    for (auto&& i : data_)
+        out.append(StructToDict(i));
+
+    return out;
+}
+
+py::dict StructToDict(const EyeTrackerDiscovery::entry& data_)
+{
+    py::dict d;
+    d["eye_tracker"] = StructToDict(data_.info);
+    d["first_seen"] = data_.firstSeen;
+    d["last_seen"] = data_.lastSeen;
+    return d;
+}
+py::list StructVectorToList(const std::vector<EyeTrackerDiscovery::entry>& data_)
+{
+    py::list out;
+
+    for (auto&& i : data_)
+        out.append(StructToDict(i));
+
+    return out;
+}
+py::dict StructToDict(const EyeTrackerDiscovery::event& data_)
+{
+    py::dict d;
+    d["type"] = EyeTrackerDiscovery::eventTypeToString(data_.type);
+    d["system_time_stamp"] = data_.system_time_stamp;
+    d["eye_tracker"] = StructToDict(data_.info);
+    return d;
+}
+py::list StructVectorToList(const std::vector<EyeTrackerDiscovery::event>& data_)
+{
+    py::list out;
+
+    for (auto&& i : data_)
+        out.append(StructToDict(i));
+
+    return out;
+}
+
 py::dict StructToDict(const TobiiResearchDisplayArea& data_)
 {
     py::dict d;
@@ -409,6 +479,152 @@ py::dict StructToDict(const TobiiResearchDisplayArea& data_)
 
     return d;
 }
+
+py::dict StructToDict(const TobiiTypes::latencySummary& data_)
+{
+    py::dict d;
+    d["count"] = data_.count;
+    d["min"] = data_.min;
+    d["max"] = data_.max;
+    d["mean"] = data_.mean;
+    d["p50"] = data_.p50;
+    d["p90"] = data_.p90;
+    d["p99"] = data_.p99;
+    d["p99_9"] = data_.p99_9;
+    return d;
+}
+
+py::dict StructToDict(const TobiiTypes::latencyStats& data_)
+{
+    py::dict d;
+    d["ingest"] = StructToDict(data_.ingest);
+    d["consume"] = StructToDict(data_.consume);
+    return d;
+}
+
+py::dict StructToDict(const TobiiTypes::memoryUsage& data_)
+{
+    py::dict d;
+    d["bytes"] = data_.bytes;
+    d["high_water_mark"] = data_.highWaterMark;
+    d["reserved"] = data_.reserved;
+    d["budget"] = data_.budget;
+    d["n_evicted"] = data_.nEvicted;
+    return d;
+}
+
+py::dict StructToDict(const TobiiTypes::bufferAllocation& data_)
+{
+    py::dict d;
+    d["prefault"] = data_.prefault;
+    d["lock"] = data_.lock;
+    d["huge_pages"] = data_.hugePages;
+    d["bytes"] = data_.bytes;
+    d["is_prefaulted"] = data_.isPrefaulted;
+    d["is_locked"] = data_.isLocked;
+    d["has_huge_pages"] = data_.hasHugePages;
+    d["error"] = data_.error;
+    return d;
+}
+
+py::dict StructToDict(const TobiiTypes::eyeImageReduction& data_)
+{
+    py::dict d;
+    d["crop"] = data_.crop;
+    d["crop_rect"] = data_.cropRect;
+    d["downscale"] = data_.downscale;
+    d["keep_every_n"] = data_.keepEveryN;
+    return d;
+}
+
+py::dict StructToDict(const TobiiTypes::eyeImageCompressionStats& data_)
+{
+    py::dict d;
+    d["enabled"] = data_.enabled;
+    d["num_threads"] = data_.numThreads;
+    d["cache_size"] = data_.cacheSize;
+    d["n_compressed"] = data_.nCompressed;
+    d["n_incompressible"] = data_.nIncompressible;
+    d["raw_bytes"] = data_.rawBytes;
+    d["compressed_bytes"] = data_.compressedBytes;
+    d["ratio"] = data_.ratio;
+    d["compress_time"] = data_.compressTime;
+    d["n_decompressed"] = data_.nDecompressed;
+    d["decompress_time"] = data_.decompressTime;
+    d["n_cache_hits"] = data_.nCacheHits;
+    d["cache_bytes"] = data_.cacheBytes;
+    return d;
+}
+
+py::dict StructToDict(TobiiTypes::allStreamsData&& data_)
+{
+    // only requested streams are included
+    py::dict d;
+    d["cut_off"] = data_.cutOff;
+    if (data_.gaze)
+        d["gaze"] = StructVectorToDict(std::move(*data_.gaze));
+    if (data_.eyeImage)
+        d["eye_image"] = StructVectorToDict(std::move(*data_.eyeImage));
+    if (data_.extSignal)
+        d["external_signal"] = StructVectorToDict(std::move(*data_.extSignal));
+    if (data_.timeSync)
+        d["time_sync"] = StructVectorToDict(std::move(*data_.timeSync));
+    if (data_.positioning)
+        d["positioning"] = StructVectorToDict(std::move(*data_.positioning));
+    if (data_.notification)
+        d["notification"] = StructVectorToDict(std::move(*data_.notification));
+    return d;
+}
+
+// reader of a shared memory sample ring, wrapped so that the variant is not converted by pybind's stl casters
+struct SharedMemoryReader
+{
+    SharedMemoryReader(std::string name_, const bool fromOldest_) : reader(openShmRingReader(std::move(name_), fromOldest_)) {}
+    AnyShmRingReader reader;
+};
+Titta::Stream shmStreamTypeToStream(const ShmRing::StreamType type_)
+{
+    switch (type_)
+    {
+    case ShmRing::StreamType::Gaze:
+        return Titta::Stream::Gaze;
+    case ShmRing::StreamType::ExtSignal:
+        return Titta::Stream::ExtSignal;
+    case ShmRing::StreamType::TimeSync:
+        return Titta::Stream::TimeSync;
+    case ShmRing::StreamType::Positioning:
+        break;
+    }
+    return Titta::Stream::Positioning;
+}
+
+py::dict DerivedToDict(const std::vector<TobiiTypes::derivedSample>& data_, const std::vector<std::string>& channels_)
+{
+    // one array per channel
+    py::dict d;
+    FieldToNpArray<true>(d, data_, "system_time_stamp", &TobiiTypes::derivedSample::system_time_stamp);
+    for (size_t c = 0; c < channels_.size(); c++)
+    {
+        py::array_t<double> a;
+        a.resize({ static_cast<py::ssize_t>(data_.size()) });
+        auto storage = a.mutable_data();
+        for (const auto& s : data_)
+            (*storage++) = c < s.values.size() ? s.values[c] : std::numeric_limits<double>::quiet_NaN();
+        d[channels_[c].c_str()] = a;
+    }
+    return d;
+}
+
+// destroying a Titta instance waits for its threads (e.g. the calibration thread), which may be calling
+// into python. So release the GIL while doing so
+struct GilReleasingDelete
+{
+    void operator()(Titta* instance_) const
+    {
+        py::gil_scoped_release release;
+        delete instance_;
+    }
+};
 }
 
 
@@ -496,6 +712,8 @@ PYBIND11_MODULE(MODULE_NAME, m)
         .value("compute", TobiiTypes::CalibrationAction::Compute)
         .value("get_calibration_data", TobiiTypes::CalibrationAction::GetCalibrationData)
         .value("apply_calibration_data", TobiiTypes::CalibrationAction::ApplyCalibrationData)
+        .value("cache_calibration_data", TobiiTypes::CalibrationAction::CacheCalibrationData)
+        .value("apply_cached_calibration_data", TobiiTypes::CalibrationAction::ApplyCachedCalibrationData)
         .value("exit", TobiiTypes::CalibrationAction::Exit)
         ;
     py::enum_<TobiiResearchCalibrationStatus>(m, "calibration_status", py::module_local())
@@ -549,15 +767,73 @@ PYBIND11_MODULE(MODULE_NAME, m)
     m.def("get_system_timestamp", &Titta::getSystemTimestamp);
     m.def("find_all_eye_trackers", []() {return StructVectorToList(Titta::findAllEyeTrackers()); });
     m.def("get_eye_tracker_from_address", [](std::string address_) {return StructToDict(Titta::getEyeTrackerFromAddress(std::move(address_))); });
+    // eye tracker discovery. NB: release the GIL while waiting for the discovery thread, it may be calling into python
+    m.def("start_eye_tracker_discovery", &Titta::startEyeTrackerDiscovery,
+        py::arg_v("interval_ms", std::nullopt, "None"), py::call_guard<py::gil_scoped_release>());
+    m.def("stop_eye_tracker_discovery", &Titta::stopEyeTrackerDiscovery, py::call_guard<py::gil_scoped_release>());
+    m.def("is_eye_tracker_discovery_running", &Titta::isEyeTrackerDiscoveryRunning);
+    m.def("refresh_eye_trackers", &Titta::refreshEyeTrackers,
+        py::arg_v("wait", std::nullopt, "None"), py::call_guard<py::gil_scoped_release>());
+    m.def("get_discovered_eye_trackers", []() { return StructVectorToList(Titta::getDiscoveredEyeTrackers()); });
+    m.def("get_eye_tracker_discovery_events", [](std::optional<bool> clear_) { return StructVectorToList(Titta::getEyeTrackerDiscoveryEvents(clear_)); },
+        py::arg_v("clear", std::nullopt, "None"));
+    m.def("set_eye_tracker_discovery_callback", [](std::optional<py::function> callback_)
+        {
+            if (!callback_)
+            {
+                Titta::setEyeTrackerDiscoveryCallback({});
+                return;
+            }
+            // the callback is invoked on the discovery thread, make sure the python function is
+            // only touched while holding the GIL, also when it is destroyed
+            std::shared_ptr<py::function> cb(new py::function(std::move(*callback_)), [](py::function* f_) { py::gil_scoped_acquire acquire; delete f_; });
+            Titta::setEyeTrackerDiscoveryCallback([cb](EyeTrackerDiscovery::event event_)
+                {
+                    py::gil_scoped_acquire acquire;
+                    try
+                    {
+                        (*cb)(StructToDict(event_));
+                    }
+                    catch (py::error_already_set& e)
+                    {
+                        e.discard_as_unraisable("eye tracker discovery callback");
+                    }
+                });
+        },
+        py::arg_v("callback", std::nullopt, "None"));
+    // the discovery thread and python callback must be gone before the interpreter shuts down
+    py::module_::import("atexit").attr("register")(py::cpp_function([]()
+        {
+            py::gil_scoped_release release;
+            Titta::stopEyeTrackerDiscovery();
+            Titta::setEyeTrackerDiscoveryCallback({});
+        }));
     // logging
     m.def("start_logging", &Titta::startLogging,
         py::arg_v("initial_buffer_size", std::nullopt, "None"));
     m.def("get_log", [](bool clearLog_) -> py::list { return StructVectorToList(Titta::getLog(clearLog_)); },
         py::arg_v("clear_log", std::nullopt, "None"));
     m.def("stop_logging", &Titta::stopLogging);
+    m.def("set_log_level", &Titta::setLogLevel,
+        "level"_a);
+    m.def("get_log_level", &Titta::getLogLevel);
+    m.def("get_num_dropped_log_messages", &Titta::getNumDroppedLogMessages);
+    m.def("start_log_file", &Titta::startLogFile,
+        "file_name"_a, py::arg_v("max_bytes", std::nullopt, "None"), py::arg_v("max_files", std::nullopt, "None"));
+    m.def("stop_log_file", &Titta::stopLogFile);
+    // tracing
+    m.def("is_tracing_enabled", &Titta::isTracingEnabled);
+    m.def("get_trace", &Titta::getTrace,
+        py::arg_v("clear", std::nullopt, "None"));
+    // thread scheduling
+    m.def("set_thread_settings", &Titta::setThreadSettings,
+        py::arg_v("policy", std::nullopt, "None"), py::arg_v("priority", std::nullopt, "None"), py::arg_v("nice", std::nullopt, "None"), py::arg_v("cpus", std::nullopt, "None"));
+    m.def("get_thread_settings", []() { return StructVectorToList(Titta::getThreadSettings()); });
+    // processing pipeline
+    m.def("get_pipeline_stage_types", &Titta::getPipelineStageTypes);
 
     // main class
-    auto cET = py::class_<Titta>(m, "EyeTracker", py::module_local())
+    auto cET = py::class_<Titta, std::unique_ptr<Titta, GilReleasingDelete>>(m, "EyeTracker", py::module_local())
         .def(py::init<std::string>(),"address"_a)
 
         .def("__repr__",
@@ -579,17 +855,17 @@ PYBIND11_MODULE(MODULE_NAME, m)
 
         //// eye-tracker specific getters and setters
         .def_property_readonly("info", &Titta::getEyeTrackerInfo)
-        .def_property         ("device_name",           [](Titta& instance_) { return                    instance_.getEyeTrackerInfo("deviceName").deviceName; }, &Titta::setDeviceName)
-        .def_property_readonly("serial_number",         [](Titta& instance_) { return                    instance_.getEyeTrackerInfo("serialNumber").serialNumber; })
-        .def_property_readonly("model",                 [](Titta& instance_) { return                    instance_.getEyeTrackerInfo("model").model; })
-        .def_property_readonly("firmware_version",      [](Titta& instance_) { return                    instance_.getEyeTrackerInfo("firmwareVersion").firmwareVersion; })
-        .def_property_readonly("runtime_version",       [](Titta& instance_) { return                    instance_.getEyeTrackerInfo("runtimeVersion").runtimeVersion; })
-        .def_property_readonly("address",               [](Titta& instance_) { return                    instance_.getEyeTrackerInfo("address").address; })
-        .def_property_readonly("capabilities",          [](Titta& instance_) { return CapabilitiesToList(instance_.getEyeTrackerInfo("capabilities").capabilities); })
-        .def_property_readonly("supported_frequencies", [](Titta& instance_) { return                    instance_.getEyeTrackerInfo("supportedFrequencies").supportedFrequencies; })
-        .def_property_readonly("supported_modes",       [](Titta& instance_) { return                    instance_.getEyeTrackerInfo("supportedModes").supportedModes; })
-        .def_property         ("frequency",             [](Titta& instance_) { return                    instance_.getEyeTrackerInfo("frequency").frequency; }, &Titta::setFrequency)
-        .def_property         ("tracking_mode",         [](Titta& instance_) { return                    instance_.getEyeTrackerInfo("trackingMode").trackingMode; }, &Titta::setTrackingMode)
+        .def_property         ("device_name",           [](Titta& instance_) { return                    instance_.getEyeTrackerInfo().deviceName; }, &Titta::setDeviceName)
+        .def_property_readonly("serial_number",         [](Titta& instance_) { return                    instance_.getEyeTrackerInfo().serialNumber; })
+        .def_property_readonly("model",                 [](Titta& instance_) { return                    instance_.getEyeTrackerInfo().model; })
+        .def_property_readonly("firmware_version",      [](Titta& instance_) { return                    instance_.getEyeTrackerInfo().firmwareVersion; })
+        .def_property_readonly("runtime_version",       [](Titta& instance_) { return                    instance_.getEyeTrackerInfo().runtimeVersion; })
+        .def_property_readonly("address",               [](Titta& instance_) { return                    instance_.getEyeTrackerInfo().address; })
+        .def_property_readonly("capabilities",          [](Titta& instance_) { return CapabilitiesToList(instance_.getEyeTrackerInfo().capabilities); })
+        .def_property_readonly("supported_frequencies", [](Titta& instance_) { return                    instance_.getEyeTrackerInfo().supportedFrequencies; })
+        .def_property_readonly("supported_modes",       [](Titta& instance_) { return                    instance_.getEyeTrackerInfo().supportedModes; })
+        .def_property         ("frequency",             [](Titta& instance_) { return                    instance_.getEyeTrackerInfo().frequency; }, &Titta::setFrequency)
+        .def_property         ("tracking_mode",         [](Titta& instance_) { return                    instance_.getEyeTrackerInfo().trackingMode; }, &Titta::setTrackingMode)
         .def_property_readonly("display_area",          [](const Titta& instance_) { return StructToDict(instance_.getDisplayArea()); })
         // modifiers
         .def("apply_licenses", &Titta::applyLicenses,
@@ -597,12 +873,13 @@ PYBIND11_MODULE(MODULE_NAME, m)
         .def("clear_licenses", &Titta::clearLicenses)
 
         //// calibration
+        // NB: release the GIL for calls that may wait for the calibration thread, it may be calling into python
         .def("enter_calibration_mode", &Titta::enterCalibrationMode,
-            "do_monocular"_a)
+            "do_monocular"_a, py::call_guard<py::gil_scoped_release>())
         .def("is_in_calibration_mode", &Titta::isInCalibrationMode,
             py::arg_v("issue_error_if_not_", std::nullopt, "None"))
         .def("leave_calibration_mode", &Titta::leaveCalibrationMode,
-            py::arg_v("force", std::nullopt, "None"))
+            py::arg_v("force", std::nullopt, "None"), py::call_guard<py::gil_scoped_release>())
         .def("calibration_collect_data", &Titta::calibrationCollectData,
             "coordinates"_a, py::arg_v("eye", std::nullopt, "None"))
         .def("calibration_discard_data", &Titta::calibrationDiscardData,
@@ -620,6 +897,75 @@ PYBIND11_MODULE(MODULE_NAME, m)
 
                 return StructToDict(*res);
             })
+        .def("calibration_wait_for_result", [](Titta& instance_, std::optional<uint64_t> requestId_, std::optional<double> timeOutMs_) -> std::optional<py::dict>
+            {
+                std::optional<TobiiTypes::CalibrationWorkResult> res;
+                {
+                    py::gil_scoped_release release;
+                    res = instance_.calibrationWaitForResult(requestId_, timeOutMs_, true);
+                }
+                if (!res.has_value())
+                    return {};
+
+                return StructToDict(*res);
+            },
+            py::arg_v("request_id", std::nullopt, "None"), py::arg_v("timeout_ms", std::nullopt, "None"))
+        // returns an awaitable for use with asyncio, resolves to the result (or None if calibration mode was left before it was produced)
+        .def("calibration_result_async", [](py::object self_, std::optional<uint64_t> requestId_)
+            {
+                auto loop = py::module_::import("asyncio").attr("get_running_loop")();
+                return loop.attr("run_in_executor")(py::none(), py::cpp_function([self_, requestId_]() -> std::optional<py::dict>
+                    {
+                        auto& instance = self_.cast<Titta&>();
+                        std::optional<TobiiTypes::CalibrationWorkResult> res;
+                        {
+                            py::gil_scoped_release release;
+                            res = instance.calibrationWaitForResult(requestId_, std::nullopt, true);
+                        }
+                        if (!res.has_value())
+                            return {};
+
+                        return StructToDict(*res);
+                    }));
+            },
+            py::arg_v("request_id", std::nullopt, "None"))
+        .def("set_calibration_result_callback", [](Titta& instance_, std::optional<py::function> callback_)
+            {
+                if (!callback_)
+                {
+                    instance_.setCalibrationResultCallback({});
+                    return;
+                }
+                // the callback is invoked on the calibration thread, make sure the python function is
+                // only touched while holding the GIL, also when it is destroyed
+                std::shared_ptr<py::function> cb(new py::function(std::move(*callback_)), [](py::function* f_) { py::gil_scoped_acquire acquire; delete f_; });
+                instance_.setCalibrationResultCallback([cb](TobiiTypes::CalibrationWorkResult result_)
+                    {
+                        py::gil_scoped_acquire acquire;
+                        try
+                        {
+                            (*cb)(StructToDict(result_));
+                        }
+                        catch (py::error_already_set& e)
+                        {
+                            e.discard_as_unraisable("calibration result callback");
+                        }
+                    });
+            },
+            py::arg_v("callback", std::nullopt, "None"))
+        // calibration cache
+        .def("calibration_store_in_cache", &Titta::calibrationStoreInCache,
+            "participant"_a)
+        .def("calibration_apply_cached", &Titta::calibrationApplyCached,
+            "participant"_a)
+        .def("add_to_calibration_cache", &Titta::addToCalibrationCache,
+            "participant"_a, "cal_data"_a)
+        .def("has_cached_calibration", &Titta::hasCachedCalibration,
+            "participant"_a)
+        .def("get_cached_calibrations", &Titta::getCachedCalibrations)
+        .def("clear_calibration_cache", &Titta::clearCalibrationCache,
+            py::arg_v("participant", std::nullopt, "None"))
+        .def_property("calibration_cache_directory", &Titta::getCalibrationCacheDirectory, &Titta::setCalibrationCacheDirectory)
 
         //// data streams
         // query if stream is supported
@@ -631,12 +977,29 @@ PYBIND11_MODULE(MODULE_NAME, m)
         // deal with eyeOpenness stream
         .def("set_include_eye_openness_in_gaze", &Titta::setIncludeEyeOpennessInGaze,
             "include"_a)
+        // compact gaze storage
+        .def("set_compact_gaze_storage", &Titta::setCompactGazeStorage,
+            "compact"_a, py::arg_v("quantize", std::nullopt, "None"), py::arg_v("compress_old", std::nullopt, "None"))
+        .def_property_readonly("is_compact_gaze_storage", &Titta::isCompactGazeStorage)
 
         // start stream
         .def("start", [](Titta& instance_, std::string stream_, const std::optional<size_t> init_buf_, const std::optional<bool> as_gif_) { return instance_.start(std::move(stream_), init_buf_, as_gif_, true); },
             "stream"_a, py::arg_v("initial_buffer_size", std::nullopt, "None"), py::arg_v("as_gif", std::nullopt, "None"))
         .def("start", py::overload_cast<Titta::Stream, std::optional<size_t>, std::optional<bool>>(&Titta::start),
             "stream"_a, py::arg_v("initial_buffer_size", std::nullopt, "None"), py::arg_v("as_gif", std::nullopt, "None"))
+        // decoding of gif eye images
+        .def("set_eye_image_decoding", &Titta::setEyeImageDecoding,
+            "mode"_a, py::arg_v("num_threads", std::nullopt, "None"))
+        .def_property_readonly("eye_image_decoding", &Titta::getEyeImageDecoding)
+        // reduction of eye images at ingest
+        .def("set_eye_image_reduction", &Titta::setEyeImageReduction,
+            py::arg_v("crop", std::nullopt, "None"), py::arg_v("crop_rect", std::nullopt, "None"), py::arg_v("downscale", std::nullopt, "None"), py::arg_v("keep_every_n", std::nullopt, "None"))
+        .def_property_readonly("eye_image_reduction", [](const Titta& instance_) { return StructToDict(instance_.getEyeImageReduction()); })
+        // in-memory compression of eye images
+        .def("set_eye_image_compression", &Titta::setEyeImageCompression,
+            "compress"_a, py::arg_v("num_threads", std::nullopt, "None"), py::arg_v("cache_size", std::nullopt, "None"))
+        .def("get_eye_image_compression_stats", [](Titta& instance_, const std::optional<bool> reset_) { return StructToDict(instance_.getEyeImageCompressionStats(reset_)); },
+            py::arg_v("reset", std::nullopt, "None"))
 
         // request stream state
         .def("is_recording", [](const Titta& instance_, std::string stream_) -> bool { return instance_.isRecording(std::move(stream_), true); },
@@ -784,6 +1147,150 @@ PYBIND11_MODULE(MODULE_NAME, m)
             },
             "stream"_a, py::arg_v("time_start", std::nullopt, "None"), py::arg_v("time_end", std::nullopt, "None"))
 
+        // most recent sample, without taking the buffer lock
+        .def("get_latest",
+            [](Titta& instance_, std::variant<std::string, Titta::Stream> stream_)
+            -> py::dict
+            {
+                Titta::Stream stream;
+                if (std::holds_alternative<std::string>(stream_))
+                    stream = Titta::stringToStream(std::get<std::string>(stream_), true);
+                else
+                    stream = std::get<Titta::Stream>(stream_);
+
+                // output in same format as peek_n, empty if nothing received yet
+                auto toVec = []<typename T>(std::optional<T> sample_) { return sample_ ? std::vector<T>{std::move(*sample_)} : std::vector<T>{}; };
+                switch (stream)
+                {
+                case Titta::Stream::Gaze:
+                case Titta::Stream::EyeOpenness:
+                    return StructVectorToDict(toVec(instance_.getLatest<Titta::gaze>()));
+                case Titta::Stream::EyeImage:
+                    return StructVectorToDict(toVec(instance_.getLatest<Titta::eyeImage>()));
+                case Titta::Stream::ExtSignal:
+                    return StructVectorToDict(toVec(instance_.getLatest<Titta::extSignal>()));
+                case Titta::Stream::TimeSync:
+                    return StructVectorToDict(toVec(instance_.getLatest<Titta::timeSync>()));
+                case Titta::Stream::Positioning:
+                    return StructVectorToDict(toVec(instance_.getLatest<Titta::positioning>()));
+                case Titta::Stream::Notification:
+                    return StructVectorToDict(toVec(instance_.getLatest<Titta::notification>()));
+                }
+                return {};
+            },
+            "stream"_a)
+
+        // consume or peek several streams at once, up to a common cut-off time
+        .def("drain_all",
+            [](Titta& instance_, std::optional<std::vector<std::string>> streams_, const std::optional<int64_t> timeStart_, const std::optional<int64_t> cutOff_)
+            -> py::dict
+            {
+                if (streams_)
+                    return StructToDict(instance_.drainAll(std::move(*streams_), timeStart_, cutOff_, true));
+                return StructToDict(instance_.drainAll(std::nullopt, timeStart_, cutOff_));
+            },
+            py::arg_v("streams", std::nullopt, "None"), py::arg_v("time_start", std::nullopt, "None"), py::arg_v("cut_off", std::nullopt, "None"))
+        .def("snapshot_all",
+            [](Titta& instance_, std::optional<std::vector<std::string>> streams_, const std::optional<int64_t> timeStart_, const std::optional<int64_t> cutOff_)
+            -> py::dict
+            {
+                if (streams_)
+                    return StructToDict(instance_.snapshotAll(std::move(*streams_), timeStart_, cutOff_, true));
+                return StructToDict(instance_.snapshotAll(std::nullopt, timeStart_, cutOff_));
+            },
+            py::arg_v("streams", std::nullopt, "None"), py::arg_v("time_start", std::nullopt, "None"), py::arg_v("cut_off", std::nullopt, "None"))
+
+        // as-of join of gaze and external signals
+        .def("join_gaze_ext_signal",
+            [](Titta& instance_, const std::optional<int64_t> timeStart_, const std::optional<int64_t> timeEnd_)
+            -> py::dict
+            {
+                auto data = instance_.joinGazeExtSignal(timeStart_, timeEnd_);
+                py::dict d;
+                d["ext_signal_index"]   = py::array_t<int64_t> (static_cast<py::ssize_t>(data.extSignalIndex.size())  , data.extSignalIndex.data());
+                d["ext_signal_value"]   = py::array_t<uint32_t>(static_cast<py::ssize_t>(data.extSignalValue.size())  , data.extSignalValue.data());
+                d["nearest_gaze_index"] = py::array_t<int64_t> (static_cast<py::ssize_t>(data.nearestGazeIndex.size()), data.nearestGazeIndex.data());
+                d["gaze"]               = StructVectorToDict(std::move(data.gaze));
+                d["external_signal"]    = StructVectorToDict(std::move(data.extSignal));
+                return d;
+            },
+            py::arg_v("time_start", std::nullopt, "None"), py::arg_v("time_end", std::nullopt, "None"))
+
+        // resampling of gaze to a uniform grid
+        .def("resample_gaze",
+            [](Titta& instance_, const double frequency_, const std::optional<int64_t> timeStart_, const std::optional<int64_t> timeEnd_, const std::optional<int64_t> maxGap_, const std::optional<std::string> method_)
+            -> py::dict
+            {
+                return StructVectorToDict(instance_.resampleGaze(frequency_, timeStart_, timeEnd_, maxGap_, method_ ? GazeResampler::stringToMethod(*method_) : std::optional<GazeResampler::Method>{}));
+            },
+            "frequency"_a, py::arg_v("time_start", std::nullopt, "None"), py::arg_v("time_end", std::nullopt, "None"), py::arg_v("max_gap", std::nullopt, "None"), py::arg_v("method", std::nullopt, "None"))
+        .def("start_gaze_resampler",
+            [](Titta& instance_, const double frequency_, const std::optional<int64_t> maxGap_, const std::optional<std::string> method_, const std::optional<int64_t> gridStart_)
+            {
+                instance_.startGazeResampler(frequency_, maxGap_, method_ ? GazeResampler::stringToMethod(*method_) : std::optional<GazeResampler::Method>{}, gridStart_);
+            },
+            "frequency"_a, py::arg_v("max_gap", std::nullopt, "None"), py::arg_v("method", std::nullopt, "None"), py::arg_v("grid_start", std::nullopt, "None"))
+        .def("get_resampled_gaze", [](Titta& instance_) { return StructVectorToDict(instance_.getResampledGaze()); })
+        .def_property_readonly("is_gaze_resampler_running", &Titta::isGazeResamplerRunning)
+        .def("stop_gaze_resampler", [](Titta& instance_) { return StructVectorToDict(instance_.stopGazeResampler()); })
+
+        // processing pipeline with derived streams
+        .def("add_pipeline_stage", &Titta::addPipelineStage,
+            "name"_a, "type"_a, py::arg_v("params", std::nullopt, "None"))
+        .def("clear_pipeline", &Titta::clearPipeline)
+        .def("get_pipeline_stages", &Titta::getPipelineStages)
+        .def("get_derived_stream_channels", &Titta::getDerivedStreamChannels,
+            "name"_a)
+        .def("start_pipeline", &Titta::startPipeline)
+        .def("stop_pipeline", &Titta::stopPipeline)
+        .def_property_readonly("is_pipeline_running", &Titta::isPipelineRunning)
+        .def("consume_derived_N",
+            [](Titta& instance_, const std::string& name_, const std::optional<size_t> NSamp_, std::optional<std::variant<std::string, Titta::BufferSide>> side_)
+            -> py::dict
+            {
+                std::optional<Titta::BufferSide> side;
+                if (side_.has_value())
+                {
+                    if (std::holds_alternative<std::string>(*side_))
+                        side = Titta::stringToBufferSide(std::get<std::string>(*side_));
+                    else
+                        side = std::get<Titta::BufferSide>(*side_);
+                }
+                return DerivedToDict(instance_.consumeDerivedN(name_, NSamp_, side), instance_.getDerivedStreamChannels(name_));
+            },
+            "name"_a, py::arg_v("N_samples", std::nullopt, "None"), py::arg_v("side", std::nullopt, "None"))
+        .def("consume_derived_time_range",
+            [](Titta& instance_, const std::string& name_, const std::optional<int64_t> timeStart_, const std::optional<int64_t> timeEnd_)
+            -> py::dict
+            {
+                return DerivedToDict(instance_.consumeDerivedTimeRange(name_, timeStart_, timeEnd_), instance_.getDerivedStreamChannels(name_));
+            },
+            "name"_a, py::arg_v("time_start", std::nullopt, "None"), py::arg_v("time_end", std::nullopt, "None"))
+        .def("peek_derived_N",
+            [](Titta& instance_, const std::string& name_, const std::optional<size_t> NSamp_, std::optional<std::variant<std::string, Titta::BufferSide>> side_)
+            -> py::dict
+            {
+                std::optional<Titta::BufferSide> side;
+                if (side_.has_value())
+                {
+                    if (std::holds_alternative<std::string>(*side_))
+                        side = Titta::stringToBufferSide(std::get<std::string>(*side_));
+                    else
+                        side = std::get<Titta::BufferSide>(*side_);
+                }
+                return DerivedToDict(instance_.peekDerivedN(name_, NSamp_, side), instance_.getDerivedStreamChannels(name_));
+            },
+            "name"_a, py::arg_v("N_samples", std::nullopt, "None"), py::arg_v("side", std::nullopt, "None"))
+        .def("peek_derived_time_range",
+            [](Titta& instance_, const std::string& name_, const std::optional<int64_t> timeStart_, const std::optional<int64_t> timeEnd_)
+            -> py::dict
+            {
+                return DerivedToDict(instance_.peekDerivedTimeRange(name_, timeStart_, timeEnd_), instance_.getDerivedStreamChannels(name_));
+            },
+            "name"_a, py::arg_v("time_start", std::nullopt, "None"), py::arg_v("time_end", std::nullopt, "None"))
+        .def("clear_derived", &Titta::clearDerived,
+            "name"_a)
+
         // clear all buffer contents
         .def("clear", [](Titta& instance_, std::string stream_) { return instance_.clear(std::move(stream_), true); },
             "stream"_a)
@@ -801,6 +1308,53 @@ PYBIND11_MODULE(MODULE_NAME, m)
             "stream"_a, py::arg_v("clear_buffer", std::nullopt, "None"))
         .def("stop", py::overload_cast<Titta::Stream, std::optional<bool>>(&Titta::stop),
             "stream"_a, py::arg_v("clear_buffer", std::nullopt, "None"))
+
+        //// latency instrumentation
+        .def("get_latency_stats", [](Titta& instance_, std::string stream_, const std::optional<bool> reset_) { return StructToDict(instance_.getLatencyStats(std::move(stream_), reset_, true)); },
+            "stream"_a, py::arg_v("reset", std::nullopt, "None"))
+        .def("get_latency_stats", [](Titta& instance_, const Titta::Stream stream_, const std::optional<bool> reset_) { return StructToDict(instance_.getLatencyStats(stream_, reset_)); },
+            "stream"_a, py::arg_v("reset", std::nullopt, "None"))
+
+        //// memory governor
+        .def("get_memory_usage", [](Titta& instance_, std::string stream_) { return StructToDict(instance_.getMemoryUsage(std::move(stream_), true)); },
+            "stream"_a)
+        .def("get_memory_usage", [](Titta& instance_, const Titta::Stream stream_) { return StructToDict(instance_.getMemoryUsage(stream_)); },
+            "stream"_a)
+        .def("get_total_memory_usage", [](Titta& instance_) { return StructToDict(instance_.getTotalMemoryUsage()); })
+        .def("set_memory_budget", &Titta::setMemoryBudget,
+            "bytes"_a)
+        .def("set_stream_memory_budget", [](Titta& instance_, std::string stream_, const size_t bytes_) { instance_.setStreamMemoryBudget(std::move(stream_), bytes_, true); },
+            "stream"_a, "bytes"_a)
+        .def("set_stream_memory_budget", py::overload_cast<Titta::Stream, size_t>(&Titta::setStreamMemoryBudget),
+            "stream"_a, "bytes"_a)
+        .def_property("eviction_order",
+            [](const Titta& instance_) { return instance_.getEvictionOrder(true); },
+            [](Titta& instance_, const std::vector<std::string>& streams_) { instance_.setEvictionOrder(streams_, true); })
+        .def("set_buffer_allocation", &Titta::setBufferAllocation,
+            py::arg_v("prefault", std::nullopt, "None"), py::arg_v("lock", std::nullopt, "None"), py::arg_v("huge_pages", std::nullopt, "None"))
+        .def("get_buffer_allocation", [](Titta& instance_, std::string stream_) { return StructToDict(instance_.getBufferAllocation(std::move(stream_), true)); },
+            "stream"_a)
+        .def("get_buffer_allocation", [](Titta& instance_, const Titta::Stream stream_) { return StructToDict(instance_.getBufferAllocation(stream_)); },
+            "stream"_a)
+
+        //// shared memory
+        .def("start_shared_memory", [](Titta& instance_, std::string stream_, std::string name_, const std::optional<size_t> capacity_) { instance_.startSharedMemory(std::move(stream_), std::move(name_), capacity_, true); },
+            "stream"_a, "name"_a, py::arg_v("capacity", std::nullopt, "None"))
+        .def("start_shared_memory", py::overload_cast<Titta::Stream, std::string, std::optional<size_t>>(&Titta::startSharedMemory),
+            "stream"_a, "name"_a, py::arg_v("capacity", std::nullopt, "None"))
+        .def("get_shared_memory_name", [](Titta& instance_, std::string stream_) { return instance_.getSharedMemoryName(std::move(stream_), true); },
+            "stream"_a)
+        .def("get_shared_memory_name", py::overload_cast<Titta::Stream>(&Titta::getSharedMemoryName),
+            "stream"_a)
+        .def("stop_shared_memory", [](Titta& instance_, std::string stream_) { instance_.stopSharedMemory(std::move(stream_), true); },
+            "stream"_a)
+        .def("stop_shared_memory", py::overload_cast<Titta::Stream>(&Titta::stopSharedMemory),
+            "stream"_a)
+
+        //// replay of recorded session
+        .def_property_readonly("is_replay", &Titta::isReplay)
+        .def_property("replay_speed", &Titta::getReplaySpeed, &Titta::setReplaySpeed)
+        .def("is_replay_finished", &Titta::isReplayFinished)
         ;
 
     // nested enums
@@ -819,6 +1373,28 @@ PYBIND11_MODULE(MODULE_NAME, m)
         .value(Titta::bufferSideToString(Titta::BufferSide::End).c_str(), Titta::BufferSide::End)
         ;
 
+    // reader for samples written to shared memory by an EyeTracker, possibly in another process
+    py::class_<SharedMemoryReader>(m, "SharedMemoryReader", py::module_local())
+        .def(py::init<std::string, bool>(),
+            "name"_a, "from_oldest"_a = false)
+        .def("__repr__",
+            [](const SharedMemoryReader& instance_)
+            {
+                return std::visit([](const auto& r_) { return string_format("<TittaPy.SharedMemoryReader (%s, %s)>", r_.getName().c_str(), Titta::streamToString(shmStreamTypeToStream(r_.getStreamType()), true).c_str()); }, instance_.reader);
+            })
+        // samples written since the previous call, in the same format as EyeTracker.consume_N
+        .def("read",
+            [](SharedMemoryReader& instance_, const std::optional<size_t> NSamp_) -> py::dict
+            {
+                return std::visit([&](auto& r_) { return StructVectorToDict(NSamp_ ? r_.read(*NSamp_) : r_.read()); }, instance_.reader);
+            },
+            py::arg_v("N_samples", std::nullopt, "None"))
+        .def_property_readonly("name", [](const SharedMemoryReader& instance_) { return std::visit([](const auto& r_) { return r_.getName(); }, instance_.reader); })
+        .def_property_readonly("stream", [](const SharedMemoryReader& instance_) { return std::visit([](const auto& r_) { return shmStreamTypeToStream(r_.getStreamType()); }, instance_.reader); })
+        .def_property_readonly("num_dropped", [](const SharedMemoryReader& instance_) { return std::visit([](const auto& r_) { return r_.getNumDropped(); }, instance_.reader); })
+        .def_property_readonly("is_writer_closed", [](const SharedMemoryReader& instance_) { return std::visit([](const auto& r_) { return r_.isWriterClosed(); }, instance_.reader); })
+        ;
+
 // set module version info
 #define Q(x) #x
 #define QUOTE(x) Q(x)
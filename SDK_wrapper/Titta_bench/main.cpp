@@ -0,0 +1,428 @@
+// Microbenchmark of Titta's sample buffers under contention.
+// A producer thread drives Titta's ingest callbacks (gaze, eye images, external signal)
+// at configurable rates, while reader threads concurrently call consumeN, peekN,
+// peekTimeRange and clearTimeRange. Reported per buffer size and per operation are
+// throughput and the p50/p99/p99.9 latency of each call.
+//
+// No eye tracker is needed: the Titta instance is a replay instance (of a
+// one-sample dummy file) whose streams are never started. The producer calls the
+// callbacks directly, exactly as the SDK would.
+//
+// Results are written to stdout (tsv by default, or json lines), progress to stderr.
+//
+// Building on Linux (run from the SDK_wrapper directory):
+//   g++ -std=c++2a -O3 -DBUILD_FROM_SCRIPT -DTOBII_SDK_MAJOR_VERSION=2 -I. -Ideps/include -Ideps/include/SDKv2
+//       Titta_bench/main.cpp src/*.cpp -LTittaMex/mex -l:libtobii_research.so.2 -Wl,-rpath,'$ORIGIN/TittaMex/mex'
+//       -lpthread -o Titta_bench
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <cstring>
+#include <cmath>
+
+#include "Titta/Titta.h"
+#include "Titta/replay.h"
+#include "Titta/utils.h"
+
+// ingest callbacks of Titta, these are what the SDK calls
+void TittaGazeCallback     (TobiiResearchGazeData*            gaze_data_, void* user_data_);
+void TittaEyeImageCallback (TobiiResearchEyeImage*            eye_image_, void* user_data_);
+void TittaExtSignalCallback(TobiiResearchExternalSignalData* ext_signal_, void* user_data_);
+
+void DoExitWithMsg(std::string errMsg_)
+{
+    throw std::runtime_error(errMsg_);
+}
+void RelayMsg(std::string msg_)
+{
+    std::cerr << msg_ << std::endl;
+}
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct options
+    {
+        double              duration        = 5.;       // s, per buffer size
+        double              gazeRate        = 1200.;    // Hz, also determines the spacing of the (synthetic) timestamps
+        bool                noPacing        = false;    // if true, producer calls the callbacks as fast as possible
+        double              eyeImageRate    = 60.;      // Hz, 0 to disable
+        double              extSignalRate   = 10.;      // Hz, 0 to disable
+        int                 imageWidth      = 160;
+        int                 imageHeight     = 160;
+        std::vector<size_t> bufferSizes     = { 1'000, 10'000, 100'000 };
+        size_t              peekN           = 100;      // samples
+        double              peekWindow      = 100.;     // ms
+        int64_t             readerInterval  = 1000;     // us, pause between reader calls, 0 for busy loop
+        bool                compactGaze     = false;    // store gaze compactly, see Titta::setCompactGazeStorage()
+        bool                quantizeGaze    = false;
+        bool                compressGaze    = false;    // compress older gaze blocks in the background
+        bool                json            = false;
+    };
+
+    void printUsage()
+    {
+        std::cerr <<
+            "usage: Titta_bench [options]\n"
+            "  --duration <s>               duration of each run (default 5)\n"
+            "  --gaze-rate <Hz>             gaze sample rate (default 1200)\n"
+            "  --no-pacing                  deliver samples as fast as possible\n"
+            "  --eye-image-rate <Hz>        eye image rate, 0 to disable (default 60)\n"
+            "  --ext-signal-rate <Hz>       external signal rate, 0 to disable (default 10)\n"
+            "  --image-size <w>x<h>         eye image size in pixels (default 160x160)\n"
+            "  --buffer-sizes <n,n,...>     gaze buffer sizes to run with (default 1000,10000,100000)\n"
+            "  --peek-n <n>                 number of samples requested by peekN (default 100)\n"
+            "  --peek-window <ms>           time window requested by peekTimeRange (default 100)\n"
+            "  --reader-interval <us>       pause between reader calls, 0 for busy loop (default 1000)\n"
+            "  --compact-gaze               store gaze samples in compact form\n"
+            "  --compact-gaze-quantized     store gaze samples in compact form, with quantized display coordinates\n"
+            "  --compact-gaze-compressed    store gaze samples in compact form, with older samples compressed\n"
+            "  --json                       output json lines instead of tsv\n";
+    }
+
+    options parseOptions(int argc_, char** argv_)
+    {
+        options opt;
+        for (int i = 1; i < argc_; i++)
+        {
+            const std::string arg = argv_[i];
+            auto next = [&]() -> std::string
+            {
+                if (i + 1 >= argc_)
+                    throw std::runtime_error("option " + arg + " expects a value");
+                return argv_[++i];
+            };
+
+            if (arg == "--duration")
+                opt.duration = std::stod(next());
+            else if (arg == "--gaze-rate")
+                opt.gazeRate = std::stod(next());
+            else if (arg == "--no-pacing")
+                opt.noPacing = true;
+            else if (arg == "--compact-gaze")
+                opt.compactGaze = true;
+            else if (arg == "--compact-gaze-quantized")
+                opt.compactGaze = opt.quantizeGaze = true;
+            else if (arg == "--compact-gaze-compressed")
+                opt.compactGaze = opt.compressGaze = true;
+            else if (arg == "--eye-image-rate")
+                opt.eyeImageRate = std::stod(next());
+            else if (arg == "--ext-signal-rate")
+                opt.extSignalRate = std::stod(next());
+            else if (arg == "--image-size")
+            {
+                const auto val = next();
+                const auto x = val.find('x');
+                if (x == std::string::npos)
+                    throw std::runtime_error("--image-size expects a value of the form <width>x<height>");
+                opt.imageWidth  = std::stoi(val.substr(0, x));
+                opt.imageHeight = std::stoi(val.substr(x + 1));
+            }
+            else if (arg == "--buffer-sizes")
+            {
+                opt.bufferSizes.clear();
+                std::stringstream ss(next());
+                for (std::string item; std::getline(ss, item, ',');)
+                    opt.bufferSizes.push_back(std::stoull(item));
+            }
+            else if (arg == "--peek-n")
+                opt.peekN = std::stoull(next());
+            else if (arg == "--peek-window")
+                opt.peekWindow = std::stod(next());
+            else if (arg == "--reader-interval")
+                opt.readerInterval = std::stoll(next());
+            else if (arg == "--json")
+                opt.json = true;
+            else if (arg == "--help" || arg == "-h")
+            {
+                printUsage();
+                std::exit(0);
+            }
+            else
+                throw std::runtime_error("unknown option " + arg);
+        }
+        if (opt.gazeRate <= 0.)
+            throw std::runtime_error("--gaze-rate should be positive");
+        if (opt.duration <= 0.)
+            throw std::runtime_error("--duration should be positive");
+        return opt;
+    }
+
+    // latencies and item counts of calls to a single operation
+    struct opStats
+    {
+        std::string             name;
+        std::vector<int64_t>    latencies;  // ns
+        size_t                  items = 0;  // samples delivered or returned
+
+        explicit opStats(std::string name_, size_t reserve_ = 0) : name(std::move(name_)) { latencies.reserve(reserve_); }
+
+        template <typename F>
+        auto time(F&& f_)
+        {
+            const auto t0 = clock_type::now();
+            if constexpr (std::is_void_v<decltype(f_())>)
+            {
+                f_();
+                latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - t0).count());
+            }
+            else
+            {
+                auto ret = f_();
+                latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - t0).count());
+                return ret;
+            }
+        }
+    };
+
+    int64_t percentile(const std::vector<int64_t>& sorted_, const double p_)
+    {
+        if (sorted_.empty())
+            return 0;
+        const auto idx = static_cast<size_t>(std::ceil(p_ / 100. * static_cast<double>(sorted_.size()))) - 1;
+        return sorted_[std::min(idx, sorted_.size() - 1)];
+    }
+
+    void printHeader(const options& opt_)
+    {
+        if (!opt_.json)
+            std::cout << "buffer_size\toperation\tcalls\tcalls_per_s\titems_per_s\tp50_ns\tp99_ns\tp99_9_ns\tmax_ns\n";
+    }
+
+    void printStats(const options& opt_, const size_t bufferSize_, opStats& s_, const double elapsed_)
+    {
+        std::sort(s_.latencies.begin(), s_.latencies.end());
+        const auto n        = s_.latencies.size();
+        const auto callRate = static_cast<double>(n) / elapsed_;
+        const auto itemRate = static_cast<double>(s_.items) / elapsed_;
+        const auto p50      = percentile(s_.latencies, 50.);
+        const auto p99      = percentile(s_.latencies, 99.);
+        const auto p999     = percentile(s_.latencies, 99.9);
+        const auto max      = n ? s_.latencies.back() : 0;
+
+        if (opt_.json)
+            std::cout << string_format(R"({"buffer_size": %zu, "operation": "%s", "calls": %zu, "calls_per_s": %.1f, "items_per_s": %.1f, "p50_ns": %lld, "p99_ns": %lld, "p99_9_ns": %lld, "max_ns": %lld})",
+                bufferSize_, s_.name.c_str(), n, callRate, itemRate,
+                static_cast<long long>(p50), static_cast<long long>(p99), static_cast<long long>(p999), static_cast<long long>(max)) << '\n';
+        else
+            std::cout << string_format("%zu\t%s\t%zu\t%.1f\t%.1f\t%lld\t%lld\t%lld\t%lld",
+                bufferSize_, s_.name.c_str(), n, callRate, itemRate,
+                static_cast<long long>(p50), static_cast<long long>(p99), static_cast<long long>(p999), static_cast<long long>(max)) << '\n';
+        std::cout.flush();
+    }
+
+    void readerPause(const options& opt_)
+    {
+        if (opt_.readerInterval > 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(opt_.readerInterval));
+        else
+            std::this_thread::yield();
+    }
+
+    void runOne(Titta& titta_, const options& opt_, const size_t bufferSize_)
+    {
+        // start with clean buffers
+        titta_.clear(Titta::Stream::Gaze);
+        titta_.clear(Titta::Stream::EyeImage);
+        titta_.clear(Titta::Stream::ExtSignal);
+
+        // synthetic timestamps, spaced according to the nominal gaze rate
+        const auto    samplePeriod  = 1'000'000. / opt_.gazeRate;   // us
+        auto          sampleTime    = [&](const int64_t i_) { return static_cast<int64_t>(std::llround(static_cast<double>(i_) * samplePeriod)); };
+        const int64_t eyeImageEvery = opt_.eyeImageRate  > 0. ? std::max<int64_t>(1, std::llround(opt_.gazeRate / opt_.eyeImageRate )) : 0;
+        const int64_t extSignalEvery= opt_.extSignalRate > 0. ? std::max<int64_t>(1, std::llround(opt_.gazeRate / opt_.extSignalRate)) : 0;
+
+        TobiiResearchGazeData gaze{};
+        gaze.left_eye .gaze_point.validity  = TOBII_RESEARCH_VALIDITY_VALID;
+        gaze.right_eye.gaze_point.validity  = TOBII_RESEARCH_VALIDITY_VALID;
+        gaze.left_eye .pupil_data.validity  = TOBII_RESEARCH_VALIDITY_VALID;
+        gaze.right_eye.pupil_data.validity  = TOBII_RESEARCH_VALIDITY_VALID;
+        gaze.left_eye .gaze_origin.validity = TOBII_RESEARCH_VALIDITY_VALID;
+        gaze.right_eye.gaze_origin.validity = TOBII_RESEARCH_VALIDITY_VALID;
+
+        std::vector<uint8_t> imageData(static_cast<size_t>(opt_.imageWidth) * opt_.imageHeight, 128);
+        TobiiResearchEyeImage eyeImage{};
+        eyeImage.bits_per_pixel = 8;
+        eyeImage.width          = opt_.imageWidth;
+        eyeImage.height         = opt_.imageHeight;
+        eyeImage.type           = TOBII_RESEARCH_EYE_IMAGE_TYPE_FULL;
+        eyeImage.data_size      = imageData.size();
+        eyeImage.data           = imageData.data();
+
+        TobiiResearchExternalSignalData extSignal{};
+        extSignal.change_type   = TOBII_RESEARCH_EXTERNAL_SIGNAL_VALUE_CHANGED;
+
+        // prefill gaze buffer up to the requested size, indices are negative so that
+        // the measured run starts at index 0
+        const auto prefill = static_cast<int64_t>(bufferSize_);
+        for (int64_t i = -prefill; i < 0; i++)
+        {
+            gaze.device_time_stamp = gaze.system_time_stamp = sampleTime(i);
+            TittaGazeCallback(&gaze, &titta_);
+        }
+
+        const auto expectedSamples = static_cast<size_t>(opt_.noPacing ? 1'000'000. * opt_.duration : opt_.gazeRate * opt_.duration * 1.1);
+        opStats gazeCb   ("callback_gaze", expectedSamples);
+        opStats imageCb  ("callback_eyeImage",  eyeImageEvery  ? expectedSamples / eyeImageEvery  + 1 : 0);
+        opStats extSigCb ("callback_extSignal", extSignalEvery ? expectedSamples / extSignalEvery + 1 : 0);
+        opStats consume  ("consumeN_gaze");
+        opStats consumeIm("consumeN_eyeImage");
+        opStats consumeES("consumeN_extSignal");
+        opStats peekN    ("peekN_gaze");
+        opStats peekRange("peekTimeRange_gaze");
+        opStats clearRng ("clearTimeRange_gaze");
+
+        std::atomic<bool>    stop = false;
+        std::atomic<int64_t> produced = 0;              // index of next sample to be produced
+
+        // keeps the gaze buffer at the requested size by consuming the oldest samples.
+        // Also empties the eye image and external signal buffers
+        std::thread consumer([&]()
+        {
+            int64_t consumed = 0;
+            while (!stop)
+            {
+                if (const auto excess = produced.load() + prefill - consumed - static_cast<int64_t>(bufferSize_); excess > 0)
+                {
+                    const auto n = consume.time([&]() { return titta_.consumeN<Titta::gaze>(static_cast<size_t>(excess), Titta::BufferSide::Start); }).size();
+                    consume.items += n;
+                    consumed += static_cast<int64_t>(n);
+                }
+                if (eyeImageEvery)
+                    consumeIm.items += consumeIm.time([&]() { return titta_.consumeN<Titta::eyeImage>(); }).size();
+                if (extSignalEvery)
+                    consumeES.items += consumeES.time([&]() { return titta_.consumeN<Titta::extSignal>(); }).size();
+                readerPause(opt_);
+            }
+        });
+        std::thread peeker([&]()
+        {
+            while (!stop)
+            {
+                peekN.items += peekN.time([&]() { return titta_.peekN<Titta::gaze>(opt_.peekN, Titta::BufferSide::End); }).size();
+                readerPause(opt_);
+            }
+        });
+        std::thread rangePeeker([&]()
+        {
+            const auto window = static_cast<int64_t>(opt_.peekWindow * 1000.);
+            while (!stop)
+            {
+                const auto latest = sampleTime(produced.load() - 1);
+                peekRange.items += peekRange.time([&]() { return titta_.peekTimeRange<Titta::gaze>(latest - window, latest); }).size();
+                readerPause(opt_);
+            }
+        });
+        // backstop that clears everything older than 1.5 times the requested buffer
+        // size. When the consumer keeps up this removes nothing, but it still contends
+        // for the write lock and has to search the buffer
+        std::thread clearer([&]()
+        {
+            const auto keep = static_cast<int64_t>(bufferSize_ + bufferSize_ / 2);
+            while (!stop)
+            {
+                const auto before = sampleTime(produced.load() - keep);
+                clearRng.time([&]() { titta_.clearTimeRange(Titta::Stream::Gaze, std::nullopt, before); });
+                readerPause(opt_);
+            }
+        });
+
+        // producer, runs on this thread
+        const auto start = clock_type::now();
+        const auto end   = start + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(opt_.duration));
+        const auto period= std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(1. / opt_.gazeRate));
+        auto nextTime    = start;
+        for (int64_t i = 0; ; i++)
+        {
+            const auto ts = sampleTime(i);
+            gaze.device_time_stamp = gaze.system_time_stamp = ts;
+            gazeCb.time([&]() { TittaGazeCallback(&gaze, &titta_); });
+            gazeCb.items++;
+            if (eyeImageEvery && i % eyeImageEvery == 0)
+            {
+                eyeImage.device_time_stamp = eyeImage.system_time_stamp = ts;
+                imageCb.time([&]() { TittaEyeImageCallback(&eyeImage, &titta_); });
+                imageCb.items++;
+            }
+            if (extSignalEvery && i % extSignalEvery == 0)
+            {
+                extSignal.device_time_stamp = extSignal.system_time_stamp = ts;
+                extSignal.value = static_cast<uint32_t>(i / extSignalEvery) & 0xFF;
+                extSigCb.time([&]() { TittaExtSignalCallback(&extSignal, &titta_); });
+                extSigCb.items++;
+            }
+            produced = i + 1;
+
+            if (opt_.noPacing)
+            {
+                if (clock_type::now() >= end)
+                    break;
+            }
+            else
+            {
+                nextTime += period;
+                if (nextTime >= end)
+                    break;
+                std::this_thread::sleep_until(nextTime);
+            }
+        }
+        const auto elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+
+        stop = true;
+        consumer.join();
+        peeker.join();
+        rangePeeker.join();
+        clearer.join();
+
+        for (auto s : { &gazeCb, &imageCb, &extSigCb, &consume, &consumeIm, &consumeES, &peekN, &peekRange, &clearRng })
+            if (!s->latencies.empty())
+                printStats(opt_, bufferSize_, *s, elapsed);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const auto opt = parseOptions(argc, argv);
+
+        // a replay instance needs a file to replay, make a minimal one. Its streams
+        // are never started, so it doesn't deliver any data of its own
+        const auto dummyFile = std::filesystem::temp_directory_path() / "Titta_bench_gaze.tsv";
+        {
+            std::ofstream f(dummyFile);
+            f << "device_time_stamp\tsystem_time_stamp\n0\t0\n";
+        }
+        Titta titta(std::string(TittaReplay::addressPrefix) + dummyFile.string());
+        std::filesystem::remove(dummyFile);
+        if (opt.compactGaze)
+            titta.setCompactGazeStorage(true, opt.quantizeGaze, opt.compressGaze);
+
+        std::cerr << string_format("Titta_bench: gaze rate %.1f Hz%s%s, eye image rate %.1f Hz (%dx%d), ext signal rate %.1f Hz, %.1f s per run, reader interval %lld us",
+            opt.gazeRate, opt.noPacing ? " (unpaced)" : "", opt.compactGaze ? (opt.quantizeGaze ? (opt.compressGaze ? " (compact, quantized, compressed)" : " (compact, quantized)") : (opt.compressGaze ? " (compact, compressed)" : " (compact)")) : "", opt.eyeImageRate, opt.imageWidth, opt.imageHeight, opt.extSignalRate,
+            opt.duration, static_cast<long long>(opt.readerInterval)) << std::endl;
+
+        printHeader(opt);
+        for (const auto bufferSize : opt.bufferSizes)
+        {
+            std::cerr << "Titta_bench: running with buffer size " << bufferSize << std::endl;
+            runOne(titta, opt, bufferSize);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage();
+        return 1;
+    }
+    return 0;
+}
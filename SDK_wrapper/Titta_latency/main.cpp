@@ -0,0 +1,460 @@
+// End-to-end latency of gaze samples through Titta, for qualifying machines, kernels
+// and configurations. For each sample it measures, against the sample's system_time_stamp:
+//   arrival:  when the sample is delivered to the gaze callback
+//   visible:  when a consumer thread that waits for new data sees the sample (through
+//             getLatestCount() and consumeN())
+// Titta's own ingest statistics (see Titta::getLatencyStats()) are reported alongside.
+//
+// The samples come either from an eye tracker (--address), in which case an extra gaze
+// subscription next to Titta's is used to time the callback arrival, or from a simulated
+// backend: a producer thread that calls Titta's gaze callback at the nominal time of each
+// sample, as the SDK would. Its timestamps are the nominal times, so arrival includes the
+// producer's wakeup latency. Buffer configuration and the scheduling of Titta's threads,
+// the SDK's threads and the consumer thread can be set, so that their effect can be compared.
+//
+// A summary is written to stdout (tsv by default, or json lines), progress to stderr. With
+// --histogram, the latency histograms are additionally written to a tsv file.
+//
+// Building on Linux (run from the SDK_wrapper directory):
+//   g++ -std=c++2a -O3 -DBUILD_FROM_SCRIPT -DTOBII_SDK_MAJOR_VERSION=2 -I. -Ideps/include -Ideps/include/SDKv2
+//       Titta_latency/main.cpp src/*.cpp -LTittaMex/mex -l:libtobii_research.so.2 -Wl,-rpath,'$ORIGIN/TittaMex/mex'
+//       -lpthread -o Titta_latency
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <optional>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <filesystem>
+#include <stdexcept>
+#include <cmath>
+
+#include "Titta/Titta.h"
+#include "Titta/replay.h"
+#include "Titta/threading.h"
+#include "Titta/utils.h"
+
+// ingest callback of Titta, this is what the SDK calls
+void TittaGazeCallback(TobiiResearchGazeData* gaze_data_, void* user_data_);
+
+void DoExitWithMsg(std::string errMsg_)
+{
+    throw std::runtime_error(errMsg_);
+}
+void RelayMsg(std::string msg_)
+{
+    std::cerr << msg_ << std::endl;
+}
+
+namespace
+{
+    using clock_type = std::chrono::steady_clock;
+
+    enum class WaitMode
+    {
+        Spin,       // busy loop
+        Yield,      // yield between checks
+        Sleep       // sleep for waitInterval between checks
+    };
+
+    struct options
+    {
+        std::optional<std::string>  address;                // eye tracker, simulated backend if not set
+        std::optional<double>       frequency;              // Hz, eye tracker is set to this frequency
+        double                      duration    = 10.;      // s
+        double                      gazeRate    = 1200.;    // Hz, of the simulated backend
+        double                      warmup      = 1.;       // s, samples received during this initial period are not counted
+        WaitMode                    waitMode    = WaitMode::Sleep;
+        int64_t                     waitInterval= 100;      // us, for WaitMode::Sleep
+        // buffer configuration
+        bool                        prefault    = false;
+        bool                        lock        = false;
+        std::string                 hugePages   = "none";
+        bool                        compactGaze = false;
+        // scheduling of Titta's and the SDK's threads, and of the consumer thread
+        TittaThreads::settings      threads;
+        // output
+        std::optional<std::string>  histogram;              // file to write histograms to
+        int64_t                     binWidth    = 10;       // us
+        bool                        json        = false;
+    };
+
+    std::string waitModeToString(const WaitMode mode_)
+    {
+        switch (mode_)
+        {
+            case WaitMode::Spin:    return "spin";
+            case WaitMode::Yield:   return "yield";
+            case WaitMode::Sleep:   return "sleep";
+        }
+        return "unknown";
+    }
+
+    void printUsage()
+    {
+        std::cerr <<
+            "usage: Titta_latency [options]\n"
+            "  --address <address>          eye tracker to use (default: simulated backend)\n"
+            "  --frequency <Hz>             set eye tracker to this sampling frequency\n"
+            "  --gaze-rate <Hz>             sample rate of the simulated backend (default 1200)\n"
+            "  --duration <s>               duration of the measurement (default 10)\n"
+            "  --warmup <s>                 initial period that is not measured (default 1)\n"
+            "  --wait spin|yield|sleep      how the consumer waits for new samples (default sleep)\n"
+            "  --wait-interval <us>         sleep between checks for new samples (default 100)\n"
+            "  --prefault                   prefault the gaze buffer, see Titta::setBufferAllocation()\n"
+            "  --lock                       lock the gaze buffer in memory\n"
+            "  --huge-pages <mode>          none, transparent or explicit (default none)\n"
+            "  --compact-gaze               store gaze samples in compact form\n"
+            "  --policy <policy>            scheduling policy of Titta's, the SDK's and the consumer thread: other, fifo or rr\n"
+            "  --priority <n>               priority for the fifo and rr policies\n"
+            "  --nice <n>                   nice value of these threads\n"
+            "  --cpus <n,n,...>             CPUs these threads may run on\n"
+            "  --histogram <file>           write latency histograms to this tsv file\n"
+            "  --bin-width <us>             bin width of the histograms (default 10)\n"
+            "  --json                       output json lines instead of tsv\n";
+    }
+
+    options parseOptions(int argc_, char** argv_)
+    {
+        options opt;
+        for (int i = 1; i < argc_; i++)
+        {
+            const std::string arg = argv_[i];
+            auto next = [&]() -> std::string
+            {
+                if (i + 1 >= argc_)
+                    throw std::runtime_error("option " + arg + " expects a value");
+                return argv_[++i];
+            };
+
+            if (arg == "--address")
+                opt.address = next();
+            else if (arg == "--frequency")
+                opt.frequency = std::stod(next());
+            else if (arg == "--gaze-rate")
+                opt.gazeRate = std::stod(next());
+            else if (arg == "--duration")
+                opt.duration = std::stod(next());
+            else if (arg == "--warmup")
+                opt.warmup = std::stod(next());
+            else if (arg == "--wait")
+            {
+                const auto val = next();
+                if (val == "spin")
+                    opt.waitMode = WaitMode::Spin;
+                else if (val == "yield")
+                    opt.waitMode = WaitMode::Yield;
+                else if (val == "sleep")
+                    opt.waitMode = WaitMode::Sleep;
+                else
+                    throw std::runtime_error("--wait expects spin, yield or sleep");
+            }
+            else if (arg == "--wait-interval")
+                opt.waitInterval = std::stoll(next());
+            else if (arg == "--prefault")
+                opt.prefault = true;
+            else if (arg == "--lock")
+                opt.lock = true;
+            else if (arg == "--huge-pages")
+                opt.hugePages = next();
+            else if (arg == "--compact-gaze")
+                opt.compactGaze = true;
+            else if (arg == "--policy")
+                opt.threads.policy = next();
+            else if (arg == "--priority")
+                opt.threads.priority = std::stoi(next());
+            else if (arg == "--nice")
+                opt.threads.nice = std::stoi(next());
+            else if (arg == "--cpus")
+            {
+                opt.threads.cpus.emplace();
+                std::stringstream ss(next());
+                for (std::string item; std::getline(ss, item, ',');)
+                    opt.threads.cpus->push_back(std::stoi(item));
+            }
+            else if (arg == "--histogram")
+                opt.histogram = next();
+            else if (arg == "--bin-width")
+                opt.binWidth = std::stoll(next());
+            else if (arg == "--json")
+                opt.json = true;
+            else if (arg == "--help" || arg == "-h")
+            {
+                printUsage();
+                std::exit(0);
+            }
+            else
+                throw std::runtime_error("unknown option " + arg);
+        }
+        if (opt.gazeRate <= 0.)
+            throw std::runtime_error("--gaze-rate should be positive");
+        if (opt.duration <= 0.)
+            throw std::runtime_error("--duration should be positive");
+        if (opt.warmup < 0.)
+            throw std::runtime_error("--warmup should not be negative");
+        if (opt.binWidth <= 0)
+            throw std::runtime_error("--bin-width should be positive");
+        if (opt.frequency && !opt.address)
+            throw std::runtime_error("--frequency is only available for an eye tracker, use --gaze-rate for the simulated backend");
+        return opt;
+    }
+
+    // latencies (us) of all samples received after the warmup period. Filled by
+    // a single thread, read only after that thread is done
+    struct measure
+    {
+        std::string             name;
+        std::vector<int64_t>    latencies;
+        int64_t                 countFrom = 0;      // system time stamp, earlier samples are not recorded
+
+        explicit measure(std::string name_, size_t reserve_) : name(std::move(name_)) { latencies.reserve(reserve_); }
+
+        void record(const int64_t sampleTime_, const int64_t now_)
+        {
+            if (sampleTime_ >= countFrom)
+                latencies.push_back(now_ - sampleTime_);
+        }
+    };
+
+    int64_t percentile(const std::vector<int64_t>& sorted_, const double p_)
+    {
+        if (sorted_.empty())
+            return 0;
+        const auto idx = static_cast<size_t>(std::ceil(p_ / 100. * static_cast<double>(sorted_.size()))) - 1;
+        return sorted_[std::min(idx, sorted_.size() - 1)];
+    }
+
+    void printHeader(const options& opt_)
+    {
+        if (!opt_.json)
+            std::cout << "backend\tmeasure\tcount\tmin_us\tmean_us\tp50_us\tp90_us\tp99_us\tp99_9_us\tmax_us\n";
+    }
+
+    void printRow(const options& opt_, const std::string& backend_, const std::string& name_, const TobiiTypes::latencySummary& s_)
+    {
+        if (opt_.json)
+            std::cout << string_format(R"({"backend": "%s", "measure": "%s", "count": %llu, "min_us": %lld, "mean_us": %.1f, "p50_us": %lld, "p90_us": %lld, "p99_us": %lld, "p99_9_us": %lld, "max_us": %lld})",
+                backend_.c_str(), name_.c_str(), static_cast<unsigned long long>(s_.count), static_cast<long long>(s_.min), s_.mean,
+                static_cast<long long>(s_.p50), static_cast<long long>(s_.p90), static_cast<long long>(s_.p99), static_cast<long long>(s_.p99_9), static_cast<long long>(s_.max)) << '\n';
+        else
+            std::cout << string_format("%s\t%s\t%llu\t%lld\t%.1f\t%lld\t%lld\t%lld\t%lld\t%lld",
+                backend_.c_str(), name_.c_str(), static_cast<unsigned long long>(s_.count), static_cast<long long>(s_.min), s_.mean,
+                static_cast<long long>(s_.p50), static_cast<long long>(s_.p90), static_cast<long long>(s_.p99), static_cast<long long>(s_.p99_9), static_cast<long long>(s_.max)) << '\n';
+        std::cout.flush();
+    }
+
+    TobiiTypes::latencySummary summarize(measure& m_)
+    {
+        auto& l = m_.latencies;
+        std::sort(l.begin(), l.end());
+        TobiiTypes::latencySummary s;
+        s.count = l.size();
+        if (l.empty())
+            return s;
+        s.min   = l.front();
+        s.max   = l.back();
+        s.mean  = static_cast<double>(std::accumulate(l.begin(), l.end(), int64_t{ 0 })) / static_cast<double>(l.size());
+        s.p50   = percentile(l, 50.);
+        s.p90   = percentile(l, 90.);
+        s.p99   = percentile(l, 99.);
+        s.p99_9 = percentile(l, 99.9);
+        return s;
+    }
+
+    // one row per bin, one column per measure. Bins are [start, start+width), latencies
+    // below zero (clock adjustments) end up in the first bin
+    void writeHistogram(const options& opt_, const std::vector<const measure*>& measures_)
+    {
+        std::ofstream f(*opt_.histogram);
+        if (!f)
+            throw std::runtime_error("cannot open histogram file " + *opt_.histogram);
+
+        int64_t max = 0;
+        for (const auto m : measures_)
+            if (!m->latencies.empty())
+                max = std::max(max, m->latencies.back());   // sorted by summarize()
+        const auto nBins = static_cast<size_t>(max / opt_.binWidth) + 1;
+
+        std::vector<std::vector<uint64_t>> counts(measures_.size(), std::vector<uint64_t>(nBins, 0));
+        for (size_t i = 0; i < measures_.size(); i++)
+            for (const auto l : measures_[i]->latencies)
+                counts[i][static_cast<size_t>(std::max<int64_t>(l, 0) / opt_.binWidth)]++;
+
+        f << "bin_start_us";
+        for (const auto m : measures_)
+            f << '\t' << m->name;
+        f << '\n';
+        for (size_t b = 0; b < nBins; b++)
+        {
+            f << static_cast<int64_t>(b) * opt_.binWidth;
+            for (const auto& c : counts)
+                f << '\t' << c[b];
+            f << '\n';
+        }
+    }
+
+    // extra subscription next to Titta's, to time the delivery by the SDK
+    void arrivalCallback(TobiiResearchGazeData* gaze_data_, void* user_data_)
+    {
+        static_cast<measure*>(user_data_)->record(gaze_data_->system_time_stamp, Titta::getSystemTimestamp());
+    }
+
+    // simulated backend: delivers samples at their nominal times, as the SDK would
+    void simulate(Titta& titta_, const options& opt_, measure& arrival_, const int64_t start_, const clock_type::time_point startSteady_, const std::atomic<bool>& stop_)
+    {
+        TobiiResearchGazeData gaze{};
+        gaze.left_eye .gaze_point.validity  = TOBII_RESEARCH_VALIDITY_VALID;
+        gaze.right_eye.gaze_point.validity  = TOBII_RESEARCH_VALIDITY_VALID;
+        gaze.left_eye .pupil_data.validity  = TOBII_RESEARCH_VALIDITY_VALID;
+        gaze.right_eye.pupil_data.validity  = TOBII_RESEARCH_VALIDITY_VALID;
+        gaze.left_eye .gaze_origin.validity = TOBII_RESEARCH_VALIDITY_VALID;
+        gaze.right_eye.gaze_origin.validity = TOBII_RESEARCH_VALIDITY_VALID;
+
+        const auto samplePeriod = 1'000'000. / opt_.gazeRate;   // us
+        for (int64_t i = 0; !stop_; i++)
+        {
+            const auto offset = static_cast<int64_t>(std::llround(static_cast<double>(i) * samplePeriod));
+            std::this_thread::sleep_until(startSteady_ + std::chrono::microseconds(offset));
+
+            gaze.device_time_stamp = offset;
+            gaze.system_time_stamp = start_ + offset;
+            arrival_.record(gaze.system_time_stamp, Titta::getSystemTimestamp());
+            TittaGazeCallback(&gaze, &titta_);
+        }
+    }
+
+    void waitPause(const options& opt_)
+    {
+        switch (opt_.waitMode)
+        {
+            case WaitMode::Spin:
+                break;
+            case WaitMode::Yield:
+                std::this_thread::yield();
+                break;
+            case WaitMode::Sleep:
+                std::this_thread::sleep_for(std::chrono::microseconds(opt_.waitInterval));
+                break;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const auto opt = parseOptions(argc, argv);
+
+        // the simulated backend is a replay instance (of a minimal file) whose streams
+        // are never started, so it doesn't deliver any data of its own
+        std::optional<Titta> titta;
+        if (opt.address)
+            titta.emplace(*opt.address);
+        else
+        {
+            const auto dummyFile = std::filesystem::temp_directory_path() / "Titta_latency_gaze.tsv";
+            {
+                std::ofstream f(dummyFile);
+                f << "device_time_stamp\tsystem_time_stamp\n0\t0\n";
+            }
+            titta.emplace(std::string(TittaReplay::addressPrefix) + dummyFile.string());
+            std::filesystem::remove(dummyFile);
+        }
+        const std::string backend = opt.address ? "tobii" : "simulated";
+
+        if (opt.frequency)
+            titta->setFrequency(static_cast<float>(*opt.frequency));
+        titta->setBufferAllocation(opt.prefault, opt.lock, opt.hugePages);
+        if (opt.compactGaze)
+            titta->setCompactGazeStorage(true);
+        if (opt.threads.policy || opt.threads.priority || opt.threads.nice || opt.threads.cpus)
+            Titta::setThreadSettings(opt.threads.policy, opt.threads.priority, opt.threads.nice, opt.threads.cpus);
+
+        const auto rate = opt.address ? static_cast<double>(titta->getDeviceState().info.frequency) : opt.gazeRate;
+        std::cerr << string_format("Titta_latency: %s backend at %.1f Hz, %.1f s (after %.1f s warmup), consumer waits by %s",
+            backend.c_str(), rate, opt.duration, opt.warmup, waitModeToString(opt.waitMode).c_str());
+        if (opt.waitMode == WaitMode::Sleep)
+            std::cerr << string_format(" (%lld us)", static_cast<long long>(opt.waitInterval));
+        std::cerr << string_format(", gaze buffer: prefault %s, lock %s, huge pages %s%s",
+            opt.prefault ? "on" : "off", opt.lock ? "on" : "off", opt.hugePages.c_str(), opt.compactGaze ? ", compact" : "") << std::endl;
+
+        const auto expected = static_cast<size_t>(rate * (opt.duration + opt.warmup) * 1.1);
+        measure arrival("arrival", expected);
+        measure visible("visible", expected);
+        std::atomic<bool> stop = false;
+
+        const auto start        = Titta::getSystemTimestamp();
+        const auto startSteady  = clock_type::now();
+        arrival.countFrom = visible.countFrom = start + static_cast<int64_t>(opt.warmup * 1'000'000.);
+
+        // consumer that waits for new samples and takes them out of the buffer
+        std::thread consumer([&]()
+        {
+            TittaThreads::scope threadRegistration("Titta_latency consumer");
+            uint64_t seen = titta->getLatestCount<Titta::gaze>();
+            while (!stop)
+            {
+                if (titta->getLatestCount<Titta::gaze>() != seen)
+                {
+                    seen = titta->getLatestCount<Titta::gaze>();
+                    const auto samples = titta->consumeN<Titta::gaze>(std::nullopt, Titta::BufferSide::Start);
+                    const auto now = Titta::getSystemTimestamp();
+                    for (const auto& s : samples)
+                        visible.record(s.system_time_stamp, now);
+                    continue;
+                }
+                waitPause(opt);
+            }
+        });
+
+        std::thread producer;
+        TobiiResearchEyeTracker* et = nullptr;
+        if (opt.address)
+        {
+            et = titta->getEyeTrackerInfo().et;
+            if (const auto status = tobii_research_subscribe_to_gaze_data(et, arrivalCallback, &arrival); status != TOBII_RESEARCH_STATUS_OK)
+                throw std::runtime_error("cannot subscribe to gaze data: " + TobiiResearchStatusToString(status));
+            titta->start(Titta::Stream::Gaze);
+        }
+        else
+            producer = std::thread([&]() { simulate(*titta, opt, arrival, start, startSteady, stop); });
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(opt.warmup));
+        titta->getLatencyStats(Titta::Stream::Gaze, true);     // reset, so Titta's statistics also cover only the measurement
+        std::this_thread::sleep_for(std::chrono::duration<double>(opt.duration));
+        const auto ingest = titta->getLatencyStats(Titta::Stream::Gaze).ingest;
+
+        stop = true;
+        if (producer.joinable())
+            producer.join();
+        if (et)
+        {
+            titta->stop(Titta::Stream::Gaze);
+            tobii_research_unsubscribe_from_gaze_data(et, arrivalCallback);
+        }
+        consumer.join();
+
+        printHeader(opt);
+        printRow(opt, backend, arrival.name, summarize(arrival));
+        printRow(opt, backend, "ingest", ingest);
+        printRow(opt, backend, visible.name, summarize(visible));
+
+        if (opt.histogram)
+        {
+            writeHistogram(opt, { &arrival, &visible });
+            std::cerr << "Titta_latency: histograms written to " << *opt.histogram << std::endl;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage();
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,525 @@
+// Streams samples from an eye tracker to local clients over a Unix-domain socket.
+// Clients subscribe to the gaze, external signal, time sync and/or positioning
+// streams, and receive them in a compact binary format (see titta_socket.h):
+// per stream a frame with a 16-byte header followed by fixed-size samples. This
+// avoids the per-sample serialization cost and the TCP stack of the websocket
+// server, for consumers that run on the same machine.
+//
+// The server is single-threaded. Each wake-up it drains the Titta buffers of all
+// subscribed streams and sends every client all its frames with a single writev
+// call. A client that cannot keep up gets its data queued, up to --max-queue bytes,
+// beyond which it is disconnected. A stream is started when the first client
+// subscribes to it and stopped when the last client unsubscribes.
+//
+// The Titta instance connects to the eye tracker at --address, or the first one
+// found if no address is given. As elsewhere, an address of the form
+// "replay://<path to _gaze.tsv file>" replays a recorded session instead.
+//
+// Building on Linux (run from the SDK_wrapper directory):
+//   g++ -std=c++2a -O3 -DBUILD_FROM_SCRIPT -DTOBII_SDK_MAJOR_VERSION=2 -I. -Ideps/include -Ideps/include/SDKv2
+//       Titta_socket/main.cpp src/*.cpp -LTittaMex/mex -l:libtobii_research.so.2 -Wl,-rpath,'$ORIGIN/TittaMex/mex'
+//       -lpthread -lrt -o Titta_socket
+#include <iostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+#include "Titta/Titta.h"
+#include "Titta/utils.h"
+#include "titta_socket.h"
+
+void DoExitWithMsg(std::string errMsg_)
+{
+    throw std::runtime_error(errMsg_);
+}
+void RelayMsg(std::string msg_)
+{
+    std::cerr << msg_ << std::endl;
+}
+
+// the structs are the protocol, make sure the compiler laid them out as intended
+static_assert(sizeof(titta_frame_header)       == 16);
+static_assert(sizeof(titta_request)            == 4);
+static_assert(sizeof(titta_eye_data)           == 44);
+static_assert(sizeof(titta_gaze_sample)        == 104);
+static_assert(sizeof(titta_ext_signal_sample)  == 24);
+static_assert(sizeof(titta_time_sync_sample)   == 24);
+static_assert(sizeof(titta_positioning_sample) == 28);
+
+namespace
+{
+    volatile std::sig_atomic_t g_stop = 0;
+    void onSignal(int) { g_stop = 1; }
+
+    struct options
+    {
+        std::optional<std::string>  address;
+        std::string                 socketPath      = TITTA_SOCKET_DEFAULT_PATH;
+        int64_t                     pollInterval    = 250;          // us
+        size_t                      maxQueue        = 16 << 20;     // bytes
+    };
+
+    void printUsage()
+    {
+        std::cerr <<
+            "usage: Titta_socket [options]\n"
+            "  --address <address>          eye tracker to connect to, or replay://<path to _gaze.tsv file> (default: first eye tracker found)\n"
+            "  --socket <path>              path of the socket to listen on (default " TITTA_SOCKET_DEFAULT_PATH ")\n"
+            "  --poll-interval <us>         interval at which new samples are checked for (default 250)\n"
+            "  --max-queue <bytes>          data queued for a client that cannot keep up, beyond which it is disconnected (default 16777216)\n";
+    }
+
+    options parseOptions(int argc_, char** argv_)
+    {
+        options opt;
+        for (int i = 1; i < argc_; i++)
+        {
+            const std::string arg = argv_[i];
+            auto next = [&]() -> std::string
+            {
+                if (i + 1 >= argc_)
+                    throw std::runtime_error("option " + arg + " expects a value");
+                return argv_[++i];
+            };
+
+            if (arg == "--address")
+                opt.address = next();
+            else if (arg == "--socket")
+                opt.socketPath = next();
+            else if (arg == "--poll-interval")
+                opt.pollInterval = std::stoll(next());
+            else if (arg == "--max-queue")
+                opt.maxQueue = std::stoull(next());
+            else if (arg == "--help" || arg == "-h")
+            {
+                printUsage();
+                std::exit(0);
+            }
+            else
+                throw std::runtime_error("unknown option " + arg);
+        }
+        if (opt.pollInterval <= 0)
+            throw std::runtime_error("--poll-interval should be positive");
+        if (opt.socketPath.size() >= sizeof(sockaddr_un::sun_path))
+            throw std::runtime_error("--socket path is too long");
+        return opt;
+    }
+
+    //// conversion to wire format
+    uint8_t toWire(const bool available_, const TobiiResearchValidity validity_)
+    {
+        if (!available_)
+            return TITTA_NOT_AVAILABLE;
+        return validity_ == TOBII_RESEARCH_VALIDITY_VALID ? TITTA_VALID : TITTA_INVALID;
+    }
+    titta_point3d toWire(const TobiiResearchPoint3D& p_)
+    {
+        return { p_.x, p_.y, p_.z };
+    }
+    titta_eye_data toWire(const TobiiTypes::eyeData& e_)
+    {
+        titta_eye_data out;
+        out.gaze_point_on_display_area_x    = e_.gaze_point.position_on_display_area.x;
+        out.gaze_point_on_display_area_y    = e_.gaze_point.position_on_display_area.y;
+        out.gaze_point_in_user_coordinates  = toWire(e_.gaze_point.position_in_user_coordinates);
+        out.gaze_origin_in_user_coordinates = toWire(e_.gaze_origin.position_in_user_coordinates);
+        out.pupil_diameter                  = e_.pupil.diameter;
+        out.eye_openness_diameter           = e_.eye_openness.diameter;
+        out.gaze_point_validity             = toWire(e_.gaze_point.available  , e_.gaze_point.validity);
+        out.gaze_origin_validity            = toWire(e_.gaze_origin.available , e_.gaze_origin.validity);
+        out.pupil_validity                  = toWire(e_.pupil.available       , e_.pupil.validity);
+        out.eye_openness_validity           = toWire(e_.eye_openness.available, e_.eye_openness.validity);
+        return out;
+    }
+    titta_gaze_sample toWire(const Titta::gaze& s_)
+    {
+        return { s_.device_time_stamp, s_.system_time_stamp, toWire(s_.left_eye), toWire(s_.right_eye) };
+    }
+    titta_ext_signal_sample toWire(const Titta::extSignal& s_)
+    {
+        return { s_.device_time_stamp, s_.system_time_stamp, s_.value, static_cast<uint32_t>(s_.change_type) };
+    }
+    titta_time_sync_sample toWire(const Titta::timeSync& s_)
+    {
+        return { s_.system_request_time_stamp, s_.device_time_stamp, s_.system_response_time_stamp };
+    }
+    titta_positioning_sample toWire(const Titta::positioning& s_)
+    {
+        return { toWire(s_.left_eye.user_position), toWire(s_.right_eye.user_position),
+                 toWire(true, s_.left_eye.validity), toWire(true, s_.right_eye.validity), 0 };
+    }
+
+    //// streams
+    constexpr size_t nStreams = 4;
+    constexpr std::array<titta_stream, nStreams> wireStreams = { TITTA_STREAM_GAZE, TITTA_STREAM_EXT_SIGNAL, TITTA_STREAM_TIME_SYNC, TITTA_STREAM_POSITIONING };
+    constexpr std::array<Titta::Stream, nStreams> tittaStreams = { Titta::Stream::Gaze, Titta::Stream::ExtSignal, Titta::Stream::TimeSync, Titta::Stream::Positioning };
+
+    std::optional<size_t> streamIndex(const uint8_t stream_)
+    {
+        const auto it = std::ranges::find(wireStreams, static_cast<titta_stream>(stream_));
+        if (it == wireStreams.end())
+            return std::nullopt;
+        return it - wireStreams.begin();
+    }
+
+    // pending frame of a stream: header and payload, sent to all subscribers
+    struct frame
+    {
+        titta_frame_header  header{};
+        std::vector<char>   payload;
+        bool                hasData = false;
+    };
+
+    template <typename T>
+    void collect(Titta& titta_, uint64_t& lastCount_, frame& frame_, const titta_stream stream_)
+    {
+        // cheap check whether anything arrived, to not take the buffer lock for nothing
+        const auto count = titta_.getLatestCount<T>();
+        if (count == lastCount_)
+            return;
+        lastCount_ = count;
+
+        const auto samples = titta_.consumeN<T>();
+        if (samples.empty())
+            return;
+        using wire_t = decltype(toWire(samples.front()));
+        frame_.header  = { TITTA_SOCKET_MAGIC, TITTA_SOCKET_VERSION, static_cast<uint8_t>(stream_), sizeof(wire_t), static_cast<uint32_t>(samples.size()), 0 };
+        frame_.payload.resize(samples.size() * sizeof(wire_t));
+        auto out = reinterpret_cast<wire_t*>(frame_.payload.data());
+        for (const auto& s : samples)
+            *out++ = toWire(s);
+        frame_.hasData = true;
+    }
+
+    //// clients
+    struct client
+    {
+        int                                 fd;
+        std::array<bool, nStreams>          subscribed{};
+        std::array<char, sizeof(titta_request)> request{};   // partially received request
+        size_t                              requestLen = 0;
+        std::vector<char>                   queue{};        // data that could not be sent yet
+        size_t                              queueOffset = 0;
+    };
+
+    class Server
+    {
+    public:
+        Server(Titta& titta_, const options& opt_) : _titta(titta_), _opt(opt_)
+        {
+            _listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (_listenFd < 0)
+                throw std::runtime_error(std::string("cannot create socket: ") + std::strerror(errno));
+            setNonBlocking(_listenFd);
+
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            std::strcpy(addr.sun_path, _opt.socketPath.c_str());
+            unlink(addr.sun_path);  // stale socket from a previous run
+            if (bind(_listenFd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 || listen(_listenFd, 16) < 0)
+                throw std::runtime_error("cannot listen on " + _opt.socketPath + ": " + std::strerror(errno));
+        }
+        ~Server()
+        {
+            for (const auto& c : _clients)
+                close(c.fd);
+            close(_listenFd);
+            unlink(_opt.socketPath.c_str());
+        }
+
+        void run()
+        {
+            // tv_nsec must stay below one second
+            const timespec timeout{ static_cast<time_t>(_opt.pollInterval / 1'000'000), static_cast<long>(_opt.pollInterval % 1'000'000 * 1000) };
+            std::vector<pollfd> fds;
+            while (!g_stop)
+            {
+                fds.clear();
+                fds.push_back({ _listenFd, POLLIN, 0 });
+                for (const auto& c : _clients)
+                    fds.push_back({ c.fd, static_cast<short>(POLLIN | (c.queue.empty() ? 0 : POLLOUT)), 0 });
+#ifdef __APPLE__
+                if (poll(fds.data(), fds.size(), static_cast<int>((_opt.pollInterval + 999) / 1000)) < 0 && errno != EINTR)   // no ppoll, millisecond resolution
+#else
+                if (ppoll(fds.data(), fds.size(), &timeout, nullptr) < 0 && errno != EINTR)
+#endif
+                    throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+
+                // service clients (fds[i+1] belongs to _clients[i]), then accept new ones
+                std::vector<bool> drop(_clients.size(), false);
+                for (size_t i = 0; i < _clients.size(); i++)
+                {
+                    const auto revents = fds[i + 1].revents;
+                    if (revents & (POLLERR | POLLNVAL))
+                        drop[i] = true;
+                    else if ((revents & (POLLIN | POLLHUP)) && !receive(_clients[i]))
+                        drop[i] = true;
+                    else if ((revents & POLLOUT) && !flush(_clients[i]))
+                        drop[i] = true;
+                }
+                for (size_t i = _clients.size(); i-- > 0;)
+                    if (drop[i])
+                        disconnect(i);
+                if (fds[0].revents & POLLIN)
+                    accept();
+
+                send();
+            }
+        }
+
+    private:
+        static void setNonBlocking(const int fd_)
+        {
+            fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+            fcntl(fd_, F_SETFD, FD_CLOEXEC);
+        }
+
+        void accept()
+        {
+            for (;;)
+            {
+                const auto fd = ::accept(_listenFd, nullptr, nullptr);
+                if (fd < 0)
+                    return;
+                setNonBlocking(fd);
+#ifdef SO_NOSIGPIPE
+                const int one = 1;
+                setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+                _clients.push_back({ fd });
+                std::cerr << "Titta_socket: client connected (" << _clients.size() << " total)" << std::endl;
+            }
+        }
+
+        void disconnect(const size_t idx_)
+        {
+            for (size_t s = 0; s < nStreams; s++)
+                if (_clients[idx_].subscribed[s])
+                    unsubscribe(s);
+            close(_clients[idx_].fd);
+            _clients.erase(_clients.begin() + idx_);
+            std::cerr << "Titta_socket: client disconnected (" << _clients.size() << " remaining)" << std::endl;
+        }
+
+        // reads and handles requests, returns false if the client should be dropped
+        bool receive(client& c_)
+        {
+            for (;;)
+            {
+                const auto n = recv(c_.fd, c_.request.data() + c_.requestLen, c_.request.size() - c_.requestLen, 0);
+                if (n == 0)
+                    return false;
+                if (n < 0)
+                    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+                c_.requestLen += n;
+                if (c_.requestLen < c_.request.size())
+                    continue;
+                c_.requestLen = 0;
+
+                titta_request req;
+                std::memcpy(&req, c_.request.data(), sizeof(req));
+                const auto s = streamIndex(req.stream);
+                if (!s)
+                {
+                    std::cerr << "Titta_socket: client requested unsupported stream " << static_cast<int>(req.stream) << std::endl;
+                    return false;
+                }
+                if (req.type == TITTA_MSG_SUBSCRIBE && !c_.subscribed[*s])
+                {
+                    c_.subscribed[*s] = true;
+                    subscribe(*s);
+                }
+                else if (req.type == TITTA_MSG_UNSUBSCRIBE && c_.subscribed[*s])
+                {
+                    c_.subscribed[*s] = false;
+                    unsubscribe(*s);
+                }
+                else if (req.type != TITTA_MSG_SUBSCRIBE && req.type != TITTA_MSG_UNSUBSCRIBE)
+                {
+                    std::cerr << "Titta_socket: client sent unknown request " << static_cast<int>(req.type) << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        void subscribe(const size_t s_)
+        {
+            if (_nSubscribers[s_]++ == 0)
+            {
+                // e.g. the eye tracker may not support the stream, the client then simply gets no data
+                try
+                {
+                    _titta.start(tittaStreams[s_]);
+                    std::cerr << "Titta_socket: started " << Titta::streamToString(tittaStreams[s_]) << " stream" << std::endl;
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "Titta_socket: cannot start " << Titta::streamToString(tittaStreams[s_]) << " stream: " << e.what() << std::endl;
+                }
+            }
+        }
+        void unsubscribe(const size_t s_)
+        {
+            if (--_nSubscribers[s_] == 0)
+            {
+                _titta.stop(tittaStreams[s_], true);
+                _lastCount[s_] = 0;
+                std::cerr << "Titta_socket: stopped " << Titta::streamToString(tittaStreams[s_]) << " stream" << std::endl;
+            }
+        }
+
+        // sends queued data, returns false if the client should be dropped
+        bool flush(client& c_)
+        {
+            while (c_.queueOffset < c_.queue.size())
+            {
+                const auto n = ::send(c_.fd, c_.queue.data() + c_.queueOffset, c_.queue.size() - c_.queueOffset, sendFlags);
+                if (n < 0)
+                    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+                c_.queueOffset += n;
+            }
+            c_.queue.clear();
+            c_.queueOffset = 0;
+            return true;
+        }
+
+        // collects new samples of subscribed streams and sends them to the clients
+        void send()
+        {
+            std::array<frame, nStreams> frames;
+            bool any = false;
+            for (size_t s = 0; s < nStreams; s++)
+            {
+                if (!_nSubscribers[s])
+                    continue;
+                switch (wireStreams[s])
+                {
+                case TITTA_STREAM_GAZE:         collect<Titta::gaze>       (_titta, _lastCount[s], frames[s], wireStreams[s]); break;
+                case TITTA_STREAM_EXT_SIGNAL:   collect<Titta::extSignal>  (_titta, _lastCount[s], frames[s], wireStreams[s]); break;
+                case TITTA_STREAM_TIME_SYNC:    collect<Titta::timeSync>   (_titta, _lastCount[s], frames[s], wireStreams[s]); break;
+                case TITTA_STREAM_POSITIONING:  collect<Titta::positioning>(_titta, _lastCount[s], frames[s], wireStreams[s]); break;
+                }
+                any = any || frames[s].hasData;
+            }
+            if (!any)
+                return;
+
+            std::vector<bool> drop(_clients.size(), false);
+            for (size_t i = 0; i < _clients.size(); i++)
+                drop[i] = !send(_clients[i], frames);
+            for (size_t i = _clients.size(); i-- > 0;)
+                if (drop[i])
+                {
+                    std::cerr << "Titta_socket: client cannot keep up" << std::endl;
+                    disconnect(i);
+                }
+        }
+
+        // sends all frames the client subscribed to in one call, queuing what could not be sent.
+        // Returns false if the client should be dropped
+        bool send(client& c_, const std::array<frame, nStreams>& frames_)
+        {
+            std::array<iovec, 2 * nStreams> iov;
+            size_t nIov = 0, total = 0;
+            for (size_t s = 0; s < nStreams; s++)
+            {
+                if (!c_.subscribed[s] || !frames_[s].hasData)
+                    continue;
+                iov[nIov++] = { const_cast<titta_frame_header*>(&frames_[s].header), sizeof(titta_frame_header) };
+                iov[nIov++] = { const_cast<char*>(frames_[s].payload.data()), frames_[s].payload.size() };
+                total += sizeof(titta_frame_header) + frames_[s].payload.size();
+            }
+            if (!nIov)
+                return true;
+
+            // only write directly if nothing is queued, else data would go out of order
+            size_t written = 0;
+            if (c_.queue.empty())
+            {
+                msghdr msg{};
+                msg.msg_iov    = iov.data();
+                msg.msg_iovlen = nIov;
+                const auto n = sendmsg(c_.fd, &msg, sendFlags);  // writev, but without SIGPIPE
+                if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                    return false;
+                written = n < 0 ? 0 : static_cast<size_t>(n);
+                if (written == total)
+                    return true;
+            }
+
+            // queue the rest
+            if (c_.queue.size() - c_.queueOffset + total - written > _opt.maxQueue)
+                return false;
+            for (size_t v = 0; v < nIov; v++)
+            {
+                const auto base = static_cast<const char*>(iov[v].iov_base);
+                const auto skip = std::min(written, iov[v].iov_len);
+                written -= skip;
+                c_.queue.insert(c_.queue.end(), base + skip, base + iov[v].iov_len);
+            }
+            return true;
+        }
+
+    private:
+#ifdef MSG_NOSIGNAL
+        static constexpr int sendFlags = MSG_NOSIGNAL;
+#else
+        static constexpr int sendFlags = 0;     // SO_NOSIGPIPE is set on the socket instead
+#endif
+
+        Titta&                          _titta;
+        const options&                  _opt;
+        int                             _listenFd = -1;
+        std::vector<client>             _clients;
+        std::array<size_t, nStreams>    _nSubscribers{};
+        std::array<uint64_t, nStreams>  _lastCount{};
+    };
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const auto opt = parseOptions(argc, argv);
+
+        std::string address;
+        if (opt.address)
+            address = *opt.address;
+        else
+        {
+            const auto trackers = Titta::findAllEyeTrackers();
+            if (trackers.empty())
+                throw std::runtime_error("no eye trackers found");
+            address = trackers[0].address;
+        }
+        Titta titta(address);
+
+        std::signal(SIGINT , onSignal);
+        std::signal(SIGTERM, onSignal);
+        std::signal(SIGPIPE, SIG_IGN);
+
+        Server server(titta, opt);
+        std::cerr << "Titta_socket: streaming from " << address << " on " << opt.socketPath << std::endl;
+        server.run();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage();
+        return 1;
+    }
+    return 0;
+}
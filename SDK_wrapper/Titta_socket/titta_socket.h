@@ -0,0 +1,146 @@
+/* Wire format of the Titta_socket server and a small C client library for it.
+ *
+ * The server streams samples over a local (Unix-domain) stream socket. After
+ * connecting, a client sends subscription requests for the streams it wants.
+ * The server then sends frames, each a titta_frame_header followed by
+ * n_samples samples of the indicated stream. Samples are fixed-size structs
+ * (see below) in the native byte order of the machine, as server and client
+ * run on the same host. The server sends at most one frame per stream per
+ * wake-up, containing all samples that arrived since the previous frame.
+ *
+ * Since the struct layouts are the protocol, they only use fixed-size fields
+ * and contain no implicit padding. A client should check magic and version of
+ * each frame and use sample_size to step through the samples, so that fields
+ * appended in a later protocol version do not break it.
+ */
+#ifndef TITTA_SOCKET_H
+#define TITTA_SOCKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TITTA_SOCKET_MAGIC          0x46535454u     /* "TTSF" */
+#define TITTA_SOCKET_VERSION        1
+#define TITTA_SOCKET_DEFAULT_PATH   "/tmp/titta.sock"
+
+typedef enum
+{
+    TITTA_STREAM_GAZE           = 1,
+    TITTA_STREAM_EXT_SIGNAL     = 2,
+    TITTA_STREAM_TIME_SYNC      = 3,
+    TITTA_STREAM_POSITIONING    = 4
+} titta_stream;
+
+/* client -> server */
+typedef enum
+{
+    TITTA_MSG_SUBSCRIBE         = 1,
+    TITTA_MSG_UNSUBSCRIBE       = 2
+} titta_msg_type;
+
+typedef struct
+{
+    uint8_t     type;           /* titta_msg_type */
+    uint8_t     stream;         /* titta_stream */
+    uint16_t    reserved;
+} titta_request;
+
+/* server -> client */
+typedef struct
+{
+    uint32_t    magic;          /* TITTA_SOCKET_MAGIC */
+    uint8_t     version;        /* TITTA_SOCKET_VERSION */
+    uint8_t     stream;         /* titta_stream */
+    uint16_t    sample_size;    /* in bytes */
+    uint32_t    n_samples;
+    uint32_t    reserved;
+} titta_frame_header;
+
+/* validity of a field of a sample */
+typedef enum
+{
+    TITTA_INVALID               = 0,
+    TITTA_VALID                 = 1,
+    TITTA_NOT_AVAILABLE         = 2     /* the eye tracker does not provide this field */
+} titta_validity;
+
+typedef struct
+{
+    float       x, y, z;
+} titta_point3d;
+
+typedef struct
+{
+    float           gaze_point_on_display_area_x;
+    float           gaze_point_on_display_area_y;
+    titta_point3d   gaze_point_in_user_coordinates;
+    titta_point3d   gaze_origin_in_user_coordinates;
+    float           pupil_diameter;
+    float           eye_openness_diameter;
+    uint8_t         gaze_point_validity;        /* titta_validity */
+    uint8_t         gaze_origin_validity;
+    uint8_t         pupil_validity;
+    uint8_t         eye_openness_validity;
+} titta_eye_data;
+
+typedef struct
+{
+    int64_t         device_time_stamp;
+    int64_t         system_time_stamp;
+    titta_eye_data  left_eye;
+    titta_eye_data  right_eye;
+} titta_gaze_sample;
+
+typedef struct
+{
+    int64_t         device_time_stamp;
+    int64_t         system_time_stamp;
+    uint32_t        value;
+    uint32_t        change_type;                /* TobiiResearchExternalSignalChangeType */
+} titta_ext_signal_sample;
+
+typedef struct
+{
+    int64_t         system_request_time_stamp;
+    int64_t         device_time_stamp;
+    int64_t         system_response_time_stamp;
+} titta_time_sync_sample;
+
+typedef struct
+{
+    titta_point3d   left_user_position;
+    titta_point3d   right_user_position;
+    uint8_t         left_validity;              /* titta_validity */
+    uint8_t         right_validity;
+    uint16_t        reserved;
+} titta_positioning_sample;
+
+
+/* Client library. All functions that return int return 0 on success and -1 on
+ * failure with errno set, unless noted otherwise. */
+typedef struct titta_client titta_client;
+
+/* connect to the server listening on path_, NULL for TITTA_SOCKET_DEFAULT_PATH. Returns NULL on failure */
+titta_client*   titta_client_connect(const char* path_);
+void            titta_client_close(titta_client* client_);
+/* file descriptor of the connection, for use with poll/select */
+int             titta_client_fd(const titta_client* client_);
+
+int             titta_client_subscribe(titta_client* client_, titta_stream stream_);
+int             titta_client_unsubscribe(titta_client* client_, titta_stream stream_);
+
+/* Blocks until a complete frame has been received. Returns 1 and sets *header_
+ * and *samples_, which point into a buffer owned by the client and stay valid
+ * until the next call. Returns 0 if the server closed the connection, and -1
+ * on error (errno is EPROTO if the frame had a wrong magic or version). */
+int             titta_client_read_frame(titta_client* client_, const titta_frame_header** header_, const void** samples_);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TITTA_SOCKET_H */
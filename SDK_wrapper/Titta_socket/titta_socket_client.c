@@ -0,0 +1,177 @@
+/* Client library for the Titta_socket server, see titta_socket.h.
+ * Plain C99 and POSIX, no dependencies: copy titta_socket.h and this file into
+ * a project, or compile it into a static library:
+ *   cc -O2 -c titta_socket_client.c && ar rcs libtitta_socket.a titta_socket_client.o
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "titta_socket.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  /* SO_NOSIGPIPE is set on the socket instead */
+#endif
+
+struct titta_client
+{
+    int         fd;
+    char*       buf;
+    size_t      cap;
+};
+
+titta_client* titta_client_connect(const char* path_)
+{
+    struct sockaddr_un addr;
+    titta_client* c;
+    int fd;
+
+    if (!path_)
+        path_ = TITTA_SOCKET_DEFAULT_PATH;
+    if (strlen(path_) >= sizeof(addr.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path_);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return NULL;
+    if (connect(fd, (const struct sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+
+#ifdef SO_NOSIGPIPE
+    {
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+    }
+#endif
+
+    c = (titta_client*)calloc(1, sizeof(*c));
+    if (!c)
+    {
+        close(fd);
+        errno = ENOMEM;
+        return NULL;
+    }
+    c->fd = fd;
+    return c;
+}
+
+void titta_client_close(titta_client* client_)
+{
+    if (!client_)
+        return;
+    close(client_->fd);
+    free(client_->buf);
+    free(client_);
+}
+
+int titta_client_fd(const titta_client* client_)
+{
+    return client_->fd;
+}
+
+static int send_request(titta_client* client_, titta_msg_type type_, titta_stream stream_)
+{
+    titta_request req;
+    const char* p = (const char*)&req;
+    size_t left = sizeof(req);
+
+    req.type     = (uint8_t)type_;
+    req.stream   = (uint8_t)stream_;
+    req.reserved = 0;
+    while (left)
+    {
+        ssize_t n = send(client_->fd, p, left, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        p    += n;
+        left -= (size_t)n;
+    }
+    return 0;
+}
+
+int titta_client_subscribe(titta_client* client_, titta_stream stream_)
+{
+    return send_request(client_, TITTA_MSG_SUBSCRIBE, stream_);
+}
+
+int titta_client_unsubscribe(titta_client* client_, titta_stream stream_)
+{
+    return send_request(client_, TITTA_MSG_UNSUBSCRIBE, stream_);
+}
+
+/* returns 1 if len_ bytes were read, 0 on orderly shutdown, -1 on error */
+static int read_all(int fd_, char* p_, size_t len_)
+{
+    while (len_)
+    {
+        ssize_t n = recv(fd_, p_, len_, 0);
+        if (n == 0)
+            return 0;
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        p_   += n;
+        len_ -= (size_t)n;
+    }
+    return 1;
+}
+
+int titta_client_read_frame(titta_client* client_, const titta_frame_header** header_, const void** samples_)
+{
+    titta_frame_header hdr;
+    size_t payload;
+    int r;
+
+    r = read_all(client_->fd, (char*)&hdr, sizeof(hdr));
+    if (r <= 0)
+        return r;
+    if (hdr.magic != TITTA_SOCKET_MAGIC || hdr.version != TITTA_SOCKET_VERSION)
+    {
+        errno = EPROTO;
+        return -1;
+    }
+
+    payload = (size_t)hdr.sample_size * hdr.n_samples;
+    if (sizeof(hdr) + payload > client_->cap)
+    {
+        char* b = (char*)realloc(client_->buf, sizeof(hdr) + payload);
+        if (!b)
+        {
+            errno = ENOMEM;
+            return -1;
+        }
+        client_->buf = b;
+        client_->cap = sizeof(hdr) + payload;
+    }
+    memcpy(client_->buf, &hdr, sizeof(hdr));
+    r = read_all(client_->fd, client_->buf + sizeof(hdr), payload);
+    if (r <= 0)
+        return r < 0 ? -1 : 0;
+
+    *header_  = (const titta_frame_header*)client_->buf;
+    *samples_ = client_->buf + sizeof(hdr);
+    return 1;
+}
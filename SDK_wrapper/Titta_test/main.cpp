@@ -0,0 +1,717 @@
+// Tests of the self-contained parts of Titta that need no eye tracker: the eye
+// image codec, the GIF decoder, the gaze resampler, compact gaze storage (with
+// and without quantization and the cold tier), the latest-sample slot, the
+// calibration cache (using a directory in the system's temporary directory),
+// the eye image reducer, the shared-memory sample rings, the log ring and the
+// latency histogram. Each test round-trips data through the component and
+// checks edge cases (empty, tiny and corrupt input).
+//
+// Prints each failed check to stderr, and a summary to stdout. Exits with 0 if
+// all checks passed, 1 otherwise.
+//
+// Building on Linux (run from the SDK_wrapper directory):
+//   g++ -std=c++2a -O2 -DBUILD_FROM_SCRIPT -DTOBII_SDK_MAJOR_VERSION=2 -I. -Ideps/include -Ideps/include/SDKv2
+//       Titta_test/main.cpp src/*.cpp -LTittaMex/mex -l:libtobii_research.so.2 -Wl,-rpath,'$ORIGIN/TittaMex/mex'
+//       -lpthread -lrt -o Titta_test
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <variant>
+#include <stdexcept>
+#include <cstring>
+#include <cmath>
+
+#include "Titta/eyeImageCodec.h"
+#include "Titta/gifDecoder.h"
+#include "Titta/resample.h"
+#include "Titta/compactGaze.h"
+#include "Titta/latestSlot.h"
+#include "Titta/calibrationCache.h"
+#include "Titta/eyeImageReducer.h"
+#include "Titta/shmRing.h"
+#include "Titta/logRing.h"
+#include "Titta/latency.h"
+
+void DoExitWithMsg(std::string errMsg_)
+{
+    throw std::runtime_error(errMsg_);
+}
+void RelayMsg(std::string msg_)
+{
+    std::cerr << msg_ << std::endl;
+}
+
+namespace
+{
+    int g_nChecks = 0;
+    int g_nFailed = 0;
+
+    void check(const bool ok_, const std::string& what_)
+    {
+        g_nChecks++;
+        if (!ok_)
+        {
+            g_nFailed++;
+            std::cerr << "FAILED: " << what_ << std::endl;
+        }
+    }
+    bool throws(const auto& fun_)
+    {
+        try
+        {
+            fun_();
+        }
+        catch (const std::exception&)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    // NaN-aware bitwise comparison, as compact storage must return exactly what was stored
+    bool sameFloat(const float a_, const float b_)
+    {
+        return (std::isnan(a_) && std::isnan(b_)) || !std::memcmp(&a_, &b_, sizeof(float));
+    }
+    bool samePoint(const TobiiResearchPoint3D& a_, const TobiiResearchPoint3D& b_)
+    {
+        return sameFloat(a_.x, b_.x) && sameFloat(a_.y, b_.y) && sameFloat(a_.z, b_.z);
+    }
+    bool sameEye(const TobiiTypes::eyeData& a_, const TobiiTypes::eyeData& b_)
+    {
+        return sameFloat(a_.gaze_point.position_on_display_area.x, b_.gaze_point.position_on_display_area.x) &&
+               sameFloat(a_.gaze_point.position_on_display_area.y, b_.gaze_point.position_on_display_area.y) &&
+               samePoint(a_.gaze_point.position_in_user_coordinates, b_.gaze_point.position_in_user_coordinates) &&
+               a_.gaze_point.validity == b_.gaze_point.validity && a_.gaze_point.available == b_.gaze_point.available &&
+               sameFloat(a_.pupil.diameter, b_.pupil.diameter) &&
+               a_.pupil.validity == b_.pupil.validity && a_.pupil.available == b_.pupil.available &&
+               samePoint(a_.gaze_origin.position_in_user_coordinates, b_.gaze_origin.position_in_user_coordinates) &&
+               a_.gaze_origin.validity == b_.gaze_origin.validity && a_.gaze_origin.available == b_.gaze_origin.available &&
+               sameFloat(a_.eye_openness.diameter, b_.eye_openness.diameter) &&
+               a_.eye_openness.validity == b_.eye_openness.validity && a_.eye_openness.available == b_.eye_openness.available;
+    }
+    bool sameGaze(const TobiiTypes::gazeData& a_, const TobiiTypes::gazeData& b_)
+    {
+        return a_.device_time_stamp == b_.device_time_stamp && a_.system_time_stamp == b_.system_time_stamp &&
+               sameEye(a_.left_eye, b_.left_eye) && sameEye(a_.right_eye, b_.right_eye);
+    }
+
+    // synthetic recording at 1200 Hz with timestamp jitter, slow drift of gaze and pupil, and
+    // stretches of invalid data
+    std::vector<TobiiTypes::gazeData> makeGaze(const size_t n_, const unsigned seed_ = 1)
+    {
+        std::mt19937 rng(seed_);
+        std::normal_distribution<float> noise(0.f, .002f);
+        std::uniform_int_distribution<int> jitter(-3, 3);
+
+        std::vector<TobiiTypes::gazeData> out(n_);
+        float x = .5f, y = .5f, pupil = 3.f, openness = 10.f;
+        int64_t ts = 1'000'000'000;
+        for (size_t i = 0; i < n_; i++)
+        {
+            auto& s = out[i];
+            ts += 833 + jitter(rng);
+            s.system_time_stamp = ts;
+            s.device_time_stamp = ts / 2 + 12345;
+            x        += noise(rng);
+            y        += noise(rng);
+            pupil    += noise(rng) / 10;
+            openness += noise(rng);
+            const bool valid = (i / 500) % 7 != 3;
+            for (const auto eye : { &TobiiTypes::gazeData::left_eye, &TobiiTypes::gazeData::right_eye })
+            {
+                auto& e = s.*eye;
+                e.gaze_point.available = e.pupil.available = e.gaze_origin.available = e.eye_openness.available = true;
+                if (!valid)
+                    continue;
+                e.gaze_point.position_on_display_area       = { x, y };
+                e.gaze_point.position_in_user_coordinates   = { x * 500.f, y * 300.f, 20.f + y };
+                e.gaze_point.validity                       = TOBII_RESEARCH_VALIDITY_VALID;
+                e.pupil.diameter                            = pupil;
+                e.pupil.validity                            = TOBII_RESEARCH_VALIDITY_VALID;
+                e.gaze_origin.position_in_user_coordinates  = { 30.f + x, 5.f - y, 600.f + y * 10.f };
+                e.gaze_origin.validity                      = TOBII_RESEARCH_VALIDITY_VALID;
+                e.eye_openness.diameter                     = openness;
+                e.eye_openness.validity                     = TOBII_RESEARCH_VALIDITY_VALID;
+            }
+        }
+        return out;
+    }
+
+    void testEyeImageCodec()
+    {
+        const auto roundTrip = [](const std::vector<uint8_t>& pixels_, const int width_, const int height_)
+        {
+            std::vector<uint8_t> compressed, decompressed;
+            if (!EyeImageCodec::compress(pixels_.data(), width_, height_, compressed))
+                return false;
+            return EyeImageCodec::decompress(compressed.data(), compressed.size(), width_, height_, decompressed) && decompressed == pixels_;
+        };
+
+        // smooth image with a dark blob, as an eye image: compresses, and losslessly
+        constexpr int w = 160, h = 120;
+        std::vector<uint8_t> image(w * h);
+        for (int y = 0; y < h; y++)
+            for (int x = 0; x < w; x++)
+            {
+                const auto d2 = (x - 80) * (x - 80) + (y - 60) * (y - 60);
+                image[y * w + x] = static_cast<uint8_t>(d2 < 400 ? 20 : 120 + (x + y) / 4);
+            }
+        check(roundTrip(image, w, h), "codec: smooth image round trip");
+        std::vector<uint8_t> compressed;
+        EyeImageCodec::compress(image.data(), w, h, compressed);
+        check(compressed.size() < image.size() / 2, "codec: smooth image compresses at least 2x");
+
+        // residuals of every size and sign, including escapes
+        std::vector<uint8_t> extremes(w * h);
+        for (size_t i = 0; i < extremes.size(); i++)
+            extremes[i] = (i / 7) % 2 ? 255 : static_cast<uint8_t>(i % 3);
+        check(roundTrip(extremes, w, h), "codec: extreme residuals round trip");
+
+        // tiny images. A single pixel cannot get smaller, and is refused
+        const std::vector<uint8_t> pixel{ 42 };
+        check(!EyeImageCodec::compress(pixel.data(), 1, 1, compressed), "codec: 1x1 image is refused");
+        std::vector<uint8_t> row(w, 128), column(h, 128);
+        check(roundTrip(row, w, 1), "codec: single row round trip");
+        check(roundTrip(column, 1, h), "codec: single column round trip");
+
+        // noise does not compress, and is refused
+        std::mt19937 rng(2);
+        std::vector<uint8_t> noise(w * h);
+        for (auto& p : noise)
+            p = static_cast<uint8_t>(rng());
+        check(!EyeImageCodec::compress(noise.data(), w, h, compressed), "codec: noise is refused");
+
+        // corrupt input is rejected
+        std::vector<uint8_t> out;
+        EyeImageCodec::compress(image.data(), w, h, compressed);
+        check(!EyeImageCodec::decompress(compressed.data(), 0, w, h, out), "codec: empty data rejected");
+        check(!EyeImageCodec::decompress(compressed.data(), compressed.size() / 2, w, h, out), "codec: truncated data rejected");
+        auto badVersion = compressed;
+        badVersion[0]++;
+        check(!EyeImageCodec::decompress(badVersion.data(), badVersion.size(), w, h, out), "codec: unknown format version rejected");
+        check(!EyeImageCodec::decompress(compressed.data(), compressed.size(), 0, h, out), "codec: zero width rejected");
+    }
+
+    // minimal GIF encoder: grayscale palette, and LZW codes that are all literals (the code table is
+    // cleared before it grows to 10-bit codes), so that the decoder's output must equal pixels_
+    std::vector<uint8_t> makeGif(const std::vector<uint8_t>& pixels_, const int width_, const int height_)
+    {
+        std::vector<uint8_t> out = { 'G', 'I', 'F', '8', '9', 'a' };
+        const auto u16 = [&out](const int v_) { out.push_back(static_cast<uint8_t>(v_ & 0xFF)); out.push_back(static_cast<uint8_t>(v_ >> 8)); };
+        u16(width_);
+        u16(height_);
+        out.insert(out.end(), { 0xF7, 0, 0 });      // 256-entry global color table
+        for (int i = 0; i < 256; i++)
+            out.insert(out.end(), { static_cast<uint8_t>(i), static_cast<uint8_t>(i), static_cast<uint8_t>(i) });
+        out.push_back(0x2C);                        // image descriptor
+        u16(0);
+        u16(0);
+        u16(width_);
+        u16(height_);
+        out.push_back(0);
+        out.push_back(8);                           // LZW minimum code size
+
+        std::vector<uint8_t> codes;
+        uint32_t acc = 0;
+        int nBits = 0;
+        const auto put = [&](const uint32_t code_)
+        {
+            acc |= code_ << nBits;
+            nBits += 9;
+            while (nBits >= 8)
+            {
+                codes.push_back(static_cast<uint8_t>(acc & 0xFF));
+                acc >>= 8;
+                nBits -= 8;
+            }
+        };
+        for (size_t i = 0; i < pixels_.size(); i++)
+        {
+            if (i % 200 == 0)
+                put(256);                           // clear
+            put(pixels_[i]);
+        }
+        put(257);                                   // end of information
+        if (nBits)
+            codes.push_back(static_cast<uint8_t>(acc));
+        for (size_t i = 0; i < codes.size(); i += 255)
+        {
+            const auto n = std::min<size_t>(255, codes.size() - i);
+            out.push_back(static_cast<uint8_t>(n));
+            out.insert(out.end(), codes.begin() + i, codes.begin() + i + n);
+        }
+        out.push_back(0);
+        out.push_back(0x3B);                        // trailer
+        return out;
+    }
+
+    void testGifDecoder()
+    {
+        constexpr int w = 64, h = 48;
+        std::vector<uint8_t> image(w * h);
+        for (size_t i = 0; i < image.size(); i++)
+            image[i] = static_cast<uint8_t>(i * 7);
+        const auto gif = makeGif(image, w, h);
+
+        std::vector<uint8_t> pixels;
+        int width = 0, height = 0;
+        std::string error;
+        check(GifDecoder::decode(gif.data(), gif.size(), pixels, width, height, error), "gif: decode (" + error + ")");
+        check(width == w && height == h, "gif: size");
+        check(pixels == image, "gif: pixels");
+
+        const auto tiny = makeGif({ 99 }, 1, 1);
+        check(GifDecoder::decode(tiny.data(), tiny.size(), pixels, width, height, error) && pixels == std::vector<uint8_t>{ 99 }, "gif: 1x1 image");
+
+        // corrupt input is rejected
+        for (const size_t n : { size_t{ 0 }, size_t{ 5 }, size_t{ 13 }, gif.size() / 2 })
+            check(!GifDecoder::decode(gif.data(), n, pixels, width, height, error) && !error.empty(), "gif: truncated to " + std::to_string(n) + " bytes rejected");
+        auto notGif = gif;
+        notGif[0] = 'X';
+        check(!GifDecoder::decode(notGif.data(), notGif.size(), pixels, width, height, error), "gif: bad signature rejected");
+    }
+
+    void testGazeResampler()
+    {
+        constexpr double  frequency = 500.;
+        constexpr int64_t maxGap    = 75'000;
+        const auto gaze = makeGaze(20'000);
+
+        for (const auto method : { GazeResampler::Method::Linear, GazeResampler::Method::Cubic })
+        {
+            const auto name  = "resampler (" + GazeResampler::methodToString(method) + "): ";
+            const auto batch = GazeResampler::resample(gaze, frequency, maxGap, method);
+            check(!batch.empty(), name + "batch output");
+
+            // incremental, in uneven chunks, gives the same as batch
+            GazeResampler resampler(frequency, maxGap, method);
+            std::vector<TobiiTypes::gazeData> incremental;
+            for (size_t i = 0, chunk = 1; i < gaze.size(); i += chunk, chunk = chunk % 97 + 1)
+            {
+                const auto out = resampler.push({ gaze.begin() + i, gaze.begin() + std::min(gaze.size(), i + chunk) });
+                incremental.insert(incremental.end(), out.begin(), out.end());
+            }
+            const auto rest = resampler.flush();
+            incremental.insert(incremental.end(), rest.begin(), rest.end());
+            bool same = incremental.size() == batch.size();
+            for (size_t i = 0; same && i < batch.size(); i++)
+                same = sameGaze(incremental[i], batch[i]);
+            check(same, name + "incremental equals batch");
+
+            // uniform grid, starting at the first sample, within the data
+            bool onGrid = true;
+            for (size_t i = 0; onGrid && i < batch.size(); i++)
+                onGrid = std::llabs(batch[i].system_time_stamp - (gaze.front().system_time_stamp + static_cast<int64_t>(std::llround(i * 1e6 / frequency)))) <= 1;
+            check(onGrid, name + "output on uniform grid");
+            check(batch.back().system_time_stamp <= gaze.back().system_time_stamp, name + "no extrapolation beyond the data");
+
+            // stretches of invalid data longer than maxGap stay invalid
+            const auto gapStart = gaze[3 * 500 + 10].system_time_stamp, gapEnd = gaze[4 * 500 - 10].system_time_stamp;
+            bool gapInvalid = true;
+            for (const auto& s : batch)
+                if (s.system_time_stamp > gapStart && s.system_time_stamp < gapEnd)
+                    gapInvalid &= s.left_eye.gaze_point.validity == TOBII_RESEARCH_VALIDITY_INVALID;
+            check(gapInvalid, name + "gap beyond maxGap is invalid");
+        }
+
+        // a linear signal is reproduced exactly by linear interpolation
+        std::vector<TobiiTypes::gazeData> line(100);
+        for (size_t i = 0; i < line.size(); i++)
+        {
+            line[i].system_time_stamp = static_cast<int64_t>(i) * 1000;
+            auto& gp = line[i].left_eye.gaze_point;
+            gp.available                = true;
+            gp.validity                 = TOBII_RESEARCH_VALIDITY_VALID;
+            gp.position_on_display_area = { static_cast<float>(i) / 100.f, .5f };
+        }
+        const auto out = GazeResampler::resample(line, 3000., maxGap, GazeResampler::Method::Linear);
+        bool exact = !out.empty();
+        for (const auto& s : out)
+            exact &= std::abs(s.left_eye.gaze_point.position_on_display_area.x - static_cast<float>(s.system_time_stamp) / 100'000.f) < 1e-5f;
+        check(exact, "resampler: linear signal reproduced");
+
+        // edge cases
+        check(GazeResampler::resample({}, frequency, maxGap, GazeResampler::Method::Linear).empty(), "resampler: no input, no output");
+        check(GazeResampler::resample({ gaze.front() }, frequency, maxGap, GazeResampler::Method::Linear).size() <= 1, "resampler: single sample");
+        check(throws([] { GazeResampler(0., maxGap, GazeResampler::Method::Linear); }), "resampler: zero frequency rejected");
+    }
+
+    void testCompactGaze()
+    {
+        const auto gaze = makeGaze(30'000);
+        for (const bool quantize : { false, true })
+            for (const bool compressOld : { false, true })
+            {
+                const auto name = std::string("compact gaze (") + (quantize ? "quantized" : "lossless") + (compressOld ? ", cold tier): " : "): ");
+                CompactGazeBuffer buf(quantize, compressOld);
+                for (const auto& s : gaze)
+                    buf.push_back(s);
+                if (compressOld)
+                {
+                    const auto before = buf.getStoredBytes();
+                    while (const auto job = buf.getCompressionJob())
+                        check(buf.commitCompression(CompactGazeBuffer::compress(*job)), name + "commit compression");
+                    check(buf.getStoredBytes() < before, name + "cold tier is smaller");
+                }
+                check(buf.size() == gaze.size(), name + "size");
+
+                const auto back = buf.get(0, buf.size());
+                bool ok = back.size() == gaze.size();
+                for (size_t i = 0; ok && i < gaze.size(); i++)
+                {
+                    if (!quantize)
+                        ok = sameGaze(back[i], gaze[i]);
+                    else
+                    {
+                        // all but the gaze point on the display area are lossless, that is within the documented resolution
+                        auto expected = gaze[i];
+                        for (const auto eye : { &TobiiTypes::gazeData::left_eye, &TobiiTypes::gazeData::right_eye })
+                        {
+                            const auto& a = (back[i].*eye).gaze_point.position_on_display_area;
+                            auto&       e = (expected.*eye).gaze_point.position_on_display_area;
+                            if (!std::isnan(e.x))
+                                ok &= std::abs(a.x - e.x) <= 6.2e-5f && std::abs(a.y - e.y) <= 6.2e-5f;
+                            e = a;
+                        }
+                        ok &= sameGaze(back[i], expected);
+                    }
+                    ok &= buf.getSystemTimeStamp(i) == gaze[i].system_time_stamp;
+                }
+                check(ok, name + "round trip");
+
+                // time ranges and erasure behave as on a plain buffer
+                const auto [iStart, iEnd, whole] = buf.findTimeRange(gaze[1000].system_time_stamp, gaze[2000].system_time_stamp);
+                check(iStart == 1000 && iEnd == 2001, name + "time range");
+                buf.erase(100, 5000);
+                buf.erase(0, 3);
+                check(buf.size() == gaze.size() - 4903, name + "size after erase");
+                check(buf.getSystemTimeStamp(0) == gaze[3].system_time_stamp && buf.getSystemTimeStamp(97) == gaze[5000].system_time_stamp, name + "contents after erase");
+                buf.clear();
+                check(buf.empty() && !buf.getStoredBytes(), name + "clear");
+            }
+    }
+
+    void testLatestSlot()
+    {
+        LatestSlot<TobiiTypes::gazeData> slot;
+        check(!slot.load() && !slot.getCount(), "latest slot: empty");
+        const auto gaze = makeGaze(3);
+        for (const auto& s : gaze)
+            slot.store(s);
+        check(slot.load() && sameGaze(*slot.load(), gaze.back()) && slot.getCount() == 3, "latest slot: holds latest value");
+
+        // types that are not trivially copyable
+        LatestSlot<std::vector<int>> vecSlot;
+        check(!vecSlot.load(), "latest slot (snapshot): empty");
+        vecSlot.emplace(std::vector<int>{ 1, 2, 3 });
+        vecSlot.emplace(std::vector<int>{ 4, 5 });
+        check(vecSlot.load() == std::vector<int>{ 4, 5 } && vecSlot.getCount() == 2, "latest slot (snapshot): holds latest value");
+
+        // values are only kept once the slot has been read, but always counted
+        LatestSlot<std::vector<int>> lazySlot;
+        lazySlot.storeIfRead({ 1 });
+        check(!lazySlot.load() && lazySlot.getCount() == 1, "latest slot (store if read): not kept before first read");
+        lazySlot.storeIfRead({ 2 });
+        check(lazySlot.load() == std::vector<int>{ 2 } && lazySlot.getCount() == 2, "latest slot (store if read): kept once read");
+
+        // readers never see a value that is being overwritten
+        LatestSlot<std::vector<int>> busySlot;
+        std::atomic<bool> done  = false;
+        std::atomic<int>  nTorn = 0;
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 4; r++)
+            readers.emplace_back([&]()
+            {
+                while (!done)
+                    if (const auto v = busySlot.load(); v && std::ranges::any_of(*v, [&](const int x_) { return x_ != v->front(); }))
+                        nTorn++;
+            });
+        for (int i = 0; i < 100'000; i++)
+            busySlot.store(std::vector<int>(16 + i % 16, i));
+        done = true;
+        for (auto& t : readers)
+            t.join();
+        check(!nTorn && busySlot.getCount() == 100'000, "latest slot (snapshot): concurrent reads are consistent");
+    }
+
+    void testCalibrationCache()
+    {
+        const auto dir = std::filesystem::temp_directory_path() / "Titta_test_calibrationCache";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+
+        // participants whose names differ only in characters that are not allowed in file names
+        const CalibrationCache::key a{ "TPSP1-010", "human", "p1-a" }, b{ "TPSP1-010", "human", "p1_a" }, c{ "TPSP1-010", "human", "p1/a" };
+        const std::vector<uint8_t> dataA{ 1, 2, 3 }, dataB{ 4, 5, 6, 7 }, dataC{ 8 };
+        {
+            CalibrationCache cache;
+            cache.setDirectory(dir.string());
+            cache.store(a, dataA);
+            cache.store(b, dataB);
+            cache.store(c, dataC);
+            check(cache.get(a) == dataA && cache.get(b) == dataB && cache.get(c) == dataC, "calibration cache: in memory");
+            check(cache.getParticipants("TPSP1-010", "human").size() == 3, "calibration cache: participants");
+            check(!cache.contains({ "TPSP1-010", "infant", "p1-a" }), "calibration cache: tracking mode is part of the key");
+        }
+        check(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator{}) == 3, "calibration cache: one file per key");
+
+        // fresh cache reads each back from disk
+        CalibrationCache fromDisk;
+        fromDisk.setDirectory(dir.string());
+        check(fromDisk.get(a) == dataA && fromDisk.get(b) == dataB && fromDisk.get(c) == dataC, "calibration cache: from disk");
+        check(!fromDisk.get({ "TPSP1-010", "human", "p2" }), "calibration cache: unknown key");
+
+        // corrupt files are detected
+        for (const auto& entry : std::filesystem::directory_iterator(dir))
+        {
+            std::fstream f(entry.path(), std::ios::in | std::ios::out | std::ios::binary);
+            f.seekp(-1, std::ios::end);
+            f.put('\xFF');
+        }
+        CalibrationCache corrupt;
+        corrupt.setDirectory(dir.string());
+        check(throws([&] { corrupt.get(a); }), "calibration cache: corrupt file rejected");
+
+        std::filesystem::remove_all(dir);
+    }
+
+    // 8-bit eye image with a dark disc (the pupil) of radius 8 centred on (cx_, cy_)
+    TobiiTypes::eyeImage makeEyeImage(const int width_, const int height_, const int cx_, const int cy_, const int cameraId_ = 0)
+    {
+        std::vector<uint8_t> pixels(static_cast<size_t>(width_) * height_);
+        for (int y = 0; y < height_; y++)
+            for (int x = 0; x < width_; x++)
+                pixels[static_cast<size_t>(y) * width_ + x] = static_cast<uint8_t>((x - cx_) * (x - cx_) + (y - cy_) * (y - cy_) < 64 ? 10 : 150 + (x + y) % 50);
+        TobiiTypes::eyeImage image;
+        image.setData(pixels.data(), pixels.size());
+        image.bits_per_pixel    = 8;
+        image.padding_per_pixel = 0;
+        image.width             = width_;
+        image.height            = height_;
+        image.camera_id         = cameraId_;
+        return image;
+    }
+    uint8_t pixelAt(const TobiiTypes::eyeImage& image_, const int x_, const int y_)
+    {
+        return static_cast<const uint8_t*>(image_.data())[static_cast<size_t>(y_) * image_.width + x_];
+    }
+
+    void testEyeImageReducer()
+    {
+        constexpr int w = 160, h = 120;
+        using Crop = EyeImageReducer::Crop;
+
+        // no reduction leaves the image alone
+        EyeImageReducer reducer;
+        auto image = makeEyeImage(w, h, 80, 60);
+        check(reducer.process(image) && image.width == w && image.height == h && image.data_size == w * h, "reducer: plain options leave image alone");
+
+        // fixed crop
+        const auto original = makeEyeImage(w, h, 80, 60);
+        image = original;
+        EyeImageReducer::reduce(image, { Crop::Fixed, { 10, 20, 40, 30 } });
+        bool same = image.width == 40 && image.height == 30 && image.data_size == 40 * 30 && image.crop_left == 10 && image.crop_top == 20;
+        for (int y = 0; same && y < 30; y++)
+            for (int x = 0; same && x < 40; x++)
+                same = pixelAt(image, x, y) == pixelAt(original, x + 10, y + 20);
+        check(same, "reducer: fixed crop");
+        image = original;
+        EyeImageReducer::reduce(image, { Crop::Fixed, { 150, 100, 40, 40 } });
+        check(image.width == 10 && image.height == 20 && image.crop_left == 150 && image.crop_top == 100, "reducer: fixed crop clipped to the image");
+        image = original;
+        EyeImageReducer::reduce(image, { Crop::Fixed, { 200, 200, 10, 10 } });
+        check(image.width == w && image.height == h, "reducer: crop outside the image keeps it whole");
+
+        // downscaling averages blocks
+        std::vector<uint8_t> blocks(static_cast<size_t>(w) * h);
+        for (int y = 0; y < h; y++)
+            for (int x = 0; x < w; x++)
+                blocks[static_cast<size_t>(y) * w + x] = static_cast<uint8_t>((x / 2 + y / 2) % 256);
+        image.setData(blocks.data(), blocks.size());
+        image.width  = w;
+        image.height = h;
+        image.crop_left = image.crop_top = 0;
+        EyeImageReducer::reduce(image, { Crop::None, {}, 2 });
+        same = image.width == w / 2 && image.height == h / 2 && image.downscale == 2;
+        for (int y = 0; same && y < h / 2; y++)
+            for (int x = 0; same && x < w / 2; x++)
+                same = pixelAt(image, x, y) == (x + y) % 256;
+        check(same, "reducer: downscale");
+        image = makeEyeImage(4, 4, 0, 0);
+        EyeImageReducer::reduce(image, { Crop::None, {}, 5 });
+        check(image.width == 4 && image.downscale == 1, "reducer: no downscale beyond image size");
+
+        // the crop window follows the pupil, also near the edge of the image
+        image = makeEyeImage(w, h, 100, 40);
+        EyeImageReducer::reduce(image, { Crop::Pupil, { 0, 0, 32, 32 } });
+        check(image.width == 32 && image.height == 32 && pixelAt(image, 100 - image.crop_left, 40 - image.crop_top) == 10 && std::abs(image.crop_left + 16 - 100) <= 8 && std::abs(image.crop_top + 16 - 40) <= 8, "reducer: pupil crop");
+        image = makeEyeImage(w, h, 5, 5);
+        EyeImageReducer::reduce(image, { Crop::Pupil, { 0, 0, 32, 32 } });
+        check(image.crop_left == 0 && image.crop_top == 0 && image.width == 32, "reducer: pupil crop at the edge");
+
+        // keepEveryN counts per camera, and restarts when the options are set
+        reducer.setOptions({ Crop::None, {}, 1, 3 });
+        std::vector<int> kept;
+        for (int i = 0; i < 7; i++)
+            for (const int camera : { 0, 1 })
+            {
+                auto frame = makeEyeImage(8, 8, 4, 4, camera);
+                if (reducer.process(frame))
+                    kept.push_back(camera * 100 + i);
+            }
+        check(kept == std::vector<int>{ 0, 100, 3, 103, 6, 106 }, "reducer: keepEveryN per camera");
+        reducer.setOptions({ Crop::None, {}, 1, 3 });
+        auto frame = makeEyeImage(8, 8, 4, 4);
+        check(reducer.process(frame), "reducer: setting options restarts frame count");
+
+        // GIFs are left alone
+        image = original;
+        image.is_gif = true;
+        EyeImageReducer::reduce(image, { Crop::Fixed, { 10, 20, 40, 30 }, 2 });
+        check(image.width == w && image.height == h && image.data_size == w * h, "reducer: gif left alone");
+
+        check(EyeImageReducer::stringToCrop(EyeImageReducer::cropToString(Crop::Pupil)) == Crop::Pupil, "reducer: crop mode round trip");
+        check(throws([] { EyeImageReducer::stringToCrop("bla"); }), "reducer: unknown crop mode rejected");
+    }
+
+    void testShmRing()
+    {
+        // unique name, so that concurrent test runs do not share a ring
+        const std::string name = "Titta_test_shmRing_" + std::to_string(std::random_device{}());
+        const auto makeSignal = [](const int64_t i_) { return TobiiResearchExternalSignalData{ i_, i_ * 10, static_cast<uint32_t>(i_), TOBII_RESEARCH_EXTERNAL_SIGNAL_VALUE_CHANGED }; };
+        const auto sameSignals = [&](const std::vector<TobiiResearchExternalSignalData>& got_, const int64_t first_, const int64_t n_)
+        {
+            bool ok = static_cast<int64_t>(got_.size()) == n_;
+            for (int64_t i = 0; ok && i < n_; i++)
+            {
+                const auto e = makeSignal(first_ + i);
+                ok = got_[i].device_time_stamp == e.device_time_stamp && got_[i].system_time_stamp == e.system_time_stamp && got_[i].value == e.value && got_[i].change_type == e.change_type;
+            }
+            return ok;
+        };
+
+        check(throws([&] { ShmRingWriter<TobiiResearchExternalSignalData>(name, 0); }), "shm ring: zero capacity rejected");
+        {
+            ShmRingWriter<TobiiResearchExternalSignalData> writer(name, 8);
+            ShmRingReader<TobiiResearchExternalSignalData> reader(name);
+            check(reader.read().empty(), "shm ring: empty");
+            for (int64_t i = 0; i < 5; i++)
+                writer.push(makeSignal(i));
+            check(sameSignals(reader.read(2), 0, 2) && sameSignals(reader.read(), 2, 3), "shm ring: round trip");
+            check(reader.read().empty() && !reader.getNumDropped(), "shm ring: nothing new");
+
+            // overwritten samples are skipped and counted
+            for (int64_t i = 5; i < 25; i++)
+                writer.push(makeSignal(i));
+            check(sameSignals(reader.read(), 17, 8) && reader.getNumDropped() == 12, "shm ring: overrun");
+            ShmRingReader<TobiiResearchExternalSignalData> fromOldest(name, true);
+            check(sameSignals(fromOldest.read(), 17, 8), "shm ring: reader starting at oldest");
+
+            // the stream type is checked
+            check(throws([&] { ShmRingReader<TobiiResearchTimeSynchronizationData> wrongType(name); }), "shm ring: wrong stream type rejected");
+            const auto any = openShmRingReader(name);
+            check(std::holds_alternative<ShmRingReader<TobiiResearchExternalSignalData>>(any), "shm ring: reader for stored stream type");
+            check(!reader.isWriterClosed(), "shm ring: writer open");
+        }
+        check(throws([&] { ShmRingReader<TobiiResearchExternalSignalData> gone(name); }), "shm ring: removed with writer");
+    }
+
+    void testLogRing()
+    {
+        check(LogRing<int>(5).capacity() == 8 && LogRing<int>(0).capacity() == 2, "log ring: capacity rounded up to power of two");
+
+        LogRing<int> ring(8);
+        int v = -1;
+        check(!ring.tryPop(v), "log ring: empty");
+        for (int i = 0; i < 3; i++)
+            ring.push(i);
+        std::vector<int> got;
+        while (ring.tryPop(v))
+            got.push_back(v);
+        check(got == std::vector<int>{ 0, 1, 2 }, "log ring: in order");
+
+        // when full, the oldest entries are dropped
+        for (int i = 0; i < 20; i++)
+            ring.push(i);
+        got.clear();
+        while (ring.tryPop(v))
+            got.push_back(v);
+        check(got == std::vector<int>{ 12, 13, 14, 15, 16, 17, 18, 19 } && ring.getNumDropped() == 12, "log ring: oldest dropped when full");
+
+        // concurrent producers, each producer's entries stay in order
+        constexpr int nProducers = 4, nPerProducer = 10'000;
+        LogRing<int> shared(nProducers * nPerProducer);
+        std::vector<std::thread> producers;
+        for (int p = 0; p < nProducers; p++)
+            producers.emplace_back([&shared, p]()
+            {
+                for (int i = 0; i < nPerProducer; i++)
+                    shared.push(p * nPerProducer + i);
+            });
+        for (auto& t : producers)
+            t.join();
+        std::vector<int> next(nProducers, 0);
+        bool inOrder = true;
+        int n = 0;
+        while (shared.tryPop(v))
+        {
+            n++;
+            inOrder &= v % nPerProducer == next[v / nPerProducer]++;
+        }
+        check(n == nProducers * nPerProducer && inOrder && !shared.getNumDropped(), "log ring: concurrent producers");
+    }
+
+    void testLatencyHistogram()
+    {
+        LatencyHistogram hist;
+        check(hist.getSummary().count == 0, "latency histogram: empty");
+
+        for (int64_t i = 1; i <= 1000; i++)
+            hist.record(i);
+        auto s = hist.getSummary();
+        const auto within1Pct = [](const int64_t got_, const int64_t expected_) { return std::llabs(got_ - expected_) <= expected_ / 100 + 1; };
+        check(s.count == 1000 && s.min == 1 && s.max == 1000 && std::abs(s.mean - 500.5) < 1e-9, "latency histogram: count, min, max, mean");
+        check(within1Pct(s.p50, 500) && within1Pct(s.p90, 900) && within1Pct(s.p99, 990) && within1Pct(s.p99_9, 999), "latency histogram: percentiles");
+
+        // small values are exact, large ones within 1%
+        hist.reset();
+        check(hist.getSummary().count == 0, "latency histogram: reset");
+        hist.record(37);
+        check(hist.getSummary().p50 == 37, "latency histogram: small value exact");
+        hist.reset();
+        hist.record(123'456'789);
+        check(within1Pct(hist.getSummary().p50, 123'456'789), "latency histogram: large value within 1%");
+
+        // out of range values are clamped
+        hist.reset();
+        hist.record(-5);
+        hist.record(int64_t{ 1 } << 40);
+        s = hist.getSummary();
+        check(s.min == 0 && s.max == (int64_t{ 1 } << 32) - 1, "latency histogram: values clamped");
+    }
+}
+
+int main()
+{
+    for (const auto& [name, test] : { std::pair{ "eye image codec", &testEyeImageCodec }, { "gif decoder", &testGifDecoder }, { "gaze resampler", &testGazeResampler }, { "compact gaze", &testCompactGaze }, { "latest slot", &testLatestSlot }, { "calibration cache", &testCalibrationCache }, { "eye image reducer", &testEyeImageReducer }, { "shm ring", &testShmRing }, { "log ring", &testLogRing }, { "latency histogram", &testLatencyHistogram } })
+    {
+        try
+        {
+            test();
+        }
+        catch (const std::exception& e)
+        {
+            check(false, std::string(name) + ": unexpected exception: " + e.what());
+        }
+    }
+
+    std::cout << g_nChecks - g_nFailed << " of " << g_nChecks << " checks passed" << std::endl;
+    return g_nFailed ? 1 : 0;
+}
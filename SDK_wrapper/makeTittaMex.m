@@ -56,6 +56,22 @@ for SDK_version=1:2
             fullfile(myDir,'src','Titta.cpp')
             fullfile(myDir,'src','types.cpp')
             fullfile(myDir,'src','utils.cpp')
+            fullfile(myDir,'src','eyeImageCodec.cpp')
+            fullfile(myDir,'src','eyeImageReducer.cpp')
+            fullfile(myDir,'src','gifDecoder.cpp')
+            fullfile(myDir,'src','workerPool.cpp')
+            fullfile(myDir,'src','discovery.cpp')
+            fullfile(myDir,'src','pinnedAllocator.cpp')
+            fullfile(myDir,'src','threading.cpp')
+            fullfile(myDir,'src','shmRing.cpp')
+            fullfile(myDir,'src','pipeline.cpp')
+            fullfile(myDir,'src','resample.cpp')
+            fullfile(myDir,'src','logSink.cpp')
+            fullfile(myDir,'src','calibrationCache.cpp')
+            fullfile(myDir,'src','compactGaze.cpp')
+            fullfile(myDir,'src','trace.cpp')
+            fullfile(myDir,'src','latency.cpp')
+            fullfile(myDir,'src','replay.cpp')
             linkTobiiResearchLib}.';
 
         if isLinux
@@ -35,7 +35,7 @@ class get_pybind_include(object):
 def get_extension_def(sdk_version):
     return Extension(
         'TittaPy_v%d' % sdk_version,
-        ['src/Titta.cpp','src/types.cpp','src/utils.cpp','TittaPy/TittaPy.cpp'],
+        ['src/Titta.cpp','src/types.cpp','src/utils.cpp','src/eyeImageCodec.cpp','src/eyeImageReducer.cpp','src/gifDecoder.cpp','src/workerPool.cpp','src/discovery.cpp','src/pinnedAllocator.cpp','src/threading.cpp','src/shmRing.cpp','src/pipeline.cpp','src/resample.cpp','src/logSink.cpp','src/calibrationCache.cpp','src/compactGaze.cpp','src/trace.cpp','src/latency.cpp','src/replay.cpp','TittaPy/TittaPy.cpp'],
         include_dirs=[
             # Path to pybind11 headers
             get_pybind_include(),
@@ -75,7 +75,7 @@ class BuildExt(build_ext):
         # set rpath so that delocate can find .dylib
         l_opts['unix'].extend(['-L./TittaMex/mex/', '-Wl,-rpath,''./SDK_wrapper/TittaMex/mex/''','-dead_strip'])
     else:
-        l_opts['unix'].extend(['-L./TittaMex/mex/', '-Wl,--gc-sections'])
+        l_opts['unix'].extend(['-L./TittaMex/mex/', '-Wl,--gc-sections', '-lrt'])
 
     def build_extensions(self):
         ct = self.compiler.compiler_type
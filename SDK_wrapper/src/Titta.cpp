@@ -4,8 +4,15 @@
 #include <string_view>
 #include <map>
 #include <cstring>
+#include <cmath>
+#include <chrono>
+#include <utility>
 
 #include "Titta/utils.h"
+#include "Titta/replay.h"
+#include "Titta/gifDecoder.h"
+#include "Titta/eyeImageReducer.h"
+#include "Titta/eyeImageCodec.h"
 
 namespace
 {
@@ -14,11 +21,26 @@ namespace
     {
         constexpr bool                  doErrorWhenCheckCallMode  = false;
         constexpr bool                  forceExitCalibrationMode  = false;
+        constexpr size_t                calibrationResultsMax     = 1024;         // completed calibration work kept for retrieval, oldest are dropped
 
-        constexpr size_t                sampleBufSize             = 2<<19;        // about half an hour at 600Hz
+        constexpr size_t                sampleBufSize             = 2<<19;        // about half an hour at 600Hz, used if eye tracker frequency is unknown
+        constexpr double                sampleBufDuration         = 30*60.;       // s, gaze buffer is sized to hold this much data at the eye tracker's frequency
 
         constexpr size_t                eyeImageBufSize           = 2<<11;        // about seven minutes at 2*5Hz
         constexpr bool                  eyeImageAsGIF             = false;
+        constexpr size_t                eyeImageDecodeThreads     = 2;
+        constexpr int                   eyeImageDownscale         = 1;
+        constexpr size_t                eyeImageKeepEveryN        = 1;
+        constexpr size_t                eyeImageCompressThreads   = 1;
+        constexpr size_t                eyeImageDecompressedCache = 16;
+        constexpr bool                  eyeImageCompressionReset  = false;
+
+        constexpr bool                  compactGazeQuantize       = false;
+        constexpr bool                  compactGazeCompressOld    = false;
+
+        constexpr bool                  bufferPrefault            = false;
+        constexpr bool                  bufferLock                = false;
+        constexpr PinnedMemory::HugePages bufferHugePages         = PinnedMemory::HugePages::None;
 
         constexpr size_t                extSignalBufSize          = 2<<9;
 
@@ -28,9 +50,13 @@ namespace
 
         constexpr size_t                notificationBufSize       = 2<<6;
 
+        constexpr size_t                sharedMemoryCapacity      = 2<<12;        // about 13 seconds of gaze at 600Hz
+
         constexpr int64_t               clearTimeRangeStart       = 0;
         constexpr int64_t               clearTimeRangeEnd         = std::numeric_limits<int64_t>::max();
 
+        constexpr std::array<Titta::Stream, 5> allStreamsDefault  = { Titta::Stream::Gaze, Titta::Stream::EyeImage, Titta::Stream::ExtSignal, Titta::Stream::TimeSync, Titta::Stream::Notification };
+
         constexpr bool                  stopBufferEmpties         = false;
         constexpr Titta::BufferSide     consumeSide               = Titta::BufferSide::Start;
         constexpr size_t                consumeNSamp              = -1;           // this overflows on purpose, consume all samples is default
@@ -41,8 +67,29 @@ namespace
         constexpr int64_t               peekTimeRangeStart        = 0;
         constexpr int64_t               peekTimeRangeEnd          = std::numeric_limits<int64_t>::max();
 
-        constexpr size_t                logBufSize                = 2<<8;
+        constexpr size_t                logBufSize                = 2<<13;
+        constexpr uint64_t              logFileMaxBytes           = 10*1024*1024;
+        constexpr size_t                logFileMaxFiles           = 5;
+        constexpr auto                  logFileFlushInterval      = std::chrono::milliseconds(100);
         constexpr bool                  logBufClear               = true;
+
+        constexpr double                discoveryInterval         = 2000.;        // ms
+        constexpr bool                  discoveryRefreshWait      = false;
+        constexpr bool                  discoveryEventsClear      = true;
+
+        constexpr bool                  traceClear                = true;
+
+        constexpr bool                  latencyStatsReset         = false;
+
+        constexpr int64_t               resampleMaxGap            = 75'000;       // us
+        constexpr GazeResampler::Method resampleMethod            = GazeResampler::Method::Linear;
+        constexpr size_t                resampledBufSize          = 2<<19;        // resampled gaze kept until retrieved, the oldest is dropped
+
+        constexpr double                replaySpeed               = 1.;           // real-time
+
+        // when evicting, free an additional 1/memoryEvictHeadroomDiv of the budget, so that not every new sample causes an eviction
+        constexpr size_t                memoryEvictHeadroomDiv    = 10;
+        constexpr std::array<Titta::Stream, 6> evictionOrder      = { Titta::Stream::EyeImage, Titta::Stream::Positioning, Titta::Stream::Gaze, Titta::Stream::TimeSync, Titta::Stream::ExtSignal, Titta::Stream::Notification };
     }
 
     // Map string to a Stream
@@ -176,6 +223,8 @@ std::string Titta::getAllBufferSidesString(const char* quoteChar_ /*= "\""*/)
 // callbacks
 void TittaGazeCallback(TobiiResearchGazeData* gaze_data_, void* user_data_)
 {
+    TITTA_TRACE_SCOPE("callback gaze", "callback");
+    TittaThreads::onCallback("Tobii SDK gaze callback");
     if (user_data_)
     {
         const auto instance = static_cast<Titta*>(user_data_);
@@ -184,6 +233,8 @@ void TittaGazeCallback(TobiiResearchGazeData* gaze_data_, void* user_data_)
 }
 void TittaEyeOpennessCallback(TobiiResearchEyeOpennessData* openness_data_, void* user_data_)
 {
+    TITTA_TRACE_SCOPE("callback eyeOpenness", "callback");
+    TittaThreads::onCallback("Tobii SDK eye openness callback");
     if (user_data_)
     {
         const auto instance = static_cast<Titta*>(user_data_);
@@ -192,80 +243,182 @@ void TittaEyeOpennessCallback(TobiiResearchEyeOpennessData* openness_data_, void
 }
 void TittaEyeImageCallback(TobiiResearchEyeImage* eye_image_, void* user_data_)
 {
+    TITTA_TRACE_SCOPE("callback eyeImage", "callback");
+    TittaThreads::onCallback("Tobii SDK eye image callback");
     if (user_data_)
     {
         const auto instance = static_cast<Titta*>(user_data_);
-        auto l = instance->lockForWriting<Titta::eyeImage>();
-        instance->_eyeImages.emplace_back(eye_image_);
+        Titta::eyeImage image(eye_image_);
+        if (!instance->_eyeImageReducer.process(image))
+            return;
+        instance->_eyeImagesLatest.storeIfRead(image);     // only copied once someone asks for it
+        // the compression job fetches the frame from the buffer
+        std::optional<Titta::eyeImageId> toCompress;
+        if (instance->_eyeImageCompression)
+            toCompress = { image.system_time_stamp, image.camera_id, image.region_id };
+        {
+            auto l = instance->lockForWriting<Titta::eyeImage>();
+            const auto now = Titta::getSystemTimestamp();   // after the lock, so the ingest latency includes waiting for the buffer
+            instance->_eyeImages.push_back(std::move(image));
+            instance->registerArrival<Titta::eyeImage>(1, now);
+        }
+        instance->enforceMemoryBudget();
+        if (toCompress)
+            instance->compressEyeImagesInBackground({ *toCompress });
+    }
+}
+namespace
+{
+    // replaces a GIF eye image by its decoded pixels, which are then reduced as set with
+    // Titta::setEyeImageReduction(). Images that cannot be decoded are left alone
+    bool decodeGifEyeImage(Titta::eyeImage& image_, const EyeImageReducer::options& reduction_)
+    {
+        TITTA_TRACE_SCOPE("decode eyeImage gif", "eyeImage");
+        std::vector<uint8_t> pixels;
+        int width = 0, height = 0;
+        std::string error;
+        if (!GifDecoder::decode(static_cast<const uint8_t*>(image_.data()), image_.data_size, pixels, width, height, error))
+            return false;
+
+        image_.setData(pixels.data(), pixels.size());
+        image_.is_gif            = false;
+        image_.bits_per_pixel    = 8;
+        image_.padding_per_pixel = 0;
+        image_.width             = width;
+        image_.height            = height;
+        EyeImageReducer::reduce(image_, reduction_);
+        return true;
     }
 }
 void TittaEyeImageGifCallback(TobiiResearchEyeImageGif* eye_image_, void* user_data_)
 {
+    TITTA_TRACE_SCOPE("callback eyeImage gif", "callback");
+    TittaThreads::onCallback("Tobii SDK eye image callback");
     if (user_data_)
     {
         const auto instance = static_cast<Titta*>(user_data_);
-        auto l = instance->lockForWriting<Titta::eyeImage>();
-        instance->_eyeImages.emplace_back(eye_image_);
+        Titta::eyeImage image(eye_image_);
+        if (!instance->_eyeImageReducer.process(image))     // GIFs are only cropped and downscaled once decoded
+            return;
+        instance->_eyeImagesLatest.storeIfRead(image);
+        std::optional<Titta::eyeImage> toDecode;
+        if (instance->_eyeImageDecoding == Titta::EyeImageDecoding::Ingest)
+            toDecode = image;
+        {
+            auto l = instance->lockForWriting<Titta::eyeImage>();
+            const auto now = Titta::getSystemTimestamp();
+            instance->_eyeImages.push_back(std::move(image));
+            instance->registerArrival<Titta::eyeImage>(1, now);
+        }
+        instance->enforceMemoryBudget();
+        // decode in the background, the decoded frame then replaces the GIF in the buffer
+        if (toDecode)
+        {
+            std::function<void()> job = [instance, image = std::move(*toDecode)]() mutable
+            {
+                if (!decodeGifEyeImage(image, instance->_eyeImageReducer.getOptions()))
+                    return;
+                if (instance->_eyeImageCompression)
+                    instance->compressEyeImage(image);
+                instance->replaceEyeImages({ &image }, true);
+            };
+            // decoder pool not (or no longer) running, e.g. as decoding is being switched off: decode here
+            if (!instance->_eyeImageDecoder.submit(std::move(job)))
+                job();
+        }
     }
 }
 void TittaExtSignalCallback(TobiiResearchExternalSignalData* ext_signal_, void* user_data_)
 {
+    TITTA_TRACE_SCOPE("callback externalSignal", "callback");
+    TittaThreads::onCallback("Tobii SDK external signal callback");
     if (user_data_)
     {
         const auto instance = static_cast<Titta*>(user_data_);
-        auto l = instance->lockForWriting<Titta::extSignal>();
-        instance->_extSignal.push_back(*ext_signal_);
+        instance->_extSignalLatest.store(*ext_signal_);
+        {
+            auto l = instance->lockForWriting<Titta::extSignal>();
+            const auto now = Titta::getSystemTimestamp();
+            instance->_extSignal.push_back(*ext_signal_);
+            if (instance->_extSignalShm)
+                instance->_extSignalShm->push(*ext_signal_);
+            instance->registerArrival<Titta::extSignal>(1, now);
+        }
+        instance->enforceMemoryBudget();
     }
 }
 void TittaTimeSyncCallback(TobiiResearchTimeSynchronizationData* time_sync_data_, void* user_data_)
 {
+    TITTA_TRACE_SCOPE("callback timeSync", "callback");
+    TittaThreads::onCallback("Tobii SDK time sync callback");
     if (user_data_)
     {
         const auto instance = static_cast<Titta*>(user_data_);
-        auto l = instance->lockForWriting<Titta::timeSync>();
-        instance->_timeSync.push_back(*time_sync_data_);
+        instance->_timeSyncLatest.store(*time_sync_data_);
+        {
+            auto l = instance->lockForWriting<Titta::timeSync>();
+            const auto now = Titta::getSystemTimestamp();
+            instance->_timeSync.push_back(*time_sync_data_);
+            if (instance->_timeSyncShm)
+                instance->_timeSyncShm->push(*time_sync_data_);
+            instance->registerArrival<Titta::timeSync>(1, now);
+        }
+        instance->enforceMemoryBudget();
     }
 }
 void TittaPositioningCallback(TobiiResearchUserPositionGuide* position_data_, void* user_data_)
 {
+    TITTA_TRACE_SCOPE("callback positioning", "callback");
+    TittaThreads::onCallback("Tobii SDK positioning callback");
     if (user_data_)
     {
         const auto instance = static_cast<Titta*>(user_data_);
-        auto l = instance->lockForWriting<Titta::positioning>();
-        instance->_positioning.push_back(*position_data_);
+        instance->_positioningLatest.store(*position_data_);
+        {
+            auto l = instance->lockForWriting<Titta::positioning>();
+            instance->_positioning.push_back(*position_data_);
+            if (instance->_positioningShm)
+                instance->_positioningShm->push(*position_data_);
+            instance->registerArrival<Titta::positioning>(1);
+        }
+        instance->enforceMemoryBudget();
     }
 }
 void TittaLogCallback(int64_t system_time_stamp_, TobiiResearchLogSource source_, TobiiResearchLogLevel level_, const char* message_)
 {
-    if (Titta::_logMessages)
-    {
-        auto l = write_lock(Titta::_logsMutex);
-        Titta::_logMessages->emplace_back(Titta::logMessage(system_time_stamp_, source_, level_, message_));
-    }
+    // filter before doing any work, so noisy debug logging is cheap to ignore
+    if (level_ > Titta::_logLevel.load(std::memory_order_relaxed))
+        return;
+    if (Titta::_logRing)
+        Titta::_logRing->push(Titta::logMessage(system_time_stamp_, source_, level_, message_));
 }
 void TittaStreamErrorCallback(TobiiResearchStreamErrorData* errorData_, void* user_data_)
 {
-    if (Titta::_logMessages && errorData_)
+    if (Titta::_logRing && errorData_)
     {
+        // attribute to the instance whose eye tracker produced the error
         std::string serial;
         if (user_data_)
-        {
-            char* serial_number;
-            tobii_research_get_serial_number(static_cast<TobiiResearchEyeTracker*>(user_data_), &serial_number);
-            serial = serial_number;
-            tobii_research_free_string(serial_number);
-        }
-        auto l = write_lock(Titta::_logsMutex);
-        Titta::_logMessages->emplace_back(Titta::streamError(std::move(serial), errorData_->system_time_stamp, errorData_->error, errorData_->source, errorData_->message));
+            serial = static_cast<Titta*>(user_data_)->_eyeTracker.serialNumber;
+        Titta::_logRing->push(Titta::streamError(std::move(serial), errorData_->system_time_stamp, errorData_->error, errorData_->source, errorData_->message));
     }
 }
 void TittaNotificationCallback(TobiiResearchNotification* notification_, void* user_data_)
 {
+    TITTA_TRACE_SCOPE("callback notification", "callback");
+    TittaThreads::onCallback("Tobii SDK notification callback");
     if (user_data_)
     {
         const auto instance = static_cast<Titta*>(user_data_);
-        auto l = instance->lockForWriting<Titta::notification>();
-        instance->_notification.emplace_back(*notification_);
+        instance->_notificationLatest.emplace(*notification_);
+        {
+            auto l = instance->lockForWriting<Titta::notification>();
+            const auto now = Titta::getSystemTimestamp();
+            instance->_notification.emplace_back(*notification_);
+            instance->registerArrival<Titta::notification>(1, now);
+        }
+        instance->onDeviceNotification(*notification_);
+        instance->enforceMemoryBudget();
     }
 }
 
@@ -288,37 +441,76 @@ int64_t Titta::getSystemTimestamp()
 }
 std::vector<TobiiTypes::eyeTracker> Titta::findAllEyeTrackers()
 {
-    TobiiResearchEyeTrackers* tobiiTrackers = nullptr;
-    const TobiiResearchStatus status = tobii_research_find_all_eyetrackers(&tobiiTrackers);
-    if (status != TOBII_RESEARCH_STATUS_OK)
-        ErrorExit("Titta::cpp: Cannot get eye trackers", status);
-    std::vector<TobiiTypes::eyeTracker> eyeTrackers;
-
-    eyeTrackers.insert(eyeTrackers.end(), &tobiiTrackers->eyetrackers[0], &tobiiTrackers->eyetrackers[tobiiTrackers->count]);   // yes, pointer to one past last element
-    tobii_research_free_eyetrackers(tobiiTrackers);
-
-    return eyeTrackers;
+    return _eyeTrackerDiscovery.getEyeTrackers();
 }
 TobiiTypes::eyeTracker Titta::getEyeTrackerFromAddress(std::string address_)
 {
+    if (_eyeTrackerDiscovery.isRunning())
+        if (auto eyeTracker = _eyeTrackerDiscovery.find(address_))
+            return *std::move(eyeTracker);
+
     TobiiResearchEyeTracker* et;
     const TobiiResearchStatus status = tobii_research_get_eyetracker(address_.c_str(), &et);
     if (status != TOBII_RESEARCH_STATUS_OK)
         ErrorExit("Titta::cpp: Cannot get eye tracker \"" + address_ + "\"", status);
     return et;
 }
+void Titta::startEyeTrackerDiscovery(std::optional<double> intervalMs_)
+{
+    // deal with default arguments
+    const auto intervalMs = intervalMs_.value_or(defaults::discoveryInterval);
 
-// logging static functions
-bool Titta::startLogging(std::optional<size_t> initialBufferSize_)
+    _eyeTrackerDiscovery.start(std::chrono::milliseconds(static_cast<int64_t>(intervalMs)));
+}
+void Titta::stopEyeTrackerDiscovery()
+{
+    _eyeTrackerDiscovery.stop();
+}
+bool Titta::isEyeTrackerDiscoveryRunning()
+{
+    return _eyeTrackerDiscovery.isRunning();
+}
+void Titta::refreshEyeTrackers(std::optional<bool> wait_)
 {
-    if (!_logMessages)
-        _logMessages = std::make_unique<std::vector<allLogTypes>>();
+    // deal with default arguments
+    const auto wait = wait_.value_or(defaults::discoveryRefreshWait);
 
+    _eyeTrackerDiscovery.refresh(wait);
+}
+std::vector<EyeTrackerDiscovery::entry> Titta::getDiscoveredEyeTrackers()
+{
+    return _eyeTrackerDiscovery.getEntries();
+}
+std::vector<EyeTrackerDiscovery::event> Titta::getEyeTrackerDiscoveryEvents(std::optional<bool> clear_)
+{
     // deal with default arguments
-    const auto initialBufferSize = initialBufferSize_.value_or(defaults::logBufSize);
+    const auto clear = clear_.value_or(defaults::discoveryEventsClear);
 
-    auto l = write_lock(Titta::_logsMutex);
-    _logMessages->reserve(initialBufferSize);
+    return _eyeTrackerDiscovery.getEvents(clear);
+}
+void Titta::setEyeTrackerDiscoveryCallback(std::function<void(EyeTrackerDiscovery::event)> callback_)
+{
+    _eyeTrackerDiscovery.setCallback(std::move(callback_));
+}
+
+// logging static functions
+bool Titta::startLogging(std::optional<size_t> initialBufferSize_)
+{
+    {
+        auto l = write_lock(Titta::_logsMutex);
+        // the ring can only be (re)created while nothing is pushing into it
+        if (!_logRing || (!_isLogging && initialBufferSize_ && *initialBufferSize_ != _logRing->capacity()))
+        {
+            // deal with default arguments
+            const auto bufferSize = initialBufferSize_.value_or(defaults::logBufSize);
+
+            if (_logRing)
+                drainLogRing();
+            auto nDropped = _logRing ? _logRing->getNumDropped() : 0;
+            _logRing = std::make_unique<LogRing<allLogTypes>>(bufferSize);
+            _logRing->addDropped(nDropped);
+        }
+    }
     const auto result = tobii_research_logging_subscribe(TittaLogCallback);
 
     if (g_allInstances)
@@ -326,26 +518,145 @@ bool Titta::startLogging(std::optional<size_t> initialBufferSize_)
         // also start stream error logging on all instances
         for (const auto inst : *g_allInstances)
             if (inst->_eyeTracker.et)
-                tobii_research_subscribe_to_stream_errors(inst->_eyeTracker.et, TittaStreamErrorCallback, inst->_eyeTracker.et);
+                tobii_research_subscribe_to_stream_errors(inst->_eyeTracker.et, TittaStreamErrorCallback, inst);
     }
 
     return _isLogging = result == TOBII_RESEARCH_STATUS_OK;
 }
+void Titta::drainLogRing()
+{
+    if (!_logRing)
+        return;
+
+    allLogTypes entry;
+    while (_logRing->tryPop(entry))
+    {
+        if (_logSink)
+            _logSink->write(entry);
+        _logMessages.push_back(std::move(entry));
+    }
+
+    // the log kept in memory is bounded by the ring's capacity too, drop the oldest messages
+    if (_logMessages.size() > _logRing->capacity())
+    {
+        const auto nDrop = _logMessages.size() - _logRing->capacity();
+        _logMessages.erase(_logMessages.begin(), _logMessages.begin() + static_cast<std::ptrdiff_t>(nDrop));
+        _logRing->addDropped(nDrop);
+    }
+}
 std::vector<Titta::allLogTypes> Titta::getLog(std::optional<bool> clearLog_)
 {
-    if (!_logMessages)
+    if (!_logRing)
         return {};
 
     // deal with default arguments
     const auto clearLog = clearLog_.value_or(defaults::logBufClear);
 
     auto l = write_lock(Titta::_logsMutex);
+    drainLogRing();
+    std::vector<allLogTypes> out(std::make_move_iterator(_logMessages.begin()), std::make_move_iterator(_logMessages.end()));
     if (clearLog)
-        return { std::move(*_logMessages) };
+        _logMessages.clear();
     else
-        // provide a copy
-        return { *_logMessages };
+        // keep a copy
+        _logMessages.assign(out.begin(), out.end());
+    return out;
+}
+void Titta::setLogLevel(TobiiResearchLogLevel level_)
+{
+    _logLevel = level_;
+}
+TobiiResearchLogLevel Titta::getLogLevel()
+{
+    return _logLevel;
+}
+uint64_t Titta::getNumDroppedLogMessages()
+{
+    return _logRing ? _logRing->getNumDropped() : 0;
+}
+void Titta::startLogFile(std::string fileName_, std::optional<uint64_t> maxBytes_, std::optional<size_t> maxFiles_)
+{
+    stopLogFile();
+
+    // deal with default arguments
+    const auto maxBytes = maxBytes_.value_or(defaults::logFileMaxBytes);
+    const auto maxFiles = maxFiles_.value_or(defaults::logFileMaxFiles);
+
+    auto sink = std::make_unique<LogFileSink>(std::move(fileName_), maxBytes, maxFiles);
+    {
+        auto l = write_lock(Titta::_logsMutex);
+        _logSink = std::move(sink);
+    }
+    _logSinkStop   = false;
+    _logSinkThread = std::thread(&Titta::logSinkThread);
+}
+void Titta::stopLogFile()
+{
+    if (_logSinkThread.joinable())
+    {
+        {
+            std::lock_guard lock(_logSinkMutex);
+            _logSinkStop = true;
+        }
+        _logSinkCV.notify_one();
+        _logSinkThread.join();
+    }
+
+    auto l = write_lock(Titta::_logsMutex);
+    _logSink.reset();
+}
+void Titta::logSinkThread()
+{
+    TITTA_TRACE_THREAD_NAME("Titta log sink");
+    TittaThreads::scope threadRegistration("Titta log sink");
+    while (true)
+    {
+        bool stop;
+        {
+            std::unique_lock lock(_logSinkMutex);
+            _logSinkCV.wait_for(lock, defaults::logFileFlushInterval, []() { return _logSinkStop; });
+            stop = _logSinkStop;
+        }
+        {
+            TITTA_TRACE_SCOPE("log sink drain", "log");
+            auto l = write_lock(Titta::_logsMutex);
+            drainLogRing();
+            if (_logSink)
+                _logSink->flush();
+        }
+        if (stop)
+            break;
+    }
 }
+bool Titta::isTracingEnabled()
+{
+#ifdef TITTA_ENABLE_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+std::string Titta::getTrace([[maybe_unused]] std::optional<bool> clear_)
+{
+#ifdef TITTA_ENABLE_TRACING
+    // deal with default arguments
+    const auto clear = clear_.value_or(defaults::traceClear);
+
+    return TittaTrace::getChromeJSON(clear);
+#else
+    DoExitWithMsg("Titta::cpp::getTrace: tracing is not available, Titta must be built with TITTA_ENABLE_TRACING defined to use it.");
+#endif
+}
+
+void Titta::setThreadSettings(std::optional<std::string> policy_, std::optional<int> priority_, std::optional<int> nice_, std::optional<std::vector<int>> cpus_)
+{
+    TittaThreads::set({ std::move(policy_), priority_, nice_, std::move(cpus_) });
+}
+std::vector<TittaThreads::info> Titta::getThreadSettings()
+{
+    return TittaThreads::getInfo();
+}
+
 bool Titta::stopLogging()
 {
     const auto result = tobii_research_logging_unsubscribe();
@@ -361,11 +672,23 @@ bool Titta::stopLogging()
                 tobii_research_unsubscribe_from_stream_errors(inst->_eyeTracker.et, TittaStreamErrorCallback);
     }
 
+    // nothing more will come in, write out what's pending and close the log file
+    stopLogFile();
+
     return success;
 }
 
 namespace
 {
+    // nullopt if the display area cannot be fetched, e.g. when replaying
+    std::optional<TobiiResearchDisplayArea> tryGetDisplayArea(TobiiResearchEyeTracker* eyetracker_)
+    {
+        TobiiResearchDisplayArea displayArea;
+        if (!eyetracker_ || tobii_research_get_display_area(eyetracker_, &displayArea) != TOBII_RESEARCH_STATUS_OK)
+            return std::nullopt;
+        return displayArea;
+    }
+
     // eye image helpers
     TobiiResearchStatus doSubscribeEyeImage(TobiiResearchEyeTracker* eyetracker_, Titta* instance_, const bool asGif_)
     {
@@ -388,10 +711,26 @@ namespace
 
 Titta::Titta(std::string address_)
 {
+    if (TittaReplay::isReplayAddress(address_))
+    {
+        // no eye tracker, replay recorded session instead
+        _replay = std::make_unique<TittaReplay>(std::move(address_));
+        _replay->setSpeed(defaults::replaySpeed);
+        _eyeTracker = _replay->getEyeTrackerInfo();
+        Init();
+        return;
+    }
+
+    // if discovery already found this eye tracker, reuse its handle
     TobiiResearchEyeTracker* et;
-    const TobiiResearchStatus status = tobii_research_get_eyetracker(address_.c_str(), &et);
-    if (status != TOBII_RESEARCH_STATUS_OK)
-        ErrorExit("Titta::cpp: Cannot get eye tracker \"" + address_ + "\"", status);
+    if (const auto known = _eyeTrackerDiscovery.find(address_); known && known->et)
+        et = known->et;
+    else
+    {
+        const TobiiResearchStatus status = tobii_research_get_eyetracker(address_.c_str(), &et);
+        if (status != TOBII_RESEARCH_STATUS_OK)
+            ErrorExit("Titta::cpp: Cannot get eye tracker \"" + address_ + "\"", status);
+    }
     _eyeTracker = TobiiTypes::eyeTracker(et);
     Init();
 }
@@ -402,6 +741,8 @@ Titta::Titta(TobiiResearchEyeTracker* et_)
 }
 Titta::~Titta()
 {
+    stopPipeline();
+    stopGazeCompressThread();
     stop(Stream::Gaze,        true);
     stop(Stream::EyeOpenness, true);
     stop(Stream::EyeImage,    true);
@@ -409,6 +750,10 @@ Titta::~Titta()
     stop(Stream::TimeSync,    true);
     stop(Stream::Positioning, true);
     stop(Stream::Notification,true);
+    // only now that no more callbacks can come in and queue work on them
+    _deviceStateRefresher.stop();
+    _eyeImageDecoder.stop();
+    _eyeImageCompressor.stop();
 
     if (_eyeTracker.et)
         tobii_research_unsubscribe_from_stream_errors(_eyeTracker.et, TittaStreamErrorCallback);
@@ -428,17 +773,22 @@ void Titta::Init()
     if (_isLogging)
     {
         // log version of SDK dll that is being used
-        if (Titta::_logMessages)
+        if (Titta::_logRing && TOBII_RESEARCH_LOG_LEVEL_INFORMATION <= _logLevel)
         {
             TobiiResearchSDKVersion v;
             tobii_research_get_sdk_version(&v);
-            auto l = lockForWriting<Titta::logMessage>();
-            Titta::_logMessages->emplace_back(Titta::logMessage(0, TOBII_RESEARCH_LOG_SOURCE_SDK, TOBII_RESEARCH_LOG_LEVEL_INFORMATION, string_format("Using C SDK version: %d.%d.%d.%d", v.major, v.minor, v.revision, v.build)));
+            Titta::_logRing->push(Titta::logMessage(0, TOBII_RESEARCH_LOG_SOURCE_SDK, TOBII_RESEARCH_LOG_LEVEL_INFORMATION, string_format("Using C SDK version: %d.%d.%d.%d", v.major, v.minor, v.revision, v.build)));
         }
 
-        // start stream error logging
-        tobii_research_subscribe_to_stream_errors(_eyeTracker.et, TittaStreamErrorCallback, _eyeTracker.et);
+        // start stream error logging (no eye tracker to log from when replaying)
+        if (_eyeTracker.et)
+            tobii_research_subscribe_to_stream_errors(_eyeTracker.et, TittaStreamErrorCallback, this);
     }
+    _evictionOrder.assign(std::begin(defaults::evictionOrder), std::end(defaults::evictionOrder));
+    // eye tracker info was just fetched, seed the device state cache with it
+    _deviceState.emplace(TobiiTypes::deviceState{ _eyeTracker, tryGetDisplayArea(_eyeTracker.et), 0 });
+    if (_eyeTracker.et)
+        _deviceStateRefresher.start(1);
     start(Stream::Notification);    // always start notification stream as soon as we're connected
     if (g_allInstances)
         g_allInstances->push_back(this);
@@ -447,50 +797,90 @@ void Titta::Init()
 // getters and setters
 TobiiTypes::eyeTracker Titta::getEyeTrackerInfo(std::optional<std::string> paramToRefresh_ /*= std::nullopt*/)
 {
-    // refresh ET info to make sure its up to date
-    _eyeTracker.refreshInfo(std::move(paramToRefresh_));
+    if (paramToRefresh_)
+        refreshDeviceState(std::move(paramToRefresh_));
 
-    return _eyeTracker;
+    return getDeviceState().info;
 }
 TobiiResearchDisplayArea Titta::getDisplayArea() const
 {
-    TobiiResearchDisplayArea display_area;
-    const TobiiResearchStatus status = tobii_research_get_display_area(_eyeTracker.et, &display_area);
-    if (status != TOBII_RESEARCH_STATUS_OK)
-        ErrorExit("Titta::cpp: Cannot get eye tracker display area", status);
-    return display_area;
+    auto state = getDeviceState();
+    if (!state.displayArea)
+    {
+        // could not be fetched when connecting, try again so that the error is reported
+        refreshDeviceState("displayArea");
+        state = getDeviceState();
+    }
+    return *state.displayArea;
+}
+TobiiTypes::deviceState Titta::getDeviceState() const
+{
+    // seeded when connecting, so always set
+    return *_deviceState.load();
+}
+void Titta::refreshDeviceState(std::optional<std::string> paramToRefresh_) const
+{
+    std::lock_guard lock(_deviceStateMutex);
+    // a notification arriving while we fetch is applied after us, or queues another refresh
+    auto state = *_deviceState.load();
+    if (paramToRefresh_ == "displayArea")
+    {
+        if (!_eyeTracker.et)
+            DoExitWithMsg("Titta::cpp::getDisplayArea: not available when replaying a recorded session");
+        TobiiResearchDisplayArea displayArea;
+        const TobiiResearchStatus status = tobii_research_get_display_area(_eyeTracker.et, &displayArea);
+        if (status != TOBII_RESEARCH_STATUS_OK)
+            ErrorExit("Titta::cpp: Cannot get eye tracker display area", status);
+        state.displayArea = displayArea;
+    }
+    else
+    {
+        if (_eyeTracker.et)
+            state.info.refreshInfo(paramToRefresh_);
+        if (!paramToRefresh_)
+            state.displayArea = tryGetDisplayArea(_eyeTracker.et);
+    }
+    _deviceState.emplace(std::move(state));
 }
 // setters
 void Titta::setDeviceName(std::string deviceName_)
 {
+    if (!_eyeTracker.et)
+        DoExitWithMsg("Titta::cpp::setDeviceName: not available when replaying a recorded session");
     const TobiiResearchStatus status = tobii_research_set_device_name(_eyeTracker.et, deviceName_.c_str());
     if (status != TOBII_RESEARCH_STATUS_OK)
         ErrorExit("Titta::cpp: Cannot set eye tracker device name", status);
 
     // refresh eye tracker info to get updated name
-    _eyeTracker.refreshInfo("deviceName");
+    refreshDeviceState("deviceName");
 }
 void Titta::setFrequency(const float frequency_)
 {
+    if (!_eyeTracker.et)
+        DoExitWithMsg("Titta::cpp::setFrequency: not available when replaying a recorded session");
     const TobiiResearchStatus status = tobii_research_set_gaze_output_frequency(_eyeTracker.et, frequency_);
     if (status != TOBII_RESEARCH_STATUS_OK)
         ErrorExit("Titta::cpp: Cannot set eye tracker frequency", status);
 
     // refresh eye tracker info to get updated frequency
-    _eyeTracker.refreshInfo("frequency");
+    refreshDeviceState("frequency");
 }
 void Titta::setTrackingMode(std::string trackingMode_)
 {
+    if (!_eyeTracker.et)
+        DoExitWithMsg("Titta::cpp::setTrackingMode: not available when replaying a recorded session");
     const TobiiResearchStatus status = tobii_research_set_eye_tracking_mode(_eyeTracker.et, trackingMode_.c_str());
     if (status != TOBII_RESEARCH_STATUS_OK)
         ErrorExit("Titta::cpp: Cannot set eye tracker tracking mode", status);
 
     // refresh eye tracker info to get updated tracking mode
-    _eyeTracker.refreshInfo("trackingMode");
+    refreshDeviceState("trackingMode");
 }
 // modifiers
 std::vector<TobiiResearchLicenseValidationResult> Titta::applyLicenses(std::vector<std::vector<uint8_t>> licenses_)
 {
+    if (!_eyeTracker.et)
+        DoExitWithMsg("Titta::cpp::applyLicenses: not available when replaying a recorded session");
     std::vector<uint8_t*> licenseKeyRing;
     std::vector<size_t>   licenseLengths;
     for (auto& license : licenses_)
@@ -504,29 +894,103 @@ std::vector<TobiiResearchLicenseValidationResult> Titta::applyLicenses(std::vect
         ErrorExit("Titta::cpp: Cannot apply eye tracker license(s)", status);
 
     // refresh eye tracker info, e.g. capabilities may have changed after license applied
-    _eyeTracker.refreshInfo();
+    refreshDeviceState(std::nullopt);
 
     return validationResults;
 }
 void Titta::clearLicenses()
 {
+    if (!_eyeTracker.et)
+        DoExitWithMsg("Titta::cpp::clearLicenses: not available when replaying a recorded session");
     const TobiiResearchStatus status = tobii_research_clear_applied_licenses(_eyeTracker.et);
     if (status != TOBII_RESEARCH_STATUS_OK)
         ErrorExit("Titta::cpp: Cannot clear eye tracker license(s)", status);
 
     // refresh eye tracker info, e.g. capabilities may have changed after licenses removed
-    _eyeTracker.refreshInfo();
+    refreshDeviceState(std::nullopt);
 }
 
 //// calibration
+#ifdef TITTA_ENABLE_TRACING
+namespace
+{
+    const char* getCalibrationActionTraceName(const TobiiTypes::CalibrationAction action_)
+    {
+        switch (action_)
+        {
+            case TobiiTypes::CalibrationAction::Nothing:
+                return "calibration nothing";
+            case TobiiTypes::CalibrationAction::Enter:
+                return "calibration enter";
+            case TobiiTypes::CalibrationAction::CollectData:
+                return "calibration collect data";
+            case TobiiTypes::CalibrationAction::DiscardData:
+                return "calibration discard data";
+            case TobiiTypes::CalibrationAction::Compute:
+                return "calibration compute and apply";
+            case TobiiTypes::CalibrationAction::GetCalibrationData:
+                return "calibration get data";
+            case TobiiTypes::CalibrationAction::ApplyCalibrationData:
+                return "calibration apply data";
+            case TobiiTypes::CalibrationAction::CacheCalibrationData:
+                return "calibration cache data";
+            case TobiiTypes::CalibrationAction::ApplyCachedCalibrationData:
+                return "calibration apply cached data";
+            case TobiiTypes::CalibrationAction::Exit:
+                return "calibration exit";
+        }
+        return "calibration unknown";
+    }
+}
+#endif
+namespace
+{
+    void setCalibrationStatusString(TobiiTypes::CalibrationWorkResult& result_)
+    {
+        result_.statusString = string_format("Tobii SDK code: %d: %s (%s)", static_cast<int>(result_.status), TobiiResearchStatusToString(result_.status).c_str(), TobiiResearchStatusToExplanation(result_.status).c_str());
+    }
+
+    TobiiResearchStatus retrieveCalibrationData(TobiiResearchEyeTracker* et_, std::optional<std::vector<uint8_t>>& out_)
+    {
+        TobiiResearchCalibrationData* calData = nullptr;
+        const auto result = tobii_research_retrieve_calibration_data(et_, &calData);
+        if (calData)
+        {
+            if (calData->size)
+                out_ = std::vector<uint8_t>(static_cast<uint8_t*>(calData->data), static_cast<uint8_t*>(calData->data) + calData->size);
+            tobii_research_free_calibration_data(calData);
+        }
+        return result;
+    }
+
+    TobiiResearchStatus applyCalibrationData(TobiiResearchEyeTracker* et_, const std::vector<uint8_t>& data_)
+    {
+        if (data_.empty())
+            return TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;
+
+        TobiiResearchCalibrationData calData;
+        // copy calibration data into array
+        const auto nItem = data_.size();
+        calData.data = malloc(nItem);
+        calData.size = nItem;
+        std::memcpy(calData.data, data_.data(), nItem);
+
+        const auto result = tobii_research_apply_calibration_data(et_, &calData);
+        free(calData.data);
+        return result;
+    }
+}
 void Titta::calibrationThread()
 {
+    TITTA_TRACE_THREAD_NAME("Titta calibration");
+    TittaThreads::scope threadRegistration("Titta calibration");
     bool keepRunning = true;
     TobiiResearchStatus result;
     while (keepRunning)
     {
         TobiiTypes::CalibrationWorkItem workItem;
         _calibrationWorkQueue.wait_dequeue(workItem);
+        TITTA_TRACE_SCOPE(getCalibrationActionTraceName(workItem.action), "calibration");
         switch (workItem.action)
         {
         case TobiiTypes::CalibrationAction::Nothing:
@@ -535,7 +999,7 @@ void Titta::calibrationThread()
         case TobiiTypes::CalibrationAction::Enter:
             // enter calibration mode
             result = tobii_research_screen_based_calibration_enter_calibration_mode(_eyeTracker.et);
-            _calibrationWorkResultQueue.enqueue({workItem, result});
+            deliverCalibrationResult({workItem, result});
 
             _calibrationState = TobiiTypes::CalibrationState::AwaitingCalPoint;
             break;
@@ -555,7 +1019,7 @@ void Titta::calibrationThread()
             else
                 result = tobii_research_screen_based_calibration_collect_data(_eyeTracker.et, static_cast<float>(coords[0]), static_cast<float>(coords[1]));
 
-            _calibrationWorkResultQueue.enqueue({workItem, result});
+            deliverCalibrationResult({workItem, result});
 
             _calibrationState = TobiiTypes::CalibrationState::AwaitingCalPoint;
             break;
@@ -575,7 +1039,7 @@ void Titta::calibrationThread()
             else
                 result = tobii_research_screen_based_calibration_discard_data(_eyeTracker.et, static_cast<float>(coords[0]), static_cast<float>(coords[1]));
 
-            _calibrationWorkResultQueue.enqueue({workItem, result});
+            deliverCalibrationResult({workItem, result});
 
             _calibrationState = TobiiTypes::CalibrationState::AwaitingCalPoint;
             break;
@@ -583,14 +1047,15 @@ void Titta::calibrationThread()
         case TobiiTypes::CalibrationAction::Compute:
         {
             _calibrationState = TobiiTypes::CalibrationState::Computing;
-            TobiiResearchCalibrationResult* computeResult;
+            TobiiResearchCalibrationResult* computeResult = nullptr;
             if (_calibrationIsMonocular)
                 result = tobii_research_screen_based_monocular_calibration_compute_and_apply(_eyeTracker.et, &computeResult);
             else
                 result = tobii_research_screen_based_calibration_compute_and_apply(_eyeTracker.et, &computeResult);
 
-            _calibrationWorkResultQueue.enqueue({ workItem, result, {}, computeResult });
-            tobii_research_free_screen_based_calibration_result(computeResult);
+            deliverCalibrationResult({ workItem, result, {}, computeResult });
+            if (computeResult)
+                tobii_research_free_screen_based_calibration_result(computeResult);
 
             _calibrationState = TobiiTypes::CalibrationState::AwaitingCalPoint;
             break;
@@ -598,15 +1063,10 @@ void Titta::calibrationThread()
         case TobiiTypes::CalibrationAction::GetCalibrationData:
         {
             _calibrationState = TobiiTypes::CalibrationState::GettingCalibrationData;
-            TobiiResearchCalibrationData* calData;
-
-            result = tobii_research_retrieve_calibration_data(_eyeTracker.et, &calData);
-
-            TobiiTypes::CalibrationWorkResult workResult{ workItem, result };
-            if (calData->size)
-                workResult.calibrationData = std::vector<uint8_t>(static_cast<uint8_t*>(calData->data), static_cast<uint8_t*>(calData->data) + calData->size);
-            tobii_research_free_calibration_data(calData);
-            _calibrationWorkResultQueue.enqueue(std::move(workResult));
+            TobiiTypes::CalibrationWorkResult workResult;
+            workResult.workItem = workItem;
+            workResult.status = retrieveCalibrationData(_eyeTracker.et, workResult.calibrationData);
+            deliverCalibrationResult(std::move(workResult));
 
             _calibrationState = TobiiTypes::CalibrationState::AwaitingCalPoint;
             break;
@@ -614,37 +1074,108 @@ void Titta::calibrationThread()
         case TobiiTypes::CalibrationAction::ApplyCalibrationData:
         {
             _calibrationState = TobiiTypes::CalibrationState::ApplyingCalibrationData;
-            if (!workItem.calibrationData.value().empty())
+            result = applyCalibrationData(_eyeTracker.et, workItem.calibrationData.value());
+            deliverCalibrationResult({workItem, result});
+            _calibrationState = TobiiTypes::CalibrationState::AwaitingCalPoint;
+            break;
+        }
+        case TobiiTypes::CalibrationAction::CacheCalibrationData:
+        {
+            // as GetCalibrationData, but the calibration is put in the cache instead of being handed back
+            _calibrationState = TobiiTypes::CalibrationState::GettingCalibrationData;
+            std::optional<std::vector<uint8_t>> calData;
+            result = retrieveCalibrationData(_eyeTracker.et, calData);
+            if (result == TOBII_RESEARCH_STATUS_OK)
+            {
+                if (!calData)
+                    result = TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;   // nothing to cache, no calibration has been computed
+                else
+                {
+                    try
+                    {
+                        _calibrationCache.store({ _eyeTracker.serialNumber, getDeviceState().info.trackingMode, workItem.participant.value() }, std::move(*calData));
+                    }
+                    catch (...)
+                    {
+                        // writing to disk failed
+                        result = TOBII_RESEARCH_STATUS_SE_INTERNAL;
+                    }
+                }
+            }
+            TobiiTypes::CalibrationWorkResult workResult;
+            workResult.workItem = workItem;
+            workResult.status   = result;
+            deliverCalibrationResult(std::move(workResult));
+            _calibrationState = TobiiTypes::CalibrationState::AwaitingCalPoint;
+            break;
+        }
+        case TobiiTypes::CalibrationAction::ApplyCachedCalibrationData:
+        {
+            _calibrationState = TobiiTypes::CalibrationState::ApplyingCalibrationData;
+            std::optional<std::vector<uint8_t>> calData;
+            try
             {
-                TobiiResearchCalibrationData calData;
-                // copy calibration data into array
-                const auto nItem = workItem.calibrationData.value().size();
-                calData.data = malloc(nItem);
-                calData.size = nItem;
-                if (nItem)
-                    std::memcpy(calData.data, workItem.calibrationData.value().data(), nItem);
-
-                result = tobii_research_apply_calibration_data(_eyeTracker.et, &calData);
-                free(calData.data);
-
-                _calibrationWorkResultQueue.enqueue({workItem, result});
+                calData = _calibrationCache.get({ _eyeTracker.serialNumber, getDeviceState().info.trackingMode, workItem.participant.value() });
             }
+            catch (...) {}  // corrupt file on disk, reported below as not found
+            if (calData)
+                result = applyCalibrationData(_eyeTracker.et, *calData);
+            else
+                result = TOBII_RESEARCH_STATUS_SE_INVALID_PARAMETER;        // removed from cache after request was made
+            TobiiTypes::CalibrationWorkResult workResult;
+            workResult.workItem = workItem;
+            workResult.status   = result;
+            deliverCalibrationResult(std::move(workResult));
             _calibrationState = TobiiTypes::CalibrationState::AwaitingCalPoint;
             break;
         }
         case TobiiTypes::CalibrationAction::Exit:
             // leave calibration mode and exit
             result = tobii_research_screen_based_calibration_leave_calibration_mode(_eyeTracker.et);
-            _calibrationWorkResultQueue.enqueue({workItem, result});
+            deliverCalibrationResult({workItem, result});
             keepRunning = false;
             break;
         }
     }
 
     _calibrationState = TobiiTypes::CalibrationState::Left;
+    {
+        std::lock_guard lock(_calibrationResultMutex);
+        _calibrationThreadRunning = false;
+    }
+    // wake up anyone waiting for a result that will now not come
+    _calibrationResultCV.notify_all();
+}
+uint64_t Titta::enqueueCalibrationWork(TobiiTypes::CalibrationWorkItem workItem_)
+{
+    workItem_.requestId = _calibrationNextRequestId++;
+    const auto id = workItem_.requestId;
+    _calibrationWorkQueue.enqueue(std::move(workItem_));
+    return id;
+}
+void Titta::deliverCalibrationResult(TobiiTypes::CalibrationWorkResult result_)
+{
+    // results are always queued, so that they can also be retrieved or waited for when a callback is set
+    std::unique_lock lock(_calibrationResultMutex);
+    _calibrationWorkResults.push_back(result_);
+    // bounded, as with a callback set the queue may never be drained
+    while (_calibrationWorkResults.size() > defaults::calibrationResultsMax)
+        _calibrationWorkResults.pop_front();
+    auto cb = _calibrationResultCallback;
+    lock.unlock();
+    _calibrationResultCV.notify_all();
+
+    // call outside the lock, so that the callback can call back into Titta
+    if (cb)
+    {
+        setCalibrationStatusString(result_);
+        cb(std::move(result_));
+    }
 }
 bool Titta::enterCalibrationMode(const bool doMonocular_)
 {
+    if (!_eyeTracker.et)
+        DoExitWithMsg("Titta::cpp::enterCalibrationMode: not available when replaying a recorded session");
     if (_calibrationThread.joinable())
         return false; // Calibration mode already entered
 
@@ -652,8 +1183,13 @@ bool Titta::enterCalibrationMode(const bool doMonocular_)
 
     // start new calibration worker
     // this calls tobii_research_screen_based_calibration_enter_calibration_mode() in the thread function
-    _calibrationWorkQueue.enqueue({TobiiTypes::CalibrationAction::Enter});
+    enqueueCalibrationWork({TobiiTypes::CalibrationAction::Enter});
     _calibrationState   = TobiiTypes::CalibrationState::NotYetEntered;
+    {
+        std::lock_guard lock(_calibrationResultMutex);
+        _calibrationWorkResults.clear();    // results of a previous calibration session
+        _calibrationThreadRunning = true;
+    }
     _calibrationThread  = std::thread(&Titta::calibrationThread, this);
 
     return true;
@@ -671,7 +1207,7 @@ bool Titta::leaveCalibrationMode(std::optional<bool> force_)
 {
     const bool forceIt = force_.value_or(defaults::forceExitCalibrationMode);
     bool issuedLeave   = false;
-    if (forceIt)
+    if (forceIt && _eyeTracker.et)
     {
         // call leave calibration mode on Tobii SDK, ignore error if any
         // this is provided as user code may need to ensure we're not in
@@ -683,7 +1219,7 @@ bool Titta::leaveCalibrationMode(std::optional<bool> force_)
     {
         // tell thread to quit and wait until it quits
         // this calls tobii_research_screen_based_calibration_leave_calibration_mode() in the thread function before exiting
-        _calibrationWorkQueue.enqueue({TobiiTypes::CalibrationAction::Exit});
+        enqueueCalibrationWork({TobiiTypes::CalibrationAction::Exit});
         _calibrationThread.join();
         issuedLeave = true;
     }
@@ -703,36 +1239,83 @@ void addCoordsEyeToWorkItem(TobiiTypes::CalibrationWorkItem& workItem, std::arra
             );
     }
 }
-void Titta::calibrationCollectData(std::array<float, 2> coordinates_, std::optional<std::string> eye_)
+uint64_t Titta::calibrationCollectData(std::array<float, 2> coordinates_, std::optional<std::string> eye_)
 {
     isInCalibrationMode(true);
     TobiiTypes::CalibrationWorkItem workItem{TobiiTypes::CalibrationAction::CollectData};
     addCoordsEyeToWorkItem(workItem, coordinates_, eye_);
-    _calibrationWorkQueue.enqueue(std::move(workItem));
+    return enqueueCalibrationWork(std::move(workItem));
 }
-void Titta::calibrationDiscardData(std::array<float, 2> coordinates_, std::optional<std::string> eye_)
+uint64_t Titta::calibrationDiscardData(std::array<float, 2> coordinates_, std::optional<std::string> eye_)
 {
     isInCalibrationMode(true);
     TobiiTypes::CalibrationWorkItem workItem{TobiiTypes::CalibrationAction::DiscardData};
     addCoordsEyeToWorkItem(workItem, coordinates_, eye_);
-    _calibrationWorkQueue.enqueue(std::move(workItem));
+    return enqueueCalibrationWork(std::move(workItem));
 }
-void Titta::calibrationComputeAndApply()
+uint64_t Titta::calibrationComputeAndApply()
 {
     isInCalibrationMode(true);
-    _calibrationWorkQueue.enqueue({TobiiTypes::CalibrationAction::Compute});
+    return enqueueCalibrationWork({TobiiTypes::CalibrationAction::Compute});
 }
-void Titta::calibrationGetData()
+uint64_t Titta::calibrationGetData()
 {
     isInCalibrationMode(true);
-    _calibrationWorkQueue.enqueue({TobiiTypes::CalibrationAction::GetCalibrationData});
+    return enqueueCalibrationWork({TobiiTypes::CalibrationAction::GetCalibrationData});
 }
-void Titta::calibrationApplyData(std::vector<uint8_t> calibrationData_)
+uint64_t Titta::calibrationApplyData(std::vector<uint8_t> calibrationData_)
 {
     isInCalibrationMode(true);
     TobiiTypes::CalibrationWorkItem workItem{TobiiTypes::CalibrationAction::ApplyCalibrationData};
     workItem.calibrationData = calibrationData_;
-    _calibrationWorkQueue.enqueue(std::move(workItem));
+    return enqueueCalibrationWork(std::move(workItem));
+}
+uint64_t Titta::calibrationStoreInCache(std::string participant_)
+{
+    isInCalibrationMode(true);
+    TobiiTypes::CalibrationWorkItem workItem;
+    workItem.action      = TobiiTypes::CalibrationAction::CacheCalibrationData;
+    workItem.participant = std::move(participant_);
+    return enqueueCalibrationWork(std::move(workItem));
+}
+uint64_t Titta::calibrationApplyCached(std::string participant_)
+{
+    isInCalibrationMode(true);
+    // check here so that a missing or corrupt calibration is reported to the caller directly.
+    // This also loads the calibration into memory if it was only on disk
+    if (!_calibrationCache.contains({ _eyeTracker.serialNumber, getDeviceState().info.trackingMode, participant_ }))
+        DoExitWithMsg("Titta::cpp::calibrationApplyCached: No cached calibration for participant \"" + participant_ + "\" on eye tracker " + _eyeTracker.serialNumber + " in tracking mode " + getDeviceState().info.trackingMode);
+
+    TobiiTypes::CalibrationWorkItem workItem;
+    workItem.action      = TobiiTypes::CalibrationAction::ApplyCachedCalibrationData;
+    workItem.participant = std::move(participant_);
+    return enqueueCalibrationWork(std::move(workItem));
+}
+void Titta::addToCalibrationCache(std::string participant_, std::vector<uint8_t> calibrationData_)
+{
+    if (calibrationData_.empty())
+        DoExitWithMsg("Titta::cpp::addToCalibrationCache: calibration data is empty");
+    _calibrationCache.store({ _eyeTracker.serialNumber, getDeviceState().info.trackingMode, std::move(participant_) }, std::move(calibrationData_));
+}
+bool Titta::hasCachedCalibration(std::string participant_)
+{
+    return _calibrationCache.contains({ _eyeTracker.serialNumber, getDeviceState().info.trackingMode, std::move(participant_) });
+}
+std::vector<std::string> Titta::getCachedCalibrations() const
+{
+    return _calibrationCache.getParticipants(_eyeTracker.serialNumber, getDeviceState().info.trackingMode);
+}
+void Titta::clearCalibrationCache(std::optional<std::string> participant_)
+{
+    _calibrationCache.clear(std::move(participant_));
+}
+void Titta::setCalibrationCacheDirectory(std::optional<std::string> directory_)
+{
+    _calibrationCache.setDirectory(std::move(directory_));
+}
+std::optional<std::string> Titta::getCalibrationCacheDirectory() const
+{
+    return _calibrationCache.getDirectory();
 }
 TobiiTypes::CalibrationState Titta::calibrationGetStatus()
 {
@@ -740,26 +1323,74 @@ TobiiTypes::CalibrationState Titta::calibrationGetStatus()
 }
 std::optional<TobiiTypes::CalibrationWorkResult> Titta::calibrationRetrieveResult(bool makeStatusString_ /*= false*/)
 {
-    TobiiTypes::CalibrationWorkResult out;
-    if (_calibrationWorkResultQueue.try_dequeue(out))
+    std::unique_lock lock(_calibrationResultMutex);
+    if (_calibrationWorkResults.empty())
+        return std::nullopt;
+
+    auto out = std::move(_calibrationWorkResults.front());
+    _calibrationWorkResults.pop_front();
+    lock.unlock();
+
+    if (makeStatusString_)
+        setCalibrationStatusString(out);
+    return out;
+}
+std::optional<TobiiTypes::CalibrationWorkResult> Titta::calibrationWaitForResult(std::optional<uint64_t> requestId_, std::optional<double> timeOutMs_, bool makeStatusString_ /*= false*/)
+{
+    std::unique_lock lock(_calibrationResultMutex);
+    auto findResult = [&]()
     {
-        if (makeStatusString_)
-            out.statusString = string_format("Tobii SDK code: %d: %s (%s)", static_cast<int>(out.status), TobiiResearchStatusToString(out.status).c_str(), TobiiResearchStatusToExplanation(out.status).c_str());
-        return out;
-    }
+        if (!requestId_)
+            return _calibrationWorkResults.begin();
+        return std::ranges::find_if(_calibrationWorkResults, [&](const auto& r_) { return r_.workItem.requestId == *requestId_; });
+    };
+    auto it = findResult();
+    auto isDone = [&]()
+    {
+        it = findResult();
+        return it != _calibrationWorkResults.end() || !_calibrationThreadRunning;
+    };
+
+    if (timeOutMs_)
+        _calibrationResultCV.wait_for(lock, std::chrono::microseconds(static_cast<int64_t>(std::max(*timeOutMs_, 0.) * 1000.)), isDone);
     else
+        _calibrationResultCV.wait(lock, isDone);
+
+    if (it == _calibrationWorkResults.end())
         return std::nullopt;
+
+    auto out = std::move(*it);
+    _calibrationWorkResults.erase(it);
+    lock.unlock();
+
+    if (makeStatusString_)
+        setCalibrationStatusString(out);
+    return out;
+}
+void Titta::setCalibrationResultCallback(std::function<void(TobiiTypes::CalibrationWorkResult)> callback_)
+{
+    std::unique_lock lock(_calibrationResultMutex);
+    _calibrationResultCallback = std::move(callback_);
 }
 
 
 // helpers to make the below generic
+template <typename T>
+int64_t T::* getTimeStampField()
+{
+    if constexpr (std::is_same_v<T, Titta::timeSync>)
+        return &T::system_request_time_stamp;
+    else
+        return &T::system_time_stamp;
+}
+
 template <typename T>
 mutex_type& Titta::getMutex()
 {
     if constexpr (std::is_same_v<T, Titta::gaze>)
         return _gazeMutex;
     if constexpr (std::is_same_v<T, Titta::eyeImage>)
-        return _extSignalMutex;
+        return _eyeImagesMutex;
     if constexpr (std::is_same_v<T, Titta::extSignal>)
         return _extSignalMutex;
     if constexpr (std::is_same_v<T, Titta::timeSync>)
@@ -774,13 +1405,38 @@ mutex_type& Titta::getMutex()
         return _notificationMutex;
 }
 
+#ifdef TITTA_ENABLE_TRACING
+template <typename T>
+constexpr std::array<const char*, 4> getLockTraceNames()   // read wait, read hold, write wait, write hold
+{
+    if constexpr (std::is_same_v<T, Titta::gaze>)
+        return { "gaze read lock wait", "gaze read lock hold", "gaze write lock wait", "gaze write lock hold" };
+    if constexpr (std::is_same_v<T, Titta::eyeImage>)
+        return { "eyeImage read lock wait", "eyeImage read lock hold", "eyeImage write lock wait", "eyeImage write lock hold" };
+    if constexpr (std::is_same_v<T, Titta::extSignal>)
+        return { "externalSignal read lock wait", "externalSignal read lock hold", "externalSignal write lock wait", "externalSignal write lock hold" };
+    if constexpr (std::is_same_v<T, Titta::timeSync>)
+        return { "timeSync read lock wait", "timeSync read lock hold", "timeSync write lock wait", "timeSync write lock hold" };
+    if constexpr (std::is_same_v<T, Titta::positioning>)
+        return { "positioning read lock wait", "positioning read lock hold", "positioning write lock wait", "positioning write lock hold" };
+    if constexpr (std::is_same_v<T, Titta::logMessage> || std::is_same_v<T, Titta::streamError>)
+        return { "log read lock wait", "log read lock hold", "log write lock wait", "log write lock hold" };
+    if constexpr (std::is_same_v<T, Titta::notification>)
+        return { "notification read lock wait", "notification read lock hold", "notification write lock wait", "notification write lock hold" };
+}
+template <typename T>
+traced_read_lock  Titta::lockForReading() { return  traced_read_lock(getMutex<T>(), getLockTraceNames<T>()[0], getLockTraceNames<T>()[1]); }
 template <typename T>
-read_lock  Titta::lockForReading() { return  read_lock(getMutex<T>()); }
+traced_write_lock Titta::lockForWriting() { return traced_write_lock(getMutex<T>(), getLockTraceNames<T>()[2], getLockTraceNames<T>()[3]); }
+#else
 template <typename T>
-write_lock Titta::lockForWriting() { return write_lock(getMutex<T>()); }
+traced_read_lock  Titta::lockForReading() { return  read_lock(getMutex<T>()); }
+template <typename T>
+traced_write_lock Titta::lockForWriting() { return write_lock(getMutex<T>()); }
+#endif
 
 template <typename T>
-std::vector<T>& Titta::getBuffer()
+Titta::buffer<T>& Titta::getBuffer()
 {
     if constexpr (std::is_same_v<T, gaze>)
         return _gaze;
@@ -796,8 +1452,257 @@ std::vector<T>& Titta::getBuffer()
         return _notification;
 }
 template <typename T>
-std::tuple<typename std::vector<T>::iterator, typename std::vector<T>::iterator>
-Titta::getIteratorsFromSampleAndSide(const size_t NSamp_, const Titta::BufferSide side_)
+LatestSlot<T>& Titta::getLatestSlot()
+{
+    if constexpr (std::is_same_v<T, gaze>)
+        return _gazeLatest;
+    if constexpr (std::is_same_v<T, eyeImage>)
+        return _eyeImagesLatest;
+    if constexpr (std::is_same_v<T, extSignal>)
+        return _extSignalLatest;
+    if constexpr (std::is_same_v<T, timeSync>)
+        return _timeSyncLatest;
+    if constexpr (std::is_same_v<T, positioning>)
+        return _positioningLatest;
+    if constexpr (std::is_same_v<T, notification>)
+        return _notificationLatest;
+}
+template <typename T>
+std::unique_ptr<ShmRingWriter<T>>& Titta::getShmWriter()
+{
+    if constexpr (std::is_same_v<T, gaze>)
+        return _gazeShm;
+    if constexpr (std::is_same_v<T, extSignal>)
+        return _extSignalShm;
+    if constexpr (std::is_same_v<T, timeSync>)
+        return _timeSyncShm;
+    if constexpr (std::is_same_v<T, positioning>)
+        return _positioningShm;
+}
+template <typename T>
+LatencyTracker& Titta::getLatencyTracker()
+{
+    if constexpr (std::is_same_v<T, gaze>)
+        return _gazeLatency;
+    if constexpr (std::is_same_v<T, eyeImage>)
+        return _eyeImagesLatency;
+    if constexpr (std::is_same_v<T, extSignal>)
+        return _extSignalLatency;
+    if constexpr (std::is_same_v<T, timeSync>)
+        return _timeSyncLatency;
+    if constexpr (std::is_same_v<T, notification>)
+        return _notificationLatency;
+}
+template <typename T>
+MemoryAccount& Titta::getMemoryAccount()
+{
+    if constexpr (std::is_same_v<T, gaze>)
+        return _gazeMemory;
+    if constexpr (std::is_same_v<T, eyeImage>)
+        return _eyeImagesMemory;
+    if constexpr (std::is_same_v<T, extSignal>)
+        return _extSignalMemory;
+    if constexpr (std::is_same_v<T, timeSync>)
+        return _timeSyncMemory;
+    if constexpr (std::is_same_v<T, positioning>)
+        return _positioningMemory;
+    if constexpr (std::is_same_v<T, notification>)
+        return _notificationMemory;
+}
+
+// memory held per sample: the sample itself, its latency bookkeeping entry and any heap data it owns
+template <typename T>
+constexpr size_t getFixedSampleBytes()
+{
+    if constexpr (std::is_same_v<T, Titta::positioning>)
+        return sizeof(T);
+    else
+        return sizeof(T) + sizeof(int32_t);
+}
+template <typename T, typename It>
+size_t getRangeBytes(const It startIt_, const It endIt_)
+{
+    auto bytes = static_cast<size_t>(std::distance(startIt_, endIt_)) * getFixedSampleBytes<T>();
+    if constexpr (std::is_same_v<T, Titta::eyeImage>)
+        for (auto it = startIt_; it != endIt_; ++it)
+            bytes += it->data_size;
+    return bytes;
+}
+
+// storage-agnostic access, gaze may be stored in compact form
+template <typename T>
+size_t Titta::getNumSamples()
+{
+    if constexpr (std::is_same_v<T, gaze>)
+        if (_gazeIsCompact)
+            return _gazeCompact.size();
+    return getBuffer<T>().size();
+}
+template <typename T>
+int64_t Titta::getSampleTimeStamp(const size_t i_)
+{
+    if constexpr (std::is_same_v<T, gaze>)
+        if (_gazeIsCompact)
+            return _gazeCompact.getSystemTimeStamp(i_);
+    return getBuffer<T>()[i_].*getTimeStampField<T>();
+}
+template <typename T>
+size_t Titta::getBytesPerSample()
+{
+    if constexpr (std::is_same_v<T, gaze>)
+        if (_gazeIsCompact)
+            return _gazeCompact.getSampleBytes() + sizeof(int32_t);
+    return getFixedSampleBytes<T>();
+}
+template <typename T>
+size_t Titta::getSampleBytes(const size_t iStart_, const size_t iEnd_)
+{
+    // NB: not for compact gaze, see syncCompactGazeAccount()
+    const auto& buf = getBuffer<T>();
+    return getRangeBytes<T>(std::next(std::cbegin(buf), iStart_), std::next(std::cbegin(buf), iEnd_));
+}
+
+template <typename T>
+void Titta::registerArrival(const size_t NSamp_, const int64_t now_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    if (!NSamp_)
+        return;
+    const auto nSamp = getNumSamples<T>();
+    if constexpr (!std::is_same_v<T, positioning>)
+    {
+        auto& tracker   = getLatencyTracker<T>();
+        for (auto i = nSamp - NSamp_; i < nSamp; ++i)
+        {
+            const auto latency = now_ - getSampleTimeStamp<T>(i);
+            tracker.ingest.record(latency);
+            tracker.arrival.push_back(static_cast<int32_t>(std::clamp<int64_t>(latency, INT32_MIN, INT32_MAX)));
+        }
+    }
+
+    // memory accounting
+    bool isCompact = false;
+    if constexpr (std::is_same_v<T, gaze>)
+        isCompact = _gazeIsCompact;
+    if (isCompact)
+        syncCompactGazeAccount();
+    else
+        addToMemoryAccount<T>(getSampleBytes<T>(nSamp - NSamp_, nSamp));
+
+    // stay within this stream's budget. The global budget is enforced by the caller
+    // once the lock is released, as that requires locking other streams' buffers
+    const auto& account = getMemoryAccount<T>();
+    if (account.budget && account.bytes > account.budget)
+        evictImpl<T>(account.bytes - account.budget + account.budget / defaults::memoryEvictHeadroomDiv);
+}
+template <typename T>
+void Titta::registerRemoval(const typename buffer<T>::iterator startIt_, const typename buffer<T>::iterator endIt_, const bool isConsumed_)
+{
+    auto& buf = getBuffer<T>();
+    registerRemoval<T>(static_cast<size_t>(std::distance(std::begin(buf), startIt_)), static_cast<size_t>(std::distance(std::begin(buf), endIt_)), isConsumed_);
+}
+template <typename T>
+void Titta::registerRemoval(const size_t iStart_, const size_t iEnd_, const bool isConsumed_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    if (iStart_ == iEnd_)
+        return;
+
+    // memory accounting. For compact gaze, done by syncCompactGazeAccount() once the samples are erased
+    bool isCompact = false;
+    if constexpr (std::is_same_v<T, gaze>)
+        isCompact = _gazeIsCompact;
+    if (!isCompact)
+        removeFromMemoryAccount<T>(getSampleBytes<T>(iStart_, iEnd_));
+
+    if constexpr (!std::is_same_v<T, positioning>)
+    {
+        auto& tracker   = getLatencyTracker<T>();
+        if (isConsumed_)
+        {
+            const auto now  = getSystemTimestamp();
+            for (auto i = iStart_; i < iEnd_; ++i)
+                tracker.consume.record(now - (getSampleTimeStamp<T>(i) + tracker.arrival[i]));
+        }
+        tracker.arrival.erase(std::next(std::begin(tracker.arrival), iStart_), std::next(std::begin(tracker.arrival), iEnd_));
+    }
+}
+template <typename T>
+void Titta::addToMemoryAccount(const size_t bytes_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    auto& account       = getMemoryAccount<T>();
+    account.bytes      += bytes_;
+    account.highWaterMark = std::max(account.highWaterMark, account.bytes);
+    const auto total    = _memoryTotal.fetch_add(bytes_, std::memory_order_relaxed) + bytes_;
+    auto highWater      = _memoryHighWaterMark.load(std::memory_order_relaxed);
+    while (total > highWater && !_memoryHighWaterMark.compare_exchange_weak(highWater, total, std::memory_order_relaxed)) {}
+}
+template <typename T>
+void Titta::removeFromMemoryAccount(const size_t bytes_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    getMemoryAccount<T>().bytes -= bytes_;
+    _memoryTotal.fetch_sub(bytes_, std::memory_order_relaxed);
+}
+void Titta::syncCompactGazeAccount()
+{
+    // !NB: appropriate locking is responsibility of caller!
+    // records (or their compressed form) and arrival latencies
+    const auto bytes    = _gazeCompact.getStoredBytes() + _gazeCompact.size() * sizeof(int32_t);
+    const auto current  = getMemoryAccount<gaze>().bytes;
+    if (bytes > current)
+        addToMemoryAccount<gaze>(bytes - current);
+    else
+        removeFromMemoryAccount<gaze>(current - bytes);
+}
+size_t Titta::evictCompactGaze(const size_t bytesToFree_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    // bytes per sample differ between the hot and cold tier, so evict by estimate until enough is freed.
+    // NB: erasing part of a cold block decompresses the rest of it, so storage can temporarily grow
+    auto& account       = getMemoryAccount<gaze>();
+    const auto before   = static_cast<int64_t>(account.bytes);
+    auto freed          = [&]() { return before - static_cast<int64_t>(account.bytes); };
+    while (!_gazeCompact.empty() && freed() < static_cast<int64_t>(bytesToFree_))
+    {
+        const auto perSample = std::max<size_t>(1, account.bytes / _gazeCompact.size());
+        const auto nEvict    = std::min(_gazeCompact.size(), (bytesToFree_ - std::max<int64_t>(0, freed()) + perSample - 1) / perSample);
+        account.nEvicted    += nEvict;
+        registerRemoval<gaze>(0, nEvict, false);
+        _gazeCompact.erase(0, nEvict);
+        syncCompactGazeAccount();
+    }
+    return static_cast<size_t>(std::max<int64_t>(0, freed()));
+}
+template <typename T>
+size_t Titta::evictImpl(const size_t bytesToFree_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    if constexpr (std::is_same_v<T, gaze>)
+        if (_gazeIsCompact)
+            return evictCompactGaze(bytesToFree_);
+
+    // drop oldest samples until at least bytesToFree_ bytes are freed, or buffer is empty
+    const auto nSamp = getNumSamples<T>();
+    size_t nEvict = 0, freed = 0;
+    while (nEvict < nSamp && freed < bytesToFree_)
+    {
+        freed += getSampleBytes<T>(nEvict, nEvict + 1);
+        ++nEvict;
+    }
+    if (!nEvict)
+        return 0;
+
+    getMemoryAccount<T>().nEvicted += nEvict;
+    registerRemoval<T>(0, nEvict, false);
+    auto& buf = getBuffer<T>();
+    buf.erase(std::begin(buf), std::next(std::begin(buf), nEvict));
+    return freed;
+}
+template <typename T>
+std::tuple<typename Titta::buffer<T>::iterator, typename Titta::buffer<T>::iterator>
+Titta::getIteratorsFromSampleAndSide(const size_t NSamp_, const Titta::BufferSide side_)
 {
     auto& buf       = getBuffer<T>();
     auto startIt    = std::begin(buf);
@@ -819,8 +1724,24 @@ Titta::getIteratorsFromSampleAndSide(const size_t NSamp_, const Titta::BufferSid
     return { startIt, endIt };
 }
 
+std::tuple<size_t, size_t> getIndicesFromSampleAndSide(const size_t bufSize_, const size_t NSamp_, const Titta::BufferSide side_)
+{
+    const auto nSamp = std::min(NSamp_, bufSize_);
+    switch (side_)
+    {
+    case Titta::BufferSide::Start:
+        return { 0, nSamp };
+    case Titta::BufferSide::End:
+        return { bufSize_ - nSamp, bufSize_ };
+    default:
+        DoExitWithMsg("Titta::cpp::getIndicesFromSampleAndSide: unknown TittaMex::BufferSide provided.");
+        break;
+    }
+    return { 0, 0 };
+}
+
 template <typename T>
-std::tuple<typename std::vector<T>::iterator, typename std::vector<T>::iterator, bool>
+std::tuple<typename Titta::buffer<T>::iterator, typename Titta::buffer<T>::iterator, bool>
 Titta::getIteratorsFromTimeRange(const int64_t timeStart_, const int64_t timeEnd_)
 {
     // !NB: appropriate locking is responsibility of caller!
@@ -834,11 +1755,7 @@ Titta::getIteratorsFromTimeRange(const int64_t timeStart_, const int64_t timeEnd
         return {startIt,endIt, true};
 
     // 2. see which member variable to access
-    int64_t T::* field;
-    if constexpr (std::is_same_v<T, timeSync>)
-        field = &T::system_request_time_stamp;
-    else
-        field = &T::system_time_stamp;
+    const auto field = getTimeStampField<T>();
 
     // 3. check if requested times are before or after vector start and end
     const bool inclFirst = timeStart_ <= buf.front().*field;
@@ -854,6 +1771,48 @@ Titta::getIteratorsFromTimeRange(const int64_t timeStart_, const int64_t timeEnd
     return {startIt, endIt, inclFirst&&inclLast};
 }
 
+namespace
+{
+    size_t getGazeBufferSizeForFrequency(const float frequency_)
+    {
+        if (frequency_ <= 0.f)
+            return defaults::sampleBufSize;
+        return static_cast<size_t>(std::ceil(frequency_ * defaults::sampleBufDuration));
+    }
+}
+template <typename T>
+void Titta::prepareBuffer(const Stream stream_, std::optional<size_t> initialBufferSize_, const size_t defaultBufferSize_)
+{
+    auto l          = lockForWriting<T>();
+    // the tightest of the stream's and the global budget applies
+    auto budget     = getMemoryAccount<T>().budget;
+    if (const auto globalBudget = _memoryBudget.load(); globalBudget && (!budget || globalBudget < budget))
+        budget      = globalBudget;
+
+    auto bufSize    = initialBufferSize_.value_or(defaultBufferSize_);
+    if (budget && bufSize > budget / getBytesPerSample<T>())
+    {
+        // fail fast if the user explicitly asked for more than fits, else reserve only what fits
+        if (initialBufferSize_)
+            DoExitWithMsg(string_format("Titta::cpp::start: requested initial buffer size for the %s stream (%zu samples, %zu bytes) exceeds the memory budget (%zu bytes)", streamToString(stream_).c_str(), bufSize, bufSize * getBytesPerSample<T>(), budget));
+        bufSize     = budget / getBytesPerSample<T>();
+    }
+
+    bool isCompact  = false;
+    if constexpr (std::is_same_v<T, gaze>)
+        isCompact   = _gazeIsCompact;
+    if (isCompact)
+        _gazeCompact.reserve(bufSize);
+    else
+    {
+        auto& buf   = getBuffer<T>();
+        // how storage is allocated can only be changed while the buffer is empty
+        if (const auto options = _bufferAllocation.load(); std::empty(buf) && buf.get_allocator().getOptions() != options)
+            buf     = buffer<T>(PinnedAllocator<T>(options));
+        buf.reserve(bufSize);
+    }
+}
+
 
 bool Titta::hasStream(std::string stream_, const bool snake_case_on_stream_not_found /*= false*/) const
 {
@@ -864,13 +1823,13 @@ bool Titta::hasStream(const Stream stream_) const
     switch (stream_)
     {
         case Stream::Gaze:
-            return _eyeTracker.capabilities & TOBII_RESEARCH_CAPABILITIES_HAS_GAZE_DATA;
+            return getDeviceState().info.capabilities & TOBII_RESEARCH_CAPABILITIES_HAS_GAZE_DATA;
         case Stream::EyeOpenness:
-            return _eyeTracker.capabilities & TOBII_RESEARCH_CAPABILITIES_HAS_EYE_OPENNESS_DATA;
+            return getDeviceState().info.capabilities & TOBII_RESEARCH_CAPABILITIES_HAS_EYE_OPENNESS_DATA;
         case Stream::EyeImage:
-            return _eyeTracker.capabilities & TOBII_RESEARCH_CAPABILITIES_HAS_EYE_IMAGES;
+            return getDeviceState().info.capabilities & TOBII_RESEARCH_CAPABILITIES_HAS_EYE_IMAGES;
         case Stream::ExtSignal:
-            return _eyeTracker.capabilities & TOBII_RESEARCH_CAPABILITIES_HAS_EXTERNAL_SIGNAL;
+            return getDeviceState().info.capabilities & TOBII_RESEARCH_CAPABILITIES_HAS_EXTERNAL_SIGNAL;
         case Stream::TimeSync:
             return true;    // no capability that can be checked for this one
         case Stream::Positioning:
@@ -903,6 +1862,153 @@ bool Titta::setIncludeEyeOpennessInGaze(const bool include_)
 
     return previous;
 }
+bool Titta::setCompactGazeStorage(const bool compact_, std::optional<bool> quantize_, std::optional<bool> compressOld_)
+{
+    // deal with default arguments
+    const auto quantize    = quantize_   .value_or(defaults::compactGazeQuantize);
+    const auto compressOld = compressOld_.value_or(defaults::compactGazeCompressOld);
+
+    if (_recordingGaze || _recordingEyeOpenness)
+        DoExitWithMsg("Titta::cpp::setCompactGazeStorage: cannot change gaze storage while recording, stop the " + streamToString(Stream::Gaze) + " stream first");
+    {
+        auto l = lockForReading<gaze>();
+        if (getNumSamples<gaze>())
+            DoExitWithMsg("Titta::cpp::setCompactGazeStorage: cannot change gaze storage while the " + streamToString(Stream::Gaze) + " buffer contains samples, consume or clear them first");
+    }
+
+    // compression thread works on the current buffer, stop it before replacing the buffer
+    stopGazeCompressThread();
+    bool previous;
+    {
+        auto l = lockForWriting<gaze>();
+        previous = _gazeIsCompact;
+        _gazeIsCompact = compact_;
+        // release memory of the storage type no longer in use
+        buffer<gaze>().swap(_gaze);
+        _gazeCompact = CompactGazeBuffer(quantize, compact_ && compressOld);
+    }
+    if (compact_ && compressOld)
+    {
+        _gazeCompressStop   = false;
+        _gazeCompressThread = std::thread(&Titta::gazeCompressThread, this);
+    }
+    return previous;
+}
+bool Titta::isCompactGazeStorage() const
+{
+    return _gazeIsCompact;
+}
+
+namespace
+{
+    const std::map<std::string, Titta::EyeImageDecoding> eyeImageDecodingMap =
+    {
+        { "none",           Titta::EyeImageDecoding::None },
+        { "ingest",         Titta::EyeImageDecoding::Ingest },
+        { "peek",           Titta::EyeImageDecoding::Peek }
+    };
+}
+void Titta::setEyeImageDecoding(std::string mode_, std::optional<size_t> numThreads_)
+{
+    const auto it = eyeImageDecodingMap.find(mode_);
+    if (it == eyeImageDecodingMap.end())
+        DoExitWithMsg(R"(Titta::cpp::setEyeImageDecoding: Requested eye image decoding mode ")" + mode_ + R"(" is not recognized. Supported modes are: "none", "ingest", "peek")");
+    const auto mode     = it->second;
+    // deal with default arguments
+    const auto nThreads = numThreads_.value_or(defaults::eyeImageDecodeThreads);
+    // without workers, frames are decoded on the thread that reads them
+    if (mode == EyeImageDecoding::Ingest && !nThreads)
+        DoExitWithMsg("Titta::cpp::setEyeImageDecoding: decoding at ingest requires at least one thread");
+
+    _eyeImageDecoding = mode;
+    if (mode == EyeImageDecoding::None)
+        _eyeImageDecoder.stop();
+    else if (_eyeImageDecoder.getNumThreads() != nThreads)
+        _eyeImageDecoder.start(nThreads);
+}
+std::string Titta::getEyeImageDecoding() const
+{
+    const auto mode = _eyeImageDecoding.load();
+    return std::ranges::find(eyeImageDecodingMap, mode, [](const auto& p_) { return p_.second; })->first;
+}
+void Titta::setEyeImageReduction(std::optional<std::string> crop_, std::optional<std::array<int, 4>> cropRect_, std::optional<int> downscale_, std::optional<size_t> keepEveryN_)
+{
+    // deal with default arguments
+    EyeImageReducer::options options;
+    options.crop        = crop_ ? EyeImageReducer::stringToCrop(*crop_) : EyeImageReducer::Crop::None;
+    options.cropRect    = cropRect_.value_or(std::array<int, 4>{});
+    options.downscale   = downscale_.value_or(defaults::eyeImageDownscale);
+    options.keepEveryN  = keepEveryN_.value_or(defaults::eyeImageKeepEveryN);
+
+    if (options.crop != EyeImageReducer::Crop::None && (options.cropRect[2] <= 0 || options.cropRect[3] <= 0))
+        DoExitWithMsg("Titta::cpp::setEyeImageReduction: cropping requires a cropRect with a positive width and height");
+    if (options.downscale < 1)
+        DoExitWithMsg("Titta::cpp::setEyeImageReduction: downscale should be at least 1");
+    if (options.keepEveryN < 1)
+        DoExitWithMsg("Titta::cpp::setEyeImageReduction: keepEveryN should be at least 1");
+
+    _eyeImageReducer.setOptions(options);
+}
+Titta::eyeImageReduction Titta::getEyeImageReduction() const
+{
+    const auto options = _eyeImageReducer.getOptions();
+
+    eyeImageReduction out;
+    out.crop            = EyeImageReducer::cropToString(options.crop);
+    out.cropRect        = options.cropRect;
+    out.downscale       = options.downscale;
+    out.keepEveryN      = options.keepEveryN;
+    return out;
+}
+void Titta::setEyeImageCompression(const bool compress_, std::optional<size_t> numThreads_, std::optional<size_t> cacheSize_)
+{
+    // deal with default arguments
+    const auto nThreads  = numThreads_.value_or(defaults::eyeImageCompressThreads);
+    const auto cacheSize = cacheSize_ .value_or(defaults::eyeImageDecompressedCache);
+    if (compress_ && !nThreads)
+        DoExitWithMsg("Titta::cpp::setEyeImageCompression: compression requires at least one thread");
+
+    {
+        std::lock_guard lock(_eyeImageCompressionMutex);
+        _eyeImageDecompressedMax = cacheSize;
+        while (_eyeImageDecompressed.size() > _eyeImageDecompressedMax)
+            _eyeImageDecompressed.pop_front();
+    }
+    _eyeImageCompression = compress_;
+    // without workers, stored frames that are still compressed are decompressed on the thread that reads them
+    if (!compress_)
+        _eyeImageCompressor.stop();
+    else if (_eyeImageCompressor.getNumThreads() != nThreads)
+        _eyeImageCompressor.start(nThreads);
+}
+Titta::eyeImageCompressionStats Titta::getEyeImageCompressionStats(std::optional<bool> reset_)
+{
+    // deal with default arguments
+    const auto reset = reset_.value_or(defaults::eyeImageCompressionReset);
+
+    eyeImageCompressionStats out;
+    out.enabled             = _eyeImageCompression;
+    out.numThreads          = _eyeImageCompressor.getNumThreads();
+
+    std::lock_guard lock(_eyeImageCompressionMutex);
+    const auto& counters    = _eyeImageCompressionCounters;
+    out.cacheSize           = _eyeImageDecompressedMax;
+    out.nCompressed         = counters.nCompressed;
+    out.nIncompressible     = counters.nIncompressible;
+    out.rawBytes            = counters.rawBytes;
+    out.compressedBytes     = counters.compressedBytes;
+    out.ratio               = counters.compressedBytes ? static_cast<double>(counters.rawBytes) / static_cast<double>(counters.compressedBytes) : 0.;
+    const auto nTried       = counters.nCompressed + counters.nIncompressible;
+    out.compressTime        = nTried ? static_cast<double>(counters.compressNs) / 1000. / static_cast<double>(nTried) : 0.;
+    out.nDecompressed       = counters.nDecompressed;
+    out.decompressTime      = counters.nDecompressed ? static_cast<double>(counters.decompressNs) / 1000. / static_cast<double>(counters.nDecompressed) : 0.;
+    out.nCacheHits          = counters.nCacheHits;
+    for (const auto& image : _eyeImageDecompressed)
+        out.cacheBytes     += image.data_size;
+    if (reset)
+        _eyeImageCompressionCounters = {};
+    return out;
+}
 
 bool Titta::start(std::string stream_, std::optional<size_t> initialBufferSize_, std::optional<bool> asGif_, const bool snake_case_on_stream_not_found /*= false*/)
 {
@@ -920,15 +2026,10 @@ bool Titta::start(const Stream stream_, std::optional<size_t> initialBufferSize_
                 result = TOBII_RESEARCH_STATUS_OK;
             else
             {
-                // deal with default arguments
-                const auto initialBufferSize = initialBufferSize_.value_or(defaults::sampleBufSize);
-                // prepare buffer
-                {
-                    auto l = lockForWriting<gaze>();
-                    _gaze.reserve(initialBufferSize);   // NB: if already reserved when starting eye openness, this will not shrink
-                }
+                // prepare buffer, by default sized for the eye tracker's current frequency
+                prepareBuffer<gaze>(stream_, initialBufferSize_, getGazeBufferSizeForFrequency(getDeviceState().info.frequency));   // NB: if already reserved when starting eye openness, this will not shrink
                 // start buffer
-                result = tobii_research_subscribe_to_gaze_data(_eyeTracker.et, TittaGazeCallback, this);
+                result = _replay ? _replay->subscribe(stream_, this) : tobii_research_subscribe_to_gaze_data(_eyeTracker.et, TittaGazeCallback, this);
                 stateVar = &_recordingGaze;
             }
             break;
@@ -939,15 +2040,10 @@ bool Titta::start(const Stream stream_, std::optional<size_t> initialBufferSize_
                 result = TOBII_RESEARCH_STATUS_OK;
             else
             {
-                // deal with default arguments
-                const auto initialBufferSize = initialBufferSize_.value_or(defaults::sampleBufSize);
-                // prepare buffer
-                {
-                    auto l = lockForWriting<gaze>();
-                    _gaze.reserve(initialBufferSize);   // NB: if already reserved when starting gaze, this will not shrink
-                }
+                // prepare buffer, by default sized for the eye tracker's current frequency
+                prepareBuffer<gaze>(stream_, initialBufferSize_, getGazeBufferSizeForFrequency(getDeviceState().info.frequency));   // NB: if already reserved when starting gaze, this will not shrink
                 // start buffer
-                result = tobii_research_subscribe_to_eye_openness(_eyeTracker.et, TittaEyeOpennessCallback, this);
+                result = _replay ? _replay->subscribe(stream_, this) : tobii_research_subscribe_to_eye_openness(_eyeTracker.et, TittaEyeOpennessCallback, this);
                 stateVar = &_recordingEyeOpenness;
             }
             break;
@@ -959,25 +2055,21 @@ bool Titta::start(const Stream stream_, std::optional<size_t> initialBufferSize_
             else
             {
                 // deal with default arguments
-                const auto initialBufferSize = initialBufferSize_.value_or(defaults::eyeImageBufSize);
                 const auto asGif             = asGif_            .value_or(defaults::eyeImageAsGIF);
 
                 // prepare and start buffer
-                {
-                    auto l = lockForWriting<eyeImage>();
-                    _eyeImages.reserve(initialBufferSize);
-                }
+                prepareBuffer<eyeImage>(stream_, initialBufferSize_, defaults::eyeImageBufSize);
 
                 // if already recording and switching from gif to normal or other way, first stop old stream
                 if (_recordingEyeImages)
                     if (asGif != _eyeImIsGif)
-                        doUnsubscribeEyeImage(_eyeTracker.et, _eyeImIsGif);
+                        _replay ? _replay->unsubscribe(stream_) : doUnsubscribeEyeImage(_eyeTracker.et, _eyeImIsGif);
                     else
                         // nothing to do
                         return true;
 
                 // subscribe to new stream
-                result = doSubscribeEyeImage(_eyeTracker.et, this, asGif);
+                result = _replay ? _replay->subscribe(stream_, this) : doSubscribeEyeImage(_eyeTracker.et, this, asGif);
                 stateVar = &_recordingEyeImages;
                 if (result==TOBII_RESEARCH_STATUS_OK)
                     // update type being recorded if subscription to stream was successful
@@ -991,14 +2083,9 @@ bool Titta::start(const Stream stream_, std::optional<size_t> initialBufferSize_
                 result = TOBII_RESEARCH_STATUS_OK;
             else
             {
-                // deal with default arguments
-                const auto initialBufferSize = initialBufferSize_.value_or(defaults::extSignalBufSize);
                 // prepare and start buffer
-                {
-                    auto l = lockForWriting<extSignal>();
-                    _extSignal.reserve(initialBufferSize);
-                }
-                result = tobii_research_subscribe_to_external_signal_data(_eyeTracker.et, TittaExtSignalCallback, this);
+                prepareBuffer<extSignal>(stream_, initialBufferSize_, defaults::extSignalBufSize);
+                result = _replay ? _replay->subscribe(stream_, this) : tobii_research_subscribe_to_external_signal_data(_eyeTracker.et, TittaExtSignalCallback, this);
                 stateVar = &_recordingExtSignal;
             }
             break;
@@ -1009,14 +2096,9 @@ bool Titta::start(const Stream stream_, std::optional<size_t> initialBufferSize_
                 result = TOBII_RESEARCH_STATUS_OK;
             else
             {
-                // deal with default arguments
-                const auto initialBufferSize = initialBufferSize_.value_or(defaults::timeSyncBufSize);
                 // prepare and start buffer
-                {
-                    auto l = lockForWriting<timeSync>();
-                    _timeSync.reserve(initialBufferSize);
-                }
-                result = tobii_research_subscribe_to_time_synchronization_data(_eyeTracker.et, TittaTimeSyncCallback, this);
+                prepareBuffer<timeSync>(stream_, initialBufferSize_, defaults::timeSyncBufSize);
+                result = _replay ? _replay->subscribe(stream_, this) : tobii_research_subscribe_to_time_synchronization_data(_eyeTracker.et, TittaTimeSyncCallback, this);
                 stateVar = &_recordingTimeSync;
             }
             break;
@@ -1027,14 +2109,9 @@ bool Titta::start(const Stream stream_, std::optional<size_t> initialBufferSize_
                 result = TOBII_RESEARCH_STATUS_OK;
             else
             {
-                // deal with default arguments
-                const auto initialBufferSize = initialBufferSize_.value_or(defaults::positioningBufSize);
                 // prepare and start buffer
-                {
-                    auto l = lockForWriting<positioning>();
-                    _positioning.reserve(initialBufferSize);
-                }
-                result = tobii_research_subscribe_to_user_position_guide(_eyeTracker.et, TittaPositioningCallback, this);
+                prepareBuffer<positioning>(stream_, initialBufferSize_, defaults::positioningBufSize);
+                result = _replay ? _replay->subscribe(stream_, this) : tobii_research_subscribe_to_user_position_guide(_eyeTracker.et, TittaPositioningCallback, this);
                 stateVar = &_recordingPositioning;
             }
             break;
@@ -1045,14 +2122,9 @@ bool Titta::start(const Stream stream_, std::optional<size_t> initialBufferSize_
                 result = TOBII_RESEARCH_STATUS_OK;
             else
             {
-                // deal with default arguments
-                const auto initialBufferSize = initialBufferSize_.value_or(defaults::notificationBufSize);
                 // prepare and start buffer
-                {
-                    auto l = lockForWriting<notification>();
-                    _notification.reserve(initialBufferSize);
-                }
-                result = tobii_research_subscribe_to_notifications(_eyeTracker.et, TittaNotificationCallback, this);
+                prepareBuffer<notification>(stream_, initialBufferSize_, defaults::notificationBufSize);
+                result = _replay ? _replay->subscribe(stream_, this) : tobii_research_subscribe_to_notifications(_eyeTracker.et, TittaNotificationCallback, this);
                 stateVar = &_recordingNotification;
             }
             break;
@@ -1124,13 +2196,17 @@ namespace {
 
 void Titta::receiveSample(const TobiiResearchGazeData* gaze_data_, const TobiiResearchEyeOpennessData* openness_data_)
 {
+    // arrival time of all samples this callback stores, taken once the gaze buffer is
+    // first locked so that it includes waiting for the buffer
+    int64_t now = 0;
     const auto needStage = _recordingGaze && _recordingEyeOpenness;
     if (!needStage && !_gazeStagingEmpty)
     {
         // if any data in staging area but no longer expecting to merge, flush to output
         auto l    = write_lock(_gazeStageMutex);
         auto lOut = lockForWriting<Titta::gaze>();
-        _gaze.insert(_gaze.end(), std::make_move_iterator(_gazeStaging.begin()), std::make_move_iterator(_gazeStaging.end()));
+        now = getSystemTimestamp();
+        storeGaze(_gazeStaging, now);
         _gazeStaging.clear();
         _gazeStagingEmpty = true;
     }
@@ -1213,8 +2289,63 @@ void Titta::receiveSample(const TobiiResearchGazeData* gaze_data_, const TobiiRe
     if (!emitBuffer.empty())
     {
         auto lOut = lockForWriting<Titta::gaze>();
-        _gaze.insert(_gaze.end(), std::make_move_iterator(emitBuffer.begin()), std::make_move_iterator(emitBuffer.end()));
+        if (!now)
+            now = getSystemTimestamp();
+        storeGaze(emitBuffer, now);
+    }
+    enforceMemoryBudget();
+}
+void Titta::storeGaze(std::deque<gaze>& samples_, const int64_t now_)
+{
+    // !NB: appropriate locking is responsibility of caller!
+    if (samples_.empty())
+        return;
+    _gazeLatest.store(samples_.back());
+    // hand the samples to the processing pipeline here, so that it sees them even if they are consumed from the buffer first
+    if (_pipelineRunning.load(std::memory_order_relaxed))
+    {
+        for (const auto& s : samples_)
+            _pipelineQueue.enqueue(s);
+        {
+            std::lock_guard lock(_pipelineMutex);
+            _pipelineNewData = true;
+        }
+        _pipelineCV.notify_one();
+    }
+    // and to the resampler
+    if (_gazeResamplerRunning.load(std::memory_order_relaxed))
+    {
+        std::lock_guard lock(_gazeResamplerMutex);
+        if (_gazeResampler)
+        {
+            auto out = _gazeResampler->push({ samples_.begin(), samples_.end() });
+            _gazeResampled.insert(_gazeResampled.end(), std::make_move_iterator(out.begin()), std::make_move_iterator(out.end()));
+            // drop the oldest, and a bit more so that this does not happen for every sample
+            if (_gazeResampled.size() > defaults::resampledBufSize)
+                _gazeResampled.erase(_gazeResampled.begin(), _gazeResampled.begin() + static_cast<ptrdiff_t>(_gazeResampled.size() - defaults::resampledBufSize + defaults::resampledBufSize / 16));
+        }
+    }
+    if (_gazeShm)
+        for (const auto& s : samples_)
+            _gazeShm->push(s);
+    if (_gazeIsCompact)
+    {
+        const auto nBlocks = _gazeCompact.getNumBlocks();
+        for (const auto& s : samples_)
+            _gazeCompact.push_back(s);
+        // a block was completed, there may be a block to move to the cold tier
+        if (_gazeCompact.isCompressingOld() && _gazeCompact.getNumBlocks() != nBlocks)
+        {
+            {
+                std::lock_guard lock(_gazeCompressMutex);
+                _gazeCompressPending = true;
+            }
+            _gazeCompressCV.notify_one();
+        }
     }
+    else
+        _gaze.insert(_gaze.end(), std::make_move_iterator(samples_.begin()), std::make_move_iterator(samples_.end()));
+    registerArrival<Titta::gaze>(samples_.size(), now_);
 }
 
 bool Titta::isRecording(std::string stream_, const bool snake_case_on_stream_not_found /*= false*/) const
@@ -1244,16 +2375,21 @@ bool Titta::isRecording(const Stream stream_) const
     return false;
 }
 
-template <typename T>
-std::vector<T> consumeFromVec(std::vector<T>& buf_, typename std::vector<T>::iterator startIt_, typename std::vector<T>::iterator endIt_)
+template <typename T, typename Alloc>
+std::vector<T> consumeFromVec(std::vector<T, Alloc>& buf_, typename std::vector<T, Alloc>::iterator startIt_, typename std::vector<T, Alloc>::iterator endIt_)
 {
+    TITTA_TRACE_SCOPE("consume copy", "buffer");
     if (std::empty(buf_))
         return std::vector<T>{};
 
     // move out the indicated elements
     if (startIt_==std::begin(buf_) && endIt_==std::end(buf_))
-        // whole buffer
-        return std::vector<T>(std::move(buf_));
+    {
+        // whole buffer. Its storage is not handed over, but kept (along with how it was allocated) for new samples
+        std::vector<T> out(std::make_move_iterator(startIt_), std::make_move_iterator(endIt_));
+        buf_.clear();
+        return out;
+    }
     else
     {
         std::vector<T> out;
@@ -1266,33 +2402,74 @@ std::vector<T> consumeFromVec(std::vector<T>& buf_, typename std::vector<T>::ite
 template <typename T>
 std::vector<T> Titta::consumeN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_)
 {
+    TITTA_TRACE_SCOPE("consumeN", "buffer");
     // deal with default arguments
     const auto N    = NSamp_.value_or(defaults::consumeNSamp);
     const auto side = side_.value_or(defaults::consumeSide);
 
     auto l          = lockForWriting<T>();  // NB: if C++ std gains upgrade_lock, replace this with upgrade lock that is converted to unique lock only after range is determined
+    if constexpr (std::is_same_v<T, gaze>)
+        if (_gazeIsCompact)
+        {
+            auto [iStart, iEnd] = getIndicesFromSampleAndSide(_gazeCompact.size(), N, side);
+            registerRemoval<T>(iStart, iEnd, true);
+            auto out = _gazeCompact.get(iStart, iEnd);
+            _gazeCompact.erase(iStart, iEnd);
+            syncCompactGazeAccount();
+            return out;
+        }
     auto& buf       = getBuffer<T>();
 
     auto [startIt, endIt] = getIteratorsFromSampleAndSide<T>(N, side);
-    return consumeFromVec(buf, startIt, endIt);
+    registerRemoval<T>(startIt, endIt, true);
+    auto out = consumeFromVec(buf, startIt, endIt);
+    if constexpr (std::is_same_v<T, eyeImage>)
+    {
+        l.unlock();
+        decompressEyeImages(out, false);
+        if (_eyeImageDecoding != EyeImageDecoding::None)
+            decodeEyeImages(out, false);
+    }
+    return out;
 }
 template <typename T>
 std::vector<T> Titta::consumeTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_)
 {
+    TITTA_TRACE_SCOPE("consumeTimeRange", "buffer");
     // deal with default arguments
     const auto timeStart= timeStart_.value_or(defaults::consumeTimeRangeStart);
     const auto timeEnd  = timeEnd_  .value_or(defaults::consumeTimeRangeEnd);
 
     auto l              = lockForWriting<T>();  // NB: if C++ std gains upgrade_lock, replace this with upgrade lock that is converted to unique lock only after range is determined
+    if constexpr (std::is_same_v<T, gaze>)
+        if (_gazeIsCompact)
+        {
+            auto [iStart, iEnd, whole] = _gazeCompact.findTimeRange(timeStart, timeEnd);
+            registerRemoval<T>(iStart, iEnd, true);
+            auto out = _gazeCompact.get(iStart, iEnd);
+            _gazeCompact.erase(iStart, iEnd);
+            syncCompactGazeAccount();
+            return out;
+        }
     auto& buf           = getBuffer<T>();
 
     auto [startIt, endIt, whole] = getIteratorsFromTimeRange<T>(timeStart, timeEnd);
-    return consumeFromVec(buf, startIt, endIt);
+    registerRemoval<T>(startIt, endIt, true);
+    auto out = consumeFromVec(buf, startIt, endIt);
+    if constexpr (std::is_same_v<T, eyeImage>)
+    {
+        l.unlock();
+        decompressEyeImages(out, false);
+        if (_eyeImageDecoding != EyeImageDecoding::None)
+            decodeEyeImages(out, false);
+    }
+    return out;
 }
 
-template <typename T>
-std::vector<T> peekFromVec(const std::vector<T>& buf_, const typename std::vector<T>::const_iterator startIt_, const typename std::vector<T>::const_iterator endIt_)
+template <typename T, typename Alloc>
+std::vector<T> peekFromVec(const std::vector<T, Alloc>& buf_, const typename std::vector<T, Alloc>::const_iterator startIt_, const typename std::vector<T, Alloc>::const_iterator endIt_)
 {
+    TITTA_TRACE_SCOPE("peek copy", "buffer");
     if (std::empty(buf_))
         return std::vector<T>{};
 
@@ -1302,46 +2479,571 @@ std::vector<T> peekFromVec(const std::vector<T>& buf_, const typename std::vecto
 template <typename T>
 std::vector<T> Titta::peekN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_)
 {
+    TITTA_TRACE_SCOPE("peekN", "buffer");
     // deal with default arguments
     const auto N    = NSamp_.value_or(defaults::peekNSamp);
     const auto side = side_.value_or(defaults::peekSide);
 
     auto l          = lockForReading<T>();
+    if constexpr (std::is_same_v<T, gaze>)
+        if (_gazeIsCompact)
+        {
+            auto [iStart, iEnd] = getIndicesFromSampleAndSide(_gazeCompact.size(), N, side);
+            return _gazeCompact.get(iStart, iEnd);
+        }
     auto& buf       = getBuffer<T>();
 
     auto [startIt, endIt] = getIteratorsFromSampleAndSide<T>(N, side);
-    return peekFromVec(buf, startIt, endIt);
+    auto out = peekFromVec(buf, startIt, endIt);
+    if constexpr (std::is_same_v<T, eyeImage>)
+    {
+        l.unlock();
+        decompressEyeImages(out, true);
+        if (_eyeImageDecoding != EyeImageDecoding::None)
+            decodeEyeImages(out, true);
+    }
+    return out;
 }
 template <typename T>
 std::vector<T> Titta::peekTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_)
 {
+    TITTA_TRACE_SCOPE("peekTimeRange", "buffer");
     // deal with default arguments
     const auto timeStart= timeStart_.value_or(defaults::peekTimeRangeStart);
     const auto timeEnd  = timeEnd_  .value_or(defaults::peekTimeRangeEnd);
 
     auto l              = lockForReading<T>();
+    if constexpr (std::is_same_v<T, gaze>)
+        if (_gazeIsCompact)
+        {
+            auto [iStart, iEnd, whole] = _gazeCompact.findTimeRange(timeStart, timeEnd);
+            return _gazeCompact.get(iStart, iEnd);
+        }
     auto& buf           = getBuffer<T>();
 
     auto [startIt, endIt, whole] = getIteratorsFromTimeRange<T>(timeStart, timeEnd);
-    return peekFromVec(buf, startIt, endIt);
-}
-
+    auto out = peekFromVec(buf, startIt, endIt);
+    if constexpr (std::is_same_v<T, eyeImage>)
+    {
+        l.unlock();
+        decompressEyeImages(out, true);
+        if (_eyeImageDecoding != EyeImageDecoding::None)
+            decodeEyeImages(out, true);
+    }
+    return out;
+}
+
 template <typename T>
 void Titta::clearImpl(const int64_t timeStart_, const int64_t timeEnd_)
 {
     auto l      = lockForWriting<T>();  // NB: if C++ std gains upgrade_lock, replace this with upgrade lock that is converted to unique lock only after range is determined
+    if constexpr (std::is_same_v<T, gaze>)
+        if (_gazeIsCompact)
+        {
+            auto [iStart, iEnd, whole] = _gazeCompact.findTimeRange(timeStart_, timeEnd_);
+            registerRemoval<T>(iStart, iEnd, false);
+            _gazeCompact.erase(iStart, iEnd);
+            syncCompactGazeAccount();
+            return;
+        }
     auto& buf   = getBuffer<T>();
     if (std::empty(buf))
         return;
 
     // find applicable range
     auto[startIt, endIt, whole] = getIteratorsFromTimeRange<T>(timeStart_, timeEnd_);
+    registerRemoval<T>(startIt, endIt, false);
     // clear the flagged bit
     if (whole)
         buf.clear();
     else
         buf.erase(startIt, endIt);
 }
+Titta::allStreamsData Titta::drainAll(std::vector<std::string> streams_, std::optional<int64_t> timeStart_, std::optional<int64_t> cutOff_, const bool snake_case_on_stream_not_found /*= false*/)
+{
+    std::vector<Stream> streams;
+    for (auto&& s : streams_)
+        streams.push_back(stringToStream(std::move(s), snake_case_on_stream_not_found));
+    return drainAll(std::move(streams), timeStart_, cutOff_);
+}
+Titta::allStreamsData Titta::drainAll(std::optional<std::vector<Stream>> streams_, std::optional<int64_t> timeStart_, std::optional<int64_t> cutOff_)
+{
+    TITTA_TRACE_SCOPE("drainAll", "buffer");
+    return drainOrSnapshotAll(true, std::move(streams_), timeStart_, cutOff_);
+}
+Titta::allStreamsData Titta::snapshotAll(std::vector<std::string> streams_, std::optional<int64_t> timeStart_, std::optional<int64_t> cutOff_, const bool snake_case_on_stream_not_found /*= false*/)
+{
+    std::vector<Stream> streams;
+    for (auto&& s : streams_)
+        streams.push_back(stringToStream(std::move(s), snake_case_on_stream_not_found));
+    return snapshotAll(std::move(streams), timeStart_, cutOff_);
+}
+Titta::allStreamsData Titta::snapshotAll(std::optional<std::vector<Stream>> streams_, std::optional<int64_t> timeStart_, std::optional<int64_t> cutOff_)
+{
+    TITTA_TRACE_SCOPE("snapshotAll", "buffer");
+    return drainOrSnapshotAll(false, std::move(streams_), timeStart_, cutOff_);
+}
+Titta::allStreamsData Titta::drainOrSnapshotAll(const bool consume_, std::optional<std::vector<Stream>> streams_, std::optional<int64_t> timeStart_, std::optional<int64_t> cutOff_)
+{
+    // deal with default arguments
+    const auto streams   = streams_.value_or(std::vector<Stream>(defaults::allStreamsDefault.begin(), defaults::allStreamsDefault.end()));
+    const auto timeStart = timeStart_.value_or(defaults::consumeTimeRangeStart);
+
+    // fix the cut-off before touching any buffer, so that all streams are cut at the same point in time,
+    // regardless of how long it takes to get through them
+    allStreamsData out;
+    out.cutOff = cutOff_.value_or(getSystemTimestamp());
+
+    auto getRange = [&]<typename T>(std::optional<std::vector<T>>& out_)
+    {
+        if (out_)   // stream requested more than once (e.g. both gaze and eyeOpenness)
+            return;
+        out_ = consume_ ? consumeTimeRange<T>(timeStart, out.cutOff) : peekTimeRange<T>(timeStart, out.cutOff);
+    };
+    for (const auto stream : streams)
+    {
+        switch (stream)
+        {
+            case Stream::Gaze:
+            case Stream::EyeOpenness:
+                getRange(out.gaze);
+                break;
+            case Stream::EyeImage:
+                getRange(out.eyeImage);
+                break;
+            case Stream::ExtSignal:
+                getRange(out.extSignal);
+                break;
+            case Stream::TimeSync:
+                getRange(out.timeSync);
+                break;
+            case Stream::Positioning:
+                // no timestamps, so all samples
+                if (!out.positioning)
+                    out.positioning = consume_ ? consumeN<positioning>() : peekN<positioning>(defaults::consumeNSamp, BufferSide::Start);
+                break;
+            case Stream::Notification:
+                getRange(out.notification);
+                break;
+            default:
+                DoExitWithMsg("Titta::cpp::" + std::string(consume_ ? "drainAll" : "snapshotAll") + ": stream " + streamToString(stream) + " is not a buffered stream");
+        }
+    }
+    return out;
+}
+
+Titta::gazeExtSignalJoin Titta::joinGazeExtSignal(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_)
+{
+    TITTA_TRACE_SCOPE("joinGazeExtSignal", "buffer");
+    // deal with default arguments
+    const auto timeStart = timeStart_.value_or(defaults::peekTimeRangeStart);
+    const auto timeEnd   = timeEnd_  .value_or(defaults::peekTimeRangeEnd);
+
+    auto gazeSamples = peekTimeRange<gaze>(timeStart, timeEnd);
+    // external signal state at the start of the range is set by the last event before it
+    auto extSignals  = peekTimeRange<extSignal>(defaults::peekTimeRangeStart, timeEnd);
+    const auto first = std::ranges::lower_bound(extSignals, timeStart, {}, &extSignal::system_time_stamp) - extSignals.begin();
+    if (first > 1)
+        extSignals.erase(extSignals.begin(), extSignals.begin() + (first - 1));
+
+    return joinGazeExtSignal(std::move(gazeSamples), std::move(extSignals));
+}
+Titta::gazeExtSignalJoin Titta::joinGazeExtSignal(std::vector<gaze> gaze_, std::vector<extSignal> extSignal_)
+{
+    TITTA_TRACE_SCOPE("joinGazeExtSignal merge", "buffer");
+    gazeExtSignalJoin out;
+    out.gaze      = std::move(gaze_);
+    out.extSignal = std::move(extSignal_);
+    const auto& g = out.gaze;
+    const auto& e = out.extSignal;
+
+    // single merge-walk over the two sorted vectors for each direction
+    out.extSignalIndex.resize(g.size());
+    out.extSignalValue.resize(g.size());
+    int64_t iE = -1;
+    for (size_t i = 0; i < g.size(); i++)
+    {
+        while (iE + 1 < static_cast<int64_t>(e.size()) && e[iE + 1].system_time_stamp <= g[i].system_time_stamp)
+            iE++;
+        out.extSignalIndex[i] = iE;
+        out.extSignalValue[i] = iE >= 0 ? e[iE].value : 0;
+    }
+
+    out.nearestGazeIndex.resize(e.size(), -1);
+    if (g.empty())
+        return out;
+    size_t iG = 0;  // last gaze sample at or before the event, or first sample if there is none
+    for (size_t i = 0; i < e.size(); i++)
+    {
+        const auto ts = e[i].system_time_stamp;
+        while (iG + 1 < g.size() && g[iG + 1].system_time_stamp <= ts)
+            iG++;
+        auto nearest = iG;
+        if (iG + 1 < g.size() && g[iG].system_time_stamp < ts && g[iG + 1].system_time_stamp - ts < ts - g[iG].system_time_stamp)
+            nearest = iG + 1;
+        out.nearestGazeIndex[i] = static_cast<int64_t>(nearest);
+    }
+    return out;
+}
+
+std::vector<Titta::gaze> Titta::resampleGaze(const double frequency_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_, std::optional<int64_t> maxGap_, std::optional<GazeResampler::Method> method_)
+{
+    TITTA_TRACE_SCOPE("resampleGaze", "buffer");
+    // deal with default arguments
+    const auto maxGap = maxGap_.value_or(defaults::resampleMaxGap);
+    const auto method = method_.value_or(defaults::resampleMethod);
+
+    return GazeResampler::resample(peekTimeRange<gaze>(timeStart_, timeEnd_), frequency_, maxGap, method, timeStart_);
+}
+void Titta::startGazeResampler(const double frequency_, std::optional<int64_t> maxGap_, std::optional<GazeResampler::Method> method_, std::optional<int64_t> gridStart_)
+{
+    // deal with default arguments
+    const auto maxGap = maxGap_.value_or(defaults::resampleMaxGap);
+    const auto method = method_.value_or(defaults::resampleMethod);
+
+    auto resampler = std::make_unique<GazeResampler>(frequency_, maxGap, method, gridStart_);
+    std::vector<gaze> out;
+    // from here on the resampler is fed by storeGaze. Hold off incoming gaze until it is installed, so that no
+    // sample is missed or passed twice
+    auto l = lockForReading<gaze>();
+    if (gridStart_)
+    {
+        // include buffered samples
+        std::vector<gaze> buffered;
+        if (_gazeIsCompact)
+        {
+            auto [iStart, iEnd, whole] = _gazeCompact.findTimeRange(*gridStart_, defaults::peekTimeRangeEnd);
+            buffered = _gazeCompact.get(iStart, iEnd);
+        }
+        else
+        {
+            auto [startIt, endIt, whole] = getIteratorsFromTimeRange<gaze>(*gridStart_, defaults::peekTimeRangeEnd);
+            buffered = peekFromVec(_gaze, startIt, endIt);
+        }
+        out = resampler->push(buffered);
+        if (out.size() > defaults::resampledBufSize)
+            out.erase(out.begin(), out.begin() + static_cast<ptrdiff_t>(out.size() - defaults::resampledBufSize));
+    }
+
+    std::lock_guard lock(_gazeResamplerMutex);
+    _gazeResampler          = std::move(resampler);
+    _gazeResampled          = std::move(out);
+    _gazeResamplerRunning   = true;
+}
+std::vector<Titta::gaze> Titta::getResampledGaze()
+{
+    TITTA_TRACE_SCOPE("getResampledGaze", "buffer");
+    std::lock_guard lock(_gazeResamplerMutex);
+    if (!_gazeResampler)
+        DoExitWithMsg("Titta::cpp::getResampledGaze: gaze resampler is not running, call startGazeResampler() first");
+    return std::exchange(_gazeResampled, {});
+}
+bool Titta::isGazeResamplerRunning() const
+{
+    std::lock_guard lock(_gazeResamplerMutex);
+    return !!_gazeResampler;
+}
+std::vector<Titta::gaze> Titta::stopGazeResampler()
+{
+    std::lock_guard lock(_gazeResamplerMutex);
+    if (!_gazeResampler)
+        return {};
+    _gazeResamplerRunning = false;
+    auto out  = std::exchange(_gazeResampled, {});
+    auto rest = _gazeResampler->flush();
+    out.insert(out.end(), std::make_move_iterator(rest.begin()), std::make_move_iterator(rest.end()));
+    _gazeResampler.reset();
+    return out;
+}
+
+template <typename T>
+std::optional<T> Titta::getLatest()
+{
+    auto out = getLatestSlot<T>().load();
+    if constexpr (std::is_same_v<T, eyeImage>)
+    {
+        // eye images are only kept in the slot once it has been read. Until then, fall back to the buffer
+        if (!out)
+        {
+            auto l = lockForReading<eyeImage>();
+            if (!_eyeImages.empty())
+                out = _eyeImages.back();
+        }
+        if (out && out->is_compressed)
+        {
+            std::vector<eyeImage> images{ std::move(*out) };
+            decompressEyeImages(images, false);
+            out = std::move(images.front());
+        }
+        if (out && out->is_gif && _eyeImageDecoding != EyeImageDecoding::None)
+            decodeGifEyeImage(*out, _eyeImageReducer.getOptions());    // not cached, the slot holds the frame as received
+    }
+    return out;
+}
+template <typename T>
+uint64_t Titta::getLatestCount()
+{
+    return getLatestSlot<T>().getCount();
+}
+
+std::vector<std::string> Titta::getPipelineStageTypes()
+{
+    return GazePipeline::getStageTypes();
+}
+void Titta::addPipelineStage(std::string name_, std::string type_, std::optional<std::map<std::string, double>> params_)
+{
+    _pipeline.addStage(std::move(name_), std::move(type_), params_.value_or(GazePipeline::params{}));
+}
+void Titta::clearPipeline()
+{
+    _pipeline.clear();
+}
+std::vector<std::tuple<std::string, std::string>> Titta::getPipelineStages() const
+{
+    return _pipeline.getStages();
+}
+std::vector<std::string> Titta::getDerivedStreamChannels(const std::string& name_) const
+{
+    return _pipeline.getChannels(name_);
+}
+void Titta::startPipeline()
+{
+    if (_pipelineRunning)
+        return;
+
+    // only gaze that arrives from now on, drop what came in while a previous run was stopping
+    gaze sample;
+    while (_pipelineQueue.try_dequeue(sample))
+        ;
+    _pipelineRunning = true;
+    _pipelineStop    = false;
+    _pipelineThread  = std::thread(&Titta::pipelineThread, this);
+}
+void Titta::stopPipeline()
+{
+    if (!_pipelineThread.joinable())
+        return;
+    _pipelineRunning = false;
+    {
+        std::lock_guard lock(_pipelineMutex);
+        _pipelineStop = true;
+    }
+    _pipelineCV.notify_one();
+    _pipelineThread.join();
+}
+void Titta::stopGazeCompressThread()
+{
+    if (!_gazeCompressThread.joinable())
+        return;
+    {
+        std::lock_guard lock(_gazeCompressMutex);
+        _gazeCompressStop = true;
+    }
+    _gazeCompressCV.notify_one();
+    _gazeCompressThread.join();
+}
+void Titta::gazeCompressThread()
+{
+    TITTA_TRACE_THREAD_NAME("Titta gaze compression");
+    TittaThreads::scope threadRegistration("Titta gaze compression");
+    while (true)
+    {
+        {
+            std::unique_lock lock(_gazeCompressMutex);
+            _gazeCompressCV.wait(lock, [this]() { return _gazeCompressPending || _gazeCompressStop; });
+            if (_gazeCompressStop)
+                break;
+            _gazeCompressPending = false;
+        }
+        // compress blocks one at a time, without holding the buffer lock while compressing
+        while (!_gazeCompressStop)
+        {
+            std::optional<CompactGazeBuffer::compressionJob> job;
+            {
+                auto l = lockForReading<gaze>();
+                job = _gazeCompact.getCompressionJob();
+            }
+            if (!job)
+                break;
+            auto block = CompactGazeBuffer::compress(*job);
+            auto l = lockForWriting<gaze>();
+            if (_gazeCompact.commitCompression(std::move(block)))
+                syncCompactGazeAccount();
+        }
+    }
+}
+bool Titta::isPipelineRunning() const
+{
+    return _pipelineRunning;
+}
+void Titta::pipelineThread()
+{
+    TITTA_TRACE_THREAD_NAME("Titta pipeline");
+    TittaThreads::scope threadRegistration("Titta pipeline");
+    while (true)
+    {
+        bool stop;
+        {
+            std::unique_lock lock(_pipelineMutex);
+            _pipelineCV.wait(lock, [this]() { return _pipelineNewData || _pipelineStop; });
+            _pipelineNewData = false;
+            stop = _pipelineStop;
+        }
+        // also process on stop, so that gaze that arrived before stopPipeline() is not lost
+        std::vector<gaze> samples;
+        samples.reserve(_pipelineQueue.size_approx());
+        gaze sample;
+        while (_pipelineQueue.try_dequeue(sample))
+            samples.push_back(std::move(sample));
+        if (!samples.empty())
+        {
+            TITTA_TRACE_SCOPE("pipeline process", "pipeline");
+            _pipeline.process(std::move(samples));
+        }
+        if (stop)
+            break;
+    }
+}
+std::vector<Titta::derivedSample> Titta::consumeDerivedN(const std::string& name_, std::optional<size_t> NSamp_, std::optional<BufferSide> side_)
+{
+    // deal with default arguments
+    const auto N    = NSamp_.value_or(defaults::consumeNSamp);
+    const auto side = side_.value_or(defaults::consumeSide);
+    return _pipeline.consumeN(name_, N, side == BufferSide::Start);
+}
+std::vector<Titta::derivedSample> Titta::consumeDerivedTimeRange(const std::string& name_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_)
+{
+    // deal with default arguments
+    const auto timeStart = timeStart_.value_or(defaults::consumeTimeRangeStart);
+    const auto timeEnd   = timeEnd_  .value_or(defaults::consumeTimeRangeEnd);
+    return _pipeline.consumeTimeRange(name_, timeStart, timeEnd);
+}
+std::vector<Titta::derivedSample> Titta::peekDerivedN(const std::string& name_, std::optional<size_t> NSamp_, std::optional<BufferSide> side_)
+{
+    // deal with default arguments
+    const auto N    = NSamp_.value_or(defaults::peekNSamp);
+    const auto side = side_.value_or(defaults::peekSide);
+    return _pipeline.peekN(name_, N, side == BufferSide::Start);
+}
+std::vector<Titta::derivedSample> Titta::peekDerivedTimeRange(const std::string& name_, std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_)
+{
+    // deal with default arguments
+    const auto timeStart = timeStart_.value_or(defaults::peekTimeRangeStart);
+    const auto timeEnd   = timeEnd_  .value_or(defaults::peekTimeRangeEnd);
+    return _pipeline.peekTimeRange(name_, timeStart, timeEnd);
+}
+void Titta::clearDerived(const std::string& name_)
+{
+    _pipeline.clearDerived(name_);
+}
+
+template <typename T>
+void Titta::startSharedMemoryImpl(std::string name_, const size_t capacity_)
+{
+    // close a ring this stream may already be writing to first: it unlinks its name, which the new ring may reuse
+    std::unique_ptr<ShmRingWriter<T>> writer;
+    {
+        auto l = lockForWriting<T>();
+        writer = std::move(getShmWriter<T>());
+    }
+    writer.reset();
+
+    // create outside the lock
+    writer = std::make_unique<ShmRingWriter<T>>(std::move(name_), capacity_);
+    auto l = lockForWriting<T>();
+    getShmWriter<T>() = std::move(writer);
+}
+void Titta::startSharedMemory(std::string stream_, std::string name_, std::optional<size_t> capacity_, const bool snake_case_on_stream_not_found /*= false*/)
+{
+    startSharedMemory(stringToStream(std::move(stream_), snake_case_on_stream_not_found), std::move(name_), capacity_);
+}
+void Titta::startSharedMemory(const Stream stream_, std::string name_, std::optional<size_t> capacity_)
+{
+    // deal with default arguments
+    const auto capacity = capacity_.value_or(defaults::sharedMemoryCapacity);
+
+    switch (stream_)
+    {
+        case Stream::Gaze:
+        case Stream::EyeOpenness:
+            startSharedMemoryImpl<gaze>(std::move(name_), capacity);
+            break;
+        case Stream::ExtSignal:
+            startSharedMemoryImpl<extSignal>(std::move(name_), capacity);
+            break;
+        case Stream::TimeSync:
+            startSharedMemoryImpl<timeSync>(std::move(name_), capacity);
+            break;
+        case Stream::Positioning:
+            startSharedMemoryImpl<positioning>(std::move(name_), capacity);
+            break;
+        default:
+            DoExitWithMsg("Titta::cpp::startSharedMemory: not supported for " + streamToString(stream_) + " stream.");
+    }
+}
+std::optional<std::string> Titta::getSharedMemoryName(std::string stream_, const bool snake_case_on_stream_not_found /*= false*/)
+{
+    return getSharedMemoryName(stringToStream(std::move(stream_), snake_case_on_stream_not_found));
+}
+std::optional<std::string> Titta::getSharedMemoryName(const Stream stream_)
+{
+    auto getName = [&]<typename T>() -> std::optional<std::string>
+    {
+        auto l = lockForReading<T>();
+        if (const auto& w = getShmWriter<T>())
+            return w->getName();
+        return std::nullopt;
+    };
+    switch (stream_)
+    {
+        case Stream::Gaze:
+        case Stream::EyeOpenness:
+            return getName.template operator()<gaze>();
+        case Stream::ExtSignal:
+            return getName.template operator()<extSignal>();
+        case Stream::TimeSync:
+            return getName.template operator()<timeSync>();
+        case Stream::Positioning:
+            return getName.template operator()<positioning>();
+        default:
+            return std::nullopt;
+    }
+}
+void Titta::stopSharedMemory(std::string stream_, const bool snake_case_on_stream_not_found /*= false*/)
+{
+    stopSharedMemory(stringToStream(std::move(stream_), snake_case_on_stream_not_found));
+}
+void Titta::stopSharedMemory(const Stream stream_)
+{
+    auto stop = [&]<typename T>()
+    {
+        std::unique_ptr<ShmRingWriter<T>> writer;
+        {
+            auto l = lockForWriting<T>();
+            writer = std::move(getShmWriter<T>());
+        }
+        // writer is destroyed here, outside the lock: this marks the ring closed and unlinks it
+    };
+    switch (stream_)
+    {
+        case Stream::Gaze:
+        case Stream::EyeOpenness:
+            stop.template operator()<gaze>();
+            break;
+        case Stream::ExtSignal:
+            stop.template operator()<extSignal>();
+            break;
+        case Stream::TimeSync:
+            stop.template operator()<timeSync>();
+            break;
+        case Stream::Positioning:
+            stop.template operator()<positioning>();
+            break;
+        default:
+            break;
+    }
+}
+
 void Titta::clear(std::string stream_, const bool snake_case_on_stream_not_found /*= false*/)
 {
     clear(stringToStream(std::move(stream_), snake_case_on_stream_not_found));
@@ -1354,6 +3056,7 @@ void Titta::clear(const Stream stream_)
         auto& buf   = getBuffer<positioning>();
         if (std::empty(buf))
             return;
+        registerRemoval<positioning>(std::begin(buf), std::end(buf), false);
         buf.clear();
     }
     else
@@ -1408,31 +3111,31 @@ bool Titta::stop(const Stream stream_, std::optional<bool> clearBuffer_)
     switch (stream_)
     {
         case Stream::Gaze:
-            result = !_recordingGaze ? TOBII_RESEARCH_STATUS_OK : tobii_research_unsubscribe_from_gaze_data(_eyeTracker.et, TittaGazeCallback);
+            result = !_recordingGaze ? TOBII_RESEARCH_STATUS_OK : _replay ? _replay->unsubscribe(stream_) : tobii_research_unsubscribe_from_gaze_data(_eyeTracker.et, TittaGazeCallback);
             stateVar = &_recordingGaze;
             break;
         case Stream::EyeOpenness:
-            result = !_recordingEyeOpenness ? TOBII_RESEARCH_STATUS_OK : tobii_research_unsubscribe_from_eye_openness(_eyeTracker.et, TittaEyeOpennessCallback);
+            result = !_recordingEyeOpenness ? TOBII_RESEARCH_STATUS_OK : _replay ? _replay->unsubscribe(stream_) : tobii_research_unsubscribe_from_eye_openness(_eyeTracker.et, TittaEyeOpennessCallback);
             stateVar = &_recordingEyeOpenness;
             break;
         case Stream::EyeImage:
-            result = !_recordingEyeImages ? TOBII_RESEARCH_STATUS_OK : doUnsubscribeEyeImage(_eyeTracker.et, _eyeImIsGif);
+            result = !_recordingEyeImages ? TOBII_RESEARCH_STATUS_OK : _replay ? _replay->unsubscribe(stream_) : doUnsubscribeEyeImage(_eyeTracker.et, _eyeImIsGif);
             stateVar = &_recordingEyeImages;
             break;
         case Stream::ExtSignal:
-            result = !_recordingExtSignal ? TOBII_RESEARCH_STATUS_OK : tobii_research_unsubscribe_from_external_signal_data(_eyeTracker.et, TittaExtSignalCallback);
+            result = !_recordingExtSignal ? TOBII_RESEARCH_STATUS_OK : _replay ? _replay->unsubscribe(stream_) : tobii_research_unsubscribe_from_external_signal_data(_eyeTracker.et, TittaExtSignalCallback);
             stateVar = &_recordingExtSignal;
             break;
         case Stream::TimeSync:
-            result = !_recordingTimeSync ? TOBII_RESEARCH_STATUS_OK : tobii_research_unsubscribe_from_time_synchronization_data(_eyeTracker.et, TittaTimeSyncCallback);
+            result = !_recordingTimeSync ? TOBII_RESEARCH_STATUS_OK : _replay ? _replay->unsubscribe(stream_) : tobii_research_unsubscribe_from_time_synchronization_data(_eyeTracker.et, TittaTimeSyncCallback);
             stateVar = &_recordingTimeSync;
             break;
         case Stream::Positioning:
-            result = !_recordingPositioning ? TOBII_RESEARCH_STATUS_OK : tobii_research_unsubscribe_from_user_position_guide(_eyeTracker.et, TittaPositioningCallback);
+            result = !_recordingPositioning ? TOBII_RESEARCH_STATUS_OK : _replay ? _replay->unsubscribe(stream_) : tobii_research_unsubscribe_from_user_position_guide(_eyeTracker.et, TittaPositioningCallback);
             stateVar = &_recordingPositioning;
             break;
         case Stream::Notification:
-            result = !_recordingNotification ? TOBII_RESEARCH_STATUS_OK : tobii_research_unsubscribe_from_notifications(_eyeTracker.et, TittaNotificationCallback);
+            result = !_recordingNotification ? TOBII_RESEARCH_STATUS_OK : _replay ? _replay->unsubscribe(stream_) : tobii_research_unsubscribe_from_notifications(_eyeTracker.et, TittaNotificationCallback);
             stateVar = &_recordingNotification;
             break;
     }
@@ -1441,8 +3144,11 @@ bool Titta::stop(const Stream stream_, std::optional<bool> clearBuffer_)
         clear(stream_);
 
     const bool success = result == TOBII_RESEARCH_STATUS_OK;
-    if (stateVar && success)
+    if (stateVar && success && *stateVar)
+    {
         *stateVar = false;
+        TittaThreads::onUnsubscribe();
+    }
 
     // if requested to merge gaze and eye openness, a call to stop eye openness also stops gaze
     if (stream_==Stream::EyeOpenness && _includeEyeOpennessInGaze && _recordingGaze)
@@ -1457,28 +3163,582 @@ bool Titta::stop(const Stream stream_, std::optional<bool> clearBuffer_)
     return success;
 }
 
+Titta::latencyStats Titta::getLatencyStats(std::string stream_, std::optional<bool> reset_, const bool snake_case_on_stream_not_found /*= false*/)
+{
+    return getLatencyStats(stringToStream(std::move(stream_), snake_case_on_stream_not_found), reset_);
+}
+Titta::latencyStats Titta::getLatencyStats(const Stream stream_, std::optional<bool> reset_)
+{
+    // deal with default arguments
+    const auto reset = reset_.value_or(defaults::latencyStatsReset);
+
+    LatencyTracker* tracker = nullptr;
+    switch (stream_)
+    {
+        case Stream::Gaze:
+        case Stream::EyeOpenness:
+            tracker = &_gazeLatency;
+            break;
+        case Stream::EyeImage:
+            tracker = &_eyeImagesLatency;
+            break;
+        case Stream::ExtSignal:
+            tracker = &_extSignalLatency;
+            break;
+        case Stream::TimeSync:
+            tracker = &_timeSyncLatency;
+            break;
+        case Stream::Positioning:
+            DoExitWithMsg("Titta::cpp::getLatencyStats: not supported for the positioning stream.");
+            break;
+        case Stream::Notification:
+            tracker = &_notificationLatency;
+            break;
+        default:
+            DoExitWithMsg("Titta::cpp::getLatencyStats: not supported for " + streamToString(stream_) + " stream.");
+    }
+    if (!tracker)
+        return {};
+
+    latencyStats out{ tracker->ingest.getSummary(), tracker->consume.getSummary() };
+    if (reset)
+    {
+        tracker->ingest .reset();
+        tracker->consume.reset();
+    }
+    return out;
+}
+
+Titta::memoryUsage Titta::getMemoryUsage(std::string stream_, const bool snake_case_on_stream_not_found /*= false*/)
+{
+    return getMemoryUsage(stringToStream(std::move(stream_), snake_case_on_stream_not_found));
+}
+Titta::memoryUsage Titta::getMemoryUsage(const Stream stream_)
+{
+    switch (stream_)
+    {
+        case Stream::Gaze:
+        case Stream::EyeOpenness:
+            return getMemoryUsageImpl<gaze>();
+        case Stream::EyeImage:
+            return getMemoryUsageImpl<eyeImage>();
+        case Stream::ExtSignal:
+            return getMemoryUsageImpl<extSignal>();
+        case Stream::TimeSync:
+            return getMemoryUsageImpl<timeSync>();
+        case Stream::Positioning:
+            return getMemoryUsageImpl<positioning>();
+        case Stream::Notification:
+            return getMemoryUsageImpl<notification>();
+        default:
+            DoExitWithMsg("Titta::cpp::getMemoryUsage: not supported for " + streamToString(stream_) + " stream.");
+    }
+}
+Titta::memoryUsage Titta::getTotalMemoryUsage()
+{
+    memoryUsage out;
+    for (const auto stream : { Stream::Gaze, Stream::EyeImage, Stream::ExtSignal, Stream::TimeSync, Stream::Positioning, Stream::Notification })
+    {
+        const auto usage = getMemoryUsage(stream);
+        out.reserved += usage.reserved;
+        out.nEvicted += usage.nEvicted;
+    }
+    out.bytes         = _memoryTotal;
+    out.highWaterMark = _memoryHighWaterMark;
+    out.budget        = _memoryBudget;
+    return out;
+}
+template <typename T>
+Titta::memoryUsage Titta::getMemoryUsageImpl()
+{
+    auto l              = lockForReading<T>();
+    const auto& account = getMemoryAccount<T>();
+
+    auto reserved       = getBuffer<T>().capacity() * sizeof(T);
+    if constexpr (std::is_same_v<T, gaze>)
+        reserved       += _gazeCompact.getReservedBytes();
+    if constexpr (!std::is_same_v<T, positioning>)
+        reserved       += getLatencyTracker<T>().arrival.size() * sizeof(int32_t);   // deque, allocates as it grows
+    return { account.bytes, account.highWaterMark, reserved, account.budget, account.nEvicted };
+}
+
+void Titta::setMemoryBudget(const size_t bytes_)
+{
+    _memoryBudget = bytes_;
+    enforceMemoryBudget();
+}
+void Titta::setStreamMemoryBudget(std::string stream_, const size_t bytes_, const bool snake_case_on_stream_not_found /*= false*/)
+{
+    setStreamMemoryBudget(stringToStream(std::move(stream_), snake_case_on_stream_not_found), bytes_);
+}
+void Titta::setStreamMemoryBudget(const Stream stream_, const size_t bytes_)
+{
+    switch (stream_)
+    {
+        case Stream::Gaze:
+        case Stream::EyeOpenness:
+            setStreamMemoryBudgetImpl<gaze>(bytes_);
+            break;
+        case Stream::EyeImage:
+            setStreamMemoryBudgetImpl<eyeImage>(bytes_);
+            break;
+        case Stream::ExtSignal:
+            setStreamMemoryBudgetImpl<extSignal>(bytes_);
+            break;
+        case Stream::TimeSync:
+            setStreamMemoryBudgetImpl<timeSync>(bytes_);
+            break;
+        case Stream::Positioning:
+            setStreamMemoryBudgetImpl<positioning>(bytes_);
+            break;
+        case Stream::Notification:
+            setStreamMemoryBudgetImpl<notification>(bytes_);
+            break;
+        default:
+            DoExitWithMsg("Titta::cpp::setStreamMemoryBudget: not supported for " + streamToString(stream_) + " stream.");
+    }
+}
+template <typename T>
+void Titta::setStreamMemoryBudgetImpl(const size_t bytes_)
+{
+    auto l          = lockForWriting<T>();
+    auto& account   = getMemoryAccount<T>();
+    account.budget  = bytes_;
+    if (account.budget && account.bytes > account.budget)
+        evictImpl<T>(account.bytes - account.budget);
+}
+void Titta::setEvictionOrder(const std::vector<std::string>& streams_, const bool snake_case_on_stream_not_found /*= false*/)
+{
+    std::vector<Stream> order;
+    for (const auto& s : streams_)
+    {
+        auto stream = stringToStream(s, snake_case_on_stream_not_found);
+        if (stream == Stream::EyeOpenness)
+            stream = Stream::Gaze;  // eye openness is stored in the gaze buffer
+        if (std::find(order.begin(), order.end(), stream) != order.end())
+            DoExitWithMsg("Titta::cpp::setEvictionOrder: stream \"" + s + "\" is listed more than once");
+        order.push_back(stream);
+    }
+
+    auto l = write_lock(_evictionOrderMutex);
+    _evictionOrder = std::move(order);
+}
+std::vector<std::string> Titta::getEvictionOrder(const bool snakeCase_ /*= false*/) const
+{
+    auto l = read_lock(_evictionOrderMutex);
+    std::vector<std::string> out;
+    for (const auto stream : _evictionOrder)
+        out.push_back(streamToString(stream, snakeCase_));
+    return out;
+}
+void Titta::setBufferAllocation(std::optional<bool> prefault_, std::optional<bool> lock_, std::optional<std::string> hugePages_)
+{
+    // deal with default arguments
+    PinnedMemory::options options;
+    options.prefault    = prefault_.value_or(defaults::bufferPrefault);
+    options.lock        = lock_    .value_or(defaults::bufferLock);
+    options.hugePages   = hugePages_ ? PinnedMemory::stringToHugePages(*hugePages_) : defaults::bufferHugePages;
+
+    _bufferAllocation   = options;
+}
+Titta::bufferAllocation Titta::getBufferAllocation(std::string stream_, const bool snake_case_on_stream_not_found /*= false*/)
+{
+    return getBufferAllocation(stringToStream(std::move(stream_), snake_case_on_stream_not_found));
+}
+Titta::bufferAllocation Titta::getBufferAllocation(const Stream stream_)
+{
+    switch (stream_)
+    {
+        case Stream::Gaze:
+        case Stream::EyeOpenness:
+            return getBufferAllocationImpl<gaze>();
+        case Stream::EyeImage:
+            return getBufferAllocationImpl<eyeImage>();
+        case Stream::ExtSignal:
+            return getBufferAllocationImpl<extSignal>();
+        case Stream::TimeSync:
+            return getBufferAllocationImpl<timeSync>();
+        case Stream::Positioning:
+            return getBufferAllocationImpl<positioning>();
+        case Stream::Notification:
+            return getBufferAllocationImpl<notification>();
+        default:
+            DoExitWithMsg("Titta::cpp::getBufferAllocation: not supported for " + streamToString(stream_) + " stream.");
+    }
+}
+template <typename T>
+Titta::bufferAllocation Titta::getBufferAllocationImpl()
+{
+    auto l              = lockForReading<T>();
+    const auto& buf     = getBuffer<T>();
+    const auto options  = buf.get_allocator().getOptions();
+    const auto status   = buf.get_allocator().getStatus();
+
+    bufferAllocation out;
+    out.prefault        = options.prefault;
+    out.lock            = options.lock;
+    out.hugePages       = PinnedMemory::hugePagesToString(options.hugePages);
+    // plain allocations are not tracked by the allocator
+    out.bytes           = options.isPlain() ? buf.capacity() * sizeof(T) : status.bytes;
+    out.isPrefaulted    = status.prefaulted;
+    out.isLocked        = status.locked;
+    out.hasHugePages    = status.hugePages;
+    out.error           = status.error;
+    return out;
+}
+void Titta::enforceMemoryBudget()
+{
+    const auto budget = _memoryBudget.load(std::memory_order_relaxed);
+    if (!budget || _memoryTotal.load(std::memory_order_relaxed) <= budget)
+        return;
+
+    // one thread doing the eviction is enough, others don't wait for it
+    std::unique_lock lEnforce(_memoryEnforceMutex, std::try_to_lock);
+    if (!lEnforce.owns_lock())
+        return;
+
+    std::vector<Stream> order;
+    {
+        auto l = read_lock(_evictionOrderMutex);
+        order = _evictionOrder;
+    }
+
+    // NB: only one buffer is locked at a time, so that this cannot deadlock with the callbacks
+    const auto target = budget - budget / defaults::memoryEvictHeadroomDiv;
+    for (const auto stream : order)
+    {
+        const auto total = _memoryTotal.load(std::memory_order_relaxed);
+        if (total <= target)
+            break;
+        const auto toFree = total - target;
+        switch (stream)
+        {
+            case Stream::Gaze:
+            case Stream::EyeOpenness:
+            {
+                auto l = lockForWriting<gaze>();
+                evictImpl<gaze>(toFree);
+                break;
+            }
+            case Stream::EyeImage:
+            {
+                auto l = lockForWriting<eyeImage>();
+                evictImpl<eyeImage>(toFree);
+                break;
+            }
+            case Stream::ExtSignal:
+            {
+                auto l = lockForWriting<extSignal>();
+                evictImpl<extSignal>(toFree);
+                break;
+            }
+            case Stream::TimeSync:
+            {
+                auto l = lockForWriting<timeSync>();
+                evictImpl<timeSync>(toFree);
+                break;
+            }
+            case Stream::Positioning:
+            {
+                auto l = lockForWriting<positioning>();
+                evictImpl<positioning>(toFree);
+                break;
+            }
+            case Stream::Notification:
+            {
+                auto l = lockForWriting<notification>();
+                evictImpl<notification>(toFree);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+void Titta::decodeEyeImages(std::vector<eyeImage>& images_, const bool cache_)
+{
+    std::vector<uint8_t> decoded(images_.size(), false);
+    std::vector<std::function<void()>> jobs;
+    const auto reduction = _eyeImageReducer.getOptions();
+    for (size_t i = 0; i < images_.size(); i++)
+        if (images_[i].is_gif)
+            jobs.emplace_back([&images_, &decoded, &reduction, i]() { decoded[i] = decodeGifEyeImage(images_[i], reduction); });
+    if (jobs.empty())
+        return;
+
+    TITTA_TRACE_SCOPE("decode eye images", "eyeImage");
+    _eyeImageDecoder.run(std::move(jobs));
+    if (!cache_)
+        return;
+
+    std::vector<const eyeImage*> toCache;
+    for (size_t i = 0; i < images_.size(); i++)
+        if (decoded[i])
+            toCache.push_back(&images_[i]);
+    if (toCache.empty())
+        return;
+    replaceEyeImages(toCache, true);
+    // the buffer now holds these frames uncompressed
+    if (_eyeImageCompression)
+    {
+        std::vector<eyeImageId> toCompress;
+        toCompress.reserve(toCache.size());
+        for (const auto image : toCache)
+            toCompress.push_back({ image->system_time_stamp, image->camera_id, image->region_id });
+        compressEyeImagesInBackground(std::move(toCompress));
+    }
+}
+void Titta::replaceEyeImages(const std::vector<const eyeImage*>& images_, const bool fromGif_)
+{
+    TITTA_TRACE_SCOPE("replace eye images", "eyeImage");
+    {
+        auto l          = lockForWriting<eyeImage>();
+        auto& account   = getMemoryAccount<eyeImage>();
+        for (const auto image : images_)
+        {
+            // the frame may have been consumed, cleared or evicted, or already been replaced, in the meantime
+            auto it = std::ranges::lower_bound(_eyeImages, image->system_time_stamp, {}, &eyeImage::system_time_stamp);
+            for (; it != _eyeImages.end() && it->system_time_stamp == image->system_time_stamp; ++it)
+            {
+                if (it->is_gif != fromGif_ || it->is_compressed || it->camera_id != image->camera_id || it->region_id != image->region_id)
+                    continue;
+
+                // NB: unsigned arithmetic, also correct if the new frame is smaller
+                const auto oldBytes = it->data_size;
+                *it = *image;
+                const auto grown    = it->data_size - oldBytes;
+                account.bytes      += grown;
+                account.highWaterMark = std::max(account.highWaterMark, account.bytes);
+                const auto total    = _memoryTotal.fetch_add(grown, std::memory_order_relaxed) + grown;
+                auto highWater      = _memoryHighWaterMark.load(std::memory_order_relaxed);
+                while (total > highWater && !_memoryHighWaterMark.compare_exchange_weak(highWater, total, std::memory_order_relaxed)) {}
+                break;
+            }
+        }
+        // stay within this stream's budget, the global budget is enforced below
+        if (account.budget && account.bytes > account.budget)
+            evictImpl<eyeImage>(account.bytes - account.budget + account.budget / defaults::memoryEvictHeadroomDiv);
+    }
+    enforceMemoryBudget();
+}
+bool Titta::compressEyeImage(eyeImage& image_)
+{
+    if (image_.is_gif || image_.is_compressed || image_.bits_per_pixel + image_.padding_per_pixel != 8 || image_.width <= 0 || image_.height <= 0 || image_.data_size != static_cast<size_t>(image_.width) * image_.height)
+        return false;
+
+    TITTA_TRACE_SCOPE("compress eyeImage", "eyeImage");
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<uint8_t> compressed;
+    const bool ok = EyeImageCodec::compress(static_cast<const uint8_t*>(image_.data()), image_.width, image_.height, compressed);
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    {
+        std::lock_guard lock(_eyeImageCompressionMutex);
+        auto& counters = _eyeImageCompressionCounters;
+        counters.compressNs += ns;
+        if (!ok)
+        {
+            counters.nIncompressible++;
+            return false;
+        }
+        counters.nCompressed++;
+        counters.rawBytes        += image_.data_size;
+        counters.compressedBytes += compressed.size();
+    }
+
+    image_.setData(compressed.data(), compressed.size());
+    image_.is_compressed = true;
+    return true;
+}
+void Titta::compressEyeImagesInBackground(std::vector<eyeImageId> images_)
+{
+    for (const auto& id : images_)
+    {
+        std::function<void()> job = [this, id]()
+        {
+            // copy the frame out of the buffer, so that the lock is not held while compressing.
+            // It may have been consumed, cleared or evicted, or already been compressed, in the meantime
+            std::optional<eyeImage> image;
+            {
+                auto l  = lockForReading<eyeImage>();
+                auto it = std::ranges::lower_bound(_eyeImages, id.system_time_stamp, {}, &eyeImage::system_time_stamp);
+                for (; it != _eyeImages.end() && it->system_time_stamp == id.system_time_stamp; ++it)
+                {
+                    if (!it->is_gif && !it->is_compressed && it->camera_id == id.camera_id && it->region_id == id.region_id)
+                    {
+                        image = *it;
+                        break;
+                    }
+                }
+            }
+            if (image && compressEyeImage(*image))
+                replaceEyeImages({ &*image }, false);
+        };
+        // compressor pool not (or no longer) running, e.g. as compression is being switched off: compress here
+        if (!_eyeImageCompressor.submit(std::move(job)))
+            job();
+    }
+}
+void Titta::decompressEyeImages(std::vector<eyeImage>& images_, const bool cache_)
+{
+    if (std::ranges::none_of(images_, &eyeImage::is_compressed))
+        return;
+
+    TITTA_TRACE_SCOPE("decompress eye images", "eyeImage");
+    auto isSameFrame = [](const eyeImage& a_, const eyeImage& b_)
+    {
+        return a_.system_time_stamp == b_.system_time_stamp && a_.camera_id == b_.camera_id && a_.region_id == b_.region_id;
+    };
+    // serve what we can from the cache. When consuming, the frames will not be read again
+    std::vector<size_t> toDecompress;
+    {
+        std::lock_guard lock(_eyeImageCompressionMutex);
+        for (size_t i = 0; i < images_.size(); i++)
+        {
+            if (!images_[i].is_compressed)
+                continue;
+            const auto it = std::ranges::find_if(_eyeImageDecompressed, [&](const eyeImage& c_) { return isSameFrame(c_, images_[i]); });
+            if (it == _eyeImageDecompressed.end())
+            {
+                toDecompress.push_back(i);
+                continue;
+            }
+            _eyeImageCompressionCounters.nCacheHits++;
+            if (cache_)
+                images_[i] = *it;
+            else
+            {
+                images_[i] = std::move(*it);
+                _eyeImageDecompressed.erase(it);
+            }
+        }
+    }
+    if (toDecompress.empty())
+        return;
+
+    std::vector<uint8_t> failed(images_.size(), false);
+    std::vector<std::function<void()>> jobs;
+    for (const auto i : toDecompress)
+        jobs.emplace_back([this, &images_, &failed, i]()
+        {
+            auto& image = images_[i];
+            const auto t0 = std::chrono::steady_clock::now();
+            std::vector<uint8_t> pixels;
+            if (!EyeImageCodec::decompress(static_cast<const uint8_t*>(image.data()), image.data_size, image.width, image.height, pixels))
+            {
+                failed[i] = true;
+                return;
+            }
+            image.setData(pixels.data(), pixels.size());
+            image.is_compressed = false;
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+            std::lock_guard lock(_eyeImageCompressionMutex);
+            _eyeImageCompressionCounters.nDecompressed++;
+            _eyeImageCompressionCounters.decompressNs += ns;
+        });
+    _eyeImageCompressor.run(std::move(jobs));
+    if (std::ranges::any_of(failed, [](const uint8_t f_) { return f_ != 0; }))
+        DoExitWithMsg("Titta::cpp::decompressEyeImages: a stored eye image could not be decompressed");
+
+    if (!cache_)
+        return;
+    std::lock_guard lock(_eyeImageCompressionMutex);
+    for (auto i = toDecompress.size() > _eyeImageDecompressedMax ? toDecompress.size() - _eyeImageDecompressedMax : 0; i < toDecompress.size(); i++)
+        _eyeImageDecompressed.push_back(images_[toDecompress[i]]);
+    while (_eyeImageDecompressed.size() > _eyeImageDecompressedMax)
+        _eyeImageDecompressed.pop_front();
+}
+void Titta::onDeviceNotification(const TobiiResearchNotification& notification_)
+{
+    switch (notification_.notification_type)
+    {
+        case TOBII_RESEARCH_NOTIFICATION_GAZE_OUTPUT_FREQUENCY_CHANGED:
+        case TOBII_RESEARCH_NOTIFICATION_DISPLAY_AREA_CHANGED:
+        case TOBII_RESEARCH_NOTIFICATION_CALIBRATION_CHANGED:
+        {
+            // the notification carries the new value, update the cache in place
+            std::lock_guard lock(_deviceStateMutex);
+            auto state = *_deviceState.load();
+            if (notification_.notification_type == TOBII_RESEARCH_NOTIFICATION_GAZE_OUTPUT_FREQUENCY_CHANGED)
+                state.info.frequency = notification_.value.output_frequency;
+            else if (notification_.notification_type == TOBII_RESEARCH_NOTIFICATION_DISPLAY_AREA_CHANGED)
+                state.displayArea = notification_.value.display_area;
+            else
+                state.calibrationChanged = notification_.system_time_stamp;
+            _deviceState.emplace(std::move(state));
+            break;
+        }
+        case TOBII_RESEARCH_NOTIFICATION_EYE_TRACKING_MODE_CHANGED:
+        case TOBII_RESEARCH_NOTIFICATION_CONNECTION_RESTORED:
+            // new value not included (and e.g. supported frequencies may differ per tracking
+            // mode), or changes may have been missed: fetch everything. Not on this thread, the
+            // SDK's callback thread, and not when read, so that readers never wait for the eye tracker
+            _deviceStateRefresher.submit([this]()
+            {
+                try
+                {
+                    refreshDeviceState(std::nullopt);
+                }
+                catch (...) {}  // keep the previous state, the next notification or setter call tries again
+            });
+            break;
+        default:
+            break;
+    }
+}
+
+bool Titta::isReplay() const
+{
+    return !!_replay;
+}
+void Titta::setReplaySpeed(const double speed_)
+{
+    if (!_replay)
+        DoExitWithMsg("Titta::cpp::setReplaySpeed: this instance is not replaying a recorded session");
+    _replay->setSpeed(speed_);
+}
+double Titta::getReplaySpeed() const
+{
+    if (!_replay)
+        DoExitWithMsg("Titta::cpp::getReplaySpeed: this instance is not replaying a recorded session");
+    return _replay->getSpeed();
+}
+bool Titta::isReplayFinished() const
+{
+    if (!_replay)
+        DoExitWithMsg("Titta::cpp::isReplayFinished: this instance is not replaying a recorded session");
+    return _replay->isFinished();
+}
+
 // gaze data (including eye openness), instantiate templated functions
 template std::vector<Titta::gaze> Titta::consumeN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
 template std::vector<Titta::gaze> Titta::consumeTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
 template std::vector<Titta::gaze> Titta::peekN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
+template std::optional<Titta::gaze> Titta::getLatest();
+template uint64_t Titta::getLatestCount<Titta::gaze>();
 template std::vector<Titta::gaze> Titta::peekTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
 
 // eye images, instantiate templated functions
 template std::vector<Titta::eyeImage> Titta::consumeN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
 template std::vector<Titta::eyeImage> Titta::consumeTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
 template std::vector<Titta::eyeImage> Titta::peekN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
+template std::optional<Titta::eyeImage> Titta::getLatest();
+template uint64_t Titta::getLatestCount<Titta::eyeImage>();
 template std::vector<Titta::eyeImage> Titta::peekTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
 
 // external signals, instantiate templated functions
 template std::vector<Titta::extSignal> Titta::consumeN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
 template std::vector<Titta::extSignal> Titta::consumeTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
 template std::vector<Titta::extSignal> Titta::peekN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
+template std::optional<Titta::extSignal> Titta::getLatest();
+template uint64_t Titta::getLatestCount<Titta::extSignal>();
 template std::vector<Titta::extSignal> Titta::peekTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
 
 // time sync data, instantiate templated functions
 template std::vector<Titta::timeSync> Titta::consumeN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
 template std::vector<Titta::timeSync> Titta::consumeTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
 template std::vector<Titta::timeSync> Titta::peekN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
+template std::optional<Titta::timeSync> Titta::getLatest();
+template uint64_t Titta::getLatestCount<Titta::timeSync>();
 template std::vector<Titta::timeSync> Titta::peekTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
 
 // positioning data, instantiate templated functions
@@ -1486,10 +3746,14 @@ template std::vector<Titta::timeSync> Titta::peekTimeRange(std::optional<int64_t
 template std::vector<Titta::positioning> Titta::consumeN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
 //template std::vector<Titta::positioning> Titta::consumeTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
 template std::vector<Titta::positioning> Titta::peekN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
+template std::optional<Titta::positioning> Titta::getLatest();
+template uint64_t Titta::getLatestCount<Titta::positioning>();
 //template std::vector<Titta::positioning> Titta::peekTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
 
 // notifications, instantiate templated functions
 template std::vector<Titta::notification> Titta::consumeN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
 template std::vector<Titta::notification> Titta::consumeTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
 template std::vector<Titta::notification> Titta::peekN(std::optional<size_t> NSamp_, std::optional<BufferSide> side_);
+template std::optional<Titta::notification> Titta::getLatest();
+template uint64_t Titta::getLatestCount<Titta::notification>();
 template std::vector<Titta::notification> Titta::peekTimeRange(std::optional<int64_t> timeStart_, std::optional<int64_t> timeEnd_);
@@ -0,0 +1,213 @@
+#include "Titta/calibrationCache.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <cstdio>
+
+#include "Titta/utils.h"
+
+namespace
+{
+    constexpr char      fileMagic[8]    = { 'T','I','T','T','A','C','A','L' };
+    constexpr uint32_t  fileVersion     = 1;
+    constexpr auto      fileExtension   = ".tcal";
+
+    // keep file names portable: anything other than alphanumerics, '-' and '.' becomes '_'
+    std::string sanitize(std::string str_)
+    {
+        std::ranges::replace_if(str_, [](const unsigned char c_) { return !std::isalnum(c_) && c_ != '-' && c_ != '.'; }, '_');
+        return str_;
+    }
+    // 64-bit FNV-1a of the key's fields. Added to the file name, as sanitizing is lossy (e.g. "p1-a" and "p1_a"
+    // would otherwise collide, and on case-insensitive file systems also "P1" and "p1")
+    std::string keyHash(const CalibrationCache::key& key_)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const auto& field : { key_.serialNumber, key_.trackingMode, key_.participant })
+            for (const auto c : field + '\0')   // separator, so that moving characters between fields changes the hash
+            {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull;
+            }
+        char buf[17];
+        std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+        return buf;
+    }
+
+    template <typename T>
+    void write(std::ofstream& file_, const T& val_)
+    {
+        file_.write(reinterpret_cast<const char*>(&val_), sizeof(T));
+    }
+    void write(std::ofstream& file_, const std::string& str_)
+    {
+        write(file_, static_cast<uint32_t>(str_.size()));
+        file_.write(str_.data(), static_cast<std::streamsize>(str_.size()));
+    }
+    template <typename T>
+    bool read(std::ifstream& file_, T& val_)
+    {
+        return static_cast<bool>(file_.read(reinterpret_cast<char*>(&val_), sizeof(T)));
+    }
+    bool read(std::ifstream& file_, std::string& str_)
+    {
+        uint32_t len;
+        if (!read(file_, len) || len > (1u << 16))
+            return false;
+        str_.resize(len);
+        return static_cast<bool>(file_.read(str_.data(), len));
+    }
+}
+
+void CalibrationCache::setDirectory(std::optional<std::string> directory_)
+{
+    if (directory_)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(*directory_, ec);
+        if (!std::filesystem::is_directory(*directory_))
+            DoExitWithMsg("Titta::cpp::CalibrationCache::setDirectory: Cannot create directory \"" + *directory_ + "\"" + (ec ? ": " + ec.message() : ""));
+    }
+
+    std::lock_guard lock(_mutex);
+    _directory = std::move(directory_);
+}
+std::optional<std::string> CalibrationCache::getDirectory() const
+{
+    std::lock_guard lock(_mutex);
+    return _directory;
+}
+
+void CalibrationCache::store(const key& key_, std::vector<uint8_t> calibrationData_)
+{
+    entry e;
+    e.checksum = checksum(calibrationData_);
+    e.data     = std::move(calibrationData_);
+
+    std::lock_guard lock(_mutex);
+    if (_directory)
+        writeToDisk(key_, e);
+    _entries.insert_or_assign(key_, std::move(e));
+}
+
+bool CalibrationCache::contains(const key& key_)
+{
+    return get(key_).has_value();
+}
+
+std::optional<std::vector<uint8_t>> CalibrationCache::get(const key& key_)
+{
+    std::lock_guard lock(_mutex);
+    if (const auto it = _entries.find(key_); it != _entries.end())
+        return it->second.data;
+    if (!_directory)
+        return std::nullopt;
+
+    // not in memory, see if we have it on disk
+    auto e = readFromDisk(key_);
+    if (!e)
+        return std::nullopt;
+    auto data = e->data;
+    _entries.emplace(key_, std::move(*e));
+    return data;
+}
+
+void CalibrationCache::clear(std::optional<std::string> participant_)
+{
+    std::lock_guard lock(_mutex);
+    if (!participant_)
+        _entries.clear();
+    else
+        std::erase_if(_entries, [&](const auto& e_) { return e_.first.participant == *participant_; });
+}
+
+std::vector<std::string> CalibrationCache::getParticipants(const std::string& serialNumber_, const std::string& trackingMode_) const
+{
+    std::lock_guard lock(_mutex);
+    std::vector<std::string> out;
+    for (const auto& [k, e] : _entries)
+        if (k.serialNumber == serialNumber_ && k.trackingMode == trackingMode_)
+            out.push_back(k.participant);
+    return out;
+}
+
+uint64_t CalibrationCache::checksum(const std::vector<uint8_t>& data_)
+{
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (const auto b : data_)
+    {
+        hash ^= b;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string CalibrationCache::getFileName(const key& key_) const
+{
+    const auto name = sanitize(key_.serialNumber) + "_" + sanitize(key_.trackingMode) + "_" + sanitize(key_.participant) + "_" + keyHash(key_) + fileExtension;
+    return (std::filesystem::path(*_directory) / name).string();
+}
+
+void CalibrationCache::writeToDisk(const key& key_, const entry& entry_) const
+{
+    // write to a temporary file and move it into place, so that a crash never leaves a half-written calibration
+    const auto fileName = getFileName(key_);
+    const auto tempName = fileName + ".tmp";
+    {
+        std::ofstream file(tempName, std::ios::binary | std::ios::trunc);
+        if (!file)
+            DoExitWithMsg("Titta::cpp::CalibrationCache::store: Cannot open file \"" + tempName + "\" for writing");
+
+        file.write(fileMagic, sizeof(fileMagic));
+        write(file, fileVersion);
+        write(file, key_.serialNumber);
+        write(file, key_.trackingMode);
+        write(file, key_.participant);
+        write(file, static_cast<uint64_t>(entry_.data.size()));
+        write(file, entry_.checksum);
+        file.write(reinterpret_cast<const char*>(entry_.data.data()), static_cast<std::streamsize>(entry_.data.size()));
+        if (!file)
+            DoExitWithMsg("Titta::cpp::CalibrationCache::store: Error writing file \"" + tempName + "\"");
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempName, fileName, ec);
+    if (ec)
+        DoExitWithMsg("Titta::cpp::CalibrationCache::store: Cannot move \"" + tempName + "\" to \"" + fileName + "\": " + ec.message());
+}
+
+std::optional<CalibrationCache::entry> CalibrationCache::readFromDisk(const key& key_) const
+{
+    const auto fileName = getFileName(key_);
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file)
+        return std::nullopt;
+
+    char        magic[sizeof(fileMagic)];
+    uint32_t    version;
+    key         fileKey;
+    uint64_t    size;
+    entry       e;
+    const bool ok =
+        file.read(magic, sizeof(magic)) && std::memcmp(magic, fileMagic, sizeof(fileMagic)) == 0 &&
+        read(file, version) && version == fileVersion &&
+        read(file, fileKey.serialNumber) && read(file, fileKey.trackingMode) && read(file, fileKey.participant) &&
+        read(file, size) && read(file, e.checksum) &&
+        size <= std::filesystem::file_size(fileName);
+    if (!ok)
+        DoExitWithMsg("Titta::cpp::CalibrationCache::get: File \"" + fileName + "\" is not a valid calibration cache file");
+    // should two keys nonetheless map to the same file, this is not ours
+    if (fileKey != key_)
+        return std::nullopt;
+
+    e.data.resize(size);
+    if (!file.read(reinterpret_cast<char*>(e.data.data()), static_cast<std::streamsize>(size)))
+        DoExitWithMsg("Titta::cpp::CalibrationCache::get: File \"" + fileName + "\" is truncated");
+    if (checksum(e.data) != e.checksum)
+        DoExitWithMsg("Titta::cpp::CalibrationCache::get: Checksum mismatch for file \"" + fileName + "\", the stored calibration is corrupt");
+
+    return e;
+}
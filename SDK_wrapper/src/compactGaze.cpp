@@ -0,0 +1,606 @@
+#include "Titta/compactGaze.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+#include "Titta/trace.h"
+
+namespace
+{
+    struct packedEye
+    {
+        float       gazePointOnDisplay[2];
+        float       gazePointInUser[3];
+        float       pupilDiameter;
+        float       gazeOriginInUser[3];
+        float       eyeOpenness;
+    };
+    struct packedEyeQuantized
+    {
+        int16_t     gazePointOnDisplay[2];
+        float       gazePointInUser[3];
+        float       pupilDiameter;
+        float       gazeOriginInUser[3];
+        float       eyeOpenness;
+    };
+    template <typename Eye>
+    struct record
+    {
+        int32_t     deviceDelta;    // NB: must be first two members, see getSystemTimeStamp()
+        int32_t     systemDelta;
+        Eye         left;
+        Eye         right;
+        uint16_t    flags;          // validity and available bits, 8 per eye
+    };
+    using fullRecord      = record<packedEye>;
+    using quantizedRecord = record<packedEyeQuantized>;
+
+    // fixed point for normalized display coordinates
+    constexpr float   quantizeScale = 8192.f;
+    constexpr int16_t quantizeNaN   = std::numeric_limits<int16_t>::min();
+
+    int16_t quantize(const float v_)
+    {
+        if (std::isnan(v_))
+            return quantizeNaN;
+        return static_cast<int16_t>(std::clamp(std::lround(v_ * quantizeScale), -32767l, 32767l));
+    }
+    float dequantize(const int16_t v_)
+    {
+        if (v_ == quantizeNaN)
+            return std::numeric_limits<float>::quiet_NaN();
+        return static_cast<float>(v_) / quantizeScale;
+    }
+
+    template <typename Eye>
+    uint16_t encodeEye(Eye& out_, const TobiiTypes::eyeData& in_)
+    {
+        if constexpr (std::is_same_v<Eye, packedEyeQuantized>)
+        {
+            out_.gazePointOnDisplay[0] = quantize(in_.gaze_point.position_on_display_area.x);
+            out_.gazePointOnDisplay[1] = quantize(in_.gaze_point.position_on_display_area.y);
+        }
+        else
+        {
+            out_.gazePointOnDisplay[0] = in_.gaze_point.position_on_display_area.x;
+            out_.gazePointOnDisplay[1] = in_.gaze_point.position_on_display_area.y;
+        }
+        out_.gazePointInUser[0] = in_.gaze_point.position_in_user_coordinates.x;
+        out_.gazePointInUser[1] = in_.gaze_point.position_in_user_coordinates.y;
+        out_.gazePointInUser[2] = in_.gaze_point.position_in_user_coordinates.z;
+        out_.pupilDiameter      = in_.pupil.diameter;
+        out_.gazeOriginInUser[0]= in_.gaze_origin.position_in_user_coordinates.x;
+        out_.gazeOriginInUser[1]= in_.gaze_origin.position_in_user_coordinates.y;
+        out_.gazeOriginInUser[2]= in_.gaze_origin.position_in_user_coordinates.z;
+        out_.eyeOpenness        = in_.eye_openness.diameter;
+
+        return static_cast<uint16_t>(
+            (in_.gaze_point  .validity == TOBII_RESEARCH_VALIDITY_VALID) << 0 | in_.gaze_point  .available << 1 |
+            (in_.pupil       .validity == TOBII_RESEARCH_VALIDITY_VALID) << 2 | in_.pupil       .available << 3 |
+            (in_.gaze_origin .validity == TOBII_RESEARCH_VALIDITY_VALID) << 4 | in_.gaze_origin .available << 5 |
+            (in_.eye_openness.validity == TOBII_RESEARCH_VALIDITY_VALID) << 6 | in_.eye_openness.available << 7);
+    }
+    template <typename Eye>
+    void decodeEye(TobiiTypes::eyeData& out_, const Eye& in_, const uint16_t flags_)
+    {
+        auto validity = [flags_](const int bit_) { return flags_ & (1 << bit_) ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID; };
+        if constexpr (std::is_same_v<Eye, packedEyeQuantized>)
+            out_.gaze_point.position_on_display_area = { dequantize(in_.gazePointOnDisplay[0]), dequantize(in_.gazePointOnDisplay[1]) };
+        else
+            out_.gaze_point.position_on_display_area = { in_.gazePointOnDisplay[0], in_.gazePointOnDisplay[1] };
+        out_.gaze_point.position_in_user_coordinates  = { in_.gazePointInUser[0], in_.gazePointInUser[1], in_.gazePointInUser[2] };
+        out_.gaze_point.validity                      = validity(0);
+        out_.gaze_point.available                     = flags_ & (1 << 1);
+        out_.pupil.diameter                           = in_.pupilDiameter;
+        out_.pupil.validity                           = validity(2);
+        out_.pupil.available                          = flags_ & (1 << 3);
+        out_.gaze_origin.position_in_user_coordinates = { in_.gazeOriginInUser[0], in_.gazeOriginInUser[1], in_.gazeOriginInUser[2] };
+        out_.gaze_origin.validity                     = validity(4);
+        out_.gaze_origin.available                    = flags_ & (1 << 5);
+        out_.eye_openness.diameter                    = in_.eyeOpenness;
+        out_.eye_openness.validity                    = validity(6);
+        out_.eye_openness.available                   = flags_ & (1 << 7);
+    }
+
+    template <typename Record>
+    void encodeRecord(uint8_t* out_, const TobiiTypes::gazeData& in_, const int64_t deviceBase_, const int64_t systemBase_)
+    {
+        Record r;
+        std::memset(&r, 0, sizeof(r));     // deterministic padding, so it compresses well in the cold tier
+        r.deviceDelta = static_cast<int32_t>(in_.device_time_stamp - deviceBase_);
+        r.systemDelta = static_cast<int32_t>(in_.system_time_stamp - systemBase_);
+        r.flags       = encodeEye(r.left, in_.left_eye);
+        r.flags      |= encodeEye(r.right, in_.right_eye) << 8;
+        std::memcpy(out_, &r, sizeof(r));
+    }
+    template <typename Record>
+    void decodeRecord(TobiiTypes::gazeData& out_, const uint8_t* in_, const int64_t deviceBase_, const int64_t systemBase_)
+    {
+        Record r;
+        std::memcpy(&r, in_, sizeof(r));
+        out_.device_time_stamp = deviceBase_ + r.deviceDelta;
+        out_.system_time_stamp = systemBase_ + r.systemDelta;
+        decodeEye(out_.left_eye , r.left , static_cast<uint16_t>(r.flags & 0xFF));
+        decodeEye(out_.right_eye, r.right, static_cast<uint16_t>(r.flags >> 8));
+    }
+
+    bool fitsDelta(const int64_t value_, const int64_t base_)
+    {
+        const auto d = value_ - base_;
+        return d >= std::numeric_limits<int32_t>::min() && d <= std::numeric_limits<int32_t>::max();
+    }
+
+    //// cold tier
+    constexpr size_t checkpointInterval = 64;   // samples
+
+    // bit streams, most significant bit first
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(std::vector<uint64_t>& words_) : _words(words_) {}
+
+        void write(const uint64_t value_, const unsigned nBits_)     // value_ must fit in nBits_ bits, 1 <= nBits_ <= 64
+        {
+            const auto used = static_cast<unsigned>(_nBits % 64);
+            if (!used)
+                _words.push_back(0);
+            const auto avail = 64 - used;
+            if (nBits_ <= avail)
+                _words.back() |= value_ << (avail - nBits_);
+            else
+            {
+                _words.back() |= value_ >> (nBits_ - avail);
+                _words.push_back(value_ << (64 - (nBits_ - avail)));
+            }
+            _nBits += nBits_;
+        }
+        uint64_t getNumBits() const { return _nBits; }
+
+    private:
+        std::vector<uint64_t>&  _words;
+        uint64_t                _nBits = 0;
+    };
+    class BitReader
+    {
+    public:
+        BitReader(const std::vector<uint64_t>& words_, const uint64_t bitPos_ = 0) : _words(words_.data()), _pos(bitPos_) {}
+
+        uint64_t read(const unsigned nBits_)                           // 1 <= nBits_ <= 64
+        {
+            const auto w     = _pos / 64;
+            const auto used  = static_cast<unsigned>(_pos % 64);
+            const auto avail = 64 - used;
+            uint64_t out;
+            if (nBits_ <= avail)
+                out = (_words[w] << used) >> (64 - nBits_);
+            else
+            {
+                const auto rest = nBits_ - avail;
+                out = ((_words[w] << used) >> used) << rest | _words[w + 1] >> (64 - rest);
+            }
+            _pos += nBits_;
+            return out;
+        }
+        bool readBit() { return read(1) != 0; }
+
+    private:
+        const uint64_t* _words;
+        uint64_t        _pos;
+    };
+
+    uint64_t zigzag(const int64_t v_)   { return (static_cast<uint64_t>(v_) << 1) ^ static_cast<uint64_t>(v_ >> 63); }
+    int64_t  unzigzag(const uint64_t v_){ return static_cast<int64_t>(v_ >> 1) ^ -static_cast<int64_t>(v_ & 1); }
+
+    // timestamps: delta-of-delta, in buckets of increasing size
+    void writeDoD(BitWriter& w_, const int64_t dod_)
+    {
+        const auto z = zigzag(dod_);
+        if (!z)
+            w_.write(0b0, 1);
+        else if (z < (1 << 7))
+            w_.write(0b10   << 7  | z, 2 + 7);
+        else if (z < (1 << 12))
+            w_.write(0b110  << 12 | z, 3 + 12);
+        else if (z < (1 << 20))
+            w_.write(0b1110 << 20 | z, 4 + 20);
+        else
+        {
+            w_.write(0b1111, 4);
+            w_.write(z, 64);
+        }
+    }
+    int64_t readDoD(BitReader& r_)
+    {
+        if (!r_.readBit())
+            return 0;
+        if (!r_.readBit())
+            return unzigzag(r_.read(7));
+        if (!r_.readBit())
+            return unzigzag(r_.read(12));
+        if (!r_.readBit())
+            return unzigzag(r_.read(20));
+        return unzigzag(r_.read(64));
+    }
+
+    // timestamp decoder/encoder state for one clock
+    struct timeState
+    {
+        int32_t value = 0;
+        int64_t delta = 0;
+
+        int64_t encode(const int32_t value_)
+        {
+            const auto delta = static_cast<int64_t>(value_) - value;
+            const auto dod   = delta - this->delta;
+            value            = value_;
+            this->delta      = delta;
+            return dod;
+        }
+        void decode(const int64_t dod_)
+        {
+            delta += dod_;
+            value  = static_cast<int32_t>(value + delta);
+        }
+    };
+
+    // other record words: XOR with previous value of the same word, meaningful bits only
+    // (reusing the previous leading/trailing zero window if the XOR fits in it)
+    struct xorState
+    {
+        uint32_t    value       = 0;
+        int         leading     = -1;   // -1: no window yet
+        int         trailing    = 0;
+
+        void encode(BitWriter& w_, const uint32_t value_)
+        {
+            const auto x = value_ ^ value;
+            value        = value_;
+            if (!x)
+            {
+                w_.write(0b0, 1);
+                return;
+            }
+            const auto lz = std::countl_zero(x);
+            const auto tz = std::countr_zero(x);
+            if (leading >= 0 && lz >= leading && tz >= trailing)
+            {
+                w_.write(0b10, 2);
+                w_.write(x >> trailing, 32 - leading - trailing);
+            }
+            else
+            {
+                const auto len = 32 - lz - tz;
+                w_.write(0b11 << 10 | static_cast<uint64_t>(lz) << 5 | (len - 1), 2 + 5 + 5);
+                w_.write(x >> tz, len);
+                leading  = lz;
+                trailing = tz;
+            }
+        }
+        uint32_t decode(BitReader& r_)
+        {
+            if (!r_.readBit())
+                return value;
+            if (!r_.readBit())
+                value ^= static_cast<uint32_t>(r_.read(32 - leading - trailing)) << trailing;
+            else
+            {
+                leading         = static_cast<int>(r_.read(5));
+                const auto len  = static_cast<int>(r_.read(5)) + 1;
+                trailing        = 32 - leading - len;
+                value          ^= static_cast<uint32_t>(r_.read(len)) << trailing;
+            }
+            return value;
+        }
+    };
+    constexpr size_t recordTimeBytes = 2 * sizeof(int32_t);     // deviceDelta and systemDelta
+    static_assert(sizeof(fullRecord) % sizeof(uint32_t) == 0 && sizeof(quantizedRecord) % sizeof(uint32_t) == 0);
+}
+
+size_t CompactGazeBuffer::getSampleBytes() const
+{
+    return _quantize ? sizeof(quantizedRecord) : sizeof(fullRecord);
+}
+
+size_t CompactGazeBuffer::getColdBytes(const compressedBlock& block_)
+{
+    return (block_.times.size() + block_.values.size()) * sizeof(uint64_t) + block_.checkpoints.size() * sizeof(checkpoint);
+}
+
+size_t CompactGazeBuffer::getReservedBytes() const
+{
+    size_t out = _blocks.capacity() * sizeof(block) + _blockStart.capacity() * sizeof(size_t);
+    for (const auto& b : _blocks)
+    {
+        out += b.data.capacity();
+        if (b.cold)
+            out += (b.cold->times.capacity() + b.cold->values.capacity()) * sizeof(uint64_t) + b.cold->checkpoints.capacity() * sizeof(checkpoint);
+    }
+    return out;
+}
+
+void CompactGazeBuffer::reserve(const size_t nSamp_)
+{
+    const auto nBlocks = (nSamp_ + _blockSize - 1) / _blockSize;
+    _blocks.reserve(nBlocks);
+    _blockStart.reserve(nBlocks);
+}
+
+void CompactGazeBuffer::clear()
+{
+    _blocks.clear();
+    _blockStart.clear();
+    _size        = 0;
+    _storedBytes = 0;
+}
+
+void CompactGazeBuffer::push_back(const TobiiTypes::gazeData& sample_)
+{
+    // start new block if last is full or compressed, or timestamps can't be represented relative to its base
+    if (_blocks.empty() || _blocks.back().n >= _blockSize || _blocks.back().cold ||
+        !fitsDelta(sample_.device_time_stamp, _blocks.back().deviceBase) ||
+        !fitsDelta(sample_.system_time_stamp, _blocks.back().systemBase))
+    {
+        auto& b = _blocks.emplace_back();
+        b.id         = _nextBlockId++;
+        b.deviceBase = sample_.device_time_stamp;
+        b.systemBase = sample_.system_time_stamp;
+        b.data.reserve(_blockSize * getSampleBytes());
+        _blockStart.push_back(_size);
+    }
+
+    auto& b = _blocks.back();
+    b.data.resize((b.n + 1) * getSampleBytes());
+    encode(b.data.data() + b.n * getSampleBytes(), sample_, b);
+    b.n++;
+    _size++;
+    _storedBytes += getSampleBytes();
+}
+
+int64_t CompactGazeBuffer::getSystemTimeStamp(const size_t i_) const
+{
+    const auto [b, j] = locate(i_);
+    return getSystemTimeStamp(_blocks[b], j);
+}
+
+int64_t CompactGazeBuffer::getSystemTimeStamp(const block& block_, const size_t i_) const
+{
+    if (block_.cold)
+    {
+        // decode from nearest checkpoint
+        const auto& cp = block_.cold->checkpoints[i_ / checkpointInterval];
+        BitReader r(block_.cold->times, cp.bitPos);
+        timeState device{ cp.device, cp.deviceDelta }, system{ cp.system, cp.systemDelta };
+        for (auto j = i_ / checkpointInterval * checkpointInterval; j <= i_; j++)
+        {
+            device.decode(readDoD(r));
+            system.decode(readDoD(r));
+        }
+        return block_.systemBase + system.value;
+    }
+    int32_t delta;
+    std::memcpy(&delta, block_.data.data() + i_ * getSampleBytes() + sizeof(int32_t), sizeof(delta));
+    return block_.systemBase + delta;
+}
+
+std::vector<TobiiTypes::gazeData> CompactGazeBuffer::get(const size_t iStart_, const size_t iEnd_) const
+{
+    TITTA_TRACE_SCOPE("compact gaze decode", "buffer");
+    std::vector<TobiiTypes::gazeData> out;
+    if (iStart_ >= iEnd_)
+        return out;
+
+    out.resize(iEnd_ - iStart_);
+    auto [b, j] = locate(iStart_);
+    std::vector<uint8_t> decompressed;
+    for (size_t o = 0; o < out.size(); ++b, j = 0)
+    {
+        const auto& blk = _blocks[b];
+        const auto  n   = std::min(blk.n - j, out.size() - o);
+        auto records    = blk.data.data();
+        if (blk.cold)
+        {
+            decompressed = decompress(blk, j + n);
+            records      = decompressed.data();
+        }
+        for (size_t k = 0; k < n; ++k)
+            decode(out[o + k], records + (j + k) * getSampleBytes(), blk);
+        o += n;
+    }
+    return out;
+}
+
+void CompactGazeBuffer::erase(const size_t iStart_, const size_t iEnd_)
+{
+    if (iStart_ >= iEnd_)
+        return;
+    if (iStart_ == 0 && iEnd_ >= _size)
+    {
+        clear();
+        return;
+    }
+
+    // remove range from each block it touches, then drop blocks that became empty
+    auto [b, j] = locate(iStart_);
+    auto nLeft  = iEnd_ - iStart_;
+    for (; nLeft && b < _blocks.size(); ++b, j = 0)
+    {
+        auto& blk       = _blocks[b];
+        const auto n    = std::min(nLeft, blk.n - j);
+        nLeft          -= n;
+        if (blk.cold)
+        {
+            // whole block goes: no need to decode. Else back to normal records first
+            _storedBytes -= getColdBytes(*blk.cold);
+            if (n == blk.n)
+            {
+                blk.n = 0;
+                continue;
+            }
+            blk.data = decompress(blk, blk.n);
+            blk.cold.reset();
+            _storedBytes += blk.data.size();
+        }
+        const auto off  = blk.data.begin() + static_cast<ptrdiff_t>(j * getSampleBytes());
+        blk.data.erase(off, off + static_cast<ptrdiff_t>(n * getSampleBytes()));
+        blk.n          -= n;
+        _storedBytes   -= n * getSampleBytes();
+    }
+    _blocks.erase(std::remove_if(_blocks.begin(), _blocks.end(), [](const block& b_) { return !b_.n; }), _blocks.end());
+    _size -= iEnd_ - iStart_;
+    updateBlockStarts();
+}
+
+std::tuple<size_t, size_t, bool> CompactGazeBuffer::findTimeRange(const int64_t timeStart_, const int64_t timeEnd_) const
+{
+    if (!_size)
+        return { 0, 0, true };
+
+    const bool inclFirst = timeStart_ <= getSystemTimeStamp(_blocks.front(), 0);
+    const bool inclLast  = timeEnd_   >= getSystemTimeStamp(_blocks.back(), _blocks.back().n - 1);
+
+    const auto iStart = inclFirst ? 0     : findFirst(timeStart_, false);
+    const auto iEnd   = inclLast  ? _size : std::max(iStart, findFirst(timeEnd_, true));
+    return { iStart, iEnd, inclFirst && inclLast };
+}
+
+size_t CompactGazeBuffer::findFirst(const int64_t time_, const bool after_) const
+{
+    auto before = [&](const int64_t ts_) { return after_ ? ts_ <= time_ : ts_ < time_; };
+
+    // first find block, by its last sample. Then find sample in block
+    const auto bIt = std::partition_point(_blocks.begin(), _blocks.end(), [&](const block& b_) { return before(getSystemTimeStamp(b_, b_.n - 1)); });
+    if (bIt == _blocks.end())
+        return _size;
+
+    size_t lo = 0, hi = bIt->n;
+    while (lo < hi)
+    {
+        const auto mid = lo + (hi - lo) / 2;
+        if (before(getSystemTimeStamp(*bIt, mid)))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return _blockStart[std::distance(_blocks.begin(), bIt)] + lo;
+}
+
+std::tuple<size_t, size_t> CompactGazeBuffer::locate(const size_t i_) const
+{
+    const auto b = static_cast<size_t>(std::distance(_blockStart.begin(), std::upper_bound(_blockStart.begin(), _blockStart.end(), i_))) - 1;
+    return { b, i_ - _blockStart[b] };
+}
+
+void CompactGazeBuffer::updateBlockStarts()
+{
+    _blockStart.resize(_blocks.size());
+    size_t start = 0;
+    for (size_t b = 0; b < _blocks.size(); ++b)
+    {
+        _blockStart[b] = start;
+        start         += _blocks[b].n;
+    }
+}
+
+void CompactGazeBuffer::encode(uint8_t* out_, const TobiiTypes::gazeData& sample_, const block& block_) const
+{
+    if (_quantize)
+        encodeRecord<quantizedRecord>(out_, sample_, block_.deviceBase, block_.systemBase);
+    else
+        encodeRecord<fullRecord>     (out_, sample_, block_.deviceBase, block_.systemBase);
+}
+
+void CompactGazeBuffer::decode(TobiiTypes::gazeData& out_, const uint8_t* in_, const block& block_) const
+{
+    if (_quantize)
+        decodeRecord<quantizedRecord>(out_, in_, block_.deviceBase, block_.systemBase);
+    else
+        decodeRecord<fullRecord>     (out_, in_, block_.deviceBase, block_.systemBase);
+}
+
+std::optional<CompactGazeBuffer::compressionJob> CompactGazeBuffer::getCompressionJob() const
+{
+    if (!_compressOld || _blocks.size() <= hotBlocks)
+        return std::nullopt;
+    for (size_t b = 0; b < _blocks.size() - hotBlocks; ++b)
+    {
+        const auto& blk = _blocks[b];
+        if (blk.cold || !blk.n)
+            continue;
+        return compressionJob{ blk.id, getSampleBytes(), blk.n, std::vector<uint8_t>(blk.data.begin(), blk.data.begin() + static_cast<ptrdiff_t>(blk.n * getSampleBytes())) };
+    }
+    return std::nullopt;
+}
+
+CompactGazeBuffer::compressedBlock CompactGazeBuffer::compress(const compressionJob& job_)
+{
+    TITTA_TRACE_SCOPE("compact gaze compress", "buffer");
+    compressedBlock out;
+    out.id = job_.id;
+    out.n  = job_.n;
+    out.checkpoints.reserve((job_.n + checkpointInterval - 1) / checkpointInterval);
+    BitWriter times(out.times), values(out.values);
+
+    timeState device, system;
+    std::vector<xorState> words((job_.recordSize - recordTimeBytes) / sizeof(uint32_t));
+    for (size_t i = 0; i < job_.n; ++i)
+    {
+        const auto record = job_.data.data() + i * job_.recordSize;
+        if (i % checkpointInterval == 0)
+            out.checkpoints.push_back({ times.getNumBits(), device.value, system.value, device.delta, system.delta });
+
+        int32_t t[2];
+        std::memcpy(t, record, recordTimeBytes);
+        writeDoD(times, device.encode(t[0]));
+        writeDoD(times, system.encode(t[1]));
+        for (size_t w = 0; w < words.size(); ++w)
+        {
+            uint32_t v;
+            std::memcpy(&v, record + recordTimeBytes + w * sizeof(uint32_t), sizeof(v));
+            words[w].encode(values, v);
+        }
+    }
+    out.times.shrink_to_fit();
+    out.values.shrink_to_fit();
+    return out;
+}
+
+bool CompactGazeBuffer::commitCompression(compressedBlock&& block_)
+{
+    // blocks are in order of id. Block must still hold the samples the job was made from: as only
+    // the last block grows and that one is never compressed, it is unchanged if it has the same size
+    const auto it = std::ranges::lower_bound(_blocks, block_.id, {}, &block::id);
+    if (it == _blocks.end() || it->id != block_.id || it->cold || it->n != block_.n)
+        return false;
+    _storedBytes += getColdBytes(block_);
+    _storedBytes -= it->data.size();
+    it->cold = std::move(block_);
+    std::vector<uint8_t>().swap(it->data);
+    return true;
+}
+
+std::vector<uint8_t> CompactGazeBuffer::decompress(const block& block_, const size_t nSamp_) const
+{
+    TITTA_TRACE_SCOPE("compact gaze decompress", "buffer");
+    const auto recordSize = getSampleBytes();
+    std::vector<uint8_t> out(nSamp_ * recordSize);
+    BitReader times(block_.cold->times), values(block_.cold->values);
+
+    timeState device, system;
+    std::vector<xorState> words((recordSize - recordTimeBytes) / sizeof(uint32_t));
+    for (size_t i = 0; i < nSamp_; ++i)
+    {
+        const auto record = out.data() + i * recordSize;
+        device.decode(readDoD(times));
+        system.decode(readDoD(times));
+        const int32_t t[2] = { device.value, system.value };
+        std::memcpy(record, t, recordTimeBytes);
+        for (size_t w = 0; w < words.size(); ++w)
+        {
+            const auto v = words[w].decode(values);
+            std::memcpy(record + recordTimeBytes + w * sizeof(uint32_t), &v, sizeof(v));
+        }
+    }
+    return out;
+}
@@ -0,0 +1,266 @@
+#include "Titta/discovery.h"
+#include <algorithm>
+#include <exception>
+#include <tobii_research_eyetracker.h>
+
+#include "Titta/utils.h"
+#include "Titta/trace.h"
+#include "Titta/threading.h"
+
+namespace
+{
+    int64_t getTimeStamp()
+    {
+        int64_t systemTimeStamp = 0;
+        tobii_research_get_system_time_stamp(&systemTimeStamp);
+        return systemTimeStamp;
+    }
+
+    std::vector<TobiiTypes::eyeTracker> getInfo(const std::vector<EyeTrackerDiscovery::entry>& entries_)
+    {
+        std::vector<TobiiTypes::eyeTracker> out;
+        out.reserve(entries_.size());
+        for (const auto& e : entries_)
+            out.push_back(e.info);
+        return out;
+    }
+}
+
+std::string EyeTrackerDiscovery::eventTypeToString(const EventType type_)
+{
+    switch (type_)
+    {
+        case EventType::Found:  return "found";
+        case EventType::Lost:   return "lost";
+    }
+    return "unknown";
+}
+
+EyeTrackerDiscovery::~EyeTrackerDiscovery()
+{
+    stop();
+}
+
+void EyeTrackerDiscovery::start(const std::chrono::milliseconds interval_)
+{
+    if (interval_ <= std::chrono::milliseconds::zero())
+        DoExitWithMsg("Titta::cpp::startEyeTrackerDiscovery: interval must be positive");
+
+    stop();
+    {
+        std::lock_guard lock(_mutex);
+        _running = true;
+    }
+    _thread = std::thread(&EyeTrackerDiscovery::thread, this, interval_);
+}
+void EyeTrackerDiscovery::stop()
+{
+    if (!_thread.joinable())
+        return;
+    {
+        std::lock_guard lock(_mutex);
+        _stopRequested = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+    // wake up anyone waiting for a scan that will now not happen
+    std::lock_guard lock(_mutex);
+    _running = false;
+    _stopRequested = false;
+    _cv.notify_all();
+}
+bool EyeTrackerDiscovery::isRunning() const
+{
+    std::lock_guard lock(_mutex);
+    return _running;
+}
+
+void EyeTrackerDiscovery::refresh(const bool wait_)
+{
+    if (!isRunning())
+    {
+        if (!scan(true))
+            DoExitWithMsg("Titta::cpp: Cannot get eye trackers: " + getLastError());
+        return;
+    }
+
+    std::unique_lock lock(_mutex);
+    // the requested scan must start after this point
+    const auto target = _scansStarted + 1;
+    _refreshPending = true;
+    _cv.notify_all();
+    if (wait_)
+        _cv.wait(lock, [&]() { return _scansCompleted >= target || !_running; });
+}
+
+std::vector<TobiiTypes::eyeTracker> EyeTrackerDiscovery::getEyeTrackers()
+{
+    {
+        std::lock_guard lock(_mutex);
+        if (_running && _scansCompleted)
+            return getInfo(_entries);
+    }
+
+    refresh(true);
+    std::lock_guard lock(_mutex);
+    return getInfo(_entries);
+}
+std::vector<EyeTrackerDiscovery::entry> EyeTrackerDiscovery::getEntries() const
+{
+    std::lock_guard lock(_mutex);
+    return _entries;
+}
+std::optional<TobiiTypes::eyeTracker> EyeTrackerDiscovery::find(const std::string& address_) const
+{
+    std::lock_guard lock(_mutex);
+    const auto it = std::ranges::find(_entries, address_, [](const entry& e_) { return e_.info.address; });
+    if (it == _entries.end())
+        return std::nullopt;
+    return it->info;
+}
+std::string EyeTrackerDiscovery::getLastError() const
+{
+    std::lock_guard lock(_mutex);
+    return _lastError;
+}
+
+std::vector<EyeTrackerDiscovery::event> EyeTrackerDiscovery::getEvents(const bool clear_)
+{
+    std::lock_guard lock(_mutex);
+    std::vector<event> out(_events.begin(), _events.end());
+    if (clear_)
+        _events.clear();
+    return out;
+}
+void EyeTrackerDiscovery::setCallback(std::function<void(event)> callback_)
+{
+    std::lock_guard lock(_mutex);
+    _callback = std::move(callback_);
+}
+
+void EyeTrackerDiscovery::thread(const std::chrono::milliseconds interval_)
+{
+    TITTA_TRACE_THREAD_NAME("Titta eye tracker discovery");
+    TittaThreads::scope threadRegistration("Titta eye tracker discovery");
+    while (true)
+    {
+        scan(false);
+
+        std::unique_lock lock(_mutex);
+        _cv.wait_for(lock, interval_, [this]() { return _refreshPending || _stopRequested; });
+        if (_stopRequested)
+            break;
+    }
+}
+
+bool EyeTrackerDiscovery::scan(const bool fresh_)
+{
+    TITTA_TRACE_SCOPE("eye tracker discovery scan", "discovery");
+    std::lock_guard scanLock(_scanMutex);
+    {
+        std::lock_guard lock(_mutex);
+        ++_scansStarted;
+        _refreshPending = false;
+    }
+
+    TobiiResearchEyeTrackers* tobiiTrackers = nullptr;
+    const TobiiResearchStatus status = tobii_research_find_all_eyetrackers(&tobiiTrackers);
+    const auto now = getTimeStamp();
+    std::vector<event> newEvents;
+    std::function<void(event)> callback;
+    bool ok = status == TOBII_RESEARCH_STATUS_OK;
+    {
+        std::unique_lock lock(_mutex);
+        if (!ok)
+            _lastError = TobiiResearchStatusToString(status);
+        else
+        {
+            _lastError.clear();
+            std::vector<entry> entries;
+            for (size_t i = 0; i < tobiiTrackers->count; i++)
+            {
+                const auto et = tobiiTrackers->eyetrackers[i];
+                char* address = nullptr;
+                if (tobii_research_get_address(et, &address) != TOBII_RESEARCH_STATUS_OK || !address)
+                    continue;
+                const std::string addressStr = address;
+                tobii_research_free_string(address);
+
+                auto it = std::ranges::find(_entries, addressStr, [](const entry& e_) { return e_.info.address; });
+                if (it != _entries.end() && !fresh_)
+                {
+                    // known eye tracker, don't query it again
+                    it->lastSeen = now;
+                    entries.push_back(std::move(*it));
+                    _entries.erase(it);
+                    continue;
+                }
+
+                // new eye tracker, or its info should be fetched again. Querying it may take a
+                // while, don't block readers of the list (it is not modified while unlocked)
+                lock.unlock();
+                std::optional<TobiiTypes::eyeTracker> info;
+                std::string error;
+                try
+                {
+                    info.emplace(et);
+                }
+                catch (const std::string& e_)       { error = e_; }
+                catch (const std::exception& e_)    { error = e_.what(); }
+                catch (...)                         { error = "unknown error"; }
+                lock.lock();
+
+                if (!info)
+                {
+                    if (!_lastError.empty())
+                        _lastError += "; ";
+                    _lastError += "Cannot get info for eye tracker \"" + addressStr + "\": " + error;
+                    if (it != _entries.end())
+                    {
+                        // keep what we know about it
+                        it->lastSeen = now;
+                        entries.push_back(std::move(*it));
+                        _entries.erase(it);
+                    }
+                    continue;
+                }
+                if (it != _entries.end())
+                {
+                    it->info     = std::move(*info);
+                    it->lastSeen = now;
+                    entries.push_back(std::move(*it));
+                    _entries.erase(it);
+                }
+                else
+                {
+                    newEvents.push_back({ EventType::Found, now, *info });
+                    entries.push_back({ std::move(*info), now, now });
+                }
+            }
+            tobii_research_free_eyetrackers(tobiiTrackers);
+
+            // anything left over was not found in this scan
+            for (auto& e : _entries)
+                newEvents.push_back({ EventType::Lost, now, std::move(e.info) });
+            _entries = std::move(entries);
+        }
+
+        for (const auto& e : newEvents)
+            addEvent(e);
+        callback = _callback;
+        ++_scansCompleted;
+        _cv.notify_all();
+    }
+
+    if (callback)
+        for (auto& e : newEvents)
+            callback(std::move(e));
+    return ok;
+}
+
+void EyeTrackerDiscovery::addEvent(event event_)
+{
+    _events.push_back(std::move(event_));
+    while (_events.size() > _maxEvents)
+        _events.pop_front();
+}
@@ -0,0 +1,223 @@
+#include "Titta/eyeImageCodec.h"
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+namespace
+{
+    constexpr uint8_t   formatVersion   = 1;
+    constexpr int       nContexts       = 8;
+    constexpr int       unaryLimit      = 16;   // longer unary codes are replaced by an escape and the raw residual
+    constexpr int       maxK            = 7;
+    constexpr uint32_t  resetCount      = 64;   // statistics are halved at this count, so that they follow the image
+
+    // per-context running statistics of the mapped residuals, from which the Rice parameter is derived
+    struct context
+    {
+        uint32_t sum   = 4;
+        uint32_t count = 1;
+
+        int k() const
+        {
+            int k = 0;
+            while ((count << k) < sum && k < maxK)
+                k++;
+            return k;
+        }
+        void update(const uint32_t m_)
+        {
+            sum += m_;
+            if (++count == resetCount)
+            {
+                sum   >>= 1;
+                count >>= 1;
+            }
+        }
+    };
+
+    // median edge detector: picks the left or upper neighbour at an edge, else the planar prediction
+    int predict(const int a_, const int b_, const int c_)
+    {
+        if (c_ >= std::max(a_, b_))
+            return std::min(a_, b_);
+        if (c_ <= std::min(a_, b_))
+            return std::max(a_, b_);
+        return a_ + b_ - c_;
+    }
+    // context from the local gradients, flat regions get their own contexts
+    int getContext(const int a_, const int b_, const int c_)
+    {
+        const auto g = static_cast<unsigned>(std::abs(a_ - c_) + std::abs(b_ - c_));
+        return std::min(nContexts - 1, static_cast<int>(std::bit_width((g + 1) / 2)));
+    }
+    // maps residual modulo 256 to 0, -1, 1, -2, 2, ... -> 0, 1, 2, 3, 4, ...
+    uint32_t mapResidual(const int pixel_, const int pred_)
+    {
+        const auto e = static_cast<int8_t>(static_cast<uint8_t>(pixel_ - pred_));
+        return e >= 0 ? 2u * e : -2 * e - 1;
+    }
+    uint8_t unmapResidual(const uint32_t m_, const int pred_)
+    {
+        const int e = (m_ & 1) ? -static_cast<int>((m_ + 1) / 2) : static_cast<int>(m_ / 2);
+        return static_cast<uint8_t>(pred_ + e);
+    }
+
+    // runs codeFun_(x, a, b, c) for each pixel of row_ in order, with a, b and c the left, upper and upper-left
+    // neighbours. At the image edges, missing neighbours are continued from the available ones
+    template <typename F>
+    void forEachPixel(const uint8_t* row_, const uint8_t* prevRow_, const int width_, F&& codeFun_)
+    {
+        if (!prevRow_)
+        {
+            codeFun_(0, 0, 0, 0);
+            for (int x = 1; x < width_; x++)
+                codeFun_(x, row_[x - 1], row_[x - 1], row_[x - 1]);
+            return;
+        }
+        codeFun_(0, prevRow_[0], prevRow_[0], prevRow_[0]);
+        for (int x = 1; x < width_; x++)
+            codeFun_(x, row_[x - 1], prevRow_[x], prevRow_[x - 1]);
+    }
+
+    class bitWriter
+    {
+    public:
+        explicit bitWriter(std::vector<uint8_t>& out_) : _out(out_) {}
+
+        // at most 32 bits
+        void put(const uint32_t value_, const int nBits_)
+        {
+            _acc   = (_acc << nBits_) | value_;
+            _nBits += nBits_;
+            while (_nBits >= 8)
+            {
+                _nBits -= 8;
+                _out.push_back(static_cast<uint8_t>(_acc >> _nBits));
+            }
+        }
+        void flush()
+        {
+            if (_nBits)
+                _out.push_back(static_cast<uint8_t>(_acc << (8 - _nBits)));
+            _nBits = 0;
+        }
+
+    private:
+        std::vector<uint8_t>&   _out;
+        uint64_t                _acc   = 0;
+        int                     _nBits = 0;
+    };
+
+    class bitReader
+    {
+    public:
+        bitReader(const uint8_t* data_, const size_t size_) : _data(data_), _size(size_) {}
+
+        uint32_t get(const int nBits_)
+        {
+            refill();
+            _nBits -= nBits_;
+            _consumed += nBits_;
+            return static_cast<uint32_t>(_acc >> _nBits) & ((1u << nBits_) - 1);
+        }
+        // number of zeros before the next one, up to limit_. The one is consumed, the zeros at the limit are not followed by one
+        int getUnary(const int limit_)
+        {
+            refill();
+            const auto window = _acc << (64 - _nBits);
+            const int  zeros  = std::min(limit_, std::countl_zero(window));
+            const int  used   = zeros < limit_ ? zeros + 1 : zeros;
+            _nBits -= used;
+            _consumed += used;
+            return zeros;
+        }
+        // false if more bits were read than there are
+        bool isValid() const { return _consumed <= 8 * _size; }
+
+    private:
+        void refill()
+        {
+            // past the end of the data, zeros are read
+            while (_nBits <= 56)
+            {
+                _acc = (_acc << 8) | (_pos < _size ? _data[_pos] : 0);
+                _pos++;
+                _nBits += 8;
+            }
+        }
+
+    private:
+        const uint8_t*  _data;
+        size_t          _size;
+        size_t          _pos      = 0;
+        uint64_t        _acc      = 0;
+        int             _nBits    = 0;
+        size_t          _consumed = 0;
+    };
+}
+
+namespace EyeImageCodec
+{
+    bool compress(const uint8_t* pixels_, const int width_, const int height_, std::vector<uint8_t>& out_)
+    {
+        const auto nPixels = static_cast<size_t>(width_) * height_;
+        out_.clear();
+        out_.reserve(nPixels / 2);
+        out_.push_back(formatVersion);
+
+        std::array<context, nContexts> contexts{};
+        bitWriter w(out_);
+        for (int y = 0; y < height_; y++)
+        {
+            const auto row = pixels_ + static_cast<size_t>(y) * width_;
+            forEachPixel(row, y ? row - width_ : nullptr, width_, [&](const int x_, const int a_, const int b_, const int c_)
+            {
+                auto& ctx    = contexts[getContext(a_, b_, c_)];
+                const auto k = ctx.k();
+                const auto m = mapResidual(row[x_], predict(a_, b_, c_));
+                const auto q = static_cast<int>(m >> k);
+                if (q < unaryLimit)
+                    w.put((1u << k) | (m & ((1u << k) - 1)), q + 1 + k);   // q zeros, a one, and the k low bits
+                else
+                    w.put(m, unaryLimit + 8);                               // escape: unaryLimit zeros and the raw value
+                ctx.update(m);
+            });
+            // give up as soon as it is clear that the frame does not get smaller
+            if (out_.size() >= nPixels)
+                return false;
+        }
+        w.flush();
+        return out_.size() < nPixels;
+    }
+
+    bool decompress(const uint8_t* data_, const size_t size_, const int width_, const int height_, std::vector<uint8_t>& pixels_)
+    {
+        if (!size_ || data_[0] != formatVersion || width_ <= 0 || height_ <= 0)
+            return false;
+
+        pixels_.resize(static_cast<size_t>(width_) * height_);
+        std::array<context, nContexts> contexts{};
+        bitReader r(data_ + 1, size_ - 1);
+        bool valid = true;
+        for (int y = 0; y < height_ && valid; y++)
+        {
+            const auto row = pixels_.data() + static_cast<size_t>(y) * width_;
+            forEachPixel(row, y ? row - width_ : nullptr, width_, [&](const int x_, const int a_, const int b_, const int c_)
+            {
+                auto& ctx    = contexts[getContext(a_, b_, c_)];
+                const auto k = ctx.k();
+                const auto q = r.getUnary(unaryLimit);
+                uint32_t m;
+                if (q < unaryLimit)
+                    m = (static_cast<uint32_t>(q) << k) | (k ? r.get(k) : 0);
+                else
+                    m = r.get(8);
+                valid &= m < 256;
+                row[x_] = unmapResidual(m, predict(a_, b_, c_));
+                ctx.update(m);
+            });
+        }
+        return valid && r.isValid();
+    }
+}
@@ -0,0 +1,210 @@
+#include "Titta/eyeImageReducer.h"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+
+#include "Titta/utils.h"
+
+namespace
+{
+    // sums of F horizontally adjacent pixels of a row, added to acc_. Written so that the compiler
+    // vectorizes it, with the common factors as compile-time constants
+    template <int F>
+    void boxRow(const uint8_t* row_, uint32_t* acc_, const int outWidth_)
+    {
+        for (int x = 0; x < outWidth_; x++)
+        {
+            uint32_t s = 0;
+            for (int k = 0; k < F; k++)
+                s += row_[x * F + k];
+            acc_[x] += s;
+        }
+    }
+    void boxRow(const uint8_t* row_, uint32_t* acc_, const int outWidth_, const int f_)
+    {
+        switch (f_)
+        {
+            case 2: return boxRow<2>(row_, acc_, outWidth_);
+            case 3: return boxRow<3>(row_, acc_, outWidth_);
+            case 4: return boxRow<4>(row_, acc_, outWidth_);
+            default:
+                for (int x = 0; x < outWidth_; x++)
+                {
+                    uint32_t s = 0;
+                    for (int k = 0; k < f_; k++)
+                        s += row_[x * f_ + k];
+                    acc_[x] += s;
+                }
+        }
+    }
+
+    // mean of each f_ x f_ block of the image. Pixels beyond the last whole block are dropped
+    void downscale(const uint8_t* in_, const int width_, const int height_, const int f_, std::vector<uint8_t>& out_, int& outWidth_, int& outHeight_)
+    {
+        outWidth_  = width_  / f_;
+        outHeight_ = height_ / f_;
+        out_.resize(static_cast<size_t>(outWidth_) * outHeight_);
+        std::vector<uint32_t> acc(outWidth_);
+        const uint32_t n    = static_cast<uint32_t>(f_ * f_);
+        const uint32_t half = n / 2;
+        for (int y = 0; y < outHeight_; y++)
+        {
+            std::ranges::fill(acc, 0u);
+            for (int r = 0; r < f_; r++)
+                boxRow(in_ + static_cast<size_t>(y * f_ + r) * width_, acc.data(), outWidth_, f_);
+            auto dst = out_.data() + static_cast<size_t>(y) * outWidth_;
+            for (int x = 0; x < outWidth_; x++)
+                dst[x] = static_cast<uint8_t>((acc[x] + half) / n);
+        }
+    }
+
+    // centre of the darkest region of the image, which in dark-pupil images is the pupil. The image is
+    // reduced to blocks, and the darkest 3x3 blocks window (about the size of a pupil) is taken
+    void findPupil(const uint8_t* in_, const int width_, const int height_, int& x_, int& y_)
+    {
+        const int block = std::max(2, std::min(width_, height_) / 24);
+        std::vector<uint8_t> blocks;
+        int bw = 0, bh = 0;
+        downscale(in_, width_, height_, block, blocks, bw, bh);
+        x_ = width_ / 2;
+        y_ = height_ / 2;
+        if (bw < 3 || bh < 3)
+            return;
+
+        uint32_t best = std::numeric_limits<uint32_t>::max();
+        for (int by = 1; by < bh - 1; by++)
+            for (int bx = 1; bx < bw - 1; bx++)
+            {
+                uint32_t s = 0;
+                for (int dy = -1; dy <= 1; dy++)
+                    for (int dx = -1; dx <= 1; dx++)
+                        s += blocks[static_cast<size_t>(by + dy) * bw + bx + dx];
+                if (s < best)
+                {
+                    best = s;
+                    x_   = bx * block + block / 2;
+                    y_   = by * block + block / 2;
+                }
+            }
+    }
+}
+
+EyeImageReducer::Crop EyeImageReducer::stringToCrop(const std::string& crop_)
+{
+    if (crop_ == "none")
+        return Crop::None;
+    if (crop_ == "fixed")
+        return Crop::Fixed;
+    if (crop_ == "pupil")
+        return Crop::Pupil;
+    DoExitWithMsg(R"(Titta::cpp::setEyeImageReduction: Requested crop mode ")" + crop_ + R"(" is not recognized. Supported modes are: "none", "fixed", "pupil")");
+}
+std::string EyeImageReducer::cropToString(const Crop crop_)
+{
+    switch (crop_)
+    {
+        case Crop::None:
+            return "none";
+        case Crop::Fixed:
+            return "fixed";
+        case Crop::Pupil:
+            return "pupil";
+    }
+    return "none";
+}
+
+void EyeImageReducer::setOptions(const options& options_)
+{
+    std::lock_guard lock(_mutex);
+    _options = options_;
+    _frameCounts.clear();
+}
+EyeImageReducer::options EyeImageReducer::getOptions() const
+{
+    std::lock_guard lock(_mutex);
+    return _options;
+}
+
+bool EyeImageReducer::process(TobiiTypes::eyeImage& image_)
+{
+    options opts;
+    {
+        std::lock_guard lock(_mutex);
+        if (_options.isPlain())
+            return true;
+        // keep the first frame of each camera, and every keepEveryN-th after it
+        if (_options.keepEveryN > 1 && _frameCounts[image_.camera_id]++ % _options.keepEveryN)
+            return false;
+        opts = _options;
+    }
+    reduce(image_, opts);
+    return true;
+}
+
+void EyeImageReducer::reduce(TobiiTypes::eyeImage& image_, const options& options_)
+{
+    if (image_.is_gif || image_.bits_per_pixel + image_.padding_per_pixel != 8 || (options_.crop == Crop::None && options_.downscale <= 1))
+        return;
+    const auto in = static_cast<const uint8_t*>(image_.data());
+    int width  = image_.width;
+    int height = image_.height;
+    if (!in || width <= 0 || height <= 0 || image_.data_size < static_cast<size_t>(width) * height)
+        return;
+
+    // determine crop rectangle, clipped to the image
+    int left = 0, top = 0;
+    switch (options_.crop)
+    {
+        case Crop::None:
+            break;
+        case Crop::Fixed:
+        {
+            const auto [l, t, w, h] = options_.cropRect;
+            const int right  = std::min(width,  l + w);
+            const int bottom = std::min(height, t + h);
+            left = std::max(0, l);
+            top  = std::max(0, t);
+            if (right <= left || bottom <= top)
+                return;     // rectangle does not overlap the image, keep it whole
+            width  = right  - left;
+            height = bottom - top;
+            break;
+        }
+        case Crop::Pupil:
+        {
+            // window centred on the pupil, shifted inward where it would extend beyond the image
+            int cx, cy;
+            findPupil(in, width, height, cx, cy);
+            const int w = std::clamp(options_.cropRect[2], 1, width);
+            const int h = std::clamp(options_.cropRect[3], 1, height);
+            left   = std::clamp(cx - w / 2, 0, width  - w);
+            top    = std::clamp(cy - h / 2, 0, height - h);
+            width  = w;
+            height = h;
+            break;
+        }
+    }
+
+    // crop
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++)
+        std::copy_n(in + static_cast<size_t>(top + y) * image_.width + left, width, pixels.data() + static_cast<size_t>(y) * width);
+
+    // downscale, unless the image would have no pixels left
+    int factor = 1;
+    if (options_.downscale > 1 && width >= options_.downscale && height >= options_.downscale)
+    {
+        std::vector<uint8_t> scaled;
+        downscale(pixels.data(), width, height, options_.downscale, scaled, width, height);
+        pixels = std::move(scaled);
+        factor = options_.downscale;
+    }
+
+    image_.setData(pixels.data(), pixels.size());
+    image_.width     = width;
+    image_.height    = height;
+    image_.crop_left = left;
+    image_.crop_top  = top;
+    image_.downscale = factor;
+}
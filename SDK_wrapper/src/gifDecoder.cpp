@@ -0,0 +1,323 @@
+#include "Titta/gifDecoder.h"
+#include <array>
+#include <cstring>
+
+namespace
+{
+    constexpr int    maxCodeBits = 12;          // LZW codes are at most 12 bits in a GIF
+    constexpr size_t maxPixels   = 1 << 24;     // way beyond any eye image, guards against corrupt sizes
+
+    uint16_t readU16(const uint8_t* p_)
+    {
+        return static_cast<uint16_t>(p_[0] | (p_[1] << 8));
+    }
+
+    // bounds-checked reading of the file
+    struct reader
+    {
+        const uint8_t*  data;
+        size_t          size;
+        size_t          pos = 0;
+
+        bool has(const size_t n_) const { return size - pos >= n_; }
+        const uint8_t* take(const size_t n_) { const auto p = data + pos; pos += n_; return p; }
+    };
+
+    // palette entry to luminance (ITU-R BT.601 weights)
+    using palette = std::array<uint8_t, 256>;
+    void readPalette(const uint8_t* p_, const size_t n_, palette& out_)
+    {
+        out_.fill(0);
+        for (size_t i = 0; i < n_; i++)
+        {
+            const auto r = p_[3 * i], g = p_[3 * i + 1], b = p_[3 * i + 2];
+            out_[i] = static_cast<uint8_t>((299 * r + 587 * g + 114 * b + 500) / 1000);
+        }
+    }
+
+    // concatenates the data sub-blocks of an image. Returns false if the file is truncated
+    bool readSubBlocks(reader& r_, std::vector<uint8_t>& out_)
+    {
+        while (true)
+        {
+            if (!r_.has(1))
+                return false;
+            const auto n = *r_.take(1);
+            if (!n)
+                return true;
+            if (!r_.has(n))
+                return false;
+            const auto p = r_.take(n);
+            out_.insert(out_.end(), p, p + n);
+        }
+    }
+    bool skipSubBlocks(reader& r_)
+    {
+        while (true)
+        {
+            if (!r_.has(1))
+                return false;
+            const auto n = *r_.take(1);
+            if (!n)
+                return true;
+            if (!r_.has(n))
+                return false;
+            r_.take(n);
+        }
+    }
+
+    // LZW decompression of the image data to palette indices. Stops when nPixels_
+    // are decoded or at the end of information code. Returns false on corrupt data
+    bool decompress(const std::vector<uint8_t>& in_, const int minCodeSize_, std::vector<uint8_t>& out_, const size_t nPixels_)
+    {
+        if (minCodeSize_ < 2 || minCodeSize_ > 8)
+            return false;
+
+        const int clearCode = 1 << minCodeSize_;
+        const int endCode   = clearCode + 1;
+
+        // each code is stored as its prefix code and last byte. Strings are written
+        // to the output back to front, using their known length
+        std::array<uint16_t, 1 << maxCodeBits> prefix;
+        std::array<uint8_t , 1 << maxCodeBits> suffix;
+        std::array<uint8_t , 1 << maxCodeBits> first;
+        std::array<uint16_t, 1 << maxCodeBits> length;
+        for (int i = 0; i < clearCode; i++)
+        {
+            prefix[i] = 0;
+            suffix[i] = first[i] = static_cast<uint8_t>(i);
+            length[i] = 1;
+        }
+
+        int codeSize = minCodeSize_ + 1;
+        int nextCode = endCode + 1;
+        int prevCode = -1;
+        uint32_t bits = 0;
+        int nBits = 0;
+
+        out_.clear();
+        out_.reserve(nPixels_);
+        size_t i = 0;
+        while (out_.size() < nPixels_)
+        {
+            // gather enough bits for the next code
+            while (nBits < codeSize && i < in_.size())
+            {
+                bits |= static_cast<uint32_t>(in_[i++]) << nBits;
+                nBits += 8;
+            }
+            if (nBits < codeSize)
+                break;
+            const int code = static_cast<int>(bits & ((1u << codeSize) - 1));
+            bits  >>= codeSize;
+            nBits  -= codeSize;
+
+            if (code == clearCode)
+            {
+                codeSize = minCodeSize_ + 1;
+                nextCode = endCode + 1;
+                prevCode = -1;
+                continue;
+            }
+            if (code == endCode)
+                break;
+
+            int outCode = code;
+            if (code >= nextCode)
+            {
+                // only the code that is about to be defined may be used before definition
+                if (code != nextCode || prevCode < 0)
+                    return false;
+                outCode = prevCode;
+            }
+
+            // output the string of outCode (and for the not-yet-defined code, its first byte again)
+            const auto len   = length[outCode];
+            const auto start = out_.size();
+            out_.resize(start + len);
+            for (int c = outCode, j = len - 1; j >= 0; c = prefix[c], j--)
+                out_[start + j] = suffix[c];
+            if (code != outCode)
+                out_.push_back(first[outCode]);
+
+            // define new code: previous string plus first byte of current
+            if (prevCode >= 0 && nextCode < (1 << maxCodeBits))
+            {
+                prefix[nextCode] = static_cast<uint16_t>(prevCode);
+                suffix[nextCode] = first[outCode];
+                first [nextCode] = first[prevCode];
+                length[nextCode] = static_cast<uint16_t>(length[prevCode] + 1);
+                nextCode++;
+                if (nextCode == (1 << codeSize) && codeSize < maxCodeBits)
+                    codeSize++;
+            }
+            prevCode = code;
+        }
+        if (out_.size() > nPixels_)
+            out_.resize(nPixels_);
+        return true;
+    }
+}
+
+namespace GifDecoder
+{
+    bool decode(const uint8_t* data_, const size_t size_, std::vector<uint8_t>& pixels_, int& width_, int& height_, std::string& error_)
+    {
+        reader r{ data_, size_ };
+
+        // header and logical screen descriptor
+        if (!r.has(13) || (std::memcmp(data_, "GIF87a", 6) && std::memcmp(data_, "GIF89a", 6)))
+        {
+            error_ = "not a GIF file";
+            return false;
+        }
+        r.take(6);
+        const auto lsd      = r.take(7);
+        const int  width    = readU16(lsd);
+        const int  height   = readU16(lsd + 2);
+        const auto flags    = lsd[4];
+        if (!width || !height)
+        {
+            error_ = "GIF has no size";
+            return false;
+        }
+        if (static_cast<size_t>(width) * height > maxPixels)
+        {
+            error_ = "GIF is too large";
+            return false;
+        }
+
+        palette globalPal{}, localPal{};
+        bool hasGlobalPal = false;
+        if (flags & 0x80)
+        {
+            const size_t n = size_t{ 2 } << (flags & 0x07);
+            if (!r.has(3 * n))
+            {
+                error_ = "GIF is truncated";
+                return false;
+            }
+            readPalette(r.take(3 * n), n, globalPal);
+            hasGlobalPal = true;
+        }
+
+        // find the first image, skipping extensions
+        while (true)
+        {
+            if (!r.has(1))
+            {
+                error_ = "GIF is truncated";
+                return false;
+            }
+            const auto blockType = *r.take(1);
+            if (blockType == 0x21)         // extension
+            {
+                if (!r.has(1) || (r.take(1), !skipSubBlocks(r)))
+                {
+                    error_ = "GIF is truncated";
+                    return false;
+                }
+                continue;
+            }
+            if (blockType == 0x3B)         // trailer
+            {
+                error_ = "GIF contains no image";
+                return false;
+            }
+            if (blockType != 0x2C)
+            {
+                error_ = "GIF contains an unknown block";
+                return false;
+            }
+            break;
+        }
+
+        // image descriptor
+        if (!r.has(9))
+        {
+            error_ = "GIF is truncated";
+            return false;
+        }
+        const auto desc     = r.take(9);
+        const int  left     = readU16(desc);
+        const int  top      = readU16(desc + 2);
+        const int  imWidth  = readU16(desc + 4);
+        const int  imHeight = readU16(desc + 6);
+        const auto imFlags  = desc[8];
+        const bool interlaced = imFlags & 0x40;
+        const palette* pal = hasGlobalPal ? &globalPal : nullptr;
+        if (imFlags & 0x80)
+        {
+            const size_t n = size_t{ 2 } << (imFlags & 0x07);
+            if (!r.has(3 * n))
+            {
+                error_ = "GIF is truncated";
+                return false;
+            }
+            readPalette(r.take(3 * n), n, localPal);
+            pal = &localPal;
+        }
+        if (!pal)
+        {
+            error_ = "GIF has no color table";
+            return false;
+        }
+
+        // image data
+        if (!r.has(1))
+        {
+            error_ = "GIF is truncated";
+            return false;
+        }
+        const int minCodeSize = *r.take(1);
+        std::vector<uint8_t> compressed;
+        if (!readSubBlocks(r, compressed))
+        {
+            error_ = "GIF is truncated";
+            return false;
+        }
+        std::vector<uint8_t> indices;
+        const auto nPixels = static_cast<size_t>(imWidth) * imHeight;
+        if (nPixels > maxPixels)
+        {
+            error_ = "GIF is too large";
+            return false;
+        }
+        if (!decompress(compressed, minCodeSize, indices, nPixels))
+        {
+            error_ = "GIF image data is corrupt";
+            return false;
+        }
+        indices.resize(nPixels, 0);     // missing pixels (truncated data) are given index 0
+
+        // place image on canvas, converting palette indices to luminance
+        pixels_.assign(static_cast<size_t>(width) * height, (*pal)[0]);
+        auto putRow = [&](const int srcRow_, const int dstRow_)
+        {
+            const int y = top + dstRow_;
+            if (y >= height)
+                return;
+            const auto src = indices.data() + static_cast<size_t>(srcRow_) * imWidth;
+            auto       dst = pixels_.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < imWidth && left + x < width; x++)
+                dst[left + x] = (*pal)[src[x]];
+        };
+        if (!interlaced)
+            for (int row = 0; row < imHeight; row++)
+                putRow(row, row);
+        else
+        {
+            // rows are stored in four passes: every 8th from 0, every 8th from 4, every 4th from 2, every 2nd from 1
+            constexpr std::array<int, 4> passStart = { 0, 4, 2, 1 };
+            constexpr std::array<int, 4> passStep  = { 8, 8, 4, 2 };
+            int srcRow = 0;
+            for (size_t p = 0; p < passStart.size(); p++)
+                for (int row = passStart[p]; row < imHeight; row += passStep[p])
+                    putRow(srcRow++, row);
+        }
+
+        width_  = width;
+        height_ = height;
+        return true;
+    }
+}
@@ -0,0 +1,92 @@
+#include "Titta/latency.h"
+#include <bit>
+#include <algorithm>
+#include <cmath>
+
+
+size_t LatencyHistogram::valueToIndex(const uint64_t value_)
+{
+    // first 2*_subBucketHalf values map one-to-one onto a bucket, above that each
+    // power of two is split into _subBucketHalf buckets
+    if (value_ < (1ull << _subBucketBits))
+        return static_cast<size_t>(value_);
+    const auto shift = std::bit_width(value_) - _subBucketBits;
+    const auto sub   = value_ >> shift;     // in [_subBucketHalf, 2*_subBucketHalf)
+    return (1 << _subBucketBits) + (shift - 1) * _subBucketHalf + static_cast<size_t>(sub - _subBucketHalf);
+}
+
+int64_t LatencyHistogram::indexToValue(const size_t index_)
+{
+    if (index_ < (1 << _subBucketBits))
+        return static_cast<int64_t>(index_);
+    const auto k     = index_ - (1 << _subBucketBits);
+    const auto shift = static_cast<int>(k / _subBucketHalf) + 1;
+    const auto sub   = static_cast<int64_t>(k % _subBucketHalf) + _subBucketHalf;
+    return (sub << shift) + (int64_t{1} << (shift - 1));
+}
+
+void LatencyHistogram::record(int64_t value_)
+{
+    // negative values can occur when clocks are adjusted, count those as zero latency
+    value_ = std::clamp<int64_t>(value_, 0, (int64_t{1} << _maxValueBits) - 1);
+
+    _counts[valueToIndex(static_cast<uint64_t>(value_))].fetch_add(1, std::memory_order_relaxed);
+    _total.fetch_add(1, std::memory_order_relaxed);
+    _sum  .fetch_add(static_cast<uint64_t>(value_), std::memory_order_relaxed);
+
+    auto cur = _min.load(std::memory_order_relaxed);
+    while (value_ < cur && !_min.compare_exchange_weak(cur, value_, std::memory_order_relaxed)) {}
+    cur = _max.load(std::memory_order_relaxed);
+    while (value_ > cur && !_max.compare_exchange_weak(cur, value_, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& c : _counts)
+        c.store(0, std::memory_order_relaxed);
+    _total.store(0, std::memory_order_relaxed);
+    _sum  .store(0, std::memory_order_relaxed);
+    _min  .store(INT64_MAX, std::memory_order_relaxed);
+    _max  .store(0, std::memory_order_relaxed);
+}
+
+TobiiTypes::latencySummary LatencyHistogram::getSummary() const
+{
+    TobiiTypes::latencySummary out;
+
+    // take a copy of the counts, so percentiles are computed on a consistent set
+    std::array<uint64_t, _nBuckets> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < _nBuckets; i++)
+    {
+        counts[i] = _counts[i].load(std::memory_order_relaxed);
+        total    += counts[i];
+    }
+    if (!total)
+        return out;
+
+    out.count = total;
+    out.min   = _min.load(std::memory_order_relaxed);
+    out.max   = _max.load(std::memory_order_relaxed);
+    out.mean  = static_cast<double>(_sum.load(std::memory_order_relaxed)) / static_cast<double>(_total.load(std::memory_order_relaxed));
+
+    auto percentile = [&](const double p_)
+    {
+        const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p_ / 100. * static_cast<double>(total))));
+        uint64_t cum = 0;
+        for (size_t i = 0; i < _nBuckets; i++)
+        {
+            cum += counts[i];
+            if (cum >= target)
+                // bucket midpoint, but never outside the observed range
+                return std::clamp(indexToValue(i), out.min, out.max);
+        }
+        return out.max;
+    };
+    out.p50   = percentile(50.);
+    out.p90   = percentile(90.);
+    out.p99   = percentile(99.);
+    out.p99_9 = percentile(99.9);
+
+    return out;
+}
@@ -0,0 +1,80 @@
+#include "Titta/logSink.h"
+#include <filesystem>
+#include <algorithm>
+#include <cinttypes>
+
+#include "Titta/utils.h"
+
+namespace
+{
+    // keep one entry per line
+    std::string sanitize(std::string str_)
+    {
+        std::ranges::replace_if(str_, [](const char c_) { return c_ == '\t' || c_ == '\n' || c_ == '\r'; }, ' ');
+        return str_;
+    }
+
+    std::string rotatedName(const std::string& fileName_, const size_t i_)
+    {
+        return fileName_ + "." + std::to_string(i_);
+    }
+}
+
+LogFileSink::LogFileSink(std::string fileName_, uint64_t maxBytes_, size_t maxFiles_) :
+    _fileName(std::move(fileName_)),
+    _maxBytes(maxBytes_),
+    _maxFiles(std::max<size_t>(maxFiles_, 1))
+{
+    if (!open())
+        DoExitWithMsg("Titta::cpp::LogFileSink: Cannot open file \"" + _fileName + "\" for writing");
+}
+
+void LogFileSink::write(const std::variant<TobiiTypes::logMessage, TobiiTypes::streamErrorMessage>& entry_)
+{
+    const auto line = std::visit([]<typename T>(const T& e_) -> std::string
+    {
+        if constexpr (std::is_same_v<T, TobiiTypes::logMessage>)
+            return string_format("log\t%" PRId64 "\t%s\t%s\t\t%s\n", e_.system_time_stamp, TobiiResearchLogSourceToString(e_.source).c_str(), TobiiResearchLogLevelToString(e_.level).c_str(), sanitize(e_.message).c_str());
+        else
+            return string_format("stream error\t%" PRId64 "\t%s\t%s\t%s\t%s\n", e_.system_time_stamp, TobiiResearchStreamErrorSourceToString(e_.source).c_str(), TobiiResearchStreamErrorToString(e_.error).c_str(), sanitize(e_.machine_serial).c_str(), sanitize(e_.message).c_str());
+    }, entry_);
+
+    if (_maxBytes && _bytesWritten + line.size() > _maxBytes && _bytesWritten)
+        rotate();
+    _file << line;
+    _bytesWritten += line.size();
+}
+
+void LogFileSink::flush()
+{
+    _file.flush();
+}
+
+bool LogFileSink::open()
+{
+    _file.open(_fileName, std::ios::out | std::ios::trunc);
+    if (!_file)
+        return false;
+    const std::string header = "type\tsystem_time_stamp\tsource\tlevel_or_error\tmachine_serial\tmessage\n";
+    _file << header;
+    _bytesWritten = header.size();
+    return true;
+}
+
+void LogFileSink::rotate()
+{
+    _file.close();
+
+    // shift older files up by one, the oldest falls off the end
+    std::error_code ec;
+    if (_maxFiles > 1)
+    {
+        std::filesystem::remove(rotatedName(_fileName, _maxFiles - 1), ec);
+        for (size_t i = _maxFiles - 1; i > 1; i--)
+            std::filesystem::rename(rotatedName(_fileName, i - 1), rotatedName(_fileName, i), ec);
+        std::filesystem::rename(_fileName, rotatedName(_fileName, 1), ec);
+    }
+
+    // NB: this runs on the log sink thread, can't error out. If reopening fails, further writes are lost
+    open();
+}
@@ -0,0 +1,242 @@
+#include "Titta/pinnedAllocator.h"
+#include <new>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   include <Windows.h>
+#else
+#   include <sys/mman.h>
+#   include <sys/resource.h>
+#   include <unistd.h>
+#endif
+
+#include "Titta/utils.h"
+
+namespace
+{
+    size_t roundUp(const size_t bytes_, const size_t multiple_)
+    {
+        return (bytes_ + multiple_ - 1) / multiple_ * multiple_;
+    }
+    void appendError(std::string& errors_, const std::string& what_)
+    {
+        if (!errors_.empty())
+            errors_ += "; ";
+        errors_ += what_;
+    }
+
+    size_t getPageSize()
+    {
+        static const size_t pageSize = []() -> size_t
+        {
+#ifdef _WIN32
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return info.dwPageSize;
+#else
+            return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+        }();
+        return pageSize;
+    }
+    size_t getHugePageSize()
+    {
+        static const size_t hugePageSize = []() -> size_t
+        {
+#if defined(_WIN32)
+            if (const auto size = GetLargePageMinimum())
+                return size;
+#elif defined(__linux__)
+            std::ifstream meminfo("/proc/meminfo");
+            std::string key;
+            size_t kB = 0;
+            while (meminfo >> key)
+            {
+                if (key == "Hugepagesize:" && meminfo >> kB)
+                    return kB * 1024;
+                meminfo.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            }
+#endif
+            return size_t{ 2 } << 20;
+        }();
+        return hugePageSize;
+    }
+    // length of the allocation for a request of bytes_, must be the same for allocate and deallocate
+    size_t getAllocationLength(const size_t bytes_, const PinnedMemory::options& options_)
+    {
+        return roundUp(bytes_, options_.hugePages == PinnedMemory::HugePages::None ? getPageSize() : getHugePageSize());
+    }
+
+    void prefault(void* ptr_, const size_t length_)
+    {
+        // write to each page, so that it gets backed now instead of on first use
+        const auto pageSize = getPageSize();
+        const auto p = static_cast<volatile char*>(ptr_);
+        for (size_t i = 0; i < length_; i += pageSize)
+            p[i] = 0;
+    }
+
+#ifndef _WIN32
+    // anonymous mapping of length_ bytes, aligned to alignment_
+    void* mapAligned(const size_t length_, const size_t alignment_)
+    {
+        if (alignment_ <= getPageSize())
+        {
+            void* p = mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            return p == MAP_FAILED ? nullptr : p;
+        }
+        const auto mapLength = length_ + alignment_;
+        void* p = mmap(nullptr, mapLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            return nullptr;
+        // unmap the unaligned head and the tail
+        const auto start   = reinterpret_cast<uintptr_t>(p);
+        const auto aligned = roundUp(start, alignment_);
+        if (aligned > start)
+            munmap(p, aligned - start);
+        if (const auto tail = start + mapLength - (aligned + length_))
+            munmap(reinterpret_cast<void*>(aligned + length_), tail);
+        return reinterpret_cast<void*>(aligned);
+    }
+#endif
+}
+
+namespace PinnedMemory
+{
+    HugePages stringToHugePages(const std::string& hugePages_)
+    {
+        if (hugePages_ == "none")
+            return HugePages::None;
+        if (hugePages_ == "transparent")
+            return HugePages::Transparent;
+        if (hugePages_ == "explicit")
+            return HugePages::Explicit;
+        DoExitWithMsg(R"(Titta::cpp::setBufferAllocation: Requested huge pages mode ")" + hugePages_ + R"(" is not recognized. Supported modes are: "none", "transparent", "explicit")");
+    }
+    std::string hugePagesToString(const HugePages hugePages_)
+    {
+        switch (hugePages_)
+        {
+            case HugePages::None:           return "none";
+            case HugePages::Transparent:    return "transparent";
+            case HugePages::Explicit:       return "explicit";
+        }
+        return "unknown";
+    }
+
+    void* allocate(const size_t bytes_, const options& options_, status& status_)
+    {
+        const auto length = getAllocationLength(bytes_, options_);
+        status result;
+        result.bytes = bytes_;
+        void* p = nullptr;
+
+#ifdef _WIN32
+        if (options_.hugePages == HugePages::Explicit)
+        {
+            // needs the "Lock pages in memory" privilege
+            p = VirtualAlloc(nullptr, length, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (p)
+                // large pages are always resident
+                result.hugePages = result.prefaulted = result.locked = true;
+            else
+                appendError(result.error, string_format("explicit huge pages unavailable (error %lu), the process needs the SeLockMemoryPrivilege", GetLastError()));
+        }
+        else if (options_.hugePages == HugePages::Transparent)
+            appendError(result.error, "transparent huge pages are not available on this platform");
+        if (!p)
+            p = VirtualAlloc(nullptr, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!p)
+            throw std::bad_alloc();
+        if (options_.prefault && !result.prefaulted)
+        {
+            prefault(p, length);
+            result.prefaulted = true;
+        }
+        if (options_.lock && !result.locked)
+        {
+            if (VirtualLock(p, length))
+                result.locked = true;
+            else
+                appendError(result.error, string_format("cannot lock memory (error %lu), the process' working set may be too small", GetLastError()));
+        }
+#else
+#   ifdef MAP_HUGETLB
+        if (options_.hugePages == HugePages::Explicit)
+        {
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p == MAP_FAILED)
+            {
+                p = nullptr;
+                appendError(result.error, std::string("explicit huge pages unavailable, using transparent huge pages instead: ") + std::strerror(errno) + " (are huge pages reserved in /proc/sys/vm/nr_hugepages?)");
+            }
+            else
+                result.hugePages = true;
+        }
+#   else
+        if (options_.hugePages == HugePages::Explicit)
+            appendError(result.error, "explicit huge pages are not available on this platform");
+#   endif
+        if (!p)
+        {
+            // for huge pages to be usable throughout, align to the huge page size
+            p = mapAligned(length, options_.hugePages == HugePages::None ? getPageSize() : getHugePageSize());
+            if (!p)
+                throw std::bad_alloc();
+#   ifdef MADV_HUGEPAGE
+            if (options_.hugePages != HugePages::None)
+            {
+                if (madvise(p, length, MADV_HUGEPAGE))
+                    appendError(result.error, std::string("cannot use transparent huge pages: ") + std::strerror(errno));
+                else
+                    result.hugePages = true;
+            }
+#   else
+            if (options_.hugePages == HugePages::Transparent)
+                appendError(result.error, "transparent huge pages are not available on this platform");
+#   endif
+        }
+        if (options_.prefault)
+        {
+            prefault(p, length);
+            result.prefaulted = true;
+        }
+        if (options_.lock)
+        {
+            if (!mlock(p, length))
+                result.locked = true;
+            else
+            {
+                const auto err = errno;
+                rlimit limit{};
+                getrlimit(RLIMIT_MEMLOCK, &limit);
+                appendError(result.error, string_format("cannot lock memory: %s (%zu bytes requested, RLIMIT_MEMLOCK is %llu bytes)", std::strerror(err), length, static_cast<unsigned long long>(limit.rlim_cur)));
+            }
+        }
+#endif
+
+        result.ptr = p;
+        status_    = std::move(result);
+        return p;
+    }
+
+    void deallocate(void* ptr_, const size_t bytes_, const options& options_, status& status_) noexcept
+    {
+        if (!ptr_)
+            return;
+#ifdef _WIN32
+        (void)bytes_; (void)options_;
+        // lock is released along with the memory
+        VirtualFree(ptr_, 0, MEM_RELEASE);
+#else
+        munmap(ptr_, getAllocationLength(bytes_, options_));
+#endif
+        if (status_.ptr == ptr_)
+            status_ = {};
+    }
+}
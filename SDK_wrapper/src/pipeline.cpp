@@ -0,0 +1,323 @@
+#include "Titta/pipeline.h"
+#include <algorithm>
+#include <deque>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <ranges>
+#include <optional>
+#include <utility>
+
+#include "Titta/utils.h"
+
+namespace
+{
+    constexpr auto nan = std::numeric_limits<double>::quiet_NaN();
+
+    double getParam(const GazePipeline::params& params_, const std::string& name_, const double default_)
+    {
+        const auto it = params_.find(name_);
+        return it == params_.end() ? default_ : it->second;
+    }
+
+    bool isValid(const TobiiTypes::gazePoint& gp_)
+    {
+        return gp_.available && gp_.validity == TOBII_RESEARCH_VALIDITY_VALID;
+    }
+
+    //// built-in stages
+    // filter: moving average of gaze position on the display over the last N valid samples of each eye
+    class MovingAverageStage final : public PipelineStage
+    {
+    public:
+        explicit MovingAverageStage(const GazePipeline::params& params_)
+        {
+            const auto window = getParam(params_, "window", 3);
+            if (!(window >= 1))
+                DoExitWithMsg("Titta::cpp::GazePipeline: movingAverage stage: window must be at least 1");
+            _window = static_cast<size_t>(window);
+        }
+
+        void process(std::vector<TobiiTypes::gazeData>& samples_, std::vector<TobiiTypes::derivedSample>& output_) override
+        {
+            for (auto& s : samples_)
+            {
+                TobiiTypes::derivedSample out{ s.system_time_stamp, std::vector<double>(4, nan) };
+                size_t i = 0;
+                for (const auto eye : { &TobiiTypes::gazeData::left_eye, &TobiiTypes::gazeData::right_eye })
+                {
+                    auto& gp   = (s.*eye).gaze_point;
+                    auto& hist = _history[i / 2];
+                    if (isValid(gp))
+                    {
+                        hist.push_back(gp.position_on_display_area);
+                        if (hist.size() > _window)
+                            hist.pop_front();
+                        double x = 0., y = 0.;
+                        for (const auto& p : hist)
+                        {
+                            x += p.x;
+                            y += p.y;
+                        }
+                        gp.position_on_display_area = { static_cast<float>(x / hist.size()), static_cast<float>(y / hist.size()) };
+                        out.values[i]     = gp.position_on_display_area.x;
+                        out.values[i + 1] = gp.position_on_display_area.y;
+                    }
+                    else
+                        hist.clear();   // don't average across gaps
+                    i += 2;
+                }
+                output_.push_back(std::move(out));
+            }
+        }
+        std::vector<std::string> getChannels() const override { return { "left_x", "left_y", "right_x", "right_y" }; }
+
+    private:
+        size_t                                                  _window;
+        std::array<std::deque<TobiiResearchNormalizedPoint2D>, 2> _history;
+    };
+
+    // transform: average of both eyes' gaze position on the display and pupil diameter, using whichever eyes are valid
+    class BinocularAverageStage final : public PipelineStage
+    {
+    public:
+        explicit BinocularAverageStage(const GazePipeline::params&) {}
+
+        void process(std::vector<TobiiTypes::gazeData>& samples_, std::vector<TobiiTypes::derivedSample>& output_) override
+        {
+            for (const auto& s : samples_)
+            {
+                double x = 0., y = 0., pupil = 0.;
+                int nGaze = 0, nPupil = 0;
+                for (const auto eye : { &TobiiTypes::gazeData::left_eye, &TobiiTypes::gazeData::right_eye })
+                {
+                    const auto& e = s.*eye;
+                    if (isValid(e.gaze_point))
+                    {
+                        x += e.gaze_point.position_on_display_area.x;
+                        y += e.gaze_point.position_on_display_area.y;
+                        nGaze++;
+                    }
+                    if (e.pupil.available && e.pupil.validity == TOBII_RESEARCH_VALIDITY_VALID)
+                    {
+                        pupil += e.pupil.diameter;
+                        nPupil++;
+                    }
+                }
+                output_.push_back({ s.system_time_stamp, { nGaze ? x / nGaze : nan, nGaze ? y / nGaze : nan, nPupil ? pupil / nPupil : nan } });
+            }
+        }
+        std::vector<std::string> getChannels() const override { return { "x", "y", "pupil_diameter" }; }
+    };
+
+    // detector: velocity-threshold (I-VT) saccade detection. Angular velocity of each eye is computed from the gaze
+    // direction (gaze origin to gaze point in user coordinates) of consecutive samples, and averaged over valid eyes
+    class IVTStage final : public PipelineStage
+    {
+    public:
+        explicit IVTStage(const GazePipeline::params& params_) :
+            _threshold(getParam(params_, "threshold", 30.))     // deg/s
+        {}
+
+        void process(std::vector<TobiiTypes::gazeData>& samples_, std::vector<TobiiTypes::derivedSample>& output_) override
+        {
+            for (const auto& s : samples_)
+            {
+                double vel = 0.;
+                int n = 0;
+                size_t i = 0;
+                for (const auto eye : { &TobiiTypes::gazeData::left_eye, &TobiiTypes::gazeData::right_eye })
+                {
+                    const auto& e = s.*eye;
+                    auto& prev = _prev[i++];
+                    if (!isValid(e.gaze_point) || !e.gaze_origin.available || e.gaze_origin.validity != TOBII_RESEARCH_VALIDITY_VALID)
+                    {
+                        prev.reset();
+                        continue;
+                    }
+                    const auto& gp = e.gaze_point.position_in_user_coordinates;
+                    const auto& go = e.gaze_origin.position_in_user_coordinates;
+                    const std::array<double, 3> dir = { gp.x - go.x, gp.y - go.y, gp.z - go.z };
+                    if (prev && s.system_time_stamp > prev->first)
+                    {
+                        const auto& d = prev->second;
+                        const auto dot   = dir[0] * d[0] + dir[1] * d[1] + dir[2] * d[2];
+                        const auto norms = std::sqrt((dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]) * (d[0] * d[0] + d[1] * d[1] + d[2] * d[2]));
+                        const auto angle = std::acos(std::clamp(dot / norms, -1., 1.)) * 180. / std::numbers::pi;
+                        vel += angle / (static_cast<double>(s.system_time_stamp - prev->first) / 1'000'000.);
+                        n++;
+                    }
+                    prev = std::make_pair(s.system_time_stamp, dir);
+                }
+                const auto v = n ? vel / n : nan;
+                output_.push_back({ s.system_time_stamp, { v, n ? static_cast<double>(v > _threshold) : nan } });
+            }
+        }
+        std::vector<std::string> getChannels() const override { return { "velocity", "is_saccade" }; }
+
+    private:
+        double _threshold;
+        std::array<std::optional<std::pair<int64_t, std::array<double, 3>>>, 2> _prev;
+    };
+
+    template <typename S>
+    GazePipeline::factory makeFactory()
+    {
+        return [](const GazePipeline::params& params_) { return std::make_unique<S>(params_); };
+    }
+
+    struct registry
+    {
+        std::mutex                                      mutex;
+        std::map<std::string, GazePipeline::factory>    factories =
+        {
+            { "movingAverage",      makeFactory<MovingAverageStage>() },
+            { "binocularAverage",   makeFactory<BinocularAverageStage>() },
+            { "ivt",                makeFactory<IVTStage>() }
+        };
+    };
+    registry& getRegistry()
+    {
+        static registry r;
+        return r;
+    }
+}
+
+void GazePipeline::registerStageType(std::string type_, factory factory_)
+{
+    auto& r = getRegistry();
+    std::lock_guard lock(r.mutex);
+    r.factories.insert_or_assign(std::move(type_), std::move(factory_));
+}
+std::vector<std::string> GazePipeline::getStageTypes()
+{
+    auto& r = getRegistry();
+    std::lock_guard lock(r.mutex);
+    std::vector<std::string> out;
+    for (const auto& t : r.factories | std::views::keys)
+        out.push_back(t);
+    return out;
+}
+
+void GazePipeline::addStage(std::string name_, std::string type_, const params& params_)
+{
+    factory f;
+    {
+        auto& r = getRegistry();
+        std::lock_guard lock(r.mutex);
+        const auto it = r.factories.find(type_);
+        if (it == r.factories.end())
+            DoExitWithMsg("Titta::cpp::GazePipeline::addStage: stage type \"" + type_ + "\" is not known");
+        f = it->second;
+    }
+    auto s  = std::make_unique<stage>();
+    s->name = std::move(name_);
+    s->type = std::move(type_);
+    s->impl = f(params_);
+
+    std::scoped_lock lock(_stageMutex, _bufferMutex);
+    if (std::ranges::any_of(_stages, [&](const auto& s_) { return s_->name == s->name; }))
+        DoExitWithMsg("Titta::cpp::GazePipeline::addStage: a stage named \"" + s->name + "\" already exists");
+    _stages.push_back(std::move(s));
+}
+void GazePipeline::clear()
+{
+    std::scoped_lock lock(_stageMutex, _bufferMutex);
+    _stages.clear();
+}
+std::vector<std::tuple<std::string, std::string>> GazePipeline::getStages() const
+{
+    std::lock_guard lock(_bufferMutex);
+    std::vector<std::tuple<std::string, std::string>> out;
+    for (const auto& s : _stages)
+        out.emplace_back(s->name, s->type);
+    return out;
+}
+std::vector<std::string> GazePipeline::getChannels(const std::string& name_) const
+{
+    std::lock_guard lock(_bufferMutex);
+    return getStage(name_, "getChannels").impl->getChannels();
+}
+
+void GazePipeline::process(std::vector<TobiiTypes::gazeData> samples_)
+{
+    std::lock_guard lock(_stageMutex);
+    for (auto& s : _stages)
+    {
+        std::vector<TobiiTypes::derivedSample> out;
+        s->impl->process(samples_, out);
+        if (out.empty())
+            continue;
+        std::lock_guard lockBuf(_bufferMutex);
+        s->buffer.insert(s->buffer.end(), std::make_move_iterator(out.begin()), std::make_move_iterator(out.end()));
+        // drop the oldest, and a bit more so that this does not happen for every batch
+        if (s->buffer.size() > maxBufferedSamples)
+            s->buffer.erase(s->buffer.begin(), s->buffer.begin() + static_cast<ptrdiff_t>(s->buffer.size() - maxBufferedSamples + maxBufferedSamples / 16));
+    }
+}
+
+GazePipeline::stage& GazePipeline::getStage(const std::string& name_, const char* func_)
+{
+    return const_cast<stage&>(std::as_const(*this).getStage(name_, func_));
+}
+const GazePipeline::stage& GazePipeline::getStage(const std::string& name_, const char* func_) const
+{
+    // !NB: caller must hold _bufferMutex
+    const auto it = std::ranges::find_if(_stages, [&](const auto& s_) { return s_->name == name_; });
+    if (it == _stages.end())
+        DoExitWithMsg(std::string("Titta::cpp::") + func_ + ": no pipeline stage named \"" + name_ + "\"");
+    return **it;
+}
+std::tuple<size_t, size_t> GazePipeline::getRange(const stage& stage_, const size_t NSamp_, const bool fromStart_) const
+{
+    const auto size  = stage_.buffer.size();
+    const auto nSamp = std::min(NSamp_, size);
+    return fromStart_ ? std::tuple<size_t, size_t>{ 0, nSamp } : std::tuple<size_t, size_t>{ size - nSamp, size };
+}
+std::tuple<size_t, size_t> GazePipeline::getRange(const stage& stage_, const int64_t timeStart_, const int64_t timeEnd_) const
+{
+    // both sides inclusive
+    const auto& buf = stage_.buffer;
+    const auto s = std::ranges::lower_bound(buf, timeStart_, {}, &TobiiTypes::derivedSample::system_time_stamp);
+    const auto e = std::ranges::upper_bound(s, buf.end(), timeEnd_, {}, &TobiiTypes::derivedSample::system_time_stamp);
+    return { static_cast<size_t>(s - buf.begin()), static_cast<size_t>(e - buf.begin()) };
+}
+
+std::vector<TobiiTypes::derivedSample> GazePipeline::consumeN(const std::string& name_, const size_t NSamp_, const bool fromStart_)
+{
+    std::lock_guard lock(_bufferMutex);
+    auto& s = getStage(name_, "consumeDerivedN");
+    auto [iStart, iEnd] = getRange(s, NSamp_, fromStart_);
+    std::vector<TobiiTypes::derivedSample> out(std::make_move_iterator(s.buffer.begin() + iStart), std::make_move_iterator(s.buffer.begin() + iEnd));
+    s.buffer.erase(s.buffer.begin() + iStart, s.buffer.begin() + iEnd);
+    return out;
+}
+std::vector<TobiiTypes::derivedSample> GazePipeline::consumeTimeRange(const std::string& name_, const int64_t timeStart_, const int64_t timeEnd_)
+{
+    std::lock_guard lock(_bufferMutex);
+    auto& s = getStage(name_, "consumeDerivedTimeRange");
+    auto [iStart, iEnd] = getRange(s, timeStart_, timeEnd_);
+    std::vector<TobiiTypes::derivedSample> out(std::make_move_iterator(s.buffer.begin() + iStart), std::make_move_iterator(s.buffer.begin() + iEnd));
+    s.buffer.erase(s.buffer.begin() + iStart, s.buffer.begin() + iEnd);
+    return out;
+}
+std::vector<TobiiTypes::derivedSample> GazePipeline::peekN(const std::string& name_, const size_t NSamp_, const bool fromStart_)
+{
+    std::lock_guard lock(_bufferMutex);
+    const auto& s = getStage(name_, "peekDerivedN");
+    auto [iStart, iEnd] = getRange(s, NSamp_, fromStart_);
+    return { s.buffer.begin() + iStart, s.buffer.begin() + iEnd };
+}
+std::vector<TobiiTypes::derivedSample> GazePipeline::peekTimeRange(const std::string& name_, const int64_t timeStart_, const int64_t timeEnd_)
+{
+    std::lock_guard lock(_bufferMutex);
+    const auto& s = getStage(name_, "peekDerivedTimeRange");
+    auto [iStart, iEnd] = getRange(s, timeStart_, timeEnd_);
+    return { s.buffer.begin() + iStart, s.buffer.begin() + iEnd };
+}
+void GazePipeline::clearDerived(const std::string& name_)
+{
+    std::lock_guard lock(_bufferMutex);
+    getStage(name_, "clearDerived").buffer.clear();
+}
@@ -0,0 +1,329 @@
+#include "Titta/replay.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include "Titta/utils.h"
+
+// ingest callbacks of Titta, the replay delivers data into these
+void TittaGazeCallback       (TobiiResearchGazeData*            gaze_data_, void* user_data_);
+void TittaEyeOpennessCallback(TobiiResearchEyeOpennessData* openness_data_, void* user_data_);
+
+namespace
+{
+    std::vector<std::string_view> splitLine(std::string_view line_, const char delim_ = '\t')
+    {
+        std::vector<std::string_view> out;
+        size_t start = 0;
+        while (true)
+        {
+            const auto pos = line_.find(delim_, start);
+            out.push_back(line_.substr(start, pos == std::string_view::npos ? std::string_view::npos : pos - start));
+            if (pos == std::string_view::npos)
+                break;
+            start = pos + 1;
+        }
+        return out;
+    }
+
+    // NB: strtod and friends need a null-terminated string
+    double parseDouble(std::string_view field_)
+    {
+        if (field_.empty())
+            return std::numeric_limits<double>::quiet_NaN();
+        const std::string temp(field_);
+        char* end;
+        const double val = std::strtod(temp.c_str(), &end);
+        return end == temp.c_str() ? std::numeric_limits<double>::quiet_NaN() : val;
+    }
+    int64_t parseInt64(std::string_view field_)
+    {
+        const std::string temp(field_);
+        return std::strtoll(temp.c_str(), nullptr, 10);
+    }
+    bool parseBool(std::string_view field_)
+    {
+        return field_ == "1" || field_ == "true" || field_ == "True" || field_ == "TRUE";
+    }
+}
+
+bool TittaReplay::isReplayAddress(std::string_view address_)
+{
+    return address_.substr(0, addressPrefix.size()) == addressPrefix;
+}
+
+TittaReplay::TittaReplay(std::string address_) :
+    _address(std::move(address_))
+{
+    if (!isReplayAddress(_address))
+        DoExitWithMsg("Titta::cpp::TittaReplay: address \"" + _address + "\" is not a replay address, should start with \"" + std::string(addressPrefix) + "\"");
+
+    readFile(_address.substr(addressPrefix.size()));
+}
+TittaReplay::~TittaReplay()
+{
+    {
+        std::lock_guard l(_stopMutex);
+        _shouldStop = true;
+    }
+    _stopCondition.notify_all();
+    if (_thread.joinable())
+        _thread.join();
+}
+
+void TittaReplay::readFile(const std::string& fileName_)
+{
+    std::ifstream file(fileName_);
+    if (!file)
+        DoExitWithMsg("Titta::cpp::TittaReplay: Cannot open file \"" + fileName_ + "\"");
+
+    // header, get column indices
+    std::string line;
+    if (!std::getline(file, line))
+        DoExitWithMsg("Titta::cpp::TittaReplay: File \"" + fileName_ + "\" is empty");
+    if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+    const auto header = splitLine(line);
+    const auto col = [&header](const std::string& name_) -> int
+    {
+        const auto it = std::find(header.begin(), header.end(), name_);
+        return it == header.end() ? -1 : static_cast<int>(std::distance(header.begin(), it));
+    };
+
+    const auto devTsCol = col("device_time_stamp");
+    const auto sysTsCol = col("system_time_stamp");
+    if (devTsCol < 0 || sysTsCol < 0)
+        DoExitWithMsg("Titta::cpp::TittaReplay: File \"" + fileName_ + "\" does not contain device_time_stamp and system_time_stamp columns. Expected a gaze tsv file as written by Titta.saveGazeDataToTSV()");
+
+    struct eyeCols
+    {
+        int gpX, gpY, gpUX, gpUY, gpUZ, gpV;
+        int pupD, pupV;
+        int goUX, goUY, goUZ, goV;
+        int eoD, eoV, eoA;
+    };
+    const auto getEyeCols = [&col](const std::string& eye_)
+    {
+        return eyeCols{
+            col(eye_ + "_gaze_point_on_display_area_x"), col(eye_ + "_gaze_point_on_display_area_y"),
+            col(eye_ + "_gaze_point_in_user_coords_x"), col(eye_ + "_gaze_point_in_user_coords_y"), col(eye_ + "_gaze_point_in_user_coords_z"),
+            col(eye_ + "_gaze_point_valid"),
+            col(eye_ + "_pupil_diameter"), col(eye_ + "_pupil_valid"),
+            col(eye_ + "_gaze_origin_in_user_coords_x"), col(eye_ + "_gaze_origin_in_user_coords_y"), col(eye_ + "_gaze_origin_in_user_coords_z"),
+            col(eye_ + "_gaze_origin_valid"),
+            col(eye_ + "_eye_openness_diameter"), col(eye_ + "_eye_openness_valid"), col(eye_ + "_eye_openness_available")
+        };
+    };
+    const auto leftCols  = getEyeCols("left");
+    const auto rightCols = getEyeCols("right");
+
+    // read samples
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+        const auto fields = splitLine(line);
+
+        const auto getF = [&fields](const int c_) { return c_ < 0 || c_ >= static_cast<int>(fields.size()) ? std::numeric_limits<float>::quiet_NaN() : static_cast<float>(parseDouble(fields[c_])); };
+        const auto getB = [&fields](const int c_) { return c_ >= 0 && c_ < static_cast<int>(fields.size()) && parseBool(fields[c_]); };
+        const auto getV = [&getB](const int c_) { return getB(c_) ? TOBII_RESEARCH_VALIDITY_VALID : TOBII_RESEARCH_VALIDITY_INVALID; };
+        const auto convertEye = [&](TobiiResearchEyeData& out_, const eyeCols& c_)
+        {
+            out_.gaze_point.position_on_display_area      = { getF(c_.gpX), getF(c_.gpY) };
+            out_.gaze_point.position_in_user_coordinates  = { getF(c_.gpUX), getF(c_.gpUY), getF(c_.gpUZ) };
+            out_.gaze_point.validity                      = getV(c_.gpV);
+            out_.pupil_data.diameter                      = getF(c_.pupD);
+            out_.pupil_data.validity                      = getV(c_.pupV);
+            out_.gaze_origin.position_in_user_coordinates = { getF(c_.goUX), getF(c_.goUY), getF(c_.goUZ) };
+            out_.gaze_origin.validity                     = getV(c_.goV);
+        };
+
+        auto& s = _samples.emplace_back();
+        s.gaze.device_time_stamp = parseInt64(fields[devTsCol]);
+        s.gaze.system_time_stamp = sysTsCol < static_cast<int>(fields.size()) ? parseInt64(fields[sysTsCol]) : 0;
+        convertEye(s.gaze.left_eye , leftCols);
+        convertEye(s.gaze.right_eye, rightCols);
+
+        s.hasEyeOpenness = getB(leftCols.eoA) || getB(rightCols.eoA);
+        if (s.hasEyeOpenness)
+        {
+            s.eyeOpenness.device_time_stamp         = s.gaze.device_time_stamp;
+            s.eyeOpenness.system_time_stamp         = s.gaze.system_time_stamp;
+            s.eyeOpenness.left_eye_openness_value   = getF(leftCols.eoD);
+            s.eyeOpenness.left_eye_validity         = getV(leftCols.eoV);
+            s.eyeOpenness.right_eye_openness_value  = getF(rightCols.eoD);
+            s.eyeOpenness.right_eye_validity        = getV(rightCols.eoV);
+            _hasEyeOpenness = true;
+        }
+    }
+    if (_samples.empty())
+        DoExitWithMsg("Titta::cpp::TittaReplay: File \"" + fileName_ + "\" contains no samples");
+
+    // determine sampling frequency from median inter-sample interval
+    if (_samples.size() > 1)
+    {
+        std::vector<int64_t> isi;
+        isi.reserve(_samples.size() - 1);
+        for (size_t i = 1; i < _samples.size(); i++)
+            isi.push_back(_samples[i].gaze.system_time_stamp - _samples[i - 1].gaze.system_time_stamp);
+        std::nth_element(isi.begin(), isi.begin() + isi.size() / 2, isi.end());
+        if (const auto median = isi[isi.size() / 2]; median > 0)
+            _frequency = static_cast<float>(1'000'000. / static_cast<double>(median));
+    }
+}
+
+TobiiTypes::eyeTracker TittaReplay::getEyeTrackerInfo() const
+{
+    auto capabilities = TOBII_RESEARCH_CAPABILITIES_HAS_GAZE_DATA;
+    if (_hasEyeOpenness)
+        capabilities = static_cast<TobiiResearchCapabilities>(capabilities | TOBII_RESEARCH_CAPABILITIES_HAS_EYE_OPENNESS_DATA);
+
+    const auto fileName = std::filesystem::path(_address.substr(addressPrefix.size())).stem().string();
+    return { fileName, "", "replay", "", "", _address, _frequency, "", capabilities, {_frequency}, {} };
+}
+
+void TittaReplay::setSpeed(const double speed_)
+{
+    if (speed_ < 0. || std::isnan(speed_))
+        DoExitWithMsg("Titta::cpp::TittaReplay::setSpeed: speed should be a positive number, or 0 for playback as fast as possible");
+    _speed = speed_;
+}
+double TittaReplay::getSpeed() const
+{
+    return _speed;
+}
+bool TittaReplay::isFinished() const
+{
+    return _isFinished;
+}
+
+TobiiResearchStatus TittaReplay::subscribe(const Titta::Stream stream_, void* user_data_)
+{
+    {
+        std::lock_guard l(_callbackMutex);
+        switch (stream_)
+        {
+            case Titta::Stream::Gaze:
+                _gazeSubscribed = true;
+                break;
+            case Titta::Stream::EyeOpenness:
+                if (!_hasEyeOpenness)
+                    return TOBII_RESEARCH_STATUS_SE_NOT_SUPPORTED;
+                _eyeOpennessSubscribed = true;
+                break;
+            case Titta::Stream::EyeImage:
+            case Titta::Stream::ExtSignal:
+                // not contained in a gaze tsv file
+                return TOBII_RESEARCH_STATUS_SE_NOT_SUPPORTED;
+            default:
+                // no data for these in a recording, accept subscription but never deliver anything
+                return TOBII_RESEARCH_STATUS_OK;
+        }
+        _userData = user_data_;
+    }
+
+    // first subscription to a stream with data starts playback, a subscription once
+    // the recording has been played back in full starts it again from the beginning
+    if (_thread.joinable() && _isFinished)
+    {
+        _thread.join();
+        _isFinished = false;
+    }
+    if (!_thread.joinable())
+        _thread = std::thread(&TittaReplay::playbackThread, this);
+    else
+    {
+        // resume if paused. Lock so the notification cannot fall between the playback thread's check and its wait
+        { std::lock_guard l(_stopMutex); }
+        _stopCondition.notify_all();
+    }
+    return TOBII_RESEARCH_STATUS_OK;
+}
+TobiiResearchStatus TittaReplay::unsubscribe(const Titta::Stream stream_)
+{
+    std::lock_guard l(_callbackMutex);
+    if (stream_ == Titta::Stream::Gaze)
+        _gazeSubscribed = false;
+    else if (stream_ == Titta::Stream::EyeOpenness)
+        _eyeOpennessSubscribed = false;
+    return TOBII_RESEARCH_STATUS_OK;
+}
+bool TittaReplay::hasSubscriber()
+{
+    std::lock_guard l(_callbackMutex);
+    return _gazeSubscribed || _eyeOpennessSubscribed;
+}
+
+void TittaReplay::playbackThread()
+{
+    TITTA_TRACE_THREAD_NAME("Titta replay");
+    TittaThreads::scope threadRegistration("Titta replay");
+    // NB: system timestamps are rebased so that the recording starts at playback onset
+    // (keeping the original inter-sample intervals), device timestamps are left untouched. Neither
+    // is scaled by the playback speed, so that at any speed the data is as it was recorded
+    // Pauses (when no stream is subscribed) also shift the system timestamps of the samples after them
+    int64_t tsOffset = Titta::getSystemTimestamp() - _samples.front().gaze.system_time_stamp;
+
+    // playback clock, re-anchored when speed changes
+    auto    anchorWall  = std::chrono::steady_clock::now();
+    int64_t anchorTs    = _samples.front().gaze.system_time_stamp;
+    double  speed       = _speed;
+    for (size_t i = 0; i < _samples.size(); )
+    {
+        const auto& s = _samples[i];
+        if (!hasSubscriber())
+        {
+            // pause until a stream is subscribed again
+            std::unique_lock l(_stopMutex);
+            _stopCondition.wait(l, [this] { return _shouldStop.load() || hasSubscriber(); });
+            if (_shouldStop)
+                return;
+            l.unlock();
+            // continue as if the recording picks up now, but never go back in time (when playing faster than real-time)
+            tsOffset    = std::max(tsOffset, Titta::getSystemTimestamp() - s.gaze.system_time_stamp);
+            anchorWall  = std::chrono::steady_clock::now();
+            anchorTs    = s.gaze.system_time_stamp;
+        }
+        if (const double newSpeed = _speed; newSpeed != speed)
+        {
+            anchorWall  = std::chrono::steady_clock::now();
+            anchorTs    = s.gaze.system_time_stamp;
+            speed       = newSpeed;
+        }
+
+        if (speed > 0. && std::isfinite(speed))
+        {
+            const auto target = anchorWall + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::micro>(static_cast<double>(s.gaze.system_time_stamp - anchorTs) / speed));
+            std::unique_lock l(_stopMutex);
+            if (_stopCondition.wait_until(l, target, [this] { return _shouldStop.load(); }))
+                return;
+        }
+        else if (_shouldStop)
+            return;
+
+        std::lock_guard l(_callbackMutex);
+        if (!_gazeSubscribed && !_eyeOpennessSubscribed)
+            continue;       // unsubscribed while waiting for this sample's time, deliver it once resumed
+        if (_gazeSubscribed)
+        {
+            auto gaze = s.gaze;
+            gaze.system_time_stamp += tsOffset;
+            TittaGazeCallback(&gaze, _userData);
+        }
+        if (_eyeOpennessSubscribed && s.hasEyeOpenness)
+        {
+            auto eyeOpenness = s.eyeOpenness;
+            eyeOpenness.system_time_stamp += tsOffset;
+            TittaEyeOpennessCallback(&eyeOpenness, _userData);
+        }
+        ++i;
+    }
+
+    _isFinished = true;
+}
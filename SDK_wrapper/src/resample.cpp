@@ -0,0 +1,239 @@
+#include "Titta/resample.h"
+#include <algorithm>
+#include <array>
+#include <map>
+#include <cmath>
+
+#include "Titta/utils.h"
+
+namespace
+{
+    const std::map<std::string, GazeResampler::Method> methodMap =
+    {
+        { "linear",     GazeResampler::Method::Linear },
+        { "cubic",      GazeResampler::Method::Cubic }
+    };
+
+    // values of each field of an eye, as a flat array
+    std::array<float, 5> getValues(const TobiiTypes::gazePoint& f_)
+    {
+        return { f_.position_on_display_area.x, f_.position_on_display_area.y, f_.position_in_user_coordinates.x, f_.position_in_user_coordinates.y, f_.position_in_user_coordinates.z };
+    }
+    void setValues(TobiiTypes::gazePoint& f_, const std::array<float, 5>& v_)
+    {
+        f_.position_on_display_area     = { v_[0], v_[1] };
+        f_.position_in_user_coordinates = { v_[2], v_[3], v_[4] };
+    }
+    std::array<float, 1> getValues(const TobiiTypes::pupilData& f_)    { return { f_.diameter }; }
+    void setValues(TobiiTypes::pupilData& f_, const std::array<float, 1>& v_)   { f_.diameter = v_[0]; }
+    std::array<float, 3> getValues(const TobiiTypes::gazeOrigin& f_)
+    {
+        return { f_.position_in_user_coordinates.x, f_.position_in_user_coordinates.y, f_.position_in_user_coordinates.z };
+    }
+    void setValues(TobiiTypes::gazeOrigin& f_, const std::array<float, 3>& v_)
+    {
+        f_.position_in_user_coordinates = { v_[0], v_[1], v_[2] };
+    }
+    std::array<float, 1> getValues(const TobiiTypes::eyeOpenness& f_)  { return { f_.diameter }; }
+    void setValues(TobiiTypes::eyeOpenness& f_, const std::array<float, 1>& v_) { f_.diameter = v_[0]; }
+
+    template <typename G>
+    bool isValid(const G& f_)
+    {
+        return f_.available && f_.validity == TOBII_RESEARCH_VALIDITY_VALID;
+    }
+}
+
+GazeResampler::Method GazeResampler::stringToMethod(std::string method_)
+{
+    const auto it = methodMap.find(method_);
+    if (it == methodMap.end())
+        DoExitWithMsg(R"(Titta::cpp: Requested interpolation method ")" + method_ + R"(" is not recognized. Supported methods are: "linear", "cubic")");
+    return it->second;
+}
+std::string GazeResampler::methodToString(Method method_)
+{
+    auto& v = *std::ranges::find_if(methodMap, [&method_](auto p_) {return p_.second == method_;});
+    return v.first;
+}
+
+GazeResampler::GazeResampler(double frequency_, int64_t maxGap_, Method method_, std::optional<int64_t> gridStart_) :
+    _frequency(frequency_),
+    _maxGap(maxGap_),
+    _method(method_),
+    _gridStart(gridStart_)
+{
+    if (!(_frequency > 0.) || !std::isfinite(_frequency))
+        DoExitWithMsg("Titta::cpp::GazeResampler: frequency must be a positive number");
+    if (_maxGap < 0)
+        DoExitWithMsg("Titta::cpp::GazeResampler: maximum gap must be zero or positive");
+}
+
+std::vector<TobiiTypes::gazeData> GazeResampler::push(const std::vector<TobiiTypes::gazeData>& samples_)
+{
+    for (const auto& s : samples_)
+        if (_window.empty() || s.system_time_stamp > _window.back().system_time_stamp)
+            _window.push_back(s);
+    if (!_gridStart && !_window.empty())
+        _gridStart = _window.front().system_time_stamp;
+    return emit(false);
+}
+
+std::vector<TobiiTypes::gazeData> GazeResampler::flush()
+{
+    return emit(true);
+}
+
+std::vector<TobiiTypes::gazeData> GazeResampler::resample(const std::vector<TobiiTypes::gazeData>& samples_, double frequency_, int64_t maxGap_, Method method_, std::optional<int64_t> gridStart_)
+{
+    GazeResampler r(frequency_, maxGap_, method_, gridStart_);
+    auto out  = r.push(samples_);
+    auto rest = r.flush();
+    out.insert(out.end(), std::make_move_iterator(rest.begin()), std::make_move_iterator(rest.end()));
+    return out;
+}
+
+int64_t GazeResampler::gridTime(const uint64_t k_) const
+{
+    // computed from the grid index, not accumulated, so that there is no drift
+    return *_gridStart + std::llround(static_cast<double>(k_) * 1'000'000. / _frequency);
+}
+
+std::vector<TobiiTypes::gazeData> GazeResampler::emit(const bool final_)
+{
+    std::vector<TobiiTypes::gazeData> out;
+    if (_window.empty())
+        return out;
+
+    const auto lastTs = _window.back().system_time_stamp;
+    for (auto t = gridTime(_nextGridIdx); t <= lastTs; t = gridTime(_nextGridIdx))
+    {
+        TobiiTypes::gazeData s;
+        if (!computeSample(t, final_, s))
+            break;
+        out.push_back(s);
+        _nextGridIdx++;
+    }
+
+    // drop input that can no longer be needed: interpolation uses samples at most maxGap from
+    // the grid point, and cubic tangents one more valid sample at most maxGap beyond that
+    const auto keepFrom = gridTime(_nextGridIdx) - 2 * _maxGap;
+    while (_window.size() > 1 && _window[1].system_time_stamp < keepFrom)
+        _window.pop_front();
+    return out;
+}
+
+bool GazeResampler::computeSample(const int64_t t_, const bool final_, TobiiTypes::gazeData& out_) const
+{
+    // first sample at or after t_, always exists as grid points are at most the last sample's timestamp
+    const auto p = static_cast<size_t>(std::ranges::lower_bound(_window, t_, {}, &TobiiTypes::gazeData::system_time_stamp) - _window.begin());
+
+    // device timestamp from nearest input sample
+    auto n = p;
+    if (p > 0 && t_ - _window[p - 1].system_time_stamp < _window[p].system_time_stamp - t_)
+        n = p - 1;
+    out_.system_time_stamp = t_;
+    out_.device_time_stamp = _window[n].device_time_stamp + (t_ - _window[n].system_time_stamp);
+
+    bool ok = true;
+    for (const auto eye : { &TobiiTypes::gazeData::left_eye, &TobiiTypes::gazeData::right_eye })
+    {
+        ok = ok && interpolate(t_, p, final_, eye, &TobiiTypes::eyeData::gaze_point  , (out_.*eye).gaze_point);
+        ok = ok && interpolate(t_, p, final_, eye, &TobiiTypes::eyeData::pupil       , (out_.*eye).pupil);
+        ok = ok && interpolate(t_, p, final_, eye, &TobiiTypes::eyeData::gaze_origin , (out_.*eye).gaze_origin);
+        ok = ok && interpolate(t_, p, final_, eye, &TobiiTypes::eyeData::eye_openness, (out_.*eye).eye_openness);
+        // availability is a property of the stream, not of the sample, take from nearest input
+        (out_.*eye).gaze_point  .available = (_window[n].*eye).gaze_point  .available;
+        (out_.*eye).pupil       .available = (_window[n].*eye).pupil       .available;
+        (out_.*eye).gaze_origin .available = (_window[n].*eye).gaze_origin .available;
+        (out_.*eye).eye_openness.available = (_window[n].*eye).eye_openness.available;
+    }
+    return ok;
+}
+
+template <typename G>
+bool GazeResampler::interpolate(const int64_t t_, const size_t p_, const bool final_, TobiiTypes::eyeData TobiiTypes::gazeData::* eye_, G TobiiTypes::eyeData::* field_, G& out_) const
+{
+    auto field  = [&](const size_t i_) -> const G& { return (_window[i_].*eye_).*field_; };
+    auto ts     = [&](const size_t i_) { return _window[i_].system_time_stamp; };
+    const auto lastTs = _window.back().system_time_stamp;
+    constexpr auto none = static_cast<size_t>(-1);
+
+    // nearest valid samples at or after, and before t_, no further than maxGap away
+    size_t b = none;
+    size_t i = p_;
+    for (; i < _window.size() && ts(i) - t_ <= _maxGap; i++)
+        if (isValid(field(i)))
+        {
+            b = i;
+            break;
+        }
+    if (b != none && ts(b) == t_)
+    {
+        out_ = field(b);
+        return true;
+    }
+    size_t a = none;
+    for (size_t j = p_; j-- > 0 && t_ - ts(j) <= _maxGap;)
+        if (isValid(field(j)))
+        {
+            a = j;
+            break;
+        }
+    if (a == none)
+        return true;    // output stays invalid
+    if (b == none)
+        // if we ran out of data, a valid sample may still arrive within maxGap
+        return final_ || i < _window.size() || lastTs - t_ > _maxGap;
+    if (ts(b) - ts(a) > _maxGap)
+        return true;
+
+    const auto va = getValues(field(a));
+    const auto vb = getValues(field(b));
+    const auto h  = static_cast<double>(ts(b) - ts(a));
+    const auto s  = static_cast<double>(t_ - ts(a)) / h;
+    auto v = va;
+    if (_method == Method::Linear)
+    {
+        for (size_t c = 0; c < v.size(); c++)
+            v[c] = static_cast<float>(va[c] + (static_cast<double>(vb[c]) - va[c]) * s);
+    }
+    else
+    {
+        // neighboring valid samples for the tangents
+        size_t a0 = none;
+        for (size_t j = a; j-- > 0 && ts(a) - ts(j) <= _maxGap;)
+            if (isValid(field(j)))
+            {
+                a0 = j;
+                break;
+            }
+        size_t b1 = none;
+        size_t j = b + 1;
+        for (; j < _window.size() && ts(j) - ts(b) <= _maxGap; j++)
+            if (isValid(field(j)))
+            {
+                b1 = j;
+                break;
+            }
+        if (b1 == none && !final_ && j == _window.size() && lastTs - ts(b) <= _maxGap)
+            return false;
+
+        // cubic Hermite, tangents from finite differences (one-sided where there is no neighbor)
+        const auto v0 = a0 != none ? getValues(field(a0)) : va;
+        const auto v1 = b1 != none ? getValues(field(b1)) : vb;
+        const auto t0 = static_cast<double>(a0 != none ? ts(a0) : ts(a));
+        const auto t1 = static_cast<double>(b1 != none ? ts(b1) : ts(b));
+        const auto s2 = s * s, s3 = s2 * s;
+        const auto h00 = 2 * s3 - 3 * s2 + 1, h10 = s3 - 2 * s2 + s, h01 = -2 * s3 + 3 * s2, h11 = s3 - s2;
+        for (size_t c = 0; c < v.size(); c++)
+        {
+            const auto ma = (static_cast<double>(vb[c]) - v0[c]) / (static_cast<double>(ts(b)) - t0);
+            const auto mb = (static_cast<double>(v1[c]) - va[c]) / (t1 - static_cast<double>(ts(a)));
+            v[c] = static_cast<float>(h00 * va[c] + h10 * h * ma + h01 * vb[c] + h11 * h * mb);
+        }
+    }
+    setValues(out_, v);
+    out_.validity = TOBII_RESEARCH_VALIDITY_VALID;
+    return true;
+}
@@ -0,0 +1,185 @@
+#include "Titta/shmRing.h"
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   include <Windows.h>
+#else
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <cerrno>
+#endif
+
+namespace
+{
+    // POSIX names must start with a slash and contain no others, Windows names must not contain backslashes
+    std::string toSystemName(const std::string& name_)
+    {
+        if (name_.empty())
+            DoExitWithMsg("Titta::cpp::SharedMemory: name must not be empty");
+#ifdef _WIN32
+        return name_[0] == '/' ? name_.substr(1) : name_;
+#else
+        return name_[0] == '/' ? name_ : '/' + name_;
+#endif
+    }
+#ifndef _WIN32
+    std::string errnoString()
+    {
+        return std::strerror(errno);
+    }
+#endif
+}
+
+SharedMemory::SharedMemory(std::string name_, const size_t size_) :
+    _name(std::move(name_)),
+    _size(size_),
+    _isOwner(true)
+{
+    const auto sysName = toSystemName(_name);
+#ifdef _WIN32
+    _handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(static_cast<uint64_t>(_size) >> 32), static_cast<DWORD>(_size & 0xFFFFFFFF), sysName.c_str());
+    if (!_handle)
+        DoExitWithMsg(string_format("Titta::cpp::SharedMemory: cannot create shared memory \"%s\" (error %lu)", _name.c_str(), GetLastError()));
+    if (GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        CloseHandle(_handle);
+        DoExitWithMsg("Titta::cpp::SharedMemory: shared memory \"" + _name + "\" is already in use");
+    }
+    _data = MapViewOfFile(_handle, FILE_MAP_ALL_ACCESS, 0, 0, _size);
+    if (!_data)
+    {
+        CloseHandle(_handle);
+        DoExitWithMsg(string_format("Titta::cpp::SharedMemory: cannot map shared memory \"%s\" (error %lu)", _name.c_str(), GetLastError()));
+    }
+#else
+    // replace any stale region, readers still attached to it keep their mapping
+    shm_unlink(sysName.c_str());
+    const int fd = shm_open(sysName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd == -1)
+        DoExitWithMsg("Titta::cpp::SharedMemory: cannot create shared memory \"" + _name + "\": " + errnoString());
+    if (ftruncate(fd, static_cast<off_t>(_size)) == -1)
+    {
+        const auto err = errnoString();
+        close(fd);
+        shm_unlink(sysName.c_str());
+        DoExitWithMsg("Titta::cpp::SharedMemory: cannot size shared memory \"" + _name + "\": " + err);
+    }
+    _data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (_data == MAP_FAILED)
+    {
+        _data = nullptr;
+        shm_unlink(sysName.c_str());
+        DoExitWithMsg("Titta::cpp::SharedMemory: cannot map shared memory \"" + _name + "\": " + errnoString());
+    }
+#endif
+}
+
+SharedMemory::SharedMemory(std::string name_) :
+    _name(std::move(name_))
+{
+    const auto sysName = toSystemName(_name);
+#ifdef _WIN32
+    _handle = OpenFileMappingA(FILE_MAP_READ, FALSE, sysName.c_str());
+    if (!_handle)
+        DoExitWithMsg("Titta::cpp::SharedMemory: shared memory \"" + _name + "\" does not exist");
+    _data = MapViewOfFile(_handle, FILE_MAP_READ, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info;
+    if (!_data || !VirtualQuery(_data, &info, sizeof(info)))
+    {
+        if (_data)
+            UnmapViewOfFile(_data);
+        CloseHandle(_handle);
+        DoExitWithMsg(string_format("Titta::cpp::SharedMemory: cannot map shared memory \"%s\" (error %lu)", _name.c_str(), GetLastError()));
+    }
+    _size = info.RegionSize;
+#else
+    const int fd = shm_open(sysName.c_str(), O_RDONLY, 0);
+    if (fd == -1)
+        DoExitWithMsg("Titta::cpp::SharedMemory: cannot open shared memory \"" + _name + "\": " + errnoString());
+    struct stat st;
+    if (fstat(fd, &st) == -1)
+    {
+        const auto err = errnoString();
+        close(fd);
+        DoExitWithMsg("Titta::cpp::SharedMemory: cannot open shared memory \"" + _name + "\": " + err);
+    }
+    _size = static_cast<size_t>(st.st_size);
+    _data = _size ? mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (_data == MAP_FAILED)
+    {
+        _data = nullptr;
+        DoExitWithMsg("Titta::cpp::SharedMemory: cannot map shared memory \"" + _name + "\"");
+    }
+#endif
+}
+
+SharedMemory::~SharedMemory()
+{
+#ifdef _WIN32
+    if (_data)
+        UnmapViewOfFile(_data);
+    if (_handle)
+        CloseHandle(_handle);
+#else
+    if (_data)
+        munmap(_data, _size);
+    if (_isOwner)
+        shm_unlink(toSystemName(_name).c_str());
+#endif
+}
+
+
+ShmRing::StreamType ShmRing::checkLayout(const SharedMemory& shm_)
+{
+    if (shm_.size() < headerSize)
+        DoExitWithMsg("Titta::cpp::ShmRingReader: shared memory \"" + shm_.getName() + "\" is not a Titta sample ring");
+    const auto h = static_cast<const header*>(shm_.data());
+    if (h->magic != magic)
+        DoExitWithMsg("Titta::cpp::ShmRingReader: shared memory \"" + shm_.getName() + "\" is not a Titta sample ring");
+    if (h->version != version)
+        DoExitWithMsg(string_format("Titta::cpp::ShmRingReader: shared memory \"%s\" has layout version %u, this reader supports version %u", shm_.getName().c_str(), h->version, version));
+
+    size_t sampleSize = 0;
+    switch (static_cast<StreamType>(h->streamType))
+    {
+    case StreamType::Gaze:
+        sampleSize = sizeof(TobiiTypes::gazeData);
+        break;
+    case StreamType::ExtSignal:
+        sampleSize = sizeof(TobiiResearchExternalSignalData);
+        break;
+    case StreamType::TimeSync:
+        sampleSize = sizeof(TobiiResearchTimeSynchronizationData);
+        break;
+    case StreamType::Positioning:
+        sampleSize = sizeof(TobiiResearchUserPositionGuide);
+        break;
+    default:
+        DoExitWithMsg(string_format("Titta::cpp::ShmRingReader: shared memory \"%s\" holds unknown stream type %u", shm_.getName().c_str(), h->streamType));
+    }
+    // sample layout must match, e.g. reader and writer built for the same platform
+    if (h->sampleSize != sampleSize || h->slotSize != (1 + (sampleSize + sizeof(uint64_t) - 1) / sizeof(uint64_t)) * sizeof(uint64_t) || !h->capacity || shm_.size() < headerSize + h->capacity * h->slotSize)
+        DoExitWithMsg("Titta::cpp::ShmRingReader: shared memory \"" + shm_.getName() + "\" has an incompatible sample layout");
+    return static_cast<StreamType>(h->streamType);
+}
+
+AnyShmRingReader openShmRingReader(std::string name_, const bool fromOldest_ /*= false*/)
+{
+    auto shm = std::make_unique<SharedMemory>(std::move(name_));
+    switch (ShmRing::checkLayout(*shm))
+    {
+    case ShmRing::StreamType::Gaze:
+        return ShmRingReader<TobiiTypes::gazeData>(std::move(shm), fromOldest_);
+    case ShmRing::StreamType::ExtSignal:
+        return ShmRingReader<TobiiResearchExternalSignalData>(std::move(shm), fromOldest_);
+    case ShmRing::StreamType::TimeSync:
+        return ShmRingReader<TobiiResearchTimeSynchronizationData>(std::move(shm), fromOldest_);
+    case ShmRing::StreamType::Positioning:
+        break;
+    }
+    return ShmRingReader<TobiiResearchUserPositionGuide>(std::move(shm), fromOldest_);
+}
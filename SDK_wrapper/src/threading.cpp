@@ -0,0 +1,356 @@
+#include "Titta/threading.h"
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   include <Windows.h>
+#else
+#   include <pthread.h>
+#   include <sched.h>
+#   include <sys/resource.h>
+#   ifdef __linux__
+#       include <sys/syscall.h>
+#       include <unistd.h>
+#   endif
+#endif
+
+#include "Titta/utils.h"
+
+namespace
+{
+    constexpr int minPriority = 1, maxPriority = 99;
+    constexpr int minNice = -20, maxNice = 19;
+#if defined(_WIN32)
+    constexpr int maxCPU = 64 * 64;     // 64 processor groups of 64
+#elif defined(__linux__)
+    constexpr int maxCPU = CPU_SETSIZE;
+#else
+    constexpr int maxCPU = 1 << 16;
+#endif
+
+    void appendError(std::string& errors_, const std::string& what_)
+    {
+        if (!errors_.empty())
+            errors_ += "; ";
+        errors_ += what_;
+    }
+#ifndef _WIN32
+    std::string errnoString(const int err_)
+    {
+        return std::strerror(err_);
+    }
+    int toPolicy(const std::string& policy_)
+    {
+        return policy_ == "fifo" ? SCHED_FIFO : policy_ == "rr" ? SCHED_RR : SCHED_OTHER;
+    }
+    std::string policyName(const int policy_)
+    {
+        switch (policy_)
+        {
+            case SCHED_OTHER:   return "other";
+            case SCHED_FIFO:    return "fifo";
+            case SCHED_RR:      return "rr";
+#ifdef SCHED_BATCH
+            case SCHED_BATCH:   return "batch";
+#endif
+#ifdef SCHED_IDLE
+            case SCHED_IDLE:    return "idle";
+#endif
+        }
+        return std::to_string(policy_);
+    }
+#endif
+
+    // a thread, in the form needed to change its settings from another thread
+    struct nativeThread
+    {
+        int64_t     id      = 0;
+#if defined(_WIN32)
+        HANDLE      handle  = nullptr;
+        bool        owned   = false;    // handle needs closing
+#elif !defined(__linux__)
+        pthread_t   handle  = {};
+#endif
+    };
+
+    nativeThread currentThread(const bool persistent_)
+    {
+        nativeThread out;
+#if defined(_WIN32)
+        out.id = GetCurrentThreadId();
+        // the pseudo handle is only valid on the current thread
+        if (persistent_ && DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &out.handle, 0, FALSE, DUPLICATE_SAME_ACCESS))
+            out.owned = true;
+        else
+            out.handle = GetCurrentThread();
+#elif defined(__linux__)
+        (void)persistent_;
+        out.id = static_cast<int64_t>(syscall(SYS_gettid));
+#else
+        (void)persistent_;
+        out.handle = pthread_self();
+#   ifdef __APPLE__
+        uint64_t id = 0;
+        pthread_threadid_np(nullptr, &id);
+        out.id = static_cast<int64_t>(id);
+#   endif
+#endif
+        return out;
+    }
+    void release(nativeThread& thread_)
+    {
+#ifdef _WIN32
+        if (thread_.owned)
+            CloseHandle(thread_.handle);
+        thread_.owned = false;
+#else
+        (void)thread_;
+#endif
+    }
+
+#ifdef _WIN32
+    int toWindowsPriority(const TittaThreads::settings& settings_)
+    {
+        if (settings_.policy && *settings_.policy != "other")
+        {
+            const auto prio = settings_.priority.value_or(minPriority);
+            return prio >= 60 ? THREAD_PRIORITY_TIME_CRITICAL : prio >= 30 ? THREAD_PRIORITY_HIGHEST : THREAD_PRIORITY_ABOVE_NORMAL;
+        }
+        const auto nice = settings_.nice.value_or(0);
+        return nice <= -15 ? THREAD_PRIORITY_HIGHEST : nice <= -5 ? THREAD_PRIORITY_ABOVE_NORMAL : nice < 5 ? THREAD_PRIORITY_NORMAL : nice < 15 ? THREAD_PRIORITY_BELOW_NORMAL : THREAD_PRIORITY_LOWEST;
+    }
+#endif
+
+    // returns a description of what failed, empty if all succeeded
+    std::string apply(const nativeThread& thread_, const TittaThreads::settings& settings_)
+    {
+        std::string errors;
+#if defined(_WIN32)
+        if (settings_.policy || settings_.nice)
+            if (!SetThreadPriority(thread_.handle, toWindowsPriority(settings_)))
+                appendError(errors, string_format("cannot set thread priority (error %lu)", GetLastError()));
+        if (settings_.cpus)
+        {
+            // a thread can only run on the CPUs of a single processor group, use that of the first CPU
+            GROUP_AFFINITY affinity = {};
+            affinity.Group = static_cast<WORD>(settings_.cpus->front() / 64);
+            for (const auto c : *settings_.cpus)
+                if (c / 64 == affinity.Group)
+                    affinity.Mask |= KAFFINITY(1) << (c % 64);
+            if (!SetThreadGroupAffinity(thread_.handle, &affinity, nullptr))
+                appendError(errors, string_format("cannot set CPU affinity (error %lu)", GetLastError()));
+        }
+#else
+        if (settings_.policy || settings_.priority)
+        {
+            int policy = 0;
+            sched_param param{};
+#   ifdef __linux__
+            policy = settings_.policy ? toPolicy(*settings_.policy) : sched_getscheduler(static_cast<pid_t>(thread_.id));
+#   else
+            pthread_getschedparam(thread_.handle, &policy, &param);
+            if (settings_.policy)
+                policy = toPolicy(*settings_.policy);
+#   endif
+            const bool isRealtime = policy == SCHED_FIFO || policy == SCHED_RR;
+            param.sched_priority  = isRealtime ? std::clamp(settings_.priority.value_or(minPriority), sched_get_priority_min(policy), sched_get_priority_max(policy)) : 0;
+#   ifdef __linux__
+            if (sched_setscheduler(static_cast<pid_t>(thread_.id), policy, &param))
+                appendError(errors, "cannot set scheduling policy: " + errnoString(errno) + (errno == EPERM && isRealtime ? " (realtime policies need CAP_SYS_NICE or an rtprio limit)" : ""));
+#   else
+            if (const auto err = pthread_setschedparam(thread_.handle, policy, &param))
+                appendError(errors, "cannot set scheduling policy: " + errnoString(err));
+#   endif
+        }
+#   ifdef __linux__
+        // on Linux, nice values are per thread
+        if (settings_.nice && setpriority(PRIO_PROCESS, static_cast<id_t>(thread_.id), *settings_.nice))
+            appendError(errors, "cannot set nice value: " + errnoString(errno));
+        if (settings_.cpus)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (const auto c : *settings_.cpus)
+                CPU_SET(c, &set);
+            if (sched_setaffinity(static_cast<pid_t>(thread_.id), sizeof(set), &set))
+                appendError(errors, "cannot set CPU affinity: " + errnoString(errno));
+        }
+#   else
+        if (settings_.nice)
+            appendError(errors, "per-thread nice values are not supported on this platform");
+        if (settings_.cpus)
+            appendError(errors, "CPU affinity is not supported on this platform");
+#   endif
+#endif
+        return errors;
+    }
+
+    TittaThreads::info readBack(const nativeThread& thread_)
+    {
+        TittaThreads::info out;
+        out.id = thread_.id;
+#if defined(_WIN32)
+        out.policy   = "priority";
+        out.priority = GetThreadPriority(thread_.handle);
+        GROUP_AFFINITY affinity = {};
+        if (GetThreadGroupAffinity(thread_.handle, &affinity))
+            for (int c = 0; c < 64; c++)
+                if (affinity.Mask & (KAFFINITY(1) << c))
+                    out.cpus.push_back(affinity.Group * 64 + c);
+#elif defined(__linux__)
+        const auto tid = static_cast<pid_t>(thread_.id);
+        out.policy = policyName(sched_getscheduler(tid));
+        sched_param param{};
+        if (!sched_getparam(tid, &param))
+            out.priority = param.sched_priority;
+        out.nice = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (!sched_getaffinity(tid, sizeof(set), &set))
+            for (int c = 0; c < CPU_SETSIZE; c++)
+                if (CPU_ISSET(c, &set))
+                    out.cpus.push_back(c);
+#else
+        int policy = 0;
+        sched_param param{};
+        if (!pthread_getschedparam(thread_.handle, &policy, &param))
+        {
+            out.policy   = policyName(policy);
+            out.priority = param.sched_priority;
+        }
+#endif
+        return out;
+    }
+
+    struct entry
+    {
+        std::string         name;
+        nativeThread        thread;
+        bool                isSDKThread = false;
+        std::string         error;
+        TittaThreads::info  snapshot;   // for SDK threads, read back when settings were applied
+    };
+
+    // never destroyed: threads owned by static objects (log sink, eye tracker discovery) may still
+    // register or unregister while statics are being destroyed at exit
+    std::mutex&                             g_mutex     = *new std::mutex;
+    std::optional<TittaThreads::settings>&  g_settings  = *new std::optional<TittaThreads::settings>;  // guarded by g_mutex
+    std::vector<entry>&                     g_threads   = *new std::vector<entry>;                      // guarded by g_mutex
+    std::atomic<uint64_t>                   g_generation = 0;   // incremented whenever settings change
+}
+
+namespace TittaThreads
+{
+    void set(settings settings_)
+    {
+        if (settings_.policy && *settings_.policy != "other" && *settings_.policy != "fifo" && *settings_.policy != "rr")
+            DoExitWithMsg(R"(Titta::cpp::setThreadSettings: Requested policy ")" + *settings_.policy + R"(" is not recognized. Supported policies are: "other", "fifo", "rr")");
+        if (settings_.priority && (*settings_.priority < minPriority || *settings_.priority > maxPriority))
+            DoExitWithMsg(string_format("Titta::cpp::setThreadSettings: priority must be between %d and %d", minPriority, maxPriority));
+        if (settings_.nice && (*settings_.nice < minNice || *settings_.nice > maxNice))
+            DoExitWithMsg(string_format("Titta::cpp::setThreadSettings: nice value must be between %d and %d", minNice, maxNice));
+        if (settings_.cpus && (settings_.cpus->empty() || std::ranges::any_of(*settings_.cpus, [](const int c_) { return c_ < 0 || c_ >= maxCPU; })))
+            DoExitWithMsg(string_format("Titta::cpp::setThreadSettings: CPU list must not be empty, and CPU numbers must be between 0 and %d", maxCPU - 1));
+
+        std::lock_guard lock(g_mutex);
+        // merge with previous settings, so that threads started later get everything that was set
+        auto merged = g_settings.value_or(settings{});
+        if (settings_.policy)
+        {
+            merged.policy = settings_.policy;
+            if (*settings_.policy == "other")
+                merged.priority.reset();
+        }
+        if (settings_.priority)
+            merged.priority = settings_.priority;
+        if (settings_.nice)
+            merged.nice = settings_.nice;
+        if (settings_.cpus)
+            merged.cpus = settings_.cpus;
+        if (merged.priority && merged.policy.value_or("other") == "other")
+            DoExitWithMsg(R"(Titta::cpp::setThreadSettings: a priority can only be set for the "fifo" and "rr" policies)");
+        g_settings = std::move(merged);
+
+        for (auto& t : g_threads)
+            if (!t.isSDKThread)
+                t.error = apply(t.thread, *g_settings);
+        // SDK threads pick up the new settings on their next callback
+        g_generation.fetch_add(1, std::memory_order_release);
+    }
+
+    std::optional<settings> get()
+    {
+        std::lock_guard lock(g_mutex);
+        return g_settings;
+    }
+
+    std::vector<info> getInfo()
+    {
+        std::lock_guard lock(g_mutex);
+        std::vector<info> out;
+        out.reserve(g_threads.size());
+        for (const auto& t : g_threads)
+        {
+            auto i = t.isSDKThread ? t.snapshot : readBack(t.thread);
+            i.name          = t.name;
+            i.isSDKThread   = t.isSDKThread;
+            i.error         = t.error;
+            out.push_back(std::move(i));
+        }
+        return out;
+    }
+
+    scope::scope(std::string name_)
+    {
+        std::lock_guard lock(g_mutex);
+        auto& t  = g_threads.emplace_back();
+        t.name   = std::move(name_);
+        t.thread = currentThread(true);
+        if (g_settings)
+            t.error = apply(t.thread, *g_settings);
+    }
+    scope::~scope()
+    {
+        const auto id = currentThread(false).id;
+        std::lock_guard lock(g_mutex);
+        const auto it = std::ranges::find_if(g_threads, [id](const entry& e_) { return !e_.isSDKThread && e_.thread.id == id; });
+        if (it != g_threads.end())
+        {
+            release(it->thread);
+            g_threads.erase(it);
+        }
+    }
+
+    void onCallback(const char* name_)
+    {
+        thread_local uint64_t appliedGeneration = 0;
+        const auto generation = g_generation.load(std::memory_order_acquire);
+        if (generation == appliedGeneration)
+            return;
+        appliedGeneration = generation;
+
+        std::lock_guard lock(g_mutex);
+        const auto thread = currentThread(false);
+        auto it = std::ranges::find_if(g_threads, [&thread](const entry& e_) { return e_.isSDKThread && e_.thread.id == thread.id; });
+        if (it == g_threads.end())
+        {
+            it = g_threads.emplace(g_threads.end());
+            it->isSDKThread = true;
+        }
+        it->name     = name_;
+        it->thread   = thread;
+        it->error    = g_settings ? apply(thread, *g_settings) : std::string{};
+        it->snapshot = readBack(thread);
+    }
+    void onUnsubscribe()
+    {
+        std::lock_guard lock(g_mutex);
+        if (std::erase_if(g_threads, [](const entry& e_) { return e_.isSDKThread; }))
+            // make the remaining SDK threads go through onCallback() again
+            g_generation.fetch_add(1, std::memory_order_release);
+    }
+}
@@ -0,0 +1,116 @@
+#include "Titta/trace.h"
+
+#ifdef TITTA_ENABLE_TRACING
+#include <vector>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include "Titta/utils.h"
+
+namespace
+{
+    struct event
+    {
+        const char* name;
+        const char* category;
+        int64_t     start;      // ns since epoch
+        int64_t     duration;   // ns
+    };
+
+    // single-producer ring: only the owning thread writes, readers copy out what
+    // they need and discard anything that may have been overwritten while copying
+    struct ring
+    {
+        std::array<event, TITTA_TRACE_RING_SIZE>    events;
+        std::atomic<uint64_t>                       head        = 0;    // total number of events written
+        uint64_t                                    dumpedUpTo  = 0;    // guarded by registry mutex
+        uint32_t                                    tid         = 0;
+        std::atomic<const char*>                    threadName  = nullptr;
+    };
+
+    // rings are owned by the registry, so events of threads that have exited can still be retrieved
+    std::mutex                          g_registryMutex;
+    std::vector<std::unique_ptr<ring>>  g_rings;
+
+    const auto g_epoch = std::chrono::steady_clock::now();
+
+    ring& getThreadRing()
+    {
+        thread_local ring* r = nullptr;
+        if (!r)
+        {
+            auto newRing = std::make_unique<ring>();
+            std::lock_guard l(g_registryMutex);
+            newRing->tid = static_cast<uint32_t>(g_rings.size()) + 1;
+            r = g_rings.emplace_back(std::move(newRing)).get();
+        }
+        return *r;
+    }
+}
+
+namespace TittaTrace
+{
+    int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_epoch).count();
+    }
+
+    void record(const char* name_, const char* category_, const int64_t start_, const int64_t end_)
+    {
+        auto& r = getThreadRing();
+        const auto h = r.head.load(std::memory_order_relaxed);
+        r.events[h % TITTA_TRACE_RING_SIZE] = { name_, category_, start_, end_ - start_ };
+        r.head.store(h + 1, std::memory_order_release);
+    }
+
+    void setThreadName(const char* name_)
+    {
+        getThreadRing().threadName = name_;
+    }
+
+    std::string getChromeJSON(const bool clear_)
+    {
+        std::string out = R"({"displayTimeUnit":"ns","traceEvents":[)";
+        bool first = true;
+        auto append = [&](const std::string& item_)
+        {
+            if (!first)
+                out += ",\n";
+            first = false;
+            out += item_;
+        };
+
+        std::lock_guard l(g_registryMutex);
+        std::vector<event> events;
+        for (const auto& r : g_rings)
+        {
+            // thread name metadata
+            const auto name = r->threadName.load();
+            append(string_format(R"({"name":"thread_name","ph":"M","pid":1,"tid":%u,"args":{"name":"%s"}})", r->tid, name ? name : string_format("thread %u", r->tid).c_str()));
+
+            // copy out events still in the ring, then drop the ones that may have been overwritten during the copy
+            const auto headBefore = r->head.load(std::memory_order_acquire);
+            auto from = std::max(r->dumpedUpTo, headBefore > TITTA_TRACE_RING_SIZE ? headBefore - TITTA_TRACE_RING_SIZE : 0);
+            events.clear();
+            for (auto i = from; i < headBefore; i++)
+                events.push_back(r->events[i % TITTA_TRACE_RING_SIZE]);
+            const auto headAfter = r->head.load(std::memory_order_acquire);
+            const auto firstValid = headAfter >= TITTA_TRACE_RING_SIZE ? headAfter - TITTA_TRACE_RING_SIZE + 1 : 0;
+            const auto skip = firstValid > from ? std::min<uint64_t>(firstValid - from, events.size()) : 0;
+
+            for (auto e = events.begin() + static_cast<ptrdiff_t>(skip); e != events.end(); ++e)
+                append(string_format(R"({"name":"%s","cat":"%s","ph":"X","pid":1,"tid":%u,"ts":%.3f,"dur":%.3f})",
+                    e->name, e->category, r->tid, static_cast<double>(e->start) / 1000., static_cast<double>(e->duration) / 1000.));
+
+            if (clear_)
+                r->dumpedUpTo = headBefore;
+        }
+        out += "]}";
+        return out;
+    }
+}
+#endif
@@ -0,0 +1,147 @@
+#include "Titta/workerPool.h"
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+#include "Titta/trace.h"
+#include "Titta/threading.h"
+
+namespace
+{
+    // jobs of a run() call, claimed one by one by the calling thread and the workers
+    struct batch
+    {
+        std::vector<std::function<void()>>  jobs;
+        std::atomic<size_t>                 next        = 0;
+        size_t                              remaining   = 0;    // guarded by mutex
+        std::mutex                          mutex;
+        std::condition_variable             cv;
+
+        explicit batch(std::vector<std::function<void()>> jobs_) : jobs(std::move(jobs_)), remaining(jobs.size()) {}
+
+        void work()
+        {
+            size_t nDone = 0;
+            for (auto i = next++; i < jobs.size(); i = next++)
+            {
+                jobs[i]();
+                ++nDone;
+            }
+            if (!nDone)
+                return;
+            std::lock_guard lock(mutex);
+            remaining -= nDone;
+            if (!remaining)
+                cv.notify_all();
+        }
+    };
+}
+
+WorkerPool::WorkerPool(std::string name_) :
+    _name(std::move(name_))
+{}
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+void WorkerPool::start(const size_t nThreads_)
+{
+    std::unique_lock lock(_mutex);
+    // stop current workers without dropping the queue
+    auto threads = std::move(_threads);
+    _threads.clear();
+    ++_generation;
+    lock.unlock();
+    _cv.notify_all();
+    for (auto& t : threads)
+        t.join();
+
+    lock.lock();
+    _running = nThreads_ > 0;
+    for (size_t i = 0; i < nThreads_; i++)
+        _threads.emplace_back(&WorkerPool::thread, this, _generation);
+}
+void WorkerPool::stop()
+{
+    std::unique_lock lock(_mutex);
+    _running = false;
+    _queue.clear();
+    auto threads = std::move(_threads);
+    _threads.clear();
+    ++_generation;
+    lock.unlock();
+    _cv.notify_all();
+    // join outside the lock, the workers need it to finish up
+    for (auto& t : threads)
+        t.join();
+}
+size_t WorkerPool::getNumThreads() const
+{
+    std::lock_guard lock(_mutex);
+    return _threads.size();
+}
+size_t WorkerPool::getNumQueued() const
+{
+    std::lock_guard lock(_mutex);
+    return _queue.size();
+}
+
+bool WorkerPool::submit(std::function<void()>&& job_)
+{
+    {
+        std::lock_guard lock(_mutex);
+        if (!_running)
+            return false;
+        _queue.push_back(std::move(job_));
+    }
+    _cv.notify_one();
+    return true;
+}
+void WorkerPool::run(std::vector<std::function<void()>> jobs_)
+{
+    if (jobs_.empty())
+        return;
+    if (jobs_.size() == 1)
+    {
+        jobs_[0]();
+        return;
+    }
+
+    auto b = std::make_shared<batch>(std::move(jobs_));
+    // ask as many workers to help as there are jobs beyond the one this thread will do.
+    // Helpers that only get to run once all jobs are claimed return immediately
+    {
+        std::lock_guard lock(_mutex);
+        if (_running)
+        {
+            const auto nHelpers = std::min(_threads.size(), b->jobs.size() - 1);
+            for (size_t i = 0; i < nHelpers; i++)
+                _queue.push_back([b]() { b->work(); });
+        }
+    }
+    _cv.notify_all();
+
+    b->work();
+    std::unique_lock lock(b->mutex);
+    b->cv.wait(lock, [&b]() { return b->remaining == 0; });
+}
+
+void WorkerPool::thread(const uint64_t generation_)
+{
+    TITTA_TRACE_THREAD_NAME(_name.c_str());
+    TittaThreads::scope threadRegistration(_name);
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(_mutex);
+            _cv.wait(lock, [&]() { return !_queue.empty() || _generation != generation_; });
+            if (_generation != generation_)
+                return;     // stop requested
+            job = std::move(_queue.front());
+            _queue.pop_front();
+        }
+        job();
+    }
+}
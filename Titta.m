@@ -2855,8 +2855,8 @@ classdef Titta < handle
                 end
                 
                 % get latest data from eye-tracker
-                eyeData     = obj.buffer.peekN('gaze',1);
-                posGuide    = obj.buffer.peekN('positioning',1);
+                eyeData     = obj.buffer.getLatest('gaze');
+                posGuide    = obj.buffer.getLatest('positioning');
                 headP.update(...
                     eyeData. left.gazeOrigin.valid, eyeData. left.gazeOrigin.inUserCoords, posGuide. left.userPosition, eyeData. left.pupil.valid, eyeData. left.pupil.diameter, eyeData. left.eyeOpenness.valid, eyeData. left.eyeOpenness.diameter,...
                     eyeData.right.gazeOrigin.valid, eyeData.right.gazeOrigin.inUserCoords, posGuide.right.userPosition, eyeData.right.pupil.valid, eyeData.right.pupil.diameter, eyeData.right.eyeOpenness.valid, eyeData.right.eyeOpenness.diameter);
@@ -3313,11 +3313,10 @@ classdef Titta < handle
         end
         
         function data = ConsumeAllData(obj,varargin)
-            data.gaze           = obj.buffer.consumeTimeRange('gaze',varargin{:});
-            data.eyeImages      = obj.buffer.consumeTimeRange('eyeImage',varargin{:});
-            data.externalSignals= obj.buffer.consumeTimeRange('externalSignal',varargin{:});
-            data.timeSync       = obj.buffer.consumeTimeRange('timeSync',varargin{:});
-            data.notifications  = obj.buffer.consumeTimeRange('notification',varargin{:});
+            % get all streams in one call, cut off at the same time so
+            % that they line up
+            data = obj.buffer.drainAll({'gaze','eyeImage','externalSignal','timeSync','notification'},varargin{:});
+            data = rmfield(data,{'positioning','cutOff'});
             % NB: positioning stream is not consumed as it will be useless
             % for later analysis (it doesn't have timestamps, and is meant
             % for visualization only). It is cleared however, consistent
@@ -4427,7 +4426,7 @@ classdef Titta < handle
                         end
                         obj.drawFixPoints(wpnt(1),fixPos,obj.settings.UI.val.onlineGaze.fixBackSize,obj.settings.UI.val.onlineGaze.fixFrontSize,obj.settings.UI.val.onlineGaze.fixBackColor,obj.settings.UI.val.onlineGaze.fixFrontColor);
                         % draw gaze data
-                        eyeData = obj.buffer.peekN('gaze');
+                        eyeData = obj.buffer.getLatest('gaze');
                         if ~isempty(eyeData.systemTimeStamp)
                             lE = eyeData. left.gazePoint.onDisplayArea(:,end).*obj.scrInfo.resolution{1}.';
                             rE = eyeData.right.gazePoint.onDisplayArea(:,end).*obj.scrInfo.resolution{1}.';
@@ -6032,7 +6031,7 @@ classdef Titta < handle
                     % get eye data if needed
                     if qShowGaze || qShowHead || qShowGazeToAll || (qShowEyeImage && qDrawEyeValidity)
                         if ~qShowGaze
-                            eyeData     = obj.buffer.peekN('gaze',1);
+                            eyeData     = obj.buffer.getLatest('gaze');
                         else
                             eyeData     = obj.buffer.peekN('gaze',nDataPointLiveView);
                         end
@@ -6053,7 +6052,7 @@ classdef Titta < handle
                     
                     % prep head
                     if qShowHead
-                        posGuide    = obj.buffer.peekN('positioning',1);
+                        posGuide    = obj.buffer.getLatest('positioning');
                         if ~isempty(eyeData.systemTimeStamp)
                             inp = {
                                  eyeData.left.gazeOrigin.valid(end),  eyeData.left.gazeOrigin.inUserCoords(:,end),  posGuide.left.userPosition,  eyeData.left.pupil.valid(end),  eyeData.left.pupil.diameter(end),  eyeData.left.eyeOpenness.valid(end),  eyeData.left.eyeOpenness.diameter(end),...
@@ -7761,7 +7760,7 @@ classdef Titta < handle
             end
             obj.buffer.enterCalibrationMode(qDoMonocular);
             while true
-                callResult  = obj.buffer.calibrationRetrieveResult();
+                callResult  = obj.buffer.calibrationWaitForResult([],100);  % blocks until a result is available, no need to poll
                 if ~isempty(callResult) && strcmp(callResult.workItem.action,'Enter')
                     if callResult.status==0
                         break;
@@ -7769,14 +7768,13 @@ classdef Titta < handle
                         error('Titta: error entering calibration mode: %s',callResult.statusString);
                     end
                 end
-                WaitSecs('YieldSecs',0.001);    % don't spin too hard
             end
         end
         
         function issuedLeave = doLeaveCalibrationMode(obj)
             issuedLeave = obj.buffer.leaveCalibrationMode();    % returns false if we never were in calibration mode to begin with
             while true && issuedLeave
-                callResult  = obj.buffer.calibrationRetrieveResult();
+                callResult  = obj.buffer.calibrationWaitForResult([],100);  % blocks until a result is available, no need to poll
                 if ~isempty(callResult) && strcmp(callResult.workItem.action,'Exit')
                     if callResult.status==0
                         break;
@@ -7784,7 +7782,6 @@ classdef Titta < handle
                         error('Titta: error exiting calibration mode: %s',callResult.statusString);
                     end
                 end
-                WaitSecs('YieldSecs',0.001);    % don't spin too hard
             end
         end
         
@@ -7812,7 +7809,7 @@ classdef Titta < handle
                 end
                 
                 % load previous calibration
-                obj.buffer.calibrationApplyData(cal.cal.computedCal);
+                requestId = obj.buffer.calibrationApplyData(cal.cal.computedCal);
                 
                 if nargin>3 && ~isempty(skipCheck) && skipCheck
                     % return immediately
@@ -7821,15 +7818,14 @@ classdef Titta < handle
                 
                 % wait for it to have loaded successfully
                 while true
-                    callResult  = obj.buffer.calibrationRetrieveResult();
-                    if ~isempty(callResult) && strcmp(callResult.workItem.action,'ApplyCalibrationData')
+                    callResult  = obj.buffer.calibrationWaitForResult(requestId,100);
+                    if ~isempty(callResult)
                         if callResult.status==0
                             break;
                         else
                             error('Titta: error loading calibration: %s',callResult.statusString);
                         end
                     end
-                    WaitSecs('YieldSecs',0.001);    % don't spin too hard
                 end
             end
         end